@@ -23,7 +23,6 @@ void HandlerInit(BT_t *bt, IBus_t *ibus)
     Context.bt = bt;
     Context.ibus = ibus;
     uint32_t now = TimerGetMillis();
-    Context.btDeviceConnRetries = 0;
     Context.btStartupIsRun = 0;
     Context.btSelectedDevice = HANDLER_BT_SELECTED_DEVICE_NONE;
     Context.volumeMode = HANDLER_VOLUME_MODE_NORMAL;
@@ -35,6 +34,9 @@ void HandlerInit(BT_t *bt, IBus_t *ibus)
     Context.mflButtonStatus = HANDLER_MFL_STATUS_OFF;
     Context.telStatus = IBUS_TEL_STATUS_NONE;
     Context.btBootState = HANDLER_BT_BOOT_OK;
+    Context.btMetadataPollInterval = HANDLER_BT_METADATA_POLL_MIN;
+    Context.btMetadataPollTimestamp = 0;
+    Context.btAVRCPCapsTimestamp = 0;
     memset(&Context.gmState, 0, sizeof(HandlerBodyModuleStatus_t));
     memset(&Context.lmState, 0, sizeof(HandlerLightControlStatus_t));
     Context.powerStatus = HANDLER_POWER_ON;
@@ -121,6 +123,15 @@ void HandlerUIInitiateConnection(void *ctx, unsigned char *deviceId)
         BT_MAC_ID_LEN
     );
     BTCommandSetConnectable(context->bt, BT_STATE_ON);
+    // Without an active device there is no disconnect to start the
+    // scheduler from, so start it here
+    if (context->bt->activeDevice.deviceId == 0) {
+        BTReconnectStart(context->bt, 0);
+        BTReconnectPrefer(
+            context->bt,
+            context->bt->pairedDevices[context->btSelectedDevice].macId
+        );
+    }
 }
 
 /**
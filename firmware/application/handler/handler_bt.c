@@ -18,6 +18,67 @@ static char *PROFILES[] = {
     "MAP"
 };
 
+/**
+ * HandlerBTBM83AVRCPQueueNotifications()
+ *     Description:
+ *         Queue the AVRCP notification registrations that the connected
+ *         device supports. A notification only fires once, so this is also
+ *         used to re-register after one has been received.
+ *     Params:
+ *         HandlerContext_t *context - The handler context
+ *     Returns:
+ *         void
+ */
+static void HandlerBTBM83AVRCPQueueNotifications(HandlerContext_t *context)
+{
+    BTConnectionAVRCPCapabilities_t *caps = &context->bt->activeDevice.avrcpCaps;
+    if (caps->trackChanged == 1) {
+        context->bt->avrcpUpdates = SET_BIT(
+            context->bt->avrcpUpdates,
+            BT_AVRCP_ACTION_SET_TRACK_CHANGE_NOTIF
+        );
+    }
+    if (caps->playbackChanged == 1) {
+        context->bt->avrcpUpdates = SET_BIT(
+            context->bt->avrcpUpdates,
+            BT_AVRCP_ACTION_SET_PLAYBACK_CHANGE_NOTIF
+        );
+    }
+    if (caps->nowPlayingChanged == 1) {
+        context->bt->avrcpUpdates = SET_BIT(
+            context->bt->avrcpUpdates,
+            BT_AVRCP_ACTION_SET_NOW_PLAYING_NOTIF
+        );
+    }
+}
+
+/**
+ * HandlerBTBM83AVRCPStart()
+ *     Description:
+ *         Fetch the metadata once and set up the notifications. If we do not
+ *         know what the device supports yet, ask it first.
+ *     Params:
+ *         HandlerContext_t *context - The handler context
+ *     Returns:
+ *         void
+ */
+static void HandlerBTBM83AVRCPStart(HandlerContext_t *context)
+{
+    if (context->bt->activeDevice.avrcpCaps.received == 1) {
+        HandlerBTBM83AVRCPQueueNotifications(context);
+    } else {
+        context->bt->avrcpUpdates = SET_BIT(
+            context->bt->avrcpUpdates,
+            BT_AVRCP_ACTION_GET_CAPABILITIES
+        );
+    }
+    context->bt->avrcpUpdates = SET_BIT(
+        context->bt->avrcpUpdates,
+        BT_AVRCP_ACTION_GET_METADATA
+    );
+    TimerResetScheduledTask(context->avrcpRegisterStatusNotifierTimerId);
+}
+
 void HandlerBTInit(HandlerContext_t *context)
 {
     EventRegisterCallback(
@@ -55,6 +116,11 @@ void HandlerBTInit(HandlerContext_t *context)
         &HandlerBTPlaybackStatus,
         context
     );
+    EventRegisterCallback(
+        BT_EVENT_METADATA_UPDATE,
+        &HandlerBTMetadata,
+        context
+    );
     context->tcuStateChangeTimerId = TimerRegisterScheduledTask(
         &HandlerTimerBTTCUStateChange,
         context,
@@ -71,15 +137,10 @@ void HandlerBTInit(HandlerContext_t *context)
             &HandlerBTBC127BootStatus,
             context
         );
-        TimerRegisterScheduledTask(
-            &HandlerTimerBTBC127State,
-            context,
-            HANDLER_INT_BC127_STATE
-        );
-        TimerRegisterScheduledTask(
-            &HandlerTimerBTBC127DeviceConnection,
-            context,
-            HANDLER_INT_DEVICE_CONN
+        EventRegisterCallback(
+            BT_EVENT_COMMAND_COMPLETE,
+            &HandlerBTBC127CommandComplete,
+            context
         );
         TimerRegisterScheduledTask(
             &HandlerTimerBTBC127ScanDevices,
@@ -118,6 +179,11 @@ void HandlerBTInit(HandlerContext_t *context)
             &HandlerBTBM83DSPStatus,
             context
         );
+        EventRegisterCallback(
+            BT_EVENT_COMMAND_COMPLETE,
+            &HandlerBTBM83CommandComplete,
+            context
+        );
         TimerRegisterScheduledTask(
             &HandlerTimerBTBM83ScanDevices,
             context,
@@ -134,6 +200,11 @@ void HandlerBTInit(HandlerContext_t *context)
             HANDLER_INT_BM83_POWER_RESET
         );
     }
+    TimerRegisterScheduledTask(
+        &HandlerTimerBTReconnect,
+        context,
+        HANDLER_INT_BT_RECONNECT
+    );
     TimerRegisterScheduledTask(
         &HandlerTimerBTVolumeManagement,
         context,
@@ -310,7 +381,8 @@ void HandlerBTCallStatus(void *ctx, uint8_t *data)
 /**
  * HandlerBTDeviceFound()
  *     Description:
- *         If a device is found and we are not connected, connect to it
+ *         If a device is found and we are not connected, hand it to the
+ *         reconnect scheduler
  *     Params:
  *         void *ctx - The context provided at registration
  *         uint8_t *tmp - Any event data
@@ -324,42 +396,12 @@ void HandlerBTDeviceFound(void *ctx, uint8_t *data)
         context->ibus->ignitionStatus > IBUS_IGNITION_OFF
     ) {
         LogDebug(LOG_SOURCE_SYSTEM, "Handler: No Device -- Attempt connection");
-        if (context->bt->type == BT_BTM_TYPE_BC127) {
-            memcpy(context->bt->activeDevice.macId, data, BT_MAC_ID_LEN);
-            BC127CommandProfileOpen(context->bt, "A2DP");
-            // uint8_t preferredDevice[BT_MAC_ID_LEN] = {0};
-            // ConfigGetBytes(
-            //     CONFIG_SETTING_LAST_CONNECTED_DEVICE_MAC,
-            //     preferredDevice,
-            //     BT_MAC_ID_LEN
-            // );
-            // if (preferredDevice[0] == 0 || memcmp(data, preferredDevice, BT_MAC_ID_LEN) == 0) {
-            //     LogDebug(LOG_SOURCE_SYSTEM, "Connecting to preferred device");
-            //     memcpy(context->bt->activeDevice.macId, data, BT_MAC_ID_LEN);
-            //     BC127CommandProfileOpen(context->bt, "A2DP");
-            // } else {
-            //     // Retry in a few seconds if the preferred does not connect,
-            //     // then the user would need to use the device selection menu
-            //     LogDebug(LOG_SOURCE_SYSTEM, "Delaying connection, waiting for preferred to connect");
-            // }
-        } else {
-            if (context->bt->pairedDevicesCount > 0) {
-                if (context->btSelectedDevice == HANDLER_BT_SELECTED_DEVICE_NONE ||
-                    context->bt->pairedDevicesCount == 1
-                ) {
-                    BTPairedDevice_t *dev = &context->bt->pairedDevices[0];
-                    BTCommandConnect(context->bt, dev);
-                    context->btSelectedDevice = 0;
-                } else {
-                    if (context->btSelectedDevice + 1 < context->bt->pairedDevicesCount) {
-                        context->btSelectedDevice++;
-                    } else {
-                        context->btSelectedDevice = 0;
-                    }
-                    BTPairedDevice_t *dev = &context->bt->pairedDevices[context->btSelectedDevice];
-                    BTCommandConnect(context->bt, dev);
-                }
-            }
+        if (context->bt->reconnect.status != BT_RECONNECT_STATUS_ACTIVE) {
+            BTReconnectStart(context->bt, 0);
+        }
+        // The BC127 only names the devices that are in range
+        if (context->bt->type == BT_BTM_TYPE_BC127 && data != 0) {
+            BTReconnectPrefer(context->bt, data);
         }
     } else {
         LogDebug(
@@ -417,6 +459,8 @@ void HandlerBTDeviceLinkConnected(void *ctx, uint8_t *data)
         if (linkType == BT_LINK_TYPE_A2DP &&
             context->bt->activeDevice.a2dpId != 0
         ) {
+            BTReconnectConnected(context->bt);
+            BTPairedDeviceSetSeen(context->bt, context->bt->activeDevice.macId);
             // Raise the volume one step to trigger the absolute volume notification
             if (context->bt->type == BT_BTM_TYPE_BC127) {
                 BC127CommandVolume(
@@ -441,6 +485,9 @@ void HandlerBTDeviceLinkConnected(void *ctx, uint8_t *data)
                 BTCommandPlay(context->bt);
             }
             if (context->bt->type == BT_BTM_TYPE_BM83) {
+                if (linkType == BT_LINK_TYPE_AVRCP) {
+                    HandlerBTBM83AVRCPStart(context);
+                }
                 // Request Device Name if it is empty
                 char tmp[BT_DEVICE_NAME_LEN] = {0};
                 if (memcmp(tmp, context->bt->activeDevice.deviceName, BT_DEVICE_NAME_LEN) == 0) {
@@ -492,8 +539,8 @@ void HandlerBTDeviceLinkConnected(void *ctx, uint8_t *data)
 /**
  * HandlerBTDeviceDisconnected()
  *     Description:
- *         If a device disconnects and our ignition is on,
- *         make the module connectable again.
+ *         If a device disconnects and our ignition is on, start the
+ *         reconnect scheduler
  *     Params:
  *         void *ctx - The context provided at registration
  *         uint8_t *tmp - Any event data
@@ -509,12 +556,17 @@ void HandlerBTDeviceDisconnected(void *ctx, uint8_t *data)
         BC127ClearPairingErrors(context->bt);
     }
     if (context->ibus->ignitionStatus > IBUS_IGNITION_OFF) {
-        if (context->btSelectedDevice != HANDLER_BT_SELECTED_DEVICE_NONE) {
-            BTPairedDevice_t *dev = &context->bt->pairedDevices[
-                context->btSelectedDevice
-            ];
-            BTCommandConnect(context->bt, dev);
-        } else {
+        // A failed attempt also lands here, and must not reset the back off
+        if (context->bt->reconnect.status != BT_RECONNECT_STATUS_ACTIVE) {
+            BTReconnectStart(context->bt, 0);
+            if (context->btSelectedDevice != HANDLER_BT_SELECTED_DEVICE_NONE) {
+                BTReconnectPrefer(
+                    context->bt,
+                    context->bt->pairedDevices[context->btSelectedDevice].macId
+                );
+            }
+        }
+        if (context->btSelectedDevice == HANDLER_BT_SELECTED_DEVICE_NONE) {
             if (ConfigGetSetting(CONFIG_SETTING_HFP) == CONFIG_SETTING_ON) {
                 IBusCommandTELSetLED(context->ibus, IBUS_TEL_LED_STATUS_RED);
             }
@@ -546,18 +598,14 @@ void HandlerBTPlaybackStatus(void *ctx, uint8_t *data)
                 BTCommandGetMetadata(context->bt);
             }
         } else {
-            context->bt->avrcpUpdates = SET_BIT(
-                context->bt->avrcpUpdates,
-                BT_AVRCP_ACTION_GET_METADATA
-            );
-            context->bt->avrcpUpdates = SET_BIT(
-                context->bt->avrcpUpdates,
-                BT_AVRCP_ACTION_SET_TRACK_CHANGE_NOTIF
-            );
-            TimerResetScheduledTask(context->avrcpRegisterStatusNotifierTimerId);
+            HandlerBTBM83AVRCPStart(context);
         }
         context->btStartupIsRun = 1;
     }
+    if (context->bt->playbackStatus == BT_AVRCP_STATUS_PLAYING) {
+        // Poll promptly after playback resumes
+        context->btMetadataPollInterval = HANDLER_BT_METADATA_POLL_MIN;
+    }
     if (context->bt->playbackStatus == BT_AVRCP_STATUS_PLAYING &&
         context->ibus->cdChangerFunction == IBUS_CDC_FUNC_NOT_PLAYING
     ) {
@@ -566,6 +614,22 @@ void HandlerBTPlaybackStatus(void *ctx, uint8_t *data)
     }
 }
 
+/**
+ * HandlerBTMetadata()
+ *     Description:
+ *         The metadata changed, so reset the polling back off
+ *     Params:
+ *         void *ctx - The context provided at registration
+ *         uint8_t *data - Any event data
+ *     Returns:
+ *         void
+ */
+void HandlerBTMetadata(void *ctx, uint8_t *data)
+{
+    HandlerContext_t *context = (HandlerContext_t *) ctx;
+    context->btMetadataPollInterval = HANDLER_BT_METADATA_POLL_MIN;
+}
+
 /**
  * HandlerBTTimeUpdate()
  *     Description:
@@ -649,6 +713,47 @@ void HandlerBTBC127BootStatus(void *ctx, uint8_t *tmp)
     } else {
         // Set the connectable and discoverable states to what they were
         BC127CommandBtState(context->bt, BT_STATE_ON, context->bt->discoverable);
+        // Reconnect from the stored devices, rather than waiting for the PDL
+        // to be listed
+        if (context->bt->status == BT_STATUS_DISCONNECTED) {
+            BTReconnectStart(context->bt, 0);
+        }
+    }
+}
+
+/**
+ * HandlerBTBC127CommandComplete()
+ *     Description:
+ *         React to BC127 command completions. If the STATUS request sent at
+ *         start up goes unanswered, the module failed to boot. A completed
+ *         LIST reconciles the stored paired devices.
+ *     Params:
+ *         void *ctx - The context provided at registration
+ *         uint8_t *data - A pointer to the BC127CommandResult_t
+ *     Returns:
+ *         void
+ */
+void HandlerBTBC127CommandComplete(void *ctx, uint8_t *data)
+{
+    HandlerContext_t *context = (HandlerContext_t *) ctx;
+    BC127CommandResult_t *result = (BC127CommandResult_t *) data;
+    if (result->status == BC127_TX_STATUS_TIMEOUT &&
+        strcmp(result->command, "STATUS") == 0 &&
+        context->bt->powerState == BT_STATE_OFF &&
+        context->btBootState == HANDLER_BT_BOOT_OK
+    ) {
+        LogWarning("BC127 Boot Failure");
+        uint16_t bootFailCount = ConfigGetBC127BootFailures();
+        bootFailCount++;
+        ConfigSetBC127BootFailures(bootFailCount);
+        IBusCommandTELSetLED(context->ibus, IBUS_TEL_LED_STATUS_RED_BLINKING);
+        context->btBootState = HANDLER_BT_BOOT_FAIL;
+    }
+    // Every device on the PDL has been listed, so drop the stale stored ones
+    if (result->status == BC127_TX_STATUS_OK &&
+        strcmp(result->command, "LIST") == 0
+    ) {
+        BTPairedDevicesReconcile(context->bt);
     }
 }
 
@@ -657,7 +762,9 @@ void HandlerBTBC127BootStatus(void *ctx, uint8_t *tmp)
 /**
  * HandlerBTBM83AVRCPUpdates()
  *     Description:
- *         Handle AVRCP updates
+ *         Handle AVRCP updates. Metadata is only requested when the device
+ *         notifies us of a change, and each notification is registered again
+ *         after it fires.
  *     Params:
  *         void *ctx - The context provided at registration
  *         uint8_t *data - Any event data
@@ -667,36 +774,65 @@ void HandlerBTBC127BootStatus(void *ctx, uint8_t *tmp)
 void HandlerBTBM83AVRCPUpdates(void *ctx, uint8_t *data)
 {
     HandlerContext_t *context = (HandlerContext_t *) ctx;
+    BTConnectionAVRCPCapabilities_t *caps = &context->bt->activeDevice.avrcpCaps;
     uint8_t type = data[0];
     uint8_t status = data[1];
-    if ((type == BM83_AVRCP_EVT_PLAYBACK_STATUS_CHANGED &&
-        status == BM83_AVRCP_DATA_PLAYBACK_STATUS_PLAYING) ||
-        type == BM83_AVRCP_EVT_ADDRESSED_PLAYER_CHANGED
-    ) {
+    uint8_t getMetadata = 0;
+    uint8_t notification = 0xFF;
+    // The interim response only confirms a registration
+    if (status == BM83_DATA_AVC_RSP_INTERIM) {
+        return;
+    }
+    switch (type) {
+        case BM83_AVRCP_PDU_GET_CAPABILITIES:
+            context->btAVRCPCapsTimestamp = 0;
+            LogDebug(
+                LOG_SOURCE_BT,
+                "BT: AVRCP Notifications: track=%d,playback=%d,content=%d",
+                caps->trackChanged,
+                caps->playbackChanged,
+                caps->nowPlayingChanged
+            );
+            HandlerBTBM83AVRCPQueueNotifications(context);
+            break;
+        case BM83_AVRCP_EVT_ADDRESSED_PLAYER_CHANGED:
+            // Registrations do not carry over to the new player
+            HandlerBTBM83AVRCPQueueNotifications(context);
+            getMetadata = 1;
+            break;
+        case BM83_AVRCP_EVT_PLAYBACK_STATUS_CHANGED:
+            notification = BT_AVRCP_ACTION_SET_PLAYBACK_CHANGE_NOTIF;
+            if (status == BM83_AVRCP_DATA_PLAYBACK_STATUS_PLAYING) {
+                // Some devices drop the track registration while paused
+                if (caps->trackChanged == 1) {
+                    context->bt->avrcpUpdates = SET_BIT(
+                        context->bt->avrcpUpdates,
+                        BT_AVRCP_ACTION_SET_TRACK_CHANGE_NOTIF
+                    );
+                }
+                getMetadata = 1;
+            }
+            break;
+        case BM83_AVRCP_EVT_PLAYBACK_TRACK_CHANGED:
+            notification = BT_AVRCP_ACTION_SET_TRACK_CHANGE_NOTIF;
+            getMetadata = 1;
+            break;
+        case BM83_AVRCP_EVT_NOW_PLAYING_CONTENT_CHANGED:
+            notification = BT_AVRCP_ACTION_SET_NOW_PLAYING_NOTIF;
+            getMetadata = 1;
+            break;
+    }
+    if (notification != 0xFF) {
+        context->bt->avrcpUpdates = SET_BIT(context->bt->avrcpUpdates, notification);
+    }
+    if (getMetadata == 1) {
         context->bt->avrcpUpdates = SET_BIT(
             context->bt->avrcpUpdates,
-            BT_AVRCP_ACTION_SET_TRACK_CHANGE_NOTIF
+            BT_AVRCP_ACTION_GET_METADATA
         );
-        if (status == BM83_AVRCP_DATA_PLAYBACK_STATUS_PLAYING) {
-            context->bt->avrcpUpdates = SET_BIT(
-                context->bt->avrcpUpdates,
-                BT_AVRCP_ACTION_GET_METADATA
-            );
-        }
+    }
+    if (context->bt->avrcpUpdates != 0x00) {
         TimerResetScheduledTask(context->avrcpRegisterStatusNotifierTimerId);
-    } else if (type == BM83_AVRCP_EVT_PLAYBACK_TRACK_CHANGED) {
-        // On AVRCP "Change"
-        if (status != BM83_DATA_AVC_RSP_INTERIM) {
-            context->bt->avrcpUpdates = SET_BIT(
-                context->bt->avrcpUpdates,
-                BT_AVRCP_ACTION_SET_TRACK_CHANGE_NOTIF
-            );
-            context->bt->avrcpUpdates = SET_BIT(
-                context->bt->avrcpUpdates,
-                BT_AVRCP_ACTION_GET_METADATA
-            );
-            TimerResetScheduledTask(context->avrcpRegisterStatusNotifierTimerId);
-        }
     }
 }
 
@@ -749,7 +885,8 @@ void HandlerBTBM83Boot(void *ctx, uint8_t *tmp)
 /**
  * HandlerBTBM83BootStatus()
  *     Description:
- *         When the BM83 reports power on, request the PDL
+ *         When the BM83 reports power on, request the PDL and start
+ *         reconnecting to the stored devices
  *     Params:
  *         void *ctx - The context provided at registration
  *         uint8_t *data - Any event data
@@ -761,12 +898,84 @@ void HandlerBTBM83BootStatus(void *ctx, uint8_t *data)
     HandlerContext_t *context = (HandlerContext_t *) ctx;
     uint8_t type = *data;
     if (type == BM83_DATA_BOOT_STATUS_POWER_ON) {
-        BM83CommandReadPairedDevices(context->bt);
+        // Until the deferred start up work loads the stored devices, the
+        // query is left to it
+        if (BootTraceIsMarked(BOOT_TRACE_PAIRED_DEVICES) == 1) {
+            BM83CommandReadPairedDevices(context->bt);
+        }
+        // Reconnect from the stored devices while the PDL is read back
+        if (context->bt->status == BT_STATUS_DISCONNECTED &&
+            context->ibus->ignitionStatus > IBUS_IGNITION_OFF
+        ) {
+            BTReconnectStart(context->bt, 0);
+        }
+    }
+}
+
+/**
+ * HandlerBTBM83CommandComplete()
+ *     Description:
+ *         When the BM83 acknowledges an AVRCP command and we still have
+ *         AVRCP requests pending, run the AVRCP manager now rather than
+ *         waiting for its next interval
+ *     Params:
+ *         void *ctx - The context provided at registration
+ *         uint8_t *data - The command opcode and the ACK status
+ *     Returns:
+ *         void
+ */
+void HandlerBTBM83CommandComplete(void *ctx, uint8_t *data)
+{
+    HandlerContext_t *context = (HandlerContext_t *) ctx;
+    uint8_t opcode = data[0];
+    uint8_t status = data[1];
+    if (opcode == BM83_CMD_AVC_VENDOR_DEPENDENT_CMD &&
+        status == BM83_DATA_ACK_STATUS_COMPLETE &&
+        context->bt->avrcpUpdates != 0x00
+    ) {
+        TimerTriggerScheduledTask(context->avrcpRegisterStatusNotifierTimerId);
     }
 }
 
 /* Timers */
 
+/**
+ * HandlerTimerBTReconnect()
+ *     Description:
+ *         Drive the reconnect scheduler while the ignition is on. If A2DP
+ *         drops while the device is still linked, start it over.
+ *     Params:
+ *         void *ctx - The context provided at registration
+ *     Returns:
+ *         void
+ */
+void HandlerTimerBTReconnect(void *ctx)
+{
+    HandlerContext_t *context = (HandlerContext_t *) ctx;
+    BT_t *bt = context->bt;
+    if (context->ibus->ignitionStatus == IBUS_IGNITION_OFF) {
+        if (bt->reconnect.status == BT_RECONNECT_STATUS_ACTIVE) {
+            BTReconnectStop(bt);
+        }
+        return;
+    }
+    // Leave the module alone while it is pairing
+    if (bt->type == BT_BTM_TYPE_BM83 && bt->discoverable == BT_STATE_ON) {
+        return;
+    }
+    if (bt->reconnect.status != BT_RECONNECT_STATUS_ACTIVE &&
+        bt->activeDevice.deviceId != 0 &&
+        bt->activeDevice.a2dpId == 0
+    ) {
+        // Give the profile a chance to come back on its own first
+        BTReconnectStart(bt, BT_RECONNECT_DELAY_MIN);
+    }
+    int8_t device = BTReconnectProcess(bt);
+    if (device != -1 && bt->type == BT_BTM_TYPE_BM83) {
+        context->btSelectedDevice = device;
+    }
+}
+
 /**
  * HandlerTimerBTTCUStateChange()
  *     Description:
@@ -881,64 +1090,6 @@ void HandlerTimerBTVolumeManagement(void *ctx)
 
 /* BC127 Specific Timers */
 
-/**
- * HandlerTimerBTBC127State()
- *     Description:
- *         Ensure the BC127 has booted, and if not, blink the red TEL LED
- *     Params:
- *         void *ctx - The context provided at registration
- *     Returns:
- *         void
- */
-void HandlerTimerBTBC127State(void *ctx)
-{
-    HandlerContext_t *context = (HandlerContext_t *) ctx;
-    if (context->bt->powerState == BT_STATE_OFF &&
-        context->btBootState == HANDLER_BT_BOOT_OK
-    ) {
-        LogWarning("BC127 Boot Failure");
-        uint16_t bootFailCount = ConfigGetBC127BootFailures();
-        bootFailCount++;
-        ConfigSetBC127BootFailures(bootFailCount);
-        IBusCommandTELSetLED(context->ibus, IBUS_TEL_LED_STATUS_RED_BLINKING);
-        context->btBootState = HANDLER_BT_BOOT_FAIL;
-    }
-}
-
-/**
- * HandlerTimerBTBC127DeviceConnection()
- *     Description:
- *         Monitor the BT connection and ensure it stays connected
- *     Params:
- *         void *ctx - The context provided at registration
- *     Returns:
- *         void
- */
-void HandlerTimerBTBC127DeviceConnection(void *ctx)
-{
-    HandlerContext_t *context = (HandlerContext_t *) ctx;
-    if (BTHasActiveMacId(context->bt) != 0 && context->bt->activeDevice.a2dpId == 0) {
-        if (context->btDeviceConnRetries <= HANDLER_DEVICE_MAX_RECONN) {
-            LogDebug(
-                LOG_SOURCE_SYSTEM,
-                "Handler: A2DP link closed -- Attempting to connect"
-            );
-            BC127CommandProfileOpen(
-                context->bt,
-                "A2DP"
-            );
-            context->btDeviceConnRetries += 1;
-        } else {
-            LogError("Handler: Giving up on BT connection");
-            context->btDeviceConnRetries = 0;
-            BTClearPairedDevices(context->bt, BT_TYPE_CLEAR_ALL);
-            BTCommandDisconnect(context->bt);
-        }
-    } else if (context->btDeviceConnRetries > 0) {
-        context->btDeviceConnRetries = 0;
-    }
-}
-
 /**
  * HandlerTimerBTBC127RequestDateTime()
  *     Description:
@@ -1017,7 +1168,9 @@ void HandlerTimerBTBC127ScanDevices(void *ctx)
 /**
  * HandlerTimerBTBC127Metadata()
  *     Description:
- *         Request current playing song periodically
+ *         The BC127 pushes the metadata when the track changes, so only poll
+ *         for it when it has gone quiet. Each poll that does not turn up new
+ *         metadata doubles the time until the next one.
  *     Params:
  *         HandlerContext_t *context - The handler context
  *     Returns:
@@ -1027,11 +1180,16 @@ void HandlerTimerBTBC127Metadata(HandlerContext_t *context)
 {
     uint32_t now = TimerGetMillis();
     if (now - HANDLER_BT_METADATA_TIMEOUT >= context->bt->metadataTimestamp &&
+        now - context->btMetadataPollTimestamp >= context->btMetadataPollInterval &&
         context->bt->activeDevice.avrcpId != 0 &&
         context->bt->callStatus == BT_CALL_INACTIVE &&
         context->bt->playbackStatus == BT_AVRCP_STATUS_PLAYING
     ) {
         BC127CommandGetMetadata(context->bt);
+        context->btMetadataPollTimestamp = now;
+        if (context->btMetadataPollInterval < HANDLER_BT_METADATA_POLL_MAX) {
+            context->btMetadataPollInterval = context->btMetadataPollInterval * 2;
+        }
     }
 }
 
@@ -1040,7 +1198,9 @@ void HandlerTimerBTBC127Metadata(HandlerContext_t *context)
 /**
  * HandlerTimerBTBM83AVRCPManager()
  *     Description:
- *         Register the track change event notifier or grab the metadata
+ *         Send the pending AVRCP requests one at a time. Devices that do not
+ *         support track change notifications have their metadata polled with
+ *         a back off instead.
  *     Params:
  *         void *ctx - The context provided at registration
  *     Returns:
@@ -1049,8 +1209,28 @@ void HandlerTimerBTBC127Metadata(HandlerContext_t *context)
 void HandlerTimerBTBM83AVRCPManager(void *ctx)
 {
     HandlerContext_t *context = (HandlerContext_t *) ctx;
+    BTConnectionAVRCPCapabilities_t *caps = &context->bt->activeDevice.avrcpCaps;
+    uint32_t now = TimerGetMillis();
+    if (context->btAVRCPCapsTimestamp != 0 &&
+        now - context->btAVRCPCapsTimestamp > HANDLER_BT_AVRCP_CAPS_TIMEOUT
+    ) {
+        // Assume the events that every AVRCP 1.3 target has to support
+        LogWarning("BT: AVRCP capabilities not received");
+        context->btAVRCPCapsTimestamp = 0;
+        caps->trackChanged = 1;
+        caps->playbackChanged = 1;
+        caps->received = 1;
+        HandlerBTBM83AVRCPQueueNotifications(context);
+    }
     if (context->bt->avrcpUpdates != 0x00) {
-        if (CHECK_BIT(context->bt->avrcpUpdates, BT_AVRCP_ACTION_SET_TRACK_CHANGE_NOTIF) > 0) {
+        if (CHECK_BIT(context->bt->avrcpUpdates, BT_AVRCP_ACTION_GET_CAPABILITIES) > 0) {
+            context->bt->avrcpUpdates = CLEAR_BIT(
+                context->bt->avrcpUpdates,
+                BT_AVRCP_ACTION_GET_CAPABILITIES
+            );
+            BM83CommandAVRCPGetCapabilities(context->bt);
+            context->btAVRCPCapsTimestamp = now;
+        } else if (CHECK_BIT(context->bt->avrcpUpdates, BT_AVRCP_ACTION_SET_TRACK_CHANGE_NOTIF) > 0) {
             context->bt->avrcpUpdates = CLEAR_BIT(
                 context->bt->avrcpUpdates,
                 BT_AVRCP_ACTION_SET_TRACK_CHANGE_NOTIF
@@ -1059,29 +1239,59 @@ void HandlerTimerBTBM83AVRCPManager(void *ctx)
                 context->bt,
                 BM83_AVRCP_EVT_PLAYBACK_TRACK_CHANGED
             );
+        } else if (CHECK_BIT(context->bt->avrcpUpdates, BT_AVRCP_ACTION_SET_PLAYBACK_CHANGE_NOTIF) > 0) {
+            context->bt->avrcpUpdates = CLEAR_BIT(
+                context->bt->avrcpUpdates,
+                BT_AVRCP_ACTION_SET_PLAYBACK_CHANGE_NOTIF
+            );
+            BM83CommandAVRCPRegisterNotification(
+                context->bt,
+                BM83_AVRCP_EVT_PLAYBACK_STATUS_CHANGED
+            );
+        } else if (CHECK_BIT(context->bt->avrcpUpdates, BT_AVRCP_ACTION_SET_NOW_PLAYING_NOTIF) > 0) {
+            context->bt->avrcpUpdates = CLEAR_BIT(
+                context->bt->avrcpUpdates,
+                BT_AVRCP_ACTION_SET_NOW_PLAYING_NOTIF
+            );
+            BM83CommandAVRCPRegisterNotification(
+                context->bt,
+                BM83_AVRCP_EVT_NOW_PLAYING_CONTENT_CHANGED
+            );
         } else if (CHECK_BIT(context->bt->avrcpUpdates, BT_AVRCP_ACTION_GET_METADATA) > 0) {
             context->bt->avrcpUpdates = CLEAR_BIT(
                 context->bt->avrcpUpdates,
                 BT_AVRCP_ACTION_GET_METADATA
             );
             BM83CommandAVRCPGetElementAttributesAll(context->bt);
+            context->btMetadataPollTimestamp = now;
         }
-        // Set the timeout to 250ms from now if we still need to get metadata
-        if (CHECK_BIT(context->bt->avrcpUpdates, BT_AVRCP_ACTION_GET_METADATA) > 0) {
-            TimerSetTaskInterval(
-                context->avrcpRegisterStatusNotifierTimerId,
-                HANDLER_INT_BT_AVRCP_UPDATER_METADATA
-            );
-        } else {
-            TimerSetTaskInterval(
-                context->avrcpRegisterStatusNotifierTimerId,
-                HANDLER_INT_BT_AVRCP_UPDATER
-            );
+    } else if (caps->received == 1 &&
+        caps->trackChanged == 0 &&
+        context->bt->activeDevice.avrcpId != 0 &&
+        context->bt->callStatus == BT_CALL_INACTIVE &&
+        context->bt->playbackStatus == BT_AVRCP_STATUS_PLAYING &&
+        now - context->btMetadataPollTimestamp >= context->btMetadataPollInterval
+    ) {
+        BM83CommandAVRCPGetElementAttributesAll(context->bt);
+        context->btMetadataPollTimestamp = now;
+        if (context->btMetadataPollInterval < HANDLER_BT_METADATA_POLL_MAX) {
+            context->btMetadataPollInterval = context->btMetadataPollInterval * 2;
         }
     }
+    // Come back in 250ms if there are more requests to send
+    if (context->bt->avrcpUpdates != 0x00) {
+        TimerSetTaskInterval(
+            context->avrcpRegisterStatusNotifierTimerId,
+            HANDLER_INT_BT_AVRCP_UPDATER_METADATA
+        );
+    } else {
+        TimerSetTaskInterval(
+            context->avrcpRegisterStatusNotifierTimerId,
+            HANDLER_INT_BT_AVRCP_UPDATER
+        );
+    }
 }
 
-
 /**
  * HandlerTimerBTBM83AVRCPPlaybackState()
  *     Description:
@@ -1159,25 +1369,5 @@ void HandlerTimerBTBM83ScanDevices(void *ctx)
         ) {
             BM83CommandReadPairedDevices(context->bt);
         }
-        if (context->bt->status == BT_STATUS_DISCONNECTED &&
-            context->bt->discoverable == BT_STATE_OFF &&
-            context->bt->pairedDevicesCount > 0
-        ) {
-            if (context->btSelectedDevice == HANDLER_BT_SELECTED_DEVICE_NONE ||
-                context->bt->pairedDevicesCount == 1
-            ) {
-                BTPairedDevice_t *dev = &context->bt->pairedDevices[0];
-                BTCommandConnect(context->bt, dev);
-                context->btSelectedDevice = 0;
-            } else {
-                if (context->btSelectedDevice + 1 < context->bt->pairedDevicesCount) {
-                    context->btSelectedDevice++;
-                } else {
-                    context->btSelectedDevice = 0;
-                }
-                BTPairedDevice_t *dev = &context->bt->pairedDevices[context->btSelectedDevice];
-                BTCommandConnect(context->bt, dev);
-            }
-        }
     }
 }
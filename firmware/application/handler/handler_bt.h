@@ -27,23 +27,25 @@ void HandlerBTCallerID(void *, uint8_t *);
 void HandlerBTDeviceLinkConnected(void *, uint8_t *);
 void HandlerBTDeviceDisconnected(void *, uint8_t *);
 void HandlerBTPlaybackStatus(void *, uint8_t *);
+void HandlerBTMetadata(void *, uint8_t *);
 void HandlerBTTimeUpdate(void *, uint8_t *);
 void HandlerUICloseConnection(void *, uint8_t *);
 void HandlerUIInitiateConnection(void *, uint8_t *);
 
 void HandlerBTBC127Boot(void *, uint8_t *);
 void HandlerBTBC127BootStatus(void *, uint8_t *);
+void HandlerBTBC127CommandComplete(void *, uint8_t *);
 
 void HandlerBTBM83AVRCPUpdates(void *, uint8_t *);
 void HandlerBTBM83Boot(void *, uint8_t *);
 void HandlerBTBM83BootStatus(void *, uint8_t *);
+void HandlerBTBM83CommandComplete(void *, uint8_t *);
 void HandlerBTBM83DSPStatus(void *, uint8_t *);
 
+void HandlerTimerBTReconnect(void *);
 void HandlerTimerBTTCUStateChange(void *);
 void HandlerTimerBTVolumeManagement(void *);
 
-void HandlerTimerBTBC127State(void *);
-void HandlerTimerBTBC127DeviceConnection(void *);
 void HandlerTimerBTBC127RequestDateTime(void *);
 void HandlerTimerBTBC127OpenProfileErrors(void *);
 void HandlerTimerBTBC127ScanDevices(void *);
@@ -20,6 +20,11 @@
 
 #define HANDLER_BT_SELECTED_DEVICE_NONE -1
 #define HANDLER_BT_METADATA_TIMEOUT 2000
+// Metadata polling backs off from the minimum to the maximum interval while
+// the metadata does not change, for devices without track notifications
+#define HANDLER_BT_METADATA_POLL_MIN 1000
+#define HANDLER_BT_METADATA_POLL_MAX 16000
+#define HANDLER_BT_AVRCP_CAPS_TIMEOUT 3000
 #define HANDLER_BT_AUTOPLAY_NOT_RUN 0
 #define HANDLER_BT_AUTOPLAY_RUN 1
 #define HANDLER_CDC_ANOUNCE_TIMEOUT 21000
@@ -27,7 +32,6 @@
 #define HANDLER_CDC_SEEK_MODE_FWD 1
 #define HANDLER_CDC_SEEK_MODE_REV 2
 #define HANDLER_CDC_STATUS_TIMEOUT 20000
-#define HANDLER_DEVICE_MAX_RECONN 15
 #define HANDLER_IBUS_MODULE_PING_STATE_OFF 0
 #define HANDLER_IBUS_MODULE_PING_STATE_READY 1
 #define HANDLER_IBUS_MODULE_PING_STATE_IKE 2
@@ -41,16 +45,15 @@
 #define HANDLER_IBUS_MODULE_PING_STATE_TEL 10
 #define HANDLER_GT_STATUS_UNCHECKED 0
 #define HANDLER_GT_STATUS_CHECKED 1
-#define HANDLER_INT_BC127_STATE 1000
 #define HANDLER_INT_CDC_ANOUNCE 1000
 #define HANDLER_INT_CDC_STATUS 500
-#define HANDLER_INT_DEVICE_CONN 30000
 #define HANDLER_INT_DEVICE_SCAN 5000
 #define HANDLER_INT_IBUS_PINGS 250
 #define HANDLER_INT_TCU_STATE_CHANGE 100
 #define HANDLER_INT_LCM_IO_STATUS 15000
 #define HANDLER_INT_LIGHTING_STATE 1000
 #define HANDLER_INT_BT_AVRCP_UPDATER 1000
+#define HANDLER_INT_BT_RECONNECT 250
 #define HANDLER_INT_BT_AVRCP_UPDATER_METADATA 250
 #define HANDLER_INT_PROFILE_ERROR 2500
 #define HANDLER_INT_POWEROFF 1000
@@ -114,7 +117,6 @@ typedef struct HandlerLightControlStatus_t {
 typedef struct HandlerContext_t {
     BT_t *bt;
     IBus_t *ibus;
-    uint8_t btDeviceConnRetries;
     int8_t btSelectedDevice: 4;
     uint8_t btStartupIsRun: 1;
     uint8_t btBootState: 2;
@@ -137,6 +139,9 @@ typedef struct HandlerContext_t {
     uint8_t lightingStateTimerId;
     uint8_t avrcpRegisterStatusNotifierTimerId;
     uint8_t bm83PowerStateTimerId;
+    uint16_t btMetadataPollInterval;
+    uint32_t btMetadataPollTimestamp;
+    uint32_t btAVRCPCapsTimestamp;
     uint32_t cdChangerLastPoll;
     uint32_t cdChangerLastStatus;
     uint32_t gearLastStatus;
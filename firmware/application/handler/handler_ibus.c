@@ -375,6 +375,7 @@ void HandlerIBusCDCStatus(void *ctx, uint8_t *pkt)
     uint8_t curStatus = IBUS_CDC_STAT_STOP;
     uint8_t curFunction = IBUS_CDC_FUNC_NOT_PLAYING;
     uint8_t requestedCommand = pkt[4];
+    BootTraceMark(BOOT_TRACE_CDC_FIRST_POLL);
     if (requestedCommand == IBUS_CDC_CMD_GET_STATUS) {
         curFunction = context->ibus->cdChangerFunction;
         if (curFunction == IBUS_CDC_FUNC_PLAYING) {
@@ -742,6 +743,7 @@ void HandlerIBusIKEIgnitionStatus(void *ctx, uint8_t *pkt)
                 BTCommandSetDiscoverable(context->bt, BT_STATE_OFF);
             }
             BTCommandDisconnect(context->bt);
+            BTReconnectStop(context->bt);
             BTClearPairedDevices(context->bt, BT_TYPE_CLEAR_ALL);
             // Unlock the vehicle
             if (ConfigGetComfortUnlock() == CONFIG_SETTING_COMFORT_UNLOCK_POS_0 &&
@@ -807,11 +809,15 @@ void HandlerIBusIKEIgnitionStatus(void *ctx, uint8_t *pkt)
                 BC127CommandTone(context->bt, "V 0 N C6 L 4");
                 // Request BC127 state
                 BC127CommandStatus(context->bt);
-            } else {
-                if (context->bt->pairedDevicesCount > 0) {
-                    uint8_t lastDevice = ConfigGetSetting(CONFIG_SETTING_LAST_CONNECTED_DEVICE);
-                    BTPairedDevice_t *dev = &context->bt->pairedDevices[lastDevice];
-                    BTCommandConnect(context->bt, dev);
+            }
+            BTReconnectStart(context->bt, 0);
+            if (context->bt->type == BT_BTM_TYPE_BM83) {
+                uint8_t lastDevice = ConfigGetSetting(CONFIG_SETTING_LAST_CONNECTED_DEVICE);
+                if (lastDevice < context->bt->pairedDevicesCount) {
+                    BTReconnectPrefer(
+                        context->bt,
+                        context->bt->pairedDevices[lastDevice].macId
+                    );
                 }
             }
             // Enable the TEL LEDs
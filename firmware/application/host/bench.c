@@ -0,0 +1,620 @@
+/*
+ * File:   bench.c
+ * Author: agent <agent@local>
+ * Description:
+ *     Time the functions that the main loop spends the most time in, with
+ *     inputs built from a fixed seed so that every run does the same work.
+ *     The inputs are the ones that lib/benchmark.c times on the PIC24.
+ *     Each benchmark reports the time per operation and the bytes of input
+ *     that an operation handles. The stable output runs a fixed number of
+ *     iterations and keeps the median of a few runs, so that the results
+ *     of two commits can be compared with bench_compare.py.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "../mappings.h"
+#include "../lib/benchmark.h"
+#include "../lib/bt.h"
+#include "../lib/bt/bt_bc127.h"
+#include "../lib/bt/bt_bm83.h"
+#include "../lib/char_queue.h"
+#include "../lib/config.h"
+#include "../lib/event.h"
+#include "../lib/ibus.h"
+#include "../lib/locale.h"
+#include "../lib/uart.h"
+#include "../lib/utils.h"
+#include "host.h"
+
+/**
+ * HostBenchmark_t
+ *     Description:
+ *         A benchmark
+ *     Fields:
+ *         name - The name it is reported and filtered by
+ *         run - Run the given number of operations, and return the bytes
+ *             of input that they handled
+ *         iterations - The number of operations in a stable run
+ */
+typedef struct HostBenchmark_t {
+    const char *name;
+    uint64_t (*run)(uint32_t);
+    uint32_t iterations;
+} HostBenchmark_t;
+
+static BT_t BENCH_BT;
+static IBus_t BENCH_IBUS;
+static UART_t BENCH_SYSTEM_UART;
+static CharQueue_t BENCH_QUEUE;
+static uint32_t BENCH_RANDOM;
+static uint64_t BENCH_ELAPSED;
+static uint64_t BENCH_STARTED;
+// The benchmarks add what they compute here, so that it is not optimized out
+static volatile uint32_t BENCH_SINK;
+static uint8_t BENCH_PACKETS[BENCHMARK_PACKETS][IBUS_MAX_MSG_LENGTH];
+
+// The lines the BC127 sends while two tracks play one after the other
+static const char *BENCH_BC127_LINES[] = {
+    "AVRCP_MEDIA 11 TITLE: Bohemian Rhapsody - Remastered 2011",
+    "AVRCP_MEDIA 11 ARTIST: Queen",
+    "AVRCP_MEDIA 11 ALBUM: A Night at the Opera (2011 Remaster)",
+    "AVRCP_MEDIA 11 PLAYING_TIME(MS): 354947",
+    "AVRCP_PLAY 11",
+    "ABS_VOL 11 87",
+    "OK",
+    "AVRCP_MEDIA 11 TITLE: Ace of Spades",
+    "AVRCP_MEDIA 11 ARTIST: Mot\xC3\xB6rhead",
+    "AVRCP_MEDIA 11 ALBUM: Ace of Spades (Expanded Edition)",
+    "AVRCP_MEDIA 11 PLAYING_TIME(MS): 169000",
+    "AVRCP_PAUSE 11",
+    "ABS_VOL 11 64",
+    "A2DP_STREAM_SUSPEND 11"
+};
+#define BENCH_BC127_LINE_COUNT \
+    (sizeof(BENCH_BC127_LINES) / sizeof(BENCH_BC127_LINES[0]))
+
+// The events of BM83 frames, with their data, that the BM83 sends the most
+// without waiting on a reply
+static const uint8_t BENCH_BM83_EVENTS[][8] = {
+    {7, BM83_EVT_READ_LOCAL_BD_ADDRESS_REPLY, 0x9A, 0x78, 0x56, 0x34, 0x12, 0x00},
+    {3, BM83_EVT_CALL_STATUS, 0x00, 0x00},
+    {3, BM83_EVT_REPORT_TYPE_CODEC, 0x03, 0x00},
+    {3, BM83_EVT_COMMAND_ACK, 0x0B, 0x00}
+};
+#define BENCH_BM83_EVENT_COUNT \
+    (sizeof(BENCH_BM83_EVENTS) / sizeof(BENCH_BM83_EVENTS[0]))
+
+static uint64_t HostBenchmarkGetClock()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t) now.tv_sec * 1000000000 + now.tv_nsec;
+}
+
+/**
+ * HostBenchmarkPause()
+ *     Description:
+ *         Stop the clock of the running benchmark while it prepares input
+ *     Params:
+ *         void
+ *     Returns:
+ *         void
+ */
+static void HostBenchmarkPause()
+{
+    BENCH_ELAPSED += HostBenchmarkGetClock() - BENCH_STARTED;
+}
+
+static void HostBenchmarkResume()
+{
+    BENCH_STARTED = HostBenchmarkGetClock();
+}
+
+static void HostBenchmarkCallback(void *context, unsigned char *data)
+{
+    BENCH_SINK++;
+}
+
+/**
+ * HostBenchmarkReceive()
+ *     Description:
+ *         Put bytes on a queue as the UART RX ISR would
+ *     Params:
+ *         CharQueue_t *queue - The queue
+ *         const uint8_t *data - The bytes
+ *         uint16_t length - The number of bytes
+ *     Returns:
+ *         void
+ */
+static void HostBenchmarkReceive(
+    CharQueue_t *queue,
+    const uint8_t *data,
+    uint16_t length
+) {
+    uint16_t i;
+    for (i = 0; i < length; i++) {
+        CharQueueAdd(queue, data[i]);
+    }
+}
+
+static uint64_t HostBenchmarkCharQueueAdd(uint32_t iterations)
+{
+    uint32_t i;
+    CharQueueReset(&BENCH_QUEUE);
+    for (i = 0; i < iterations; i++) {
+        CharQueueAdd(&BENCH_QUEUE, (uint8_t) i);
+        // Keep the queue from filling, as the main loop would
+        if ((i & 0xFF) == 0xFF) {
+            BENCH_QUEUE.readCursor = BENCH_QUEUE.writeCursor;
+        }
+    }
+    return iterations;
+}
+
+static uint64_t HostBenchmarkCharQueueNext(uint32_t iterations)
+{
+    uint32_t i = 0;
+    uint32_t sum = 0;
+    CharQueueReset(&BENCH_QUEUE);
+    while (i < iterations) {
+        uint32_t count = iterations - i;
+        if (count > 256) {
+            count = 256;
+        }
+        HostBenchmarkPause();
+        uint32_t j;
+        for (j = 0; j < count; j++) {
+            CharQueueAdd(&BENCH_QUEUE, (uint8_t) BenchmarkRandom(&BENCH_RANDOM));
+        }
+        HostBenchmarkResume();
+        for (j = 0; j < count; j++) {
+            sum += CharQueueNext(&BENCH_QUEUE);
+        }
+        i += count;
+    }
+    BENCH_SINK += sum;
+    return iterations;
+}
+
+/**
+ * HostBenchmarkCharQueueSeek()
+ *     Description:
+ *         Find the end of each line on a queue of random bytes, and take the
+ *         line off the queue, as the BC127 driver does
+ *     Params:
+ *         uint32_t iterations - The number of lines to find
+ *     Returns:
+ *         uint64_t - The bytes scanned
+ */
+static uint64_t HostBenchmarkCharQueueSeek(uint32_t iterations)
+{
+    uint64_t bytes = 0;
+    uint32_t i;
+    CharQueueReset(&BENCH_QUEUE);
+    for (i = 0; i < iterations; i++) {
+        if (CharQueueGetSize(&BENCH_QUEUE) == 0) {
+            HostBenchmarkPause();
+            while (CharQueueGetSize(&BENCH_QUEUE) < CHAR_QUEUE_SIZE / 2) {
+                uint16_t length = 8 + BenchmarkRandom(&BENCH_RANDOM) % 120;
+                uint16_t j;
+                for (j = 1; j < length; j++) {
+                    CharQueueAdd(&BENCH_QUEUE, 0x20 + BenchmarkRandom(&BENCH_RANDOM) % 0x5F);
+                }
+                CharQueueAdd(&BENCH_QUEUE, '\r');
+            }
+            HostBenchmarkResume();
+        }
+        uint16_t length = CharQueueSeek(&BENCH_QUEUE, '\r');
+        BENCH_QUEUE.readCursor = (BENCH_QUEUE.readCursor + length) % CHAR_QUEUE_SIZE;
+        bytes += length;
+    }
+    return bytes;
+}
+
+static uint64_t HostBenchmarkIBusValidateChecksum(uint32_t iterations)
+{
+    uint64_t bytes = 0;
+    uint32_t valid = 0;
+    uint32_t i;
+    for (i = 0; i < iterations; i++) {
+        uint8_t *packet = BENCH_PACKETS[i % BENCHMARK_PACKETS];
+        valid += IBusValidateChecksum(packet);
+        bytes += packet[1] + 2;
+    }
+    BENCH_SINK += valid;
+    return bytes;
+}
+
+/**
+ * HostBenchmarkIBusSendCommand()
+ *     Description:
+ *         Queue the packets for transmission. The transmit buffer is a ring
+ *         that the main loop sends from, so it never needs to be emptied.
+ *     Params:
+ *         uint32_t iterations - The number of packets to queue
+ *     Returns:
+ *         uint64_t - The bytes of the packets that were queued
+ */
+static uint64_t HostBenchmarkIBusSendCommand(uint32_t iterations)
+{
+    uint64_t bytes = 0;
+    uint32_t i;
+    for (i = 0; i < iterations; i++) {
+        uint8_t *packet = BENCH_PACKETS[i % BENCHMARK_PACKETS];
+        IBusSendCommand(
+            &BENCH_IBUS,
+            packet[IBUS_PKT_SRC],
+            packet[IBUS_PKT_DST],
+            &packet[IBUS_PKT_CMD],
+            packet[1] - 2
+        );
+        bytes += packet[1] + 2;
+    }
+    return bytes;
+}
+
+static uint64_t HostBenchmarkUtilsNormalizeText(uint32_t iterations)
+{
+    char text[BENCHMARK_TEXT_SIZE];
+    uint64_t bytes = 0;
+    uint32_t i;
+    for (i = 0; i < iterations; i++) {
+        const char *input = BenchmarkGetText(i % BENCHMARK_TEXT_COUNT);
+        UtilsNormalizeText(text, input, BENCHMARK_TEXT_SIZE);
+        bytes += strlen(input);
+    }
+    return bytes;
+}
+
+/**
+ * HostBenchmarkBC127Process()
+ *     Description:
+ *         Parse and handle the BC127 lines one at a time, after they have
+ *         been received a queue's worth at a time
+ *     Params:
+ *         uint32_t iterations - The number of lines
+ *     Returns:
+ *         uint64_t - The bytes of the lines, with their carriage returns
+ */
+static uint64_t HostBenchmarkBC127Process(uint32_t iterations)
+{
+    CharQueue_t *queue = (CharQueue_t *) &BENCH_BT.uart.rxQueue;
+    uint64_t bytes = 0;
+    uint32_t line = 0;
+    uint32_t i = 0;
+    CharQueueReset(queue);
+    while (i < iterations) {
+        uint32_t count = 0;
+        HostBenchmarkPause();
+        while (i + count < iterations) {
+            const char *text = BENCH_BC127_LINES[line % BENCH_BC127_LINE_COUNT];
+            uint16_t length = strlen(text);
+            if (CharQueueGetSize(queue) + length + 1 >= CHAR_QUEUE_SIZE) {
+                break;
+            }
+            HostBenchmarkReceive(queue, (const uint8_t *) text, length);
+            CharQueueAdd(queue, BC127_MSG_END_CHAR);
+            bytes += length + 1;
+            line++;
+            count++;
+        }
+        HostBenchmarkResume();
+        i += count;
+        while (count-- > 0) {
+            BC127Process(&BENCH_BT);
+        }
+    }
+    return bytes;
+}
+
+/**
+ * HostBenchmarkBM83Process()
+ *     Description:
+ *         Parse and handle the BM83 frames one at a time, after they have
+ *         been received a queue's worth at a time. Every frame other than
+ *         a command ACK is acknowledged.
+ *     Params:
+ *         uint32_t iterations - The number of frames
+ *     Returns:
+ *         uint64_t - The bytes of the frames
+ */
+static uint64_t HostBenchmarkBM83Process(uint32_t iterations)
+{
+    CharQueue_t *queue = (CharQueue_t *) &BENCH_BT.uart.rxQueue;
+    uint64_t bytes = 0;
+    uint32_t frame = 0;
+    uint32_t i = 0;
+    CharQueueReset(queue);
+    while (i < iterations) {
+        uint32_t count = 0;
+        HostBenchmarkPause();
+        while (i + count < iterations) {
+            const uint8_t *event = BENCH_BM83_EVENTS[frame % BENCH_BM83_EVENT_COUNT];
+            uint8_t data[12] = {BM83_UART_START_WORD, 0x00, event[0]};
+            uint8_t checksum = event[0];
+            uint8_t j;
+            if (CharQueueGetSize(queue) + event[0] + 4 >= CHAR_QUEUE_SIZE) {
+                break;
+            }
+            for (j = 0; j < event[0]; j++) {
+                data[3 + j] = event[1 + j];
+                checksum += event[1 + j];
+            }
+            data[3 + j] = -checksum;
+            HostBenchmarkReceive(queue, data, event[0] + 4);
+            bytes += event[0] + 4;
+            frame++;
+            count++;
+        }
+        HostBenchmarkResume();
+        i += count;
+        while (count-- > 0) {
+            BM83Process(&BENCH_BT);
+        }
+    }
+    return bytes;
+}
+
+static uint64_t HostBenchmarkEventTriggerCallback(uint32_t iterations)
+{
+    uint32_t i;
+    for (i = 0; i < iterations; i++) {
+        EventTriggerCallback(BT_EVENT_METADATA_UPDATE, 0);
+    }
+    return 0;
+}
+
+static uint64_t HostBenchmarkEventTriggerCallbackUnsubscribed(uint32_t iterations)
+{
+    uint32_t i;
+    for (i = 0; i < iterations; i++) {
+        EventTriggerCallback(BENCHMARK_EVENT_UNSUBSCRIBED, 0);
+    }
+    return 0;
+}
+
+static uint64_t HostBenchmarkLocaleGetText(uint32_t iterations)
+{
+    uint32_t sum = 0;
+    uint32_t i;
+    LocaleSetLanguage(CONFIG_SETTING_LANGUAGE_ENGLISH);
+    for (i = 0; i < iterations; i++) {
+        sum += LocaleGetText(i % (LOCALE_STRING_MAX_INDEX + 1))[0];
+    }
+    BENCH_SINK += sum;
+    return 0;
+}
+
+/**
+ * HostBenchmarkLocaleSetLanguage()
+ *     Description:
+ *         Switch between the languages, which builds the table of strings
+ *         that LocaleGetText() reads from
+ *     Params:
+ *         uint32_t iterations - The number of switches
+ *     Returns:
+ *         uint64_t - The bytes of the strings in the tables built
+ */
+static uint64_t HostBenchmarkLocaleSetLanguage(uint32_t iterations)
+{
+    static const uint8_t languages[] = {
+        CONFIG_SETTING_LANGUAGE_ENGLISH,
+        CONFIG_SETTING_LANGUAGE_GERMAN,
+        CONFIG_SETTING_LANGUAGE_RUSSIAN,
+        CONFIG_SETTING_LANGUAGE_SPANISH
+    };
+    uint64_t bytes = 0;
+    uint32_t i;
+    for (i = 0; i < iterations; i++) {
+        LocaleSetLanguage(languages[i % sizeof(languages)]);
+        HostBenchmarkPause();
+        uint16_t stringIndex;
+        for (stringIndex = 0; stringIndex <= LOCALE_STRING_MAX_INDEX; stringIndex++) {
+            bytes += LocaleGetTextLength(stringIndex);
+        }
+        HostBenchmarkResume();
+    }
+    LocaleSetLanguage(CONFIG_SETTING_LANGUAGE_ENGLISH);
+    return bytes;
+}
+
+static const HostBenchmark_t BENCHMARKS[] = {
+    {"CharQueueAdd", HostBenchmarkCharQueueAdd, 2000000},
+    {"CharQueueNext", HostBenchmarkCharQueueNext, 2000000},
+    {"CharQueueSeek", HostBenchmarkCharQueueSeek, 200000},
+    {"IBusValidateChecksum", HostBenchmarkIBusValidateChecksum, 1000000},
+    {"IBusSendCommand", HostBenchmarkIBusSendCommand, 1000000},
+    {"UtilsNormalizeText", HostBenchmarkUtilsNormalizeText, 200000},
+    {"BC127Process", HostBenchmarkBC127Process, 200000},
+    {"BM83Process", HostBenchmarkBM83Process, 200000},
+    {"EventTriggerCallback", HostBenchmarkEventTriggerCallback, 500000},
+    {
+        "EventTriggerCallbackUnsubscribed",
+        HostBenchmarkEventTriggerCallbackUnsubscribed,
+        500000
+    },
+    {"LocaleGetText", HostBenchmarkLocaleGetText, 5000000},
+    {"LocaleSetLanguage", HostBenchmarkLocaleSetLanguage, 20000}
+};
+#define BENCHMARK_COUNT (sizeof(BENCHMARKS) / sizeof(BENCHMARKS[0]))
+
+/**
+ * HostBenchmarkInit()
+ *     Description:
+ *         Bring up the modules that the benchmarks use, without the handlers,
+ *         and register as many event callbacks as the handlers do, with
+ *         HOST_BENCHMARK_SUBSCRIBERS of them on the metadata update
+ *     Params:
+ *         void
+ *     Returns:
+ *         void
+ */
+static void HostBenchmarkInit()
+{
+    uint16_t i;
+    BENCH_SYSTEM_UART = UARTInit(
+        SYSTEM_UART_MODULE,
+        SYSTEM_UART_RX_RPIN,
+        SYSTEM_UART_TX_RPIN,
+        SYSTEM_UART_RX_PRIORITY,
+        SYSTEM_UART_TX_PRIORITY,
+        UART_BAUD_115200,
+        UART_PARITY_NONE
+    );
+    UARTAddModuleHandler(&BENCH_SYSTEM_UART);
+    BENCH_BT = BTInit();
+    UARTAddModuleHandler(&BENCH_BT.uart);
+    BENCH_IBUS = IBusInit();
+    UARTAddModuleHandler(&BENCH_IBUS.uart);
+    for (i = 0; i < HOST_BENCHMARK_CALLBACKS; i++) {
+        uint8_t type = i % HOST_BENCHMARK_EVENT_TYPES;
+        if (i < HOST_BENCHMARK_SUBSCRIBERS) {
+            type = BT_EVENT_METADATA_UPDATE;
+        } else if (type == BT_EVENT_METADATA_UPDATE) {
+            type = HOST_BENCHMARK_EVENT_TYPES;
+        }
+        EventRegisterCallback(type, &HostBenchmarkCallback, 0);
+    }
+    BENCH_RANDOM = BENCHMARK_SEED;
+    for (i = 0; i < BENCHMARK_PACKETS; i++) {
+        BenchmarkGetPacket(&BENCH_RANDOM, BENCH_PACKETS[i]);
+    }
+}
+
+/**
+ * HostBenchmarkMeasure()
+ *     Description:
+ *         Run a benchmark from BENCHMARK_SEED
+ *     Params:
+ *         const HostBenchmark_t *benchmark - The benchmark
+ *         uint32_t iterations - The number of operations
+ *         uint64_t *bytes - Set to the bytes of input handled
+ *     Returns:
+ *         uint64_t - The nanoseconds it took, less the time it was paused
+ */
+static uint64_t HostBenchmarkMeasure(
+    const HostBenchmark_t *benchmark,
+    uint32_t iterations,
+    uint64_t *bytes
+) {
+    BENCH_RANDOM = BENCHMARK_SEED;
+    BENCH_ELAPSED = 0;
+    HostBenchmarkResume();
+    *bytes = benchmark->run(iterations);
+    HostBenchmarkPause();
+    return BENCH_ELAPSED;
+}
+
+static int HostBenchmarkCompare(const void *a, const void *b)
+{
+    uint64_t left = *(const uint64_t *) a;
+    uint64_t right = *(const uint64_t *) b;
+    return (left > right) - (left < right);
+}
+
+static uint8_t HostBenchmarkIsSelected(const char *name, char **filters, int count)
+{
+    int i;
+    if (count == 0) {
+        return 1;
+    }
+    for (i = 0; i < count; i++) {
+        if (strstr(name, filters[i]) != 0) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * HostBenchmarkRun()
+ *     Description:
+ *         Run the benchmarks whose names contain one of the filters, and
+ *         report them on stdout. Each one runs for about HOST_BENCHMARK_TIME,
+ *         or if stable, HOST_BENCHMARK_REPEATS times over its fixed number
+ *         of iterations, and the median is reported as "name ns/op bytes/op"
+ *     Params:
+ *         uint8_t stable - If the output is to be compared between runs
+ *         char **filters - The names to run, or all of them if there are none
+ *         int count - The number of filters
+ *     Returns:
+ *         uint8_t - The number of benchmarks run
+ */
+uint8_t HostBenchmarkRun(uint8_t stable, char **filters, int count)
+{
+    uint8_t ran = 0;
+    uint8_t i;
+    HostBenchmarkInit();
+    for (i = 0; i < BENCHMARK_COUNT; i++) {
+        const HostBenchmark_t *benchmark = &BENCHMARKS[i];
+        uint32_t iterations = benchmark->iterations;
+        uint64_t elapsed = 0;
+        uint64_t bytes = 0;
+        if (HostBenchmarkIsSelected(benchmark->name, filters, count) == 0) {
+            continue;
+        }
+        if (stable == 0 && ran == 0) {
+            printf(
+                "%-32s %12s %12s %12s %10s\n",
+                "Benchmark",
+                "Iterations",
+                "ns/op",
+                "bytes/op",
+                "MB/s"
+            );
+        }
+        if (stable == 1) {
+            uint64_t runs[HOST_BENCHMARK_REPEATS];
+            uint8_t repeat;
+            for (repeat = 0; repeat < HOST_BENCHMARK_REPEATS; repeat++) {
+                runs[repeat] = HostBenchmarkMeasure(benchmark, iterations, &bytes);
+            }
+            qsort(runs, HOST_BENCHMARK_REPEATS, sizeof(uint64_t), HostBenchmarkCompare);
+            elapsed = runs[HOST_BENCHMARK_REPEATS / 2];
+            printf(
+                "%s %.2f %.2f\n",
+                benchmark->name,
+                (double) elapsed / iterations,
+                (double) bytes / iterations
+            );
+        } else {
+            // Grow the run until it is long enough to time
+            iterations = 1;
+            while (1) {
+                elapsed = HostBenchmarkMeasure(benchmark, iterations, &bytes);
+                if (elapsed >= HOST_BENCHMARK_TIME * 1000000ULL ||
+                    iterations >= 0x7FFFFFFF / 10
+                ) {
+                    break;
+                }
+                uint64_t next = iterations * 10ULL;
+                if (elapsed > 0) {
+                    next = (uint64_t) iterations * HOST_BENCHMARK_TIME * 1200000ULL / elapsed;
+                    if (next > iterations * 10ULL) {
+                        next = iterations * 10ULL;
+                    } else if (next <= iterations) {
+                        next = iterations + 1;
+                    }
+                }
+                iterations = next;
+            }
+            double megabytes = 0;
+            if (elapsed > 0) {
+                megabytes = (double) bytes * 1000 / elapsed;
+            }
+            printf(
+                "%-32s %12u %12.2f %12.2f %10.1f\n",
+                benchmark->name,
+                iterations,
+                (double) elapsed / iterations,
+                (double) bytes / iterations,
+                megabytes
+            );
+        }
+        fflush(stdout);
+        ran++;
+    }
+    return ran;
+}
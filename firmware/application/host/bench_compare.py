@@ -0,0 +1,80 @@
+#!/usr/bin/env python3
+"""
+Compare two runs of the benchmarks, as written by "make bench STABLE=1".
+
+Run the benchmarks on the commit before a change and on the change, on the
+same host with as little else running as possible, and compare them:
+
+    make bench STABLE=1 > before.txt
+    ...
+    make bench STABLE=1 > after.txt
+    ./bench_compare.py before.txt after.txt
+
+The cycles that "BENCH" prints on the CLI of a device compare the same way,
+from a capture of the CLI on each firmware, and are what a change to the
+firmware costs on the PIC24. The host's nanoseconds only say which way it
+moved.
+
+A benchmark whose time changed by less than the threshold is reported as
+unchanged, since the host adds that much noise from one run to the next. A
+change to the bytes per operation means that the benchmark itself changed,
+and its times cannot be compared.
+"""
+import sys
+
+from argparse import ArgumentParser
+
+
+def read_results(path):
+    """Map each benchmark to its (time/op, bytes/op), in the order it ran"""
+    results = {}
+    with open(path) as f:
+        for line in f:
+            parts = line.split()
+            if len(parts) != 3:
+                continue
+            try:
+                results[parts[0]] = (float(parts[1]), float(parts[2]))
+            except ValueError:
+                continue
+    return results
+
+
+def main():
+    parser = ArgumentParser(description='Compare two runs of the benchmarks')
+    parser.add_argument('before', help='The results of the baseline')
+    parser.add_argument('after', help='The results of the change')
+    parser.add_argument('--threshold', type=float, default=5.0, help='The change in percent to report')
+    args = parser.parse_args()
+
+    before = read_results(args.before)
+    after = read_results(args.after)
+    if len(before) == 0 or len(after) == 0:
+        print('No results to compare')
+        return 1
+    print('%-32s %10s %10s %8s' % ('Benchmark', 'Before', 'After', 'Change'))
+    for name, (old, oldBytes) in before.items():
+        if name not in after:
+            print('%-32s %10.2f %10s' % (name, old, 'missing'))
+            continue
+        new, newBytes = after[name]
+        change = 0.0
+        if old > 0:
+            change = (new - old) * 100 / old
+        if newBytes != oldBytes:
+            note = 'input changed'
+        elif change <= -args.threshold:
+            note = 'faster'
+        elif change >= args.threshold:
+            note = 'slower'
+        else:
+            note = ''
+        print('%-32s %10.2f %10.2f %+7.1f%% %s' % (name, old, new, change, note))
+    for name in after:
+        if name not in before:
+            print('%-32s %10s %10.2f' % (name, 'new', after[name][0]))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,128 @@
+/*
+ * File:   eeprom.c
+ * Author: agent <agent@local>
+ * Description:
+ *     Host implementation of the EEPROM API, backed by memory that can be
+ *     loaded from and saved to a file
+ */
+#include <stdio.h>
+#include "../lib/eeprom.h"
+#include "host.h"
+
+static uint8_t EEPROM[HOST_EEPROM_SIZE];
+
+/**
+ * EEPROMInit()
+ *     Description:
+ *         A blank EEPROM reads as 0xFF. Memory that was loaded from a file
+ *         is kept.
+ *     Params:
+ *         void
+ *     Returns:
+ *         void
+ */
+void EEPROMInit()
+{
+}
+
+void EEPROMErase()
+{
+    memset(EEPROM, 0xFF, HOST_EEPROM_SIZE);
+}
+
+uint8_t EEPROMIsBusy()
+{
+    return 0;
+}
+
+void EEPROMIsReady()
+{
+}
+
+unsigned char EEPROMReadByte(uint32_t address)
+{
+    return EEPROM[address % HOST_EEPROM_SIZE];
+}
+
+void EEPROMReadBytes(uint32_t address, uint8_t *data, uint16_t length)
+{
+    uint16_t i;
+    for (i = 0; i < length; i++) {
+        data[i] = EEPROM[(address + i) % HOST_EEPROM_SIZE];
+    }
+}
+
+void EEPROMWriteByte(uint32_t address, unsigned char data)
+{
+    EEPROM[address % HOST_EEPROM_SIZE] = data;
+}
+
+/**
+ * EEPROMWritePage()
+ *     Description:
+ *         Write up to a page of bytes. Like the device, a write that crosses
+ *         an EEPROM_PAGE_SIZE boundary wraps around to the start of the page.
+ *     Params:
+ *         uint32_t address - The memory address of the first byte
+ *         const uint8_t *data - The bytes to write
+ *         uint8_t length - The number of bytes to write
+ *     Returns:
+ *         void
+ */
+void EEPROMWritePage(uint32_t address, const uint8_t *data, uint8_t length)
+{
+    uint32_t page = address - (address % EEPROM_PAGE_SIZE);
+    uint8_t i;
+    for (i = 0; i < length; i++) {
+        uint32_t offset = (address + i) % EEPROM_PAGE_SIZE;
+        EEPROM[(page + offset) % HOST_EEPROM_SIZE] = data[i];
+    }
+}
+
+/**
+ * HostEEPROMLoad()
+ *     Description:
+ *         Blank the EEPROM and then fill it from the given file, if it exists
+ *     Params:
+ *         const char *path - The file to load, or 0 for a blank EEPROM
+ *     Returns:
+ *         void
+ */
+void HostEEPROMLoad(const char *path)
+{
+    EEPROMErase();
+    if (path == 0) {
+        return;
+    }
+    FILE *file = fopen(path, "rb");
+    if (file == 0) {
+        return;
+    }
+    if (fread(EEPROM, 1, HOST_EEPROM_SIZE, file) == 0) {
+        EEPROMErase();
+    }
+    fclose(file);
+}
+
+/**
+ * HostEEPROMSave()
+ *     Description:
+ *         Write the whole EEPROM out to the given file
+ *     Params:
+ *         const char *path - The file to write, or 0 to discard the EEPROM
+ *     Returns:
+ *         void
+ */
+void HostEEPROMSave(const char *path)
+{
+    if (path == 0) {
+        return;
+    }
+    FILE *file = fopen(path, "wb");
+    if (file == 0) {
+        fprintf(stderr, "Unable to write the EEPROM to %s\n", path);
+        return;
+    }
+    fwrite(EEPROM, 1, HOST_EEPROM_SIZE, file);
+    fclose(file);
+}
@@ -0,0 +1,527 @@
+/*
+ * File:   host.c
+ * Author: agent <agent@local>
+ * Description:
+ *     Run the application on a Linux host. The application's main() is
+ *     built as BlueBusMain() and called from here. The milliseconds timer
+ *     follows the host clock, or with -f a virtual clock that runs as fast
+ *     as the main loop does. The system UART is on stdin / stdout, a log
+ *     can be replayed into the IBus and Bluetooth UARTs, and every frame the
+ *     application sends on them is recorded in the format of the log. With
+ *     -B, the benchmarks in bench.c are run instead of the application.
+ */
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "../mappings.h"
+#include "../lib/bt/bt_bm83.h"
+#include "../lib/timer.h"
+#include "../lib/uart.h"
+#include "host.h"
+
+int BlueBusMain(void);
+void _AltT1Interrupt(void);
+uint32_t __real_TimerGetMicros();
+uint32_t __real_TimerGetMillis();
+
+/**
+ * Host_t
+ *     Description:
+ *         The state of the simulated peripherals
+ *     Fields:
+ *         eepromPath - The file that backs the EEPROM, or 0
+ *         record - Where the frames sent on the IBus and Bluetooth UARTs go
+ *         runTime - Exit once the application has run this many
+ *             milliseconds, or 0 to run until interrupted
+ *         fast - If the clock is virtual instead of following the host
+ *         benchmark - If the benchmarks are running, and what the
+ *             application sends is to be discarded
+ *         replaying - If a log is being replayed
+ *         replayEnd - When to exit after the replay ended, in ms since boot
+ *         start - The host clock when the simulation started, in us
+ *         micros - The microseconds since boot
+ *         millis - The number of Timer1 interrupts delivered
+ *         passes - The number of passes of the main loop
+ *         spins - The number of clock reads in this pass of the main loop
+ *         framesSent - The number of frames recorded
+ *         timerEnabled - If the Timer1 interrupt is enabled
+ *         stdinOpen - If stdin may still have data for the system UART
+ *         stdinFlags - The file status flags of stdin, restored on exit
+ *         txLength - The number of bytes waiting in each txLine
+ *         txLine - The bytes of the frame being sent on each UART
+ */
+typedef struct Host_t {
+    const char *eepromPath;
+    FILE *record;
+    uint32_t runTime;
+    uint8_t fast;
+    uint8_t benchmark;
+    uint8_t replaying;
+    uint32_t replayEnd;
+    uint64_t start;
+    uint64_t micros;
+    uint32_t millis;
+    uint64_t passes;
+    uint16_t spins;
+    uint32_t framesSent;
+    uint8_t timerEnabled;
+    uint8_t stdinOpen;
+    int stdinFlags;
+    uint16_t txLength[UART_MODULES_COUNT];
+    uint8_t txLine[UART_MODULES_COUNT][HOST_UART_LINE_SIZE];
+} Host_t;
+static Host_t HOST;
+
+/**
+ * HostGetClock()
+ *     Description:
+ *         Get the host's monotonic clock
+ *     Params:
+ *         void
+ *     Returns:
+ *         uint64_t - The microseconds since an arbitrary point
+ */
+static uint64_t HostGetClock()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t) now.tv_sec * 1000000 + now.tv_nsec / 1000;
+}
+
+/**
+ * HostIsFrameComplete()
+ *     Description:
+ *         Check if the bytes sent on a UART make up a whole frame. IBus and
+ *         BM83 frames carry their length, and BC127 commands end in a
+ *         carriage return.
+ *     Params:
+ *         uint8_t moduleIndex - The zero based UART module index
+ *     Returns:
+ *         uint8_t - 1 if the frame is complete, 0 otherwise
+ */
+static uint8_t HostIsFrameComplete(uint8_t moduleIndex)
+{
+    uint8_t *line = HOST.txLine[moduleIndex];
+    uint16_t length = HOST.txLength[moduleIndex];
+    if (moduleIndex == IBUS_UART_MODULE - 1) {
+        return length >= 2 && length >= line[1] + 2;
+    }
+    if (line[0] == BM83_UART_START_WORD) {
+        return length >= 3 && length >= ((line[1] << 8) | line[2]) + 4;
+    }
+    return line[length - 1] == '\r';
+}
+
+/**
+ * HostRecordFrame()
+ *     Description:
+ *         Record the frame sent on a UART with the time it was sent, in the
+ *         format that the application logs received frames in
+ *     Params:
+ *         uint8_t moduleIndex - The zero based UART module index
+ *     Returns:
+ *         void
+ */
+static void HostRecordFrame(uint8_t moduleIndex)
+{
+    uint8_t *line = HOST.txLine[moduleIndex];
+    uint16_t length = HOST.txLength[moduleIndex];
+    uint16_t i;
+    if (length == 0) {
+        return;
+    }
+    if (moduleIndex == IBUS_UART_MODULE - 1) {
+        fprintf(
+            HOST.record,
+            "[%u] DEBUG: IBus: TX[%u]:",
+            HOST.millis,
+            length
+        );
+    } else if (line[0] == BM83_UART_START_WORD) {
+        fprintf(HOST.record, "[%u] DEBUG: BM83: TX:", HOST.millis);
+    } else {
+        if (line[length - 1] == '\r') {
+            length--;
+        }
+        fprintf(
+            HOST.record,
+            "[%u] DEBUG: BT: W: '%.*s'\n",
+            HOST.millis,
+            length,
+            line
+        );
+        length = 0;
+    }
+    for (i = 0; i < length; i++) {
+        fprintf(HOST.record, " %02X", line[i]);
+    }
+    if (length != 0) {
+        fprintf(HOST.record, "\n");
+    }
+    HOST.txLength[moduleIndex] = 0;
+    HOST.framesSent++;
+}
+
+/**
+ * HostReadStdin()
+ *     Description:
+ *         Pass whatever is waiting on stdin to the system UART. Line feeds
+ *         become carriage returns, which is what a terminal sends.
+ *     Params:
+ *         void
+ *     Returns:
+ *         void
+ */
+static void HostReadStdin()
+{
+    uint8_t data[64];
+    ssize_t length;
+    ssize_t i;
+    if (HOST.stdinOpen == 0) {
+        return;
+    }
+    length = read(STDIN_FILENO, data, sizeof(data));
+    if (length == 0 || (length < 0 && errno != EAGAIN)) {
+        HOST.stdinOpen = 0;
+        return;
+    }
+    for (i = 0; i < length; i++) {
+        if (data[i] == '\n') {
+            data[i] = '\r';
+        }
+    }
+    if (length > 0) {
+        HostUARTReceive(SYSTEM_UART_MODULE, data, length);
+    }
+}
+
+/**
+ * HostExit()
+ *     Description:
+ *         Record what is left on the UARTs, report on the replay and save
+ *         the EEPROM
+ *     Params:
+ *         void
+ *     Returns:
+ *         void
+ */
+static void HostExit()
+{
+    uint8_t i;
+    for (i = 0; i < UART_MODULES_COUNT; i++) {
+        if (i != SYSTEM_UART_MODULE - 1) {
+            HostRecordFrame(i);
+        }
+    }
+    fflush(stdout);
+    fflush(HOST.record);
+    if (HOST.replaying == 1) {
+        HostReplayStats_t *stats = HostReplayGetStats();
+        uint64_t elapsed = (HostGetClock() - HOST.start) / 1000;
+        fprintf(
+            stderr,
+            "Replay: %u frames (%llu bytes) in, %u frames out, "
+            "%u ms simulated in %llu ms, %llu loop passes\n",
+            stats->frames,
+            (unsigned long long) stats->bytes,
+            HOST.framesSent,
+            HOST.millis,
+            (unsigned long long) elapsed,
+            (unsigned long long) HOST.passes
+        );
+        // What the crash record would hold as the queue high water marks
+        for (i = 0; i < UART_MODULES_COUNT; i++) {
+            UART_t *uart = UARTGetModuleHandler(i + 1);
+            if (uart != 0 && i != SYSTEM_UART_MODULE - 1) {
+                fprintf(
+                    stderr,
+                    "UART[%u]: RX queue high water mark %u, TX %u\n",
+                    i + 1,
+                    uart->rxQueue.maxSize,
+                    uart->txQueueMax
+                );
+            }
+        }
+    }
+    fcntl(STDIN_FILENO, F_SETFL, HOST.stdinFlags);
+    HostEEPROMSave(HOST.eepromPath);
+}
+
+static void HostSignal(int signal)
+{
+    exit(0);
+}
+
+/**
+ * HostAdvance()
+ *     Description:
+ *         Run the simulation up to the given time. Deliver the Timer1
+ *         interrupts that came due and receive the replayed bytes that have
+ *         arrived.
+ *     Params:
+ *         uint64_t micros - The microseconds since boot
+ *     Returns:
+ *         void
+ */
+static void HostAdvance(uint64_t micros)
+{
+    HOST.micros = micros;
+    while (HOST.millis < HOST.micros / 1000) {
+        HOST.millis++;
+        if (HOST.timerEnabled == 1) {
+            _AltT1Interrupt();
+        }
+    }
+    if (HOST.replaying == 1 && HOST.replayEnd == 0 &&
+        HostReplayProcess(HOST.micros) == 0
+    ) {
+        HOST.replayEnd = HOST.millis + HOST_REPLAY_TAIL;
+    }
+}
+
+/**
+ * HostIdle()
+ *     Description:
+ *         The application idles the CPU until the next interrupt. Run the
+ *         simulation on, which delivers any that came due.
+ *     Params:
+ *         void
+ *     Returns:
+ *         void
+ */
+void HostIdle()
+{
+    HostProcess();
+}
+
+/**
+ * HostProcess()
+ *     Description:
+ *         Run the simulation for a pass of the main loop and pass stdin to
+ *         the system UART. Following the host clock, sleep briefly when no
+ *         time has passed, so that the simulation does not spin the host CPU.
+ *     Params:
+ *         void
+ *     Returns:
+ *         void
+ */
+void HostProcess()
+{
+    uint64_t micros = HOST.micros + HOST_FAST_STEP;
+    HOST.passes++;
+    HOST.spins = 0;
+    if (HOST.fast == 0) {
+        micros = HostGetClock() - HOST.start;
+        if (micros / 1000 == HOST.millis) {
+            struct timespec pause = {0, 100000};
+            nanosleep(&pause, 0);
+        }
+    }
+    HostAdvance(micros);
+    HostReadStdin();
+    fflush(stdout);
+    if ((HOST.runTime != 0 && HOST.millis >= HOST.runTime) ||
+        (HOST.replayEnd != 0 && HOST.millis >= HOST.replayEnd)
+    ) {
+        exit(0);
+    }
+}
+
+/**
+ * HostReadClock()
+ *     Description:
+ *         Some code waits for the clock to move on, which the timers do in
+ *         the background on the PIC, so time has to pass when the
+ *         application reads it too. With the virtual clock, a run of reads
+ *         within one pass of the main loop is taken to be such a wait.
+ *     Params:
+ *         void
+ *     Returns:
+ *         void
+ */
+static void HostReadClock()
+{
+    if (HOST.fast == 0) {
+        HostAdvance(HostGetClock() - HOST.start);
+    } else if (++HOST.spins == HOST_FAST_SPINS) {
+        HOST.spins = 0;
+        HostAdvance(HOST.micros + HOST_FAST_STEP);
+    }
+}
+
+/**
+ * __wrap_TimerGetMicros()
+ *     Description:
+ *         The linker sends the application's calls to TimerGetMicros() here.
+ *         Timer4/5 follow the host clock, so with the virtual clock the
+ *         microseconds are taken from it instead, to keep them in step with
+ *         the milliseconds.
+ *     Params:
+ *         void
+ *     Returns:
+ *         uint32_t - The free running microsecond count
+ */
+uint32_t __wrap_TimerGetMicros()
+{
+    HostReadClock();
+    if (HOST.fast == 0) {
+        return __real_TimerGetMicros();
+    }
+    return HOST.micros & TIMER_MICROS_MASK;
+}
+
+/**
+ * __wrap_TimerGetMillis()
+ *     Description:
+ *         The linker sends the application's calls to TimerGetMillis() here
+ *     Params:
+ *         void
+ *     Returns:
+ *         uint32_t - The milliseconds since boot
+ */
+uint32_t __wrap_TimerGetMillis()
+{
+    HostReadClock();
+    return __real_TimerGetMillis();
+}
+
+void HostSetTimerEnabled(uint8_t enabled)
+{
+    HOST.timerEnabled = enabled;
+}
+
+/**
+ * HostUARTTransmit()
+ *     Description:
+ *         Take a byte sent by the application. The system UART goes to
+ *         stdout, and the others are recorded a frame at a time. The IBus
+ *         transceiver hears what we send, so IBus bytes are also received.
+ *     Params:
+ *         uint8_t moduleIndex - The zero based UART module index
+ *         uint8_t data - The byte
+ *     Returns:
+ *         void
+ */
+void HostUARTTransmit(uint8_t moduleIndex, uint8_t data)
+{
+    if (HOST.benchmark == 1) {
+        return;
+    }
+    if (moduleIndex == SYSTEM_UART_MODULE - 1) {
+        fputc(data, stdout);
+        return;
+    }
+    if (moduleIndex == IBUS_UART_MODULE - 1) {
+        HostUARTReceive(IBUS_UART_MODULE, &data, 1);
+    }
+    HOST.txLine[moduleIndex][HOST.txLength[moduleIndex]++] = data;
+    if (HostIsFrameComplete(moduleIndex) == 1 ||
+        HOST.txLength[moduleIndex] == HOST_UART_LINE_SIZE
+    ) {
+        HostRecordFrame(moduleIndex);
+    }
+}
+
+static void HostUsage(const char *name)
+{
+    fprintf(
+        stderr,
+        "Usage: %s [-f] [-b board version] [-e eeprom image] "
+        "[-r log to replay] [-o record file] [-t run time ms]\n"
+        "       %s -B [-s] [benchmark ...]\n",
+        name,
+        name
+    );
+}
+
+int main(int argc, char **argv)
+{
+    uint8_t boardVersion = BOARD_VERSION_TWO;
+    uint8_t boardVersionSet = 0;
+    const char *replayPath = 0;
+    const char *recordPath = 0;
+    uint8_t stable = 0;
+    int option;
+    while ((option = getopt(argc, argv, "Bb:e:fo:r:st:h")) != -1) {
+        switch (option) {
+            case 'B':
+                HOST.benchmark = 1;
+                break;
+            case 'b':
+                boardVersion = BOARD_VERSION_TWO;
+                if (atoi(optarg) == 1) {
+                    boardVersion = BOARD_VERSION_ONE;
+                }
+                boardVersionSet = 1;
+                break;
+            case 'e':
+                HOST.eepromPath = optarg;
+                break;
+            case 'f':
+                HOST.fast = 1;
+                break;
+            case 'o':
+                recordPath = optarg;
+                break;
+            case 'r':
+                replayPath = optarg;
+                break;
+            case 's':
+                stable = 1;
+                break;
+            case 't':
+                HOST.runTime = strtoul(optarg, 0, 10);
+                break;
+            default:
+                HostUsage(argv[0]);
+                return 1;
+        }
+    }
+    if (HOST.benchmark == 1) {
+        // Without an EEPROM image, the settings are the defaults and the
+        // logs are off, so that only the work being timed is done
+        HostSFRInit(boardVersion);
+        HostEEPROMLoad(HOST.eepromPath);
+        HOST.fast = 1;
+        if (HostBenchmarkRun(stable, &argv[optind], argc - optind) == 0) {
+            fprintf(stderr, "No benchmark matches\n");
+            return 1;
+        }
+        return 0;
+    }
+    HOST.record = stderr;
+    if (recordPath != 0) {
+        HOST.record = fopen(recordPath, "w");
+        if (HOST.record == 0) {
+            fprintf(stderr, "Unable to open %s\n", recordPath);
+            return 1;
+        }
+    }
+    if (replayPath != 0) {
+        uint8_t logBoardVersion = boardVersion;
+        if (HostReplayOpen(replayPath, &logBoardVersion) == 0) {
+            fprintf(stderr, "Unable to open %s\n", replayPath);
+            return 1;
+        }
+        // Run the Bluetooth module that the log was captured with
+        if (boardVersionSet == 0) {
+            boardVersion = logBoardVersion;
+        }
+        HOST.replaying = 1;
+    }
+    HostSFRInit(boardVersion);
+    HostEEPROMLoad(HOST.eepromPath);
+    HOST.stdinFlags = fcntl(STDIN_FILENO, F_GETFL);
+    fcntl(STDIN_FILENO, F_SETFL, HOST.stdinFlags | O_NONBLOCK);
+    HOST.stdinOpen = 1;
+    HOST.start = HostGetClock();
+    atexit(HostExit);
+    signal(SIGINT, HostSignal);
+    signal(SIGTERM, HostSignal);
+    return BlueBusMain();
+}
@@ -0,0 +1,72 @@
+/*
+ * File:   host.h
+ * Author: agent <agent@local>
+ * Description:
+ *     Simulated peripherals for running the application on a Linux host.
+ *     The drivers in this directory replace lib/uart.c, lib/eeprom.c,
+ *     lib/i2c.c and lib/stack.c behind their existing headers, and report
+ *     to the simulator through the functions declared here. A captured log
+ *     can be replayed into the simulated UARTs, and the busiest functions
+ *     of the application can be benchmarked.
+ */
+#ifndef HOST_H
+#define HOST_H
+#include <stdint.h>
+// The largest EEPROM we use (25LC1024 on the HW1 boards)
+#define HOST_EEPROM_SIZE 0x20000
+// I2C addresses are seven bits, and every device has 256 registers
+#define HOST_I2C_DEVICES 128
+#define HOST_I2C_REGISTERS 256
+// The longest frame a UART can send before it is recorded
+#define HOST_UART_LINE_SIZE 1024
+// With -f, every pass of the main loop takes this many microseconds, and
+// so does every run of this many reads of the clock within one pass
+#define HOST_FAST_STEP 100
+#define HOST_FAST_SPINS 1000
+// The longest log line and received frame that a replay handles
+#define HOST_REPLAY_LINE_SIZE 4096
+#define HOST_REPLAY_FRAME_SIZE 1024
+// The first frame of a replay arrives this many milliseconds after boot
+#define HOST_REPLAY_START 1000
+// How long a byte takes on the line: 11 bits at 9600 baud for the IBus,
+// and 10 bits at 115200 baud for the Bluetooth module, in microseconds
+#define HOST_REPLAY_IBUS_BYTE_TIME 1146
+#define HOST_REPLAY_BT_BYTE_TIME 87
+// Keep running this many milliseconds after a replay ends
+#define HOST_REPLAY_TAIL 1000
+// With -B, each benchmark runs for about this many milliseconds, or with
+// -s, this many times over a fixed number of iterations
+#define HOST_BENCHMARK_TIME 250
+#define HOST_BENCHMARK_REPEATS 5
+// The handlers register about this many event callbacks over the event
+// types, and at most this many on the same event
+#define HOST_BENCHMARK_CALLBACKS 88
+#define HOST_BENCHMARK_EVENT_TYPES 80
+#define HOST_BENCHMARK_SUBSCRIBERS 4
+
+/**
+ * HostReplayStats_t
+ *     Description:
+ *         The amount of traffic that a replay has fed to the application
+ *     Fields:
+ *         frames - The number of frames read from the log
+ *         bytes - The number of bytes received
+ */
+typedef struct HostReplayStats_t {
+    uint32_t frames;
+    uint64_t bytes;
+} HostReplayStats_t;
+
+uint8_t HostBenchmarkRun(uint8_t, char **, int);
+void HostEEPROMLoad(const char *);
+void HostEEPROMSave(const char *);
+void HostIdle();
+void HostProcess();
+HostReplayStats_t *HostReplayGetStats();
+uint8_t HostReplayOpen(const char *, uint8_t *);
+uint8_t HostReplayProcess(uint64_t);
+void HostSetTimerEnabled(uint8_t);
+void HostSFRInit(uint8_t);
+void HostUARTReceive(uint8_t, const uint8_t *, uint16_t);
+void HostUARTTransmit(uint8_t, uint8_t);
+#endif /* HOST_H */
@@ -0,0 +1,72 @@
+/*
+ * File:   i2c.c
+ * Author: agent <agent@local>
+ * Description:
+ *     Host implementation of the I2C API. Every address answers, and each
+ *     device is a bank of registers that read back what was last written.
+ */
+#include "../lib/i2c.h"
+#include "host.h"
+
+static uint8_t I2CRegisters[HOST_I2C_DEVICES][HOST_I2C_REGISTERS];
+
+void I2CInit()
+{
+    memset(I2CRegisters, 0, sizeof(I2CRegisters));
+}
+
+void I2CClearErrors()
+{
+}
+
+int8_t I2CPoll(unsigned char deviceAddress)
+{
+    if (deviceAddress >= HOST_I2C_DEVICES) {
+        return I2C_ERR_BadAddr;
+    }
+    return I2C_STATUS_OK;
+}
+
+int8_t I2CRead(
+    unsigned char deviceAddress,
+    unsigned char registerAddress,
+    unsigned char *buffer
+) {
+    if (deviceAddress >= HOST_I2C_DEVICES) {
+        return I2C_ERR_BadAddr;
+    }
+    *buffer = I2CRegisters[deviceAddress][registerAddress];
+    return I2C_STATUS_OK;
+}
+
+int8_t I2CRecoverBus()
+{
+    return I2C_STATUS_OK;
+}
+
+int8_t I2CRestart()
+{
+    return I2C_STATUS_OK;
+}
+
+int8_t I2CStart()
+{
+    return I2C_STATUS_OK;
+}
+
+int8_t I2CStop()
+{
+    return I2C_STATUS_OK;
+}
+
+int8_t I2CWrite(
+    unsigned char deviceAddress,
+    unsigned char registerAddress,
+    unsigned char data
+) {
+    if (deviceAddress >= HOST_I2C_DEVICES) {
+        return I2C_ERR_BadAddr;
+    }
+    I2CRegisters[deviceAddress][registerAddress] = data;
+    return I2C_STATUS_OK;
+}
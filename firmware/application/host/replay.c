@@ -0,0 +1,278 @@
+/*
+ * File:   replay.c
+ * Author: agent <agent@local>
+ * Description:
+ *     Feed the IBus and Bluetooth traffic in a captured BlueBus log back
+ *     into the UART RX queues, with each frame arriving at the time it was
+ *     logged. The frames that the logging firmware sent itself are skipped,
+ *     since the firmware under test sends its own.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../mappings.h"
+#include "host.h"
+
+/**
+ * HostReplay_t
+ *     Description:
+ *         The state of a log replay
+ *     Fields:
+ *         file - The log being replayed
+ *         module - The UART module that the current frame is received on
+ *         data - The bytes of the current frame
+ *         length - The number of bytes in the current frame
+ *         index - The next byte of the current frame to receive
+ *         byteTime - The time it takes to receive a byte, in microseconds
+ *         end - When the last byte of the current frame is received, in
+ *             microseconds since boot
+ *         logBase - The log timestamp that virtualBase corresponds to
+ *         virtualBase - The milliseconds since boot that logBase replays at
+ *         lastLogTime - The log timestamp of the last frame
+ *         stats - The amount of traffic replayed so far
+ */
+typedef struct HostReplay_t {
+    FILE *file;
+    uint8_t module;
+    uint8_t data[HOST_REPLAY_FRAME_SIZE];
+    uint16_t length;
+    uint16_t index;
+    uint16_t byteTime;
+    uint64_t end;
+    uint64_t logBase;
+    uint64_t virtualBase;
+    uint64_t lastLogTime;
+    HostReplayStats_t stats;
+} HostReplay_t;
+static HostReplay_t REPLAY;
+
+/**
+ * HostReplayParseHex()
+ *     Description:
+ *         Parse space separated hex bytes until anything else is found
+ *     Params:
+ *         const char *text - The text to parse
+ *         uint8_t *data - The buffer to parse into
+ *         uint16_t size - The size of the buffer
+ *     Returns:
+ *         uint16_t - The number of bytes parsed
+ */
+static uint16_t HostReplayParseHex(const char *text, uint8_t *data, uint16_t size)
+{
+    uint16_t length = 0;
+    while (length < size) {
+        char *end;
+        while (*text == ' ') {
+            text++;
+        }
+        unsigned long value = strtoul(text, &end, 16);
+        if (end - text != 2) {
+            break;
+        }
+        data[length++] = (uint8_t) value;
+        text = end;
+    }
+    return length;
+}
+
+/**
+ * HostReplayParseLine()
+ *     Description:
+ *         Turn a line of the log into the bytes that were received, if it
+ *         records a received frame. The formats are the ones that
+ *         utility/log_parser.pl reads.
+ *     Params:
+ *         const char *line - The log line
+ *         uint64_t *timestamp - Set to the log timestamp of the frame
+ *     Returns:
+ *         uint8_t - The UART module the frame was received on, or 0 if the
+ *             line is not a received frame
+ */
+static uint8_t HostReplayParseLine(const char *line, uint64_t *timestamp)
+{
+    char *text;
+    if (line[0] != '[') {
+        return 0;
+    }
+    *timestamp = strtoull(line + 1, &text, 10);
+    if (strncmp(text, "] DEBUG: ", 9) != 0) {
+        return 0;
+    }
+    text += 9;
+    if (strncmp(text, "IBus: RX[", 9) == 0) {
+        text = strstr(text, "]: ");
+        if (text == 0 || strstr(text, "[SELF]") != 0) {
+            return 0;
+        }
+        REPLAY.length = HostReplayParseHex(
+            text + 3,
+            REPLAY.data,
+            HOST_REPLAY_FRAME_SIZE
+        );
+        return IBUS_UART_MODULE;
+    }
+    if (strncmp(text, "BM83: RX: ", 10) == 0) {
+        // The checksum is not logged, so put it back
+        uint16_t length = HostReplayParseHex(
+            text + 10,
+            REPLAY.data,
+            HOST_REPLAY_FRAME_SIZE - 1
+        );
+        uint8_t checksum = 0;
+        uint16_t i;
+        if (length < 4) {
+            return 0;
+        }
+        for (i = 1; i < length; i++) {
+            checksum += REPLAY.data[i];
+        }
+        REPLAY.data[length++] = (uint8_t) (0x100 - checksum);
+        REPLAY.length = length;
+        return BT_UART_MODULE;
+    }
+    if (strncmp(text, "BT: R: '", 8) == 0) {
+        // The message is logged without the delimiter that ends it
+        char *end = strrchr(text + 8, '\'');
+        uint16_t length;
+        text += 8;
+        if (end == 0 || end - text >= HOST_REPLAY_FRAME_SIZE) {
+            return 0;
+        }
+        length = end - text;
+        memcpy(REPLAY.data, text, length);
+        REPLAY.data[length++] = '\r';
+        REPLAY.length = length;
+        return BT_UART_MODULE;
+    }
+    return 0;
+}
+
+/**
+ * HostReplayNextFrame()
+ *     Description:
+ *         Read the log up to the next received frame, and work out when its
+ *         last byte arrives. Time in the log maps onto time since boot from
+ *         HOST_REPLAY_START on, and a log that goes back in time, because
+ *         the logging firmware restarted, carries on from where it was.
+ *     Params:
+ *         void
+ *     Returns:
+ *         uint8_t - 1 if there is a frame, 0 at the end of the log
+ */
+static uint8_t HostReplayNextFrame()
+{
+    char line[HOST_REPLAY_LINE_SIZE];
+    uint64_t timestamp = 0;
+    REPLAY.length = 0;
+    REPLAY.index = 0;
+    while (fgets(line, sizeof(line), REPLAY.file) != 0) {
+        line[strcspn(line, "\r\n")] = '\0';
+        REPLAY.module = HostReplayParseLine(line, &timestamp);
+        if (REPLAY.module != 0 && REPLAY.length > 0) {
+            break;
+        }
+    }
+    if (REPLAY.length == 0) {
+        return 0;
+    }
+    if (REPLAY.stats.frames == 0 || timestamp < REPLAY.lastLogTime) {
+        uint64_t virtualTime = HOST_REPLAY_START;
+        if (REPLAY.stats.frames != 0) {
+            virtualTime = REPLAY.virtualBase +
+                (REPLAY.lastLogTime - REPLAY.logBase);
+        }
+        REPLAY.logBase = timestamp;
+        REPLAY.virtualBase = virtualTime;
+    }
+    REPLAY.lastLogTime = timestamp;
+    REPLAY.end = (REPLAY.virtualBase + (timestamp - REPLAY.logBase)) * 1000;
+    if (REPLAY.module == IBUS_UART_MODULE) {
+        REPLAY.byteTime = HOST_REPLAY_IBUS_BYTE_TIME;
+    } else {
+        REPLAY.byteTime = HOST_REPLAY_BT_BYTE_TIME;
+    }
+    REPLAY.stats.frames++;
+    return 1;
+}
+
+/**
+ * HostReplayOpen()
+ *     Description:
+ *         Open a log to replay, and find out which Bluetooth module it was
+ *         captured with
+ *     Params:
+ *         const char *path - The log file
+ *         uint8_t *boardVersion - Set to the board version whose Bluetooth
+ *             module produced the log, if the log says
+ *     Returns:
+ *         uint8_t - 1 if the log was opened, 0 otherwise
+ */
+uint8_t HostReplayOpen(const char *path, uint8_t *boardVersion)
+{
+    char line[HOST_REPLAY_LINE_SIZE];
+    REPLAY.file = fopen(path, "r");
+    if (REPLAY.file == 0) {
+        return 0;
+    }
+    while (fgets(line, sizeof(line), REPLAY.file) != 0) {
+        if (strstr(line, "] DEBUG: BM83: ") != 0) {
+            *boardVersion = BOARD_VERSION_TWO;
+            break;
+        }
+        if (strstr(line, "] DEBUG: BT: ") != 0) {
+            *boardVersion = BOARD_VERSION_ONE;
+            break;
+        }
+    }
+    rewind(REPLAY.file);
+    HostReplayNextFrame();
+    return 1;
+}
+
+/**
+ * HostReplayGetStats()
+ *     Description:
+ *         Get the amount of traffic replayed so far
+ *     Params:
+ *         void
+ *     Returns:
+ *         HostReplayStats_t * - The replay statistics
+ */
+HostReplayStats_t *HostReplayGetStats()
+{
+    return &REPLAY.stats;
+}
+
+/**
+ * HostReplayProcess()
+ *     Description:
+ *         Receive every byte that has arrived by the given time. The bytes of
+ *         a frame are spaced by the time the line takes to carry them, and
+ *         the last one arrives when the frame was logged.
+ *     Params:
+ *         uint64_t now - The microseconds since boot
+ *     Returns:
+ *         uint8_t - 1 while there is more to replay, 0 at the end of the log
+ */
+uint8_t HostReplayProcess(uint64_t now)
+{
+    if (REPLAY.file == 0) {
+        return 0;
+    }
+    while (REPLAY.length != 0) {
+        while (REPLAY.index < REPLAY.length) {
+            uint64_t remaining = (uint64_t) (REPLAY.length - 1 - REPLAY.index) *
+                REPLAY.byteTime;
+            if (REPLAY.end > now + remaining) {
+                return 1;
+            }
+            HostUARTReceive(REPLAY.module, &REPLAY.data[REPLAY.index], 1);
+            REPLAY.index++;
+            REPLAY.stats.bytes++;
+        }
+        HostReplayNextFrame();
+    }
+    fclose(REPLAY.file);
+    REPLAY.file = 0;
+    return 0;
+}
@@ -0,0 +1,132 @@
+/*
+ * File:   sfr.c
+ * Author: agent <agent@local>
+ * Description:
+ *     Storage for the special function registers of the host build, and C
+ *     versions of the interrupt control setters from sfr_setters.s
+ */
+#include <time.h>
+#include <xc.h>
+#include "host.h"
+#include "../lib/sfr_setters.h"
+#include "../lib/timer.h"
+
+volatile IFS0BITS IFS0bits;
+volatile INTCON1BITS INTCON1bits;
+volatile INTCON2BITS INTCON2bits;
+volatile IOCPDGBITS IOCPDGbits;
+volatile LATBBITS LATBbits;
+volatile LATDBITS LATDbits;
+volatile LATEBITS LATEbits;
+volatile LATFBITS LATFbits;
+volatile LATGBITS LATGbits;
+volatile PORTDBITS PORTDbits;
+volatile PORTEBITS PORTEbits;
+volatile PORTFBITS PORTFbits;
+volatile PORTGBITS PORTGbits;
+volatile T2CONBITS T2CONbits;
+volatile TRISBBITS TRISBbits;
+volatile TRISDBITS TRISDbits;
+volatile TRISEBITS TRISEbits;
+volatile TRISFBITS TRISFbits;
+volatile TRISGBITS TRISGbits;
+
+volatile uint16_t ANSB;
+volatile uint16_t ANSC;
+volatile uint16_t ANSD;
+volatile uint16_t ANSE;
+volatile uint16_t ANSF;
+volatile uint16_t ANSG;
+volatile uint16_t LATB;
+volatile uint16_t LATC;
+volatile uint16_t LATD;
+volatile uint16_t LATE;
+volatile uint16_t LATF;
+volatile uint16_t LATG;
+volatile uint16_t PR1;
+volatile uint16_t PR2;
+volatile uint16_t PR4;
+volatile uint16_t PR5;
+volatile uint16_t HostRPOR[16];
+volatile uint16_t SPLIM;
+volatile uint16_t T1CON;
+volatile uint16_t T4CON;
+volatile uint16_t T5CON;
+volatile uint16_t TMR2;
+volatile uint16_t TMR5;
+volatile uint16_t TMR5HLD;
+static volatile uint16_t HostTMR4;
+volatile uint16_t TRISB;
+volatile uint16_t TRISC;
+volatile uint16_t TRISD;
+volatile uint16_t TRISE;
+volatile uint16_t TRISF;
+volatile uint16_t TRISG;
+
+/**
+ * HostSFRInit()
+ *     Description:
+ *         Put the input pins and flags that the application polls into the
+ *         state that lets it run. The IBus transceiver reports an idle bus,
+ *         and the delay timer always reads as expired, so that
+ *         TimerDelayMicroseconds() returns at once.
+ *     Params:
+ *         uint8_t boardVersion - BOARD_VERSION_ONE or BOARD_VERSION_TWO
+ *     Returns:
+ *         void
+ */
+void HostSFRInit(uint8_t boardVersion)
+{
+    PORTDbits.RD0 = 0;
+    PORTGbits.RG8 = boardVersion;
+    IFS0bits.T2IF = 1;
+}
+
+/**
+ * HostGetTMR4()
+ *     Description:
+ *         Read the low word of Timer4/5, counting the host's monotonic
+ *         clock in instruction cycles, and latch the high word into TMR5HLD
+ *         as the hardware does. The profiler then reports how long the
+ *         application takes on the host, scaled to the device's clock rate.
+ *     Params:
+ *         void
+ *     Returns:
+ *         volatile uint16_t * - The low word of the timer
+ */
+volatile uint16_t *HostGetTMR4()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    uint32_t cycles = (uint64_t) now.tv_sec * SYS_CLOCK +
+        (uint64_t) now.tv_nsec * TIMER_CYCLES_PER_MICROSECOND / 1000;
+    TMR5HLD = cycles >> 16;
+    HostTMR4 = cycles & 0xFFFF;
+    return &HostTMR4;
+}
+
+/*
+ * Only the Timer1 interrupt enable is of interest to the simulator, which
+ * stops calling the Timer1 ISR if it is disabled. Priorities and flags
+ * have no meaning here.
+ */
+void SetI2CMAEV(unsigned index, unsigned value) { }
+void SetI2CSLEV(unsigned index, unsigned value) { }
+void SetSPIIE(unsigned index, unsigned value) { }
+void SetSPITXIE(unsigned index, unsigned value) { }
+void SetSPIRXIE(unsigned index, unsigned value) { }
+void SetTIMERIF(unsigned index, unsigned value) { }
+void SetTIMERIP(unsigned index, unsigned value) { }
+void SetUARTRXIE(unsigned index, unsigned value) { }
+void SetUARTRXIF(unsigned index, unsigned value) { }
+void SetUARTRXIP(unsigned index, unsigned value) { }
+void SetUARTTXIE(unsigned index, unsigned value) { }
+void SetUARTTXIF(unsigned index, unsigned value) { }
+void SetUARTTXIP(unsigned index, unsigned value) { }
+
+void SetTIMERIE(unsigned index, unsigned value)
+{
+    if (index == TIMER_INDEX) {
+        HostSetTimerEnabled(value);
+    }
+}
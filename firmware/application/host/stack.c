@@ -0,0 +1,29 @@
+/*
+ * File:   stack.c
+ * Author: agent <agent@local>
+ * Description:
+ *     Host implementation of the stack API. The host stack is not the
+ *     PIC24 one, so nothing is painted and nothing is recorded. Use
+ *     "make stack" for the worst case stack of each call tree instead.
+ */
+#include "../lib/stack.h"
+
+uint16_t STACK_BASE = 0;
+
+uint16_t StackGetHighWaterMark()
+{
+    return 0;
+}
+
+uint16_t StackGetSize()
+{
+    return 0;
+}
+
+void StackInit()
+{
+}
+
+void StackTimerRecordHighWaterMark(void *ctx)
+{
+}
@@ -0,0 +1,205 @@
+#!/usr/bin/env python3
+"""
+Report the worst case stack of each call tree in the application.
+
+GCC writes the stack frame of every function (-fstack-usage) and the calls
+that it makes (-fcallgraph-info=su) into a .ci file next to each object. The
+calls made through the event callbacks and the scheduled tasks are function
+pointers, so they are added from the registrations in the source.
+
+The frames are the ones of the host build, so they are bigger than the
+PIC24's, where a pointer and an int are two bytes. Use the report to find
+the deepest call trees and to compare them from one change to the next,
+and "GET STACK" on the CLI for the stack that the firmware has really used.
+
+The UART interrupts are not in the report, since lib/uart.c only builds for
+the PIC24. They copy a byte between the UART and its queue.
+"""
+import os
+import re
+import sys
+
+from argparse import ArgumentParser
+
+INDIRECT_CALL = '__indirect_call'
+NODE = re.compile(r'node: \{ title: "([^"]+)" label: "([^"]+)"')
+EDGE = re.compile(r'edge: \{ sourcename: "([^"]+)" targetname: "([^"]+)"')
+FRAME = re.compile(r'(\d+) bytes \(([a-z,]+)\)')
+# The simulator that the host drivers report to is not on the PIC24
+SIMULATOR_PREFIX = 'Host'
+# The functions that call the registered function pointers, and how to find
+# the functions that they are registered with
+DISPATCHERS = [
+    (
+        ['EventTriggerCallback'],
+        re.compile(r'EventRegisterCallback\(\s*[^,]+,\s*&?(\w+)')
+    ),
+    (
+        ['TimerProcessScheduledTasks', 'TimerTriggerScheduledTask'],
+        re.compile(r'TimerRegisterScheduledTask\(\s*&?(\w+)')
+    ),
+]
+
+
+class Function(object):
+    def __init__(self, title, name, location, size, qualifier):
+        self.title = title
+        self.name = name
+        self.location = location
+        self.size = size
+        self.qualifier = qualifier
+        self.calls = set()
+
+
+def read_call_graph(build_dir):
+    """Read every .ci file under the build directory"""
+    functions = {}
+    edges = []
+    for root, dirs, files in os.walk(build_dir):
+        for name in sorted(files):
+            if not name.endswith('.ci'):
+                continue
+            with open(os.path.join(root, name)) as f:
+                for line in f:
+                    node = NODE.match(line)
+                    if node:
+                        label = node.group(2).split('\\n')
+                        frame = FRAME.match(label[-1])
+                        if frame is not None:
+                            functions[node.group(1)] = Function(
+                                node.group(1),
+                                label[0],
+                                label[1],
+                                int(frame.group(1)),
+                                frame.group(2)
+                            )
+                        continue
+                    edge = EDGE.match(line)
+                    if edge:
+                        edges.append((edge.group(1), edge.group(2)))
+    return functions, edges
+
+
+def resolve(functions, name, path):
+    """Find a function by name, preferring a static one in the given file"""
+    static = '%s:%s' % (path, name)
+    if static in functions:
+        return static
+    if name in functions:
+        return name
+    return None
+
+
+def add_indirect_calls(functions):
+    """Point the dispatchers at the functions registered with them"""
+    sources = set(f.location.rsplit(':', 2)[0] for f in functions.values())
+    for callers, registration in DISPATCHERS:
+        targets = set()
+        for path in sorted(sources):
+            if not path.endswith('.c') or not os.path.exists(path):
+                continue
+            with open(path) as f:
+                for name in registration.findall(f.read()):
+                    title = resolve(functions, name, path)
+                    if title is not None:
+                        targets.add(title)
+        for caller in callers:
+            if caller in functions:
+                functions[caller].calls |= targets
+                functions[caller].calls.discard(INDIRECT_CALL)
+
+
+def worst_path(functions, title, memo, active, recursion):
+    """The deepest path from a function, as (bytes, [titles])"""
+    if title in memo:
+        return memo[title]
+    function = functions.get(title)
+    if function is None:
+        return (0, [title])
+    active.add(title)
+    best = (0, [])
+    for callee in sorted(function.calls):
+        if callee.split(':')[-1].startswith(SIMULATOR_PREFIX):
+            continue
+        if callee in active:
+            recursion.add((title, callee))
+            continue
+        path = worst_path(functions, callee, memo, active, recursion)
+        if path[0] > best[0]:
+            best = path
+    active.discard(title)
+    memo[title] = (function.size + best[0], [title] + best[1])
+    return memo[title]
+
+
+def main():
+    parser = ArgumentParser(description='Report the worst case stack of each call tree')
+    parser.add_argument('build', help='The directory holding the .ci files')
+    parser.add_argument('--main', default='main', help='The name of main()')
+    parser.add_argument('--root', action='append', default=[], help='Also report the call tree of this function')
+    parser.add_argument('--top', type=int, default=10, help='How many of the largest frames to list')
+    args = parser.parse_args()
+
+    functions, edges = read_call_graph(args.build)
+    if len(functions) == 0:
+        print('No call graph found in %s' % args.build)
+        return 1
+    for source, target in edges:
+        if source in functions:
+            functions[source].calls.add(target)
+    add_indirect_calls(functions)
+
+    # The interrupts, and the trap handlers that lib/crash_trap.s calls
+    roots = [args.main] + args.root + sorted(
+        t for t, f in functions.items()
+        if f.name.startswith('_Alt') or f.name.endswith('Interrupt') or
+        (f.name.startswith('Trap') and f.name != 'TrapWait')
+    )
+    memo = {}
+    recursion = set()
+    print('Worst case stack per call tree (host frame sizes, bytes)')
+    for root in roots:
+        if root not in functions:
+            print('    %s: not found' % root)
+            continue
+        size, path = worst_path(functions, root, memo, set(), recursion)
+        print('%s: %d' % (functions[root].name, size))
+        for title in path:
+            function = functions.get(title)
+            if function is None:
+                print('    %6s  %s' % ('?', title))
+            else:
+                print('    %6d  %s (%s)' % (function.size, function.name, function.location))
+
+    # The host drivers stand in for the PIC24 ones on the paths above, but
+    # their own frames say nothing about the firmware
+    application = [f for f in functions.values() if f.location.startswith('..')]
+    print('Largest frames')
+    largest = sorted(application, key=lambda f: (-f.size, f.title))
+    for function in largest[:args.top]:
+        print('    %6d  %s (%s)' % (function.size, function.name, function.location))
+
+    # A frame that grows at run time by an amount the compiler cannot bound
+    # comes from a variable length array or alloca()
+    dynamic = [f for f in largest if f.qualifier == 'dynamic']
+    print('Unbounded dynamic frames: %d' % len(dynamic))
+    for function in dynamic:
+        print('    %6d+ %s (%s)' % (function.size, function.name, function.location))
+
+    unresolved = sorted(
+        f.name for f in application if INDIRECT_CALL in f.calls
+    )
+    print('Unresolved calls through a pointer: %d' % len(unresolved))
+    for name in unresolved:
+        print('    %s' % name)
+
+    # Every callback is taken to be reachable from every dispatch, so a call
+    # back into a dispatcher shows up here even if it cannot recurse
+    print('Possible recursion: %d' % len(recursion))
+    for caller, callee in sorted(recursion):
+        print('    %s -> %s' % (functions[caller].name, callee.split(':')[-1]))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
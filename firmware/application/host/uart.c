@@ -0,0 +1,225 @@
+/*
+ * File:   uart.c
+ * Author: agent <agent@local>
+ * Description:
+ *     Host implementation of the UART API. Received bytes are put on the
+ *     RX queue by the simulator, exactly as the RX ISR would, and sent bytes
+ *     go straight to the simulator instead of through a hardware FIFO.
+ */
+#include "../lib/uart.h"
+#include "host.h"
+
+static UART_t *UARTModules[UART_MODULES_COUNT];
+static UART UARTRegisters[UART_MODULES_COUNT];
+
+UART_t UARTInit(
+    uint8_t uartModule,
+    uint8_t rxPin,
+    uint8_t txPin,
+    uint8_t rxPriority,
+    uint8_t txPriority,
+    uint8_t baudRate,
+    uint8_t parity
+) {
+    UART_t uart;
+    uart.rxQueue = CharQueueInit();
+    uart.txQueue = 0;
+    uart.txReadCursor = 0;
+    uart.txWriteCursor = 0;
+    uart.txDropped = 0;
+    uart.txQueueMax = 0;
+    uart.txFullMode = UART_TX_FULL_WAIT;
+    uart.rxWatermark = UART_RX_WATERMARK_CHAR;
+    uart.moduleIndex = uartModule - 1;
+    uart.rxError = 0;
+    uart.rxTimestamp = 0;
+    uart.rxTimestampCursor = UART_RX_TIMESTAMP_TAKEN;
+    uart.txPin = txPin;
+    uart.registers = &UARTRegisters[uart.moduleIndex];
+    uart.registers->uxbrg = baudRate;
+    // The transmit shift register is always empty
+    uart.registers->uxsta = 0b0001010100000000;
+    return uart;
+}
+
+void UARTAddModuleHandler(UART_t *uart)
+{
+    UARTModules[uart->moduleIndex] = uart;
+}
+
+void UARTDestroy(uint8_t uartModule)
+{
+    UART_t *uart = UARTGetModuleHandler(uartModule);
+    uart->registers->uxbrg = 0;
+    uart->registers->uxmode = 0;
+    uart->registers->uxsta = 0;
+}
+
+UART_t * UARTGetModuleHandler(uint8_t moduleIndex)
+{
+    return UARTModules[moduleIndex - 1];
+}
+
+/**
+ * UARTGetRXTimestamp()
+ *     Description:
+ *         Get the cycle count at which the byte at the head of the RX queue
+ *         arrived. That is only known for a byte that reached an empty
+ *         queue. Any other byte came in behind it, so the time it is read
+ *         is the closest bound there is. Call it before the byte is taken
+ *         from the queue; the stamp is used up so that a stream that never
+ *         lets the queue drain cannot wrap back onto it.
+ *     Params:
+ *         UART_t *uart - The UART
+ *     Returns:
+ *         uint32_t - The cycle count
+ */
+uint32_t UARTGetRXTimestamp(UART_t *uart)
+{
+    // The RX ISR only moves the stamp while the queue is empty
+    if (uart->rxQueue.readCursor == uart->rxTimestampCursor) {
+        uart->rxTimestampCursor = UART_RX_TIMESTAMP_TAKEN;
+        return uart->rxTimestamp;
+    }
+    return TimerGetCycles();
+}
+
+/**
+ * UARTHasRXData()
+ *     Description:
+ *         The simulator puts received bytes straight on the RX queue, so
+ *         nothing ever waits in a hardware RX FIFO
+ *     Params:
+ *         UART_t *uart - The UART
+ *     Returns:
+ *         uint8_t - Always 0
+ */
+uint8_t UARTHasRXData(UART_t *uart)
+{
+    return 0;
+}
+
+/**
+ * UARTRXDrainIdle()
+ *     Description:
+ *         The application calls this once per pass of the main loop, before
+ *         it reads the RX queue, so it is where the simulator delivers the
+ *         interrupts that came due since the last pass
+ *     Params:
+ *         UART_t *uart - The UART
+ *     Returns:
+ *         void
+ */
+void UARTRXDrainIdle(UART_t *uart)
+{
+    HostProcess();
+}
+
+void UARTSetRXWatermark(UART_t *uart, uint8_t watermark)
+{
+    uart->rxWatermark = watermark;
+}
+
+void UARTReportErrors(UART_t *uart)
+{
+    uart->rxError = 0;
+    uart->txDropped = 0;
+}
+
+void UARTRXQueueReset(UART_t *uart)
+{
+    CharQueueReset(&uart->rxQueue);
+}
+
+void UARTFlush(UART_t *uart)
+{
+}
+
+void UARTSendChar(UART_t *uart, unsigned char data)
+{
+    HostUARTTransmit(uart->moduleIndex, data);
+}
+
+void UARTSendCharBlocking(UART_t *uart, uint8_t data)
+{
+    HostUARTTransmit(uart->moduleIndex, data);
+}
+
+void UARTSendData(UART_t *uart, unsigned char *data, uint16_t length)
+{
+    uint16_t i;
+    for (i = 0; i < length; i++) {
+        HostUARTTransmit(uart->moduleIndex, data[i]);
+    }
+}
+
+void UARTSendString(UART_t *uart, char *data)
+{
+    uint16_t stringLength = strlen(data);
+    uint16_t i = 0;
+    for (i = 0; i < stringLength; i++) {
+        char c = data[i];
+        // Print only readable and newline characters
+        if ((c >= 0x20 && c <= 0x7E) || c == 0x0D || c == 0x0A) {
+            HostUARTTransmit(uart->moduleIndex, c);
+        }
+    }
+}
+
+void UARTSetTXFullMode(UART_t *uart, uint8_t mode)
+{
+    uart->txFullMode = mode;
+}
+
+void UARTSetTXQueue(UART_t *uart, volatile uint8_t *queue)
+{
+    uart->txQueue = queue;
+}
+
+/**
+ * HostUARTReceive()
+ *     Description:
+ *         Put bytes on the RX queue of a UART module, as UARTRXDrain() does
+ *         from the RX ISR. The cursors are written directly rather than
+ *         through CharQueueAdd(), so the high water mark is kept here.
+ *         Bytes that do not fit on the queue are lost.
+ *     Params:
+ *         uint8_t uartModule - The UART Module Number
+ *         const uint8_t *data - The bytes that were received
+ *         uint16_t length - The number of bytes
+ *     Returns:
+ *         void
+ */
+void HostUARTReceive(uint8_t uartModule, const uint8_t *data, uint16_t length)
+{
+    UART_t *uart = UARTGetModuleHandler(uartModule);
+    uint16_t i;
+    if (uart == 0) {
+        return;
+    }
+    volatile CharQueue_t *queue = &uart->rxQueue;
+    uint16_t readCursor = queue->readCursor;
+    uint16_t writeCursor = queue->writeCursor;
+    if (readCursor == writeCursor) {
+        uart->rxTimestamp = TimerGetCycles();
+        uart->rxTimestampCursor = writeCursor;
+    }
+    for (i = 0; i < length; i++) {
+        uint16_t nextCursor = writeCursor + 1;
+        if (nextCursor >= CHAR_QUEUE_SIZE) {
+            nextCursor = 0;
+        }
+        if (nextCursor != readCursor) {
+            queue->data[writeCursor] = data[i];
+            writeCursor = nextCursor;
+        }
+    }
+    uint16_t size = writeCursor - readCursor;
+    if (writeCursor < readCursor) {
+        size = CHAR_QUEUE_SIZE - readCursor + writeCursor;
+    }
+    if (size > queue->maxSize) {
+        queue->maxSize = size;
+    }
+    queue->writeCursor = writeCursor;
+}
@@ -0,0 +1,202 @@
+/*
+ * File:   xc.h
+ * Author: agent <agent@local>
+ * Description:
+ *     Stand in for the XC16 device header on the host build. The special
+ *     function registers that the application touches are plain variables
+ *     (see sfr.c), so code that only reads and writes them runs unmodified.
+ */
+#ifndef XC_H
+#define XC_H
+#include <stdint.h>
+
+/**
+ * UART
+ *     Description:
+ *         The register block of a UART module, in the same layout as the
+ *         PIC24FJ header, starting at UxMODE
+ */
+typedef struct UART {
+    uint16_t uxmode;
+    uint16_t uxsta;
+    uint16_t uxtxreg;
+    uint16_t uxrxreg;
+    uint16_t uxbrg;
+} UART;
+
+typedef struct {
+    unsigned T2IF:1;
+} IFS0BITS;
+typedef struct {
+    unsigned OSCFAIL:1;
+    unsigned STKERR:1;
+    unsigned ADDRERR:1;
+    unsigned MATHERR:1;
+} INTCON1BITS;
+typedef struct {
+    unsigned AIVTEN:1;
+} INTCON2BITS;
+typedef struct {
+    unsigned IOCPDG8:1;
+} IOCPDGBITS;
+typedef struct {
+    unsigned LATB7:1;
+} LATBBITS;
+typedef struct {
+    unsigned LATD1:1;
+    unsigned LATD2:1;
+    unsigned LATD3:1;
+    unsigned LATD10:1;
+    unsigned LATD11:1;
+} LATDBITS;
+typedef struct {
+    unsigned LATE0:1;
+    unsigned LATE1:1;
+    unsigned LATE2:1;
+    unsigned LATE3:1;
+    unsigned LATE4:1;
+    unsigned LATE5:1;
+    unsigned LATE6:1;
+    unsigned LATE7:1;
+} LATEBITS;
+typedef struct {
+    unsigned LATF0:1;
+    unsigned LATF1:1;
+    unsigned LATF4:1;
+    unsigned LATF5:1;
+} LATFBITS;
+typedef struct {
+    unsigned LATG6:1;
+    unsigned LATG7:1;
+} LATGBITS;
+typedef struct {
+    unsigned RD0:1;
+    unsigned RD4:1;
+    unsigned RD8:1;
+} PORTDBITS;
+typedef struct {
+    unsigned RE6:1;
+    unsigned RE7:1;
+} PORTEBITS;
+typedef struct {
+    unsigned RF1:1;
+} PORTFBITS;
+typedef struct {
+    unsigned RG8:1;
+} PORTGBITS;
+typedef struct {
+    unsigned TON:1;
+} T2CONBITS;
+typedef struct {
+    unsigned TRISB7:1;
+} TRISBBITS;
+typedef struct {
+    unsigned TRISD0:1;
+    unsigned TRISD1:1;
+    unsigned TRISD2:1;
+    unsigned TRISD3:1;
+    unsigned TRISD4:1;
+    unsigned TRISD8:1;
+    unsigned TRISD9:1;
+    unsigned TRISD10:1;
+    unsigned TRISD11:1;
+} TRISDBITS;
+typedef struct {
+    unsigned TRISE0:1;
+    unsigned TRISE1:1;
+    unsigned TRISE2:1;
+    unsigned TRISE3:1;
+    unsigned TRISE4:1;
+    unsigned TRISE5:1;
+    unsigned TRISE6:1;
+    unsigned TRISE7:1;
+} TRISEBITS;
+typedef struct {
+    unsigned TRISF0:1;
+    unsigned TRISF1:1;
+    unsigned TRISF4:1;
+    unsigned TRISF5:1;
+} TRISFBITS;
+typedef struct {
+    unsigned TRISG6:1;
+    unsigned TRISG7:1;
+    unsigned TRISG8:1;
+} TRISGBITS;
+
+extern volatile IFS0BITS IFS0bits;
+extern volatile INTCON1BITS INTCON1bits;
+extern volatile INTCON2BITS INTCON2bits;
+extern volatile IOCPDGBITS IOCPDGbits;
+extern volatile LATBBITS LATBbits;
+extern volatile LATDBITS LATDbits;
+extern volatile LATEBITS LATEbits;
+extern volatile LATFBITS LATFbits;
+extern volatile LATGBITS LATGbits;
+extern volatile PORTDBITS PORTDbits;
+extern volatile PORTEBITS PORTEbits;
+extern volatile PORTFBITS PORTFbits;
+extern volatile PORTGBITS PORTGbits;
+extern volatile T2CONBITS T2CONbits;
+extern volatile TRISBBITS TRISBbits;
+extern volatile TRISDBITS TRISDbits;
+extern volatile TRISEBITS TRISEbits;
+extern volatile TRISFBITS TRISFbits;
+extern volatile TRISGBITS TRISGbits;
+
+extern volatile uint16_t ANSB;
+extern volatile uint16_t ANSC;
+extern volatile uint16_t ANSD;
+extern volatile uint16_t ANSE;
+extern volatile uint16_t ANSF;
+extern volatile uint16_t ANSG;
+extern volatile uint16_t LATB;
+extern volatile uint16_t LATC;
+extern volatile uint16_t LATD;
+extern volatile uint16_t LATE;
+extern volatile uint16_t LATF;
+extern volatile uint16_t LATG;
+extern volatile uint16_t PR1;
+extern volatile uint16_t PR2;
+extern volatile uint16_t PR4;
+extern volatile uint16_t PR5;
+extern volatile uint16_t SPLIM;
+// The remappable output registers are addressed from RPOR0 onwards
+extern volatile uint16_t HostRPOR[16];
+#define RPOR0 HostRPOR[0]
+extern volatile uint16_t T1CON;
+extern volatile uint16_t T4CON;
+extern volatile uint16_t T5CON;
+extern volatile uint16_t TMR2;
+// Timer4/5 count the host's own time in instruction cycles, so a read of
+// the low word goes to the simulator, which latches the high word
+volatile uint16_t *HostGetTMR4();
+#define TMR4 (*HostGetTMR4())
+extern volatile uint16_t TMR5;
+extern volatile uint16_t TMR5HLD;
+extern volatile uint16_t TRISB;
+extern volatile uint16_t TRISC;
+extern volatile uint16_t TRISD;
+extern volatile uint16_t TRISE;
+extern volatile uint16_t TRISF;
+extern volatile uint16_t TRISG;
+
+// Interrupt attributes mean nothing to the host compiler. The handlers
+// become plain functions that the simulator calls.
+#define __interrupt__
+#define auto_psv
+
+// The simulator delivers the interrupts once per pass of the main loop, so
+// idling until the next one is another step of its clock
+void HostIdle();
+#define Idle() HostIdle()
+
+// The simulator only delivers interrupts between passes of the main loop and
+// from Idle(), so there is no CPU priority to raise
+#define SET_AND_SAVE_CPU_IPL(save_to, ipl) ((save_to) = (ipl))
+#define RESTORE_CPU_IPL(saved_to) ((void) (saved_to))
+
+// The application resets the MCU with an inline RESET instruction. There is
+// nothing to reset on the host, so the assembler is given an empty macro
+// of that name and the reset is ignored.
+__asm__(".macro RESET\n.endm");
+#endif /* XC_H */
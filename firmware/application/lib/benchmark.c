@@ -0,0 +1,496 @@
+/*
+ * File:   benchmark.c
+ * Author: agent <agent@local>
+ * Description:
+ *     Time the busiest functions of the application on the PIC24 itself, in
+ *     instruction cycles, with the same inputs as the host benchmarks in
+ *     host/bench.c. The host's nanoseconds say little about a 16-bit core
+ *     without a cache, so the cost of a change to these functions is judged
+ *     by the cycles that "BENCH" reports on the CLI.
+ */
+#include "benchmark.h"
+#include "log.h"
+
+/**
+ * Benchmark_t
+ *     Description:
+ *         A benchmark that is safe to run on a working device, since it
+ *         neither sends anything nor changes the state of the modules
+ *     Fields:
+ *         name - The name, which is the same as the host benchmark's
+ *         run - Run the given number of operations between
+ *             BenchmarkStart() and BenchmarkStop(), and return the bytes of
+ *             input that they handled
+ *         iterations - The number of operations in a run, which keeps a
+ *             run to a few milliseconds of the main loop
+ */
+typedef struct Benchmark_t {
+    const char *name;
+    uint32_t (*run)(uint16_t);
+    uint16_t iterations;
+} Benchmark_t;
+
+static uint32_t BENCHMARK_BEGIN = 0;
+static uint32_t BENCHMARK_CYCLES = 0;
+static uint32_t BENCHMARK_RANDOM = BENCHMARK_SEED;
+// The benchmarks add what they compute here, so that it is not optimized out
+static volatile uint16_t BENCHMARK_SINK = 0;
+// The queue benchmarks share one queue, which is too large for the stack
+static CharQueue_t BENCHMARK_QUEUE;
+
+// Track metadata, with the characters that have to be transliterated
+static const char *BENCHMARK_TEXT[BENCHMARK_TEXT_COUNT] = {
+    "Bohemian Rhapsody - Remastered 2011",
+    "Mot\xC3\xB6rhead - Ace of Spades (Expanded Edition)",
+    "Sigur R\xC3\xB3s - Hopp\xC3\xADpolla",
+    "\xD0\x9A\xD0\xB8\xD0\xBD\xD0\xBE - \xD0\x93\xD1\x80\xD1\x83\xD0\xBF\xD0\xBF\xD0\xB0 \xD0\xBA\xD1\x80\xD0\xBE\xD0\xB2\xD0\xB8",
+    "Beyonc\xC3\xA9 \\C3\\A9 Halo"
+};
+
+/**
+ * BenchmarkStart()
+ *     Description:
+ *         Start timing the part of a benchmark that is being measured
+ *     Params:
+ *         None
+ *     Returns:
+ *         void
+ */
+static void BenchmarkStart()
+{
+    BENCHMARK_BEGIN = TimerGetCycles();
+}
+
+/**
+ * BenchmarkStop()
+ *     Description:
+ *         Stop timing, and add the cycles since BenchmarkStart() to the run
+ *     Params:
+ *         None
+ *     Returns:
+ *         void
+ */
+static void BenchmarkStop()
+{
+    BENCHMARK_CYCLES += TimerGetCycles() - BENCHMARK_BEGIN;
+}
+
+/**
+ * BenchmarkCharQueueAdd()
+ *     Description:
+ *         Add bytes to an empty queue one at a time
+ *     Params:
+ *         uint16_t iterations - The number of bytes, which all have to fit
+ *             on the queue
+ *     Returns:
+ *         uint32_t - The bytes added
+ */
+static uint32_t BenchmarkCharQueueAdd(uint16_t iterations)
+{
+    uint16_t i;
+    CharQueueReset(&BENCHMARK_QUEUE);
+    BENCHMARK_QUEUE.maxSize = 0;
+    BenchmarkStart();
+    for (i = 0; i < iterations; i++) {
+        CharQueueAdd(&BENCHMARK_QUEUE, (uint8_t) i);
+    }
+    BenchmarkStop();
+    return iterations;
+}
+
+/**
+ * BenchmarkCharQueueNext()
+ *     Description:
+ *         Take random bytes off a queue one at a time, as the drivers do
+ *     Params:
+ *         uint16_t iterations - The number of bytes, which all have to fit
+ *             on the queue
+ *     Returns:
+ *         uint32_t - The bytes taken
+ */
+static uint32_t BenchmarkCharQueueNext(uint16_t iterations)
+{
+    uint16_t sum = 0;
+    uint16_t i;
+    CharQueueReset(&BENCHMARK_QUEUE);
+    BENCHMARK_QUEUE.maxSize = 0;
+    for (i = 0; i < iterations; i++) {
+        CharQueueAdd(&BENCHMARK_QUEUE, (uint8_t) BenchmarkRandom(&BENCHMARK_RANDOM));
+    }
+    BenchmarkStart();
+    for (i = 0; i < iterations; i++) {
+        sum += CharQueueNext(&BENCHMARK_QUEUE);
+    }
+    BenchmarkStop();
+    BENCHMARK_SINK += sum;
+    return iterations;
+}
+
+/**
+ * BenchmarkCharQueueSeek()
+ *     Description:
+ *         Find the end of each line on a queue of random bytes, and take the
+ *         line off the queue, as the BC127 driver does
+ *     Params:
+ *         uint16_t iterations - The number of lines, which all have to fit
+ *             on the queue
+ *     Returns:
+ *         uint32_t - The bytes scanned
+ */
+static uint32_t BenchmarkCharQueueSeek(uint16_t iterations)
+{
+    uint32_t bytes = 0;
+    uint16_t i;
+    CharQueueReset(&BENCHMARK_QUEUE);
+    BENCHMARK_QUEUE.maxSize = 0;
+    for (i = 0; i < iterations; i++) {
+        uint16_t length = 8 + BenchmarkRandom(&BENCHMARK_RANDOM) % 120;
+        uint16_t j;
+        for (j = 1; j < length; j++) {
+            CharQueueAdd(&BENCHMARK_QUEUE, 0x20 + BenchmarkRandom(&BENCHMARK_RANDOM) % 0x5F);
+        }
+        CharQueueAdd(&BENCHMARK_QUEUE, '\r');
+    }
+    BenchmarkStart();
+    for (i = 0; i < iterations; i++) {
+        uint16_t length = CharQueueSeek(&BENCHMARK_QUEUE, '\r');
+        BENCHMARK_QUEUE.readCursor += length;
+        bytes += length;
+    }
+    BenchmarkStop();
+    return bytes;
+}
+
+/**
+ * BenchmarkIBusValidateChecksum()
+ *     Description:
+ *         Validate the checksum of random IBus packets, as each received
+ *         frame is
+ *     Params:
+ *         uint16_t iterations - The number of packets
+ *     Returns:
+ *         uint32_t - The bytes checked
+ */
+static uint32_t BenchmarkIBusValidateChecksum(uint16_t iterations)
+{
+    uint8_t packets[BENCHMARK_PACKETS][IBUS_MAX_MSG_LENGTH];
+    uint32_t bytes = 0;
+    uint16_t valid = 0;
+    uint16_t i;
+    for (i = 0; i < BENCHMARK_PACKETS; i++) {
+        BenchmarkGetPacket(&BENCHMARK_RANDOM, packets[i]);
+    }
+    BenchmarkStart();
+    for (i = 0; i < iterations; i++) {
+        valid += IBusValidateChecksum(packets[i % BENCHMARK_PACKETS]);
+    }
+    BenchmarkStop();
+    for (i = 0; i < iterations; i++) {
+        bytes += packets[i % BENCHMARK_PACKETS][1] + 2;
+    }
+    BENCHMARK_SINK += valid;
+    return bytes;
+}
+
+/**
+ * BenchmarkUtilsNormalizeText()
+ *     Description:
+ *         Transliterate track metadata for the display
+ *     Params:
+ *         uint16_t iterations - The number of texts
+ *     Returns:
+ *         uint32_t - The bytes of input
+ */
+static uint32_t BenchmarkUtilsNormalizeText(uint16_t iterations)
+{
+    char text[BENCHMARK_TEXT_SIZE];
+    uint32_t bytes = 0;
+    uint16_t i;
+    for (i = 0; i < iterations; i++) {
+        const char *input = BenchmarkGetText(i);
+        BenchmarkStart();
+        UtilsNormalizeText(text, input, BENCHMARK_TEXT_SIZE);
+        BenchmarkStop();
+        bytes += strlen(input);
+    }
+    return bytes;
+}
+
+/**
+ * BenchmarkEventTriggerCallbackUnsubscribed()
+ *     Description:
+ *         Trigger an event that nothing is registered for, which is the cost
+ *         of walking the callbacks alone
+ *     Params:
+ *         uint16_t iterations - The number of events
+ *     Returns:
+ *         uint32_t - Zero, since there is no input
+ */
+static uint32_t BenchmarkEventTriggerCallbackUnsubscribed(uint16_t iterations)
+{
+    uint16_t i;
+    BenchmarkStart();
+    for (i = 0; i < iterations; i++) {
+        EventTriggerCallback(BENCHMARK_EVENT_UNSUBSCRIBED, 0);
+    }
+    BenchmarkStop();
+    return 0;
+}
+
+/**
+ * BenchmarkLocaleGetText()
+ *     Description:
+ *         Look up each of the locale strings in turn
+ *     Params:
+ *         uint16_t iterations - The number of lookups
+ *     Returns:
+ *         uint32_t - Zero, since there is no input
+ */
+static uint32_t BenchmarkLocaleGetText(uint16_t iterations)
+{
+    uint16_t sum = 0;
+    uint16_t i;
+    BenchmarkStart();
+    for (i = 0; i < iterations; i++) {
+        sum += LocaleGetText(i % (LOCALE_STRING_MAX_INDEX + 1))[0];
+    }
+    BenchmarkStop();
+    BENCHMARK_SINK += sum;
+    return 0;
+}
+
+/**
+ * BenchmarkTimerGetMicros()
+ *     Description:
+ *         Read the microseconds since boot
+ *     Params:
+ *         uint16_t iterations - The number of reads
+ *     Returns:
+ *         uint32_t - Zero, since there is no input
+ */
+static uint32_t BenchmarkTimerGetMicros(uint16_t iterations)
+{
+    uint32_t sum = 0;
+    uint16_t i;
+    BenchmarkStart();
+    for (i = 0; i < iterations; i++) {
+        sum += TimerGetMicros();
+    }
+    BenchmarkStop();
+    BENCHMARK_SINK += sum;
+    return 0;
+}
+
+/**
+ * BenchmarkTimerGetMillis()
+ *     Description:
+ *         Read the milliseconds since boot
+ *     Params:
+ *         uint16_t iterations - The number of reads
+ *     Returns:
+ *         uint32_t - Zero, since there is no input
+ */
+static uint32_t BenchmarkTimerGetMillis(uint16_t iterations)
+{
+    uint32_t sum = 0;
+    uint16_t i;
+    BenchmarkStart();
+    for (i = 0; i < iterations; i++) {
+        sum += TimerGetMillis();
+    }
+    BenchmarkStop();
+    BENCHMARK_SINK += sum;
+    return 0;
+}
+
+/**
+ * BenchmarkLogMessageFormat()
+ *     Description:
+ *         Format a debug message as LogMessage() does, with the timestamp
+ *         widened to 64 bits. The timestamp is fixed, since the time it
+ *         takes depends on its number of digits.
+ *     Params:
+ *         uint16_t iterations - The number of messages
+ *     Returns:
+ *         uint32_t - The bytes formatted
+ */
+static uint32_t BenchmarkLogMessageFormat(uint16_t iterations)
+{
+    char output[LOG_MESSAGE_SIZE];
+    uint32_t bytes = 0;
+    uint16_t i;
+    for (i = 0; i < iterations; i++) {
+        long long unsigned int ts = BENCHMARK_LOG_TIMESTAMP;
+        BenchmarkStart();
+        snprintf(output, LOG_MESSAGE_SIZE - 1, "[%llu] %s: %s\r\n", ts, "DEBUG", "BT: R: 'AVRCP_PLAY 11'");
+        BenchmarkStop();
+        bytes += strlen(output);
+    }
+    return bytes;
+}
+
+/**
+ * BenchmarkLogMessageFormat32()
+ *     Description:
+ *         Format the same message as BenchmarkLogMessageFormat() with a 32
+ *         bit timestamp, which is what the 64 bit one costs against
+ *     Params:
+ *         uint16_t iterations - The number of messages
+ *     Returns:
+ *         uint32_t - The bytes formatted
+ */
+static uint32_t BenchmarkLogMessageFormat32(uint16_t iterations)
+{
+    char output[LOG_MESSAGE_SIZE];
+    uint32_t bytes = 0;
+    uint16_t i;
+    for (i = 0; i < iterations; i++) {
+        long unsigned int ts = BENCHMARK_LOG_TIMESTAMP;
+        BenchmarkStart();
+        snprintf(output, LOG_MESSAGE_SIZE - 1, "[%lu] %s: %s\r\n", ts, "DEBUG", "BT: R: 'AVRCP_PLAY 11'");
+        BenchmarkStop();
+        bytes += strlen(output);
+    }
+    return bytes;
+}
+
+static const Benchmark_t BENCHMARKS[] = {
+    {"CharQueueAdd", &BenchmarkCharQueueAdd, 256},
+    {"CharQueueNext", &BenchmarkCharQueueNext, 256},
+    {"CharQueueSeek", &BenchmarkCharQueueSeek, 4},
+    {"IBusValidateChecksum", &BenchmarkIBusValidateChecksum, 64},
+    {"UtilsNormalizeText", &BenchmarkUtilsNormalizeText, 2 * BENCHMARK_TEXT_COUNT},
+    {
+        "EventTriggerCallbackUnsubscribed",
+        &BenchmarkEventTriggerCallbackUnsubscribed,
+        32
+    },
+    {"LocaleGetText", &BenchmarkLocaleGetText, 2 * (LOCALE_STRING_MAX_INDEX + 1)},
+    {"TimerGetMicros", &BenchmarkTimerGetMicros, 256},
+    {"TimerGetMillis", &BenchmarkTimerGetMillis, 256},
+    {"LogMessageFormat", &BenchmarkLogMessageFormat, 8},
+    {"LogMessageFormat32", &BenchmarkLogMessageFormat32, 8}
+};
+#define BENCHMARK_COUNT (sizeof(BENCHMARKS) / sizeof(BENCHMARKS[0]))
+
+/**
+ * BenchmarkGetCount()
+ *     Description:
+ *         Get the number of benchmarks
+ *     Params:
+ *         None
+ *     Returns:
+ *         uint8_t - The number of benchmarks
+ */
+uint8_t BenchmarkGetCount()
+{
+    return BENCHMARK_COUNT;
+}
+
+/**
+ * BenchmarkGetName()
+ *     Description:
+ *         Get the name of a benchmark
+ *     Params:
+ *         uint8_t idx - The benchmark
+ *     Returns:
+ *         const char * - The name, or 0 if there is no such benchmark
+ */
+const char *BenchmarkGetName(uint8_t idx)
+{
+    if (idx >= BENCHMARK_COUNT) {
+        return 0;
+    }
+    return BENCHMARKS[idx].name;
+}
+
+/**
+ * BenchmarkGetPacket()
+ *     Description:
+ *         Build an IBus packet of a random length, with random bytes and a
+ *         valid checksum
+ *     Params:
+ *         uint32_t *state - The state of the random sequence
+ *         uint8_t *packet - Where to build it, which holds IBUS_MAX_MSG_LENGTH
+ *     Returns:
+ *         void
+ */
+void BenchmarkGetPacket(uint32_t *state, uint8_t *packet)
+{
+    uint8_t length = 5 + BenchmarkRandom(state) % (IBUS_MAX_MSG_LENGTH - 4);
+    uint8_t checksum = 0;
+    uint8_t i;
+    packet[1] = length - 2;
+    for (i = 0; i < length - 1; i++) {
+        if (i != 1) {
+            packet[i] = BenchmarkRandom(state);
+        }
+        checksum ^= packet[i];
+    }
+    packet[length - 1] = checksum;
+}
+
+/**
+ * BenchmarkGetText()
+ *     Description:
+ *         Get one of the texts that the text benchmarks cycle through
+ *     Params:
+ *         uint8_t idx - The text, which wraps around
+ *     Returns:
+ *         const char * - The text
+ */
+const char *BenchmarkGetText(uint8_t idx)
+{
+    return BENCHMARK_TEXT[idx % BENCHMARK_TEXT_COUNT];
+}
+
+/**
+ * BenchmarkRandom()
+ *     Description:
+ *         Get the next number of a xorshift sequence
+ *     Params:
+ *         uint32_t *state - The state of the sequence, which starts at
+ *             BENCHMARK_SEED
+ *     Returns:
+ *         uint32_t - The number
+ */
+uint32_t BenchmarkRandom(uint32_t *state)
+{
+    uint32_t value = *state;
+    value ^= value << 13;
+    value ^= value >> 17;
+    value ^= value << 5;
+    *state = value;
+    return value;
+}
+
+/**
+ * BenchmarkRun()
+ *     Description:
+ *         Run a benchmark BENCHMARK_REPEATS times from BENCHMARK_SEED, and
+ *         keep the fastest run. The main loop does not run in the meantime.
+ *     Params:
+ *         uint8_t idx - The benchmark
+ *         BenchmarkResult_t *result - Where to put its cost
+ *     Returns:
+ *         void
+ */
+void BenchmarkRun(uint8_t idx, BenchmarkResult_t *result)
+{
+    uint8_t repeat;
+    memset(result, 0, sizeof(BenchmarkResult_t));
+    if (idx >= BENCHMARK_COUNT) {
+        return;
+    }
+    const Benchmark_t *benchmark = &BENCHMARKS[idx];
+    result->iterations = benchmark->iterations;
+    result->cycles = 0xFFFFFFFF;
+    for (repeat = 0; repeat < BENCHMARK_REPEATS; repeat++) {
+        BENCHMARK_RANDOM = BENCHMARK_SEED;
+        BENCHMARK_CYCLES = 0;
+        result->bytes = benchmark->run(benchmark->iterations);
+        if (BENCHMARK_CYCLES < result->cycles) {
+            result->cycles = BENCHMARK_CYCLES;
+        }
+    }
+}
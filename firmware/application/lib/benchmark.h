@@ -0,0 +1,57 @@
+/*
+ * File:   benchmark.h
+ * Author: agent <agent@local>
+ * Description:
+ *     Time the busiest functions of the application on the PIC24 itself, in
+ *     instruction cycles, with the same inputs as the host benchmarks in
+ *     host/bench.c. The host's nanoseconds say little about a 16-bit core
+ *     without a cache, so the cost of a change to these functions is judged
+ *     by the cycles that "BENCH" reports on the CLI.
+ */
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "char_queue.h"
+#include "event.h"
+#include "ibus.h"
+#include "locale.h"
+#include "timer.h"
+#include "utils.h"
+// Every benchmark draws its input from the same sequence, on the host too
+#define BENCHMARK_SEED 0x2545F491
+// The number of IBus packets that the IBus benchmarks cycle through
+#define BENCHMARK_PACKETS 8
+#define BENCHMARK_TEXT_COUNT 5
+#define BENCHMARK_TEXT_SIZE 128
+// Interrupts only ever add cycles to a run, so the fewest of this many
+// runs is reported
+#define BENCHMARK_REPEATS 5
+// An event type that no callback is registered for
+#define BENCHMARK_EVENT_UNSUBSCRIBED 0xFE
+// The uptime that the log benchmarks format, which is an hour
+#define BENCHMARK_LOG_TIMESTAMP 3600000UL
+
+/**
+ * BenchmarkResult_t
+ *     Description:
+ *         The cost of a benchmark
+ *     Fields:
+ *         iterations - The number of operations in a run
+ *         cycles - The instruction cycles of the fastest run
+ *         bytes - The bytes of input that a run handled
+ */
+typedef struct BenchmarkResult_t {
+    uint16_t iterations;
+    uint32_t cycles;
+    uint32_t bytes;
+} BenchmarkResult_t;
+
+uint8_t BenchmarkGetCount();
+const char *BenchmarkGetName(uint8_t);
+void BenchmarkGetPacket(uint32_t *, uint8_t *);
+const char *BenchmarkGetText(uint8_t);
+uint32_t BenchmarkRandom(uint32_t *);
+void BenchmarkRun(uint8_t, BenchmarkResult_t *);
+#endif /* BENCHMARK_H */
@@ -0,0 +1,97 @@
+/*
+ * File:   boot_trace.c
+ * Author: agent <agent@local>
+ * Description:
+ *     Record when each stage of the boot completes, so the time it takes to
+ *     get on the bus after power up can be measured
+ */
+#include "boot_trace.h"
+static BootTrace_t BOOT_TRACE;
+
+static const char *BOOT_TRACE_STAGE_NAMES[BOOT_TRACE_STAGE_COUNT] = {
+    "Timer",
+    "EEPROM",
+    "I2C",
+    "BT",
+    "IBus",
+    "Upgrade",
+    "Handler",
+    "CLI",
+    "Main Loop",
+    "IBus First RX",
+    "IBus First TX",
+    "CDC First Poll",
+    "Deferred Start",
+    "Paired Devices",
+    "Phonebook",
+    "DAC Init",
+    "DAC Startup",
+    "Ready"
+};
+
+/**
+ * BootTraceGet()
+ *     Description:
+ *         Get the boot trace
+ *     Params:
+ *         None
+ *     Returns:
+ *         BootTrace_t * - The boot trace
+ */
+BootTrace_t *BootTraceGet()
+{
+    return &BOOT_TRACE;
+}
+
+/**
+ * BootTraceGetStageName()
+ *     Description:
+ *         Get the name of a boot stage
+ *     Params:
+ *         uint8_t stage - The stage
+ *     Returns:
+ *         const char * - The stage name
+ */
+const char *BootTraceGetStageName(uint8_t stage)
+{
+    if (stage >= BOOT_TRACE_STAGE_COUNT) {
+        return "";
+    }
+    return BOOT_TRACE_STAGE_NAMES[stage];
+}
+
+/**
+ * BootTraceIsMarked()
+ *     Description:
+ *         Check if a boot stage has completed
+ *     Params:
+ *         uint8_t stage - The stage
+ *     Returns:
+ *         uint8_t - 1 if the stage has completed, 0 otherwise
+ */
+uint8_t BootTraceIsMarked(uint8_t stage)
+{
+    if ((BOOT_TRACE.marked & ((uint32_t) 1 << stage)) != 0) {
+        return 1;
+    }
+    return 0;
+}
+
+/**
+ * BootTraceMark()
+ *     Description:
+ *         Record the completion of a boot stage. Only the first completion
+ *         of each stage is kept, so this is safe to call on every frame.
+ *     Params:
+ *         uint8_t stage - The stage
+ *     Returns:
+ *         void
+ */
+void BootTraceMark(uint8_t stage)
+{
+    if (stage >= BOOT_TRACE_STAGE_COUNT || BootTraceIsMarked(stage) == 1) {
+        return;
+    }
+    BOOT_TRACE.timestamps[stage] = TimerGetMillis();
+    BOOT_TRACE.marked |= (uint32_t) 1 << stage;
+}
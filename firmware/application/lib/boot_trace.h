@@ -0,0 +1,55 @@
+/*
+ * File:   boot_trace.h
+ * Author: agent <agent@local>
+ * Description:
+ *     Record when each stage of the boot completes, so the time it takes to
+ *     get on the bus after power up can be measured
+ */
+#ifndef BOOT_TRACE_H
+#define BOOT_TRACE_H
+#include <stdint.h>
+#include "timer.h"
+
+// Stages, in the order they are expected to complete
+#define BOOT_TRACE_TIMER 0
+#define BOOT_TRACE_EEPROM 1
+#define BOOT_TRACE_I2C 2
+#define BOOT_TRACE_BT 3
+#define BOOT_TRACE_IBUS 4
+#define BOOT_TRACE_UPGRADE 5
+#define BOOT_TRACE_HANDLER 6
+#define BOOT_TRACE_CLI 7
+#define BOOT_TRACE_MAIN_LOOP 8
+#define BOOT_TRACE_IBUS_FIRST_RX 9
+#define BOOT_TRACE_IBUS_FIRST_TX 10
+#define BOOT_TRACE_CDC_FIRST_POLL 11
+#define BOOT_TRACE_DEFERRED_START 12
+#define BOOT_TRACE_PAIRED_DEVICES 13
+#define BOOT_TRACE_PHONEBOOK 14
+#define BOOT_TRACE_DAC_INIT 15
+#define BOOT_TRACE_DAC_STARTUP 16
+#define BOOT_TRACE_READY 17
+#define BOOT_TRACE_STAGE_COUNT 18
+
+// Deferred work starts once we have been on the bus, or after this long
+#define BOOT_TRACE_DEFER_TIMEOUT 250
+
+/**
+ * BootTrace_t
+ *     Description:
+ *         The time at which each boot stage completed
+ *     Fields:
+ *         marked - One bit per stage, set once the stage has completed
+ *         timestamps - The milliseconds since boot at which each stage
+ *             completed
+ */
+typedef struct BootTrace_t {
+    uint32_t marked;
+    uint32_t timestamps[BOOT_TRACE_STAGE_COUNT];
+} BootTrace_t;
+
+BootTrace_t *BootTraceGet();
+const char *BootTraceGetStageName(uint8_t);
+uint8_t BootTraceIsMarked(uint8_t);
+void BootTraceMark(uint8_t);
+#endif /* BOOT_TRACE_H */
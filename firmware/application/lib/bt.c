@@ -8,6 +8,8 @@
 #include "locale.h"
 #include "uart.h"
 
+static uint8_t BT_UART_TX_QUEUE[UART_TX_QUEUE_SIZE];
+
 /**
  * BTInit()
  *     Description:
@@ -39,6 +41,7 @@ BT_t BTInit()
     memset(bt.pairingErrors, 0, sizeof(bt.pairingErrors));
     // Make sure that we initialize the char arrays to all zeros
     BTClearMetadata(&bt);
+    BTBrowseClear(&bt, BT_BROWSE_SCOPE_NONE);
     bt.uart = UARTInit(
         BT_UART_MODULE,
         BT_UART_RX_RPIN,
@@ -48,6 +51,10 @@ BT_t BTInit()
         UART_BAUD_115200,
         UART_PARITY_NONE
     );
+    // Take the RX interrupt once per three bytes instead of every byte. The
+    // module process functions pick up the rest of each burst
+    UARTSetRXWatermark(&bt.uart, UART_RX_WATERMARK_3_4);
+    UARTSetTXQueue(&bt.uart, BT_UART_TX_QUEUE);
     if (bt.type == BT_BTM_TYPE_BM83) {
         // The BM83 is not pairable by default
         bt.discoverable = BT_STATE_OFF;
@@ -55,6 +62,154 @@ BT_t BTInit()
     return bt;
 }
 
+/**
+ * BTBrowseEnterItem()
+ *     Description:
+ *         Enter a browsed folder, or play a browsed media item. The depth
+ *         changes once the device confirms the new path.
+ *     Params:
+ *         BT_t *bt - The Bluetooth context
+ *         uint16_t index - The index of the item in the folder
+ *     Returns:
+ *         void
+ */
+void BTBrowseEnterItem(BT_t *bt, uint16_t index)
+{
+    BTBrowseItem_t *item = BTBrowseGetItem(bt, index);
+    if (item == 0 || bt->browse.pending == BT_BROWSE_PAGE_PATH) {
+        return;
+    }
+    if (item->type == BT_BROWSE_ITEM_TYPE_FOLDER) {
+        bt->browse.pending = BT_BROWSE_PAGE_PATH;
+        bt->browse.requestTimestamp = TimerGetMillis();
+        bt->browse.pendingDepth = bt->browse.depth + 1;
+        BM83CommandAVRCPBrowseChangePath(
+            bt,
+            BM83_AVRCP_DATA_CHANGE_PATH_DOWN,
+            item->uid
+        );
+    } else {
+        BM83CommandAVRCPPlayItem(bt, bt->browse.scope, item->uid);
+    }
+}
+
+/**
+ * BTBrowseOpen()
+ *     Description:
+ *         Start browsing the given scope from its first item. Only the BM83
+ *         supports browsing.
+ *     Params:
+ *         BT_t *bt - The Bluetooth context
+ *         uint8_t scope - The scope to browse (BT_BROWSE_SCOPE_*)
+ *     Returns:
+ *         void
+ */
+void BTBrowseOpen(BT_t *bt, uint8_t scope)
+{
+    if (bt->type == BT_BTM_TYPE_BC127) {
+        LogWarning("BT: Browsing is not supported on the BC127");
+        return;
+    }
+    BTBrowseClear(bt, scope);
+    bt->browse.depth = 0;
+}
+
+/**
+ * BTBrowseProcess()
+ *     Description:
+ *         Request the next page the browsing window is missing, the visible
+ *         page first and then the page after it. One request is outstanding
+ *         at a time.
+ *     Params:
+ *         BT_t *bt - The Bluetooth context
+ *     Returns:
+ *         void
+ */
+static void BTBrowseProcess(BT_t *bt)
+{
+    if (bt->browse.scope == BT_BROWSE_SCOPE_NONE ||
+        bt->activeDevice.avrcpId == 0
+    ) {
+        return;
+    }
+    if (bt->browse.pending != BT_BROWSE_PAGE_NONE) {
+        if ((TimerGetMillis() - bt->browse.requestTimestamp) <
+            BT_BROWSE_REQUEST_TIMEOUT
+        ) {
+            return;
+        }
+        LogWarning("BT: Browse request timed out");
+        bt->browse.pending = BT_BROWSE_PAGE_NONE;
+    }
+    uint16_t page = bt->browse.position / BT_BROWSE_PAGE_SIZE;
+    uint8_t idx;
+    for (idx = 0; idx < BT_BROWSE_WINDOW_PAGES; idx++) {
+        uint16_t start = page * BT_BROWSE_PAGE_SIZE;
+        if (bt->browse.itemCount != BT_BROWSE_COUNT_UNKNOWN &&
+            start >= bt->browse.itemCount
+        ) {
+            return;
+        }
+        if (bt->browse.pageTags[page % BT_BROWSE_WINDOW_PAGES] != page) {
+            bt->browse.pending = page;
+            bt->browse.requestTimestamp = TimerGetMillis();
+            BM83CommandAVRCPBrowseGetFolderItems(
+                bt,
+                bt->browse.scope,
+                start,
+                start + BT_BROWSE_PAGE_SIZE - 1
+            );
+            return;
+        }
+        page++;
+    }
+}
+
+/**
+ * BTBrowseSetPosition()
+ *     Description:
+ *         Scroll the browsing window so the given item is the first visible
+ *         one. Missing pages are fetched from BTProcess().
+ *     Params:
+ *         BT_t *bt - The Bluetooth context
+ *         uint16_t position - The index of the first visible item
+ *     Returns:
+ *         void
+ */
+void BTBrowseSetPosition(BT_t *bt, uint16_t position)
+{
+    if (bt->browse.itemCount != BT_BROWSE_COUNT_UNKNOWN &&
+        position >= bt->browse.itemCount
+    ) {
+        position = 0;
+        if (bt->browse.itemCount > 0) {
+            position = bt->browse.itemCount - 1;
+        }
+    }
+    bt->browse.position = position;
+}
+
+/**
+ * BTBrowseUp()
+ *     Description:
+ *         Go back to the parent of the browsed folder. The depth changes
+ *         once the device confirms the new path.
+ *     Params:
+ *         BT_t *bt - The Bluetooth context
+ *     Returns:
+ *         void
+ */
+void BTBrowseUp(BT_t *bt)
+{
+    if (bt->browse.depth == 0 || bt->browse.pending == BT_BROWSE_PAGE_PATH) {
+        return;
+    }
+    bt->browse.pending = BT_BROWSE_PAGE_PATH;
+    bt->browse.requestTimestamp = TimerGetMillis();
+    bt->browse.pendingDepth = bt->browse.depth - 1;
+    BM83CommandAVRCPBrowseChangePath(bt, BM83_AVRCP_DATA_CHANGE_PATH_UP, 0);
+}
+
 /**
  * BTCommandCallAccept()
  *     Description:
@@ -165,7 +320,8 @@ void BTCommandRedial(BT_t *bt)
 void BTCommandConnect(BT_t *bt, BTPairedDevice_t *dev)
 {
     if (bt->type == BT_BTM_TYPE_BC127) {
-        // Set the MAC ID?
+        // The BC127 opens profiles against the active MAC ID
+        memcpy(bt->activeDevice.macId, dev->macId, BT_MAC_ID_LEN);
         BC127CommandProfileOpen(bt, "A2DP");
     } else {
         uint8_t profiles = BM83_DATA_LINK_BACK_PROFILES_A2DP;
@@ -490,5 +646,234 @@ void BTProcess(BT_t *bt)
         BC127Process(bt);
     } else {
         BM83Process(bt);
+        BTBrowseProcess(bt);
+    }
+}
+
+/**
+ * BTReconnectConnected()
+ *     Description:
+ *         Stop the reconnect scheduler once A2DP is open, and credit the
+ *         device if the connection came from the attempt in flight
+ *     Params:
+ *         BT_t *bt - A pointer to the module object
+ *     Returns:
+ *         void
+ */
+void BTReconnectConnected(BT_t *bt)
+{
+    BTReconnect_t *reconnect = &bt->reconnect;
+    if (reconnect->status != BT_RECONNECT_STATUS_ACTIVE) {
+        return;
+    }
+    if (reconnect->pending == 1 &&
+        memcmp(reconnect->macId, bt->activeDevice.macId, BT_MAC_ID_LEN) == 0
+    ) {
+        BTPairedDeviceSetResult(bt, reconnect->macId, 1);
+    }
+    reconnect->status = BT_RECONNECT_STATUS_IDLE;
+    reconnect->pending = 0;
+    reconnect->connects++;
+    reconnect->lastAttempts = reconnect->attempts;
+    reconnect->lastDuration = TimerGetMillis() - reconnect->start;
+    LogDebug(
+        LOG_SOURCE_BT,
+        "BT: Reconnected after %u attempts in %lums",
+        reconnect->lastAttempts,
+        reconnect->lastDuration
+    );
+}
+
+/**
+ * BTReconnectPrefer()
+ *     Description:
+ *         Try the given device next, since it is known to be in range. If
+ *         no attempt is in flight, it is tried straight away.
+ *     Params:
+ *         BT_t *bt - A pointer to the module object
+ *         uint8_t *macId - The MAC ID of the device
+ *     Returns:
+ *         void
+ */
+void BTReconnectPrefer(BT_t *bt, uint8_t *macId)
+{
+    BTReconnect_t *reconnect = &bt->reconnect;
+    memcpy(reconnect->preferred, macId, BT_MAC_ID_LEN);
+    if (reconnect->pending == 0) {
+        reconnect->scheduled = TimerGetMillis();
+        reconnect->wait = 0;
+    }
+}
+
+/**
+ * BTReconnectSchedule()
+ *     Description:
+ *         Set the time of the next reconnect attempt
+ *     Params:
+ *         BTReconnect_t *reconnect - The reconnect scheduler
+ *         uint32_t now - The current time
+ *         uint8_t backoff - 1 to double the delay first
+ *     Returns:
+ *         void
+ */
+static void BTReconnectSchedule(BTReconnect_t *reconnect, uint32_t now, uint8_t backoff)
+{
+    if (backoff == 1) {
+        if (reconnect->delay < BT_RECONNECT_DELAY_MAX / 2) {
+            reconnect->delay = reconnect->delay * 2;
+        } else {
+            reconnect->delay = BT_RECONNECT_DELAY_MAX;
+        }
+    }
+    // Jitter keeps the attempts from lining up with the phone's own
+    reconnect->seed = (reconnect->seed * 1103515245) + 12345;
+    uint16_t jitter = (reconnect->seed >> 16) % ((reconnect->delay / 4) + 1);
+    reconnect->scheduled = now;
+    reconnect->wait = reconnect->delay + jitter;
+}
+
+/**
+ * BTReconnectProcess()
+ *     Description:
+ *         Make the next reconnect attempt once it is due. An attempt that is
+ *         still in flight by then has failed. While a device is linked with
+ *         other profiles only that device is tried. Otherwise the most likely
+ *         device that has not been tried in this round goes next, and the
+ *         delay doubles after each round.
+ *     Params:
+ *         BT_t *bt - A pointer to the module object
+ *     Returns:
+ *         int8_t - The index of the device that was tried, or -1
+ */
+int8_t BTReconnectProcess(BT_t *bt)
+{
+    BTReconnect_t *reconnect = &bt->reconnect;
+    uint32_t now = TimerGetMillis();
+    uint8_t testMac[BT_MAC_ID_LEN] = {0};
+    int8_t device = -1;
+    uint8_t idx;
+    if (reconnect->status != BT_RECONNECT_STATUS_ACTIVE ||
+        bt->activeDevice.a2dpId != 0 ||
+        (now - reconnect->scheduled) < reconnect->wait
+    ) {
+        return -1;
+    }
+    if (reconnect->pending == 1) {
+        BTPairedDeviceSetResult(bt, reconnect->macId, 0);
+        reconnect->pending = 0;
+    }
+    if (bt->pairedDevicesCount == 0) {
+        // Nothing to try until the devices are loaded or listed
+        BTReconnectSchedule(reconnect, now, 0);
+        return -1;
+    }
+    if (bt->activeDevice.deviceId != 0) {
+        // Other profiles are still up, so A2DP goes to the same device
+        if (bt->type == BT_BTM_TYPE_BC127) {
+            BC127CommandProfileOpen(bt, "A2DP");
+        } else {
+            for (idx = 0; idx < bt->pairedDevicesCount; idx++) {
+                if (memcmp(bt->pairedDevices[idx].macId, bt->activeDevice.macId, BT_MAC_ID_LEN) == 0) {
+                    device = idx;
+                }
+            }
+            if (device == -1) {
+                // Never link back to another phone while this one is linked
+                BTReconnectSchedule(reconnect, now, 1);
+                return -1;
+            }
+            BTCommandConnect(bt, &bt->pairedDevices[device]);
+        }
+        LogDebug(
+            LOG_SOURCE_BT,
+            "BT: Reconnect attempt %u to the linked device",
+            reconnect->attempts + 1
+        );
+        memcpy(reconnect->macId, bt->activeDevice.macId, BT_MAC_ID_LEN);
+        reconnect->pending = 1;
+        reconnect->attempts++;
+        BTReconnectSchedule(reconnect, now, 1);
+        return device;
     }
+    if (memcmp(reconnect->preferred, testMac, BT_MAC_ID_LEN) != 0) {
+        for (idx = 0; idx < bt->pairedDevicesCount; idx++) {
+            if (memcmp(bt->pairedDevices[idx].macId, reconnect->preferred, BT_MAC_ID_LEN) == 0) {
+                device = idx;
+            }
+        }
+        memset(reconnect->preferred, 0, BT_MAC_ID_LEN);
+    }
+    if (device == -1) {
+        uint8_t rank = 0;
+        int8_t likely = BTPairedDeviceGetLikely(bt, rank);
+        while (likely != -1 && (reconnect->tried & (1 << likely)) != 0) {
+            likely = BTPairedDeviceGetLikely(bt, ++rank);
+        }
+        device = likely;
+    }
+    if (device != -1) {
+        BTPairedDevice_t *dev = &bt->pairedDevices[device];
+        LogDebug(
+            LOG_SOURCE_BT,
+            "BT: Reconnect attempt %u to device %d",
+            reconnect->attempts + 1,
+            device
+        );
+        BTCommandConnect(bt, dev);
+        memcpy(reconnect->macId, dev->macId, BT_MAC_ID_LEN);
+        reconnect->pending = 1;
+        reconnect->attempts++;
+        reconnect->tried |= 1 << device;
+    }
+    // Back off once every device has had its turn
+    uint8_t allTried = (1 << bt->pairedDevicesCount) - 1;
+    uint8_t backoff = 0;
+    if ((reconnect->tried & allTried) == allTried) {
+        reconnect->tried = 0;
+        backoff = 1;
+    }
+    BTReconnectSchedule(reconnect, now, backoff);
+    return device;
+}
+
+/**
+ * BTReconnectStart()
+ *     Description:
+ *         Start the reconnect scheduler over with fast retries, after a
+ *         link loss or when the ignition comes on
+ *     Params:
+ *         BT_t *bt - A pointer to the module object
+ *         uint16_t delay - The time to wait before the first attempt
+ *     Returns:
+ *         void
+ */
+void BTReconnectStart(BT_t *bt, uint16_t delay)
+{
+    BTReconnect_t *reconnect = &bt->reconnect;
+    uint32_t now = TimerGetMillis();
+    reconnect->status = BT_RECONNECT_STATUS_ACTIVE;
+    reconnect->pending = 0;
+    reconnect->tried = 0;
+    reconnect->attempts = 0;
+    reconnect->delay = BT_RECONNECT_DELAY_MIN;
+    reconnect->start = now;
+    reconnect->scheduled = now;
+    reconnect->wait = delay;
+    reconnect->seed ^= now;
+}
+
+/**
+ * BTReconnectStop()
+ *     Description:
+ *         Stop the reconnect scheduler
+ *     Params:
+ *         BT_t *bt - A pointer to the module object
+ *     Returns:
+ *         void
+ */
+void BTReconnectStop(BT_t *bt)
+{
+    bt->reconnect.status = BT_RECONNECT_STATUS_IDLE;
+    bt->reconnect.pending = 0;
+    memset(bt->reconnect.preferred, 0, BT_MAC_ID_LEN);
 }
@@ -14,6 +14,10 @@
 #include "uart.h"
 
 BT_t BTInit();
+void BTBrowseEnterItem(BT_t *, uint16_t);
+void BTBrowseOpen(BT_t *, uint8_t);
+void BTBrowseSetPosition(BT_t *, uint16_t);
+void BTBrowseUp(BT_t *);
 void BTCommandCallAccept(BT_t *);
 void BTCommandCallEnd(BT_t *);
 void BTCommandDial(BT_t *, const char *, const char *);
@@ -36,4 +40,9 @@ void BTCommandSetDiscoverable(BT_t *, unsigned char);
 void BTCommandToggleVoiceRecognition(BT_t *);
 uint8_t BTHasActiveMacId(BT_t *);
 void BTProcess(BT_t *);
+void BTReconnectConnected(BT_t *);
+void BTReconnectPrefer(BT_t *, uint8_t *);
+int8_t BTReconnectProcess(BT_t *);
+void BTReconnectStart(BT_t *, uint16_t);
+void BTReconnectStop(BT_t *);
 #endif /* BT_H */
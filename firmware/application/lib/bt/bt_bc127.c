@@ -38,6 +38,42 @@ int8_t BTBC127MicGainTable[] = {
     39 // Technically 39.5 - D6
 };
 
+/* The event names, indexed by their BC127_EVENT_* identifier */
+static const char *BC127_EVENT_NAMES[BC127_EVENT_COUNT] = {
+    "A2DP_STREAM_SUSPEND",
+    "ABS_VOL",
+    "AT",
+    "AVRCP_MEDIA",
+    "AVRCP_PLAY",
+    "AVRCP_PAUSE",
+    "AVRCP_STOP",
+    "Build:",
+    "CALL_ACTIVE",
+    "CALL_END",
+    "CALL_INCOMING",
+    "CALL_OUTGOING",
+    "CLOSE_OK",
+    "LINK",
+    "LIST",
+    "NAME",
+    "OPEN_ERROR",
+    "OPEN_OK",
+    "SCO_CLOSE",
+    "SCO_OPEN",
+    "STATE",
+    "OK",
+    "ERROR"
+};
+
+/* Open-addressed hash table of event identifiers + 1, 0 marks an empty slot */
+static uint8_t BC127_EVENT_TABLE[BC127_EVENT_TABLE_SIZE];
+static uint32_t BC127_EVENT_HASHES[BC127_EVENT_COUNT];
+static uint8_t BC127_EVENT_TABLE_READY = 0;
+
+/* Outstanding commands, ordered oldest first */
+static BC127TXCommand_t BC127_TX_QUEUE[BC127_TX_QUEUE_SIZE];
+static uint8_t BC127_TX_QUEUE_COUNT = 0;
+
 /**
  * BC127ClearPairingErrors()
  *     Description:
@@ -509,6 +545,28 @@ void BC127CommandPause(BT_t *bt)
     }
 }
 
+/**
+ * BC127CommandPhonebookPull()
+ *     Description:
+ *         Pull the phonebook of the currently selected device over PBAP and
+ *         store it in the EEPROM as it arrives
+ *     Params:
+ *         BT_t *bt - A pointer to the module object
+ *     Returns:
+ *         void
+ */
+void BC127CommandPhonebookPull(BT_t *bt)
+{
+    if (bt->activeDevice.pbapId != 0) {
+        char command[32];
+        snprintf(command, 32, "PB_PULL %d 3 1 5 0 87", bt->activeDevice.pbapId);
+        PhonebookSyncStart(bt->activeDevice.macId);
+        BC127SendCommand(bt, command);
+    } else {
+        LogWarning("BT: Unable to PB_PULL - PBAP link unopened");
+    }
+}
+
 /**
  * BC127CommandPlay()
  *     Description:
@@ -1048,6 +1106,7 @@ void BC127CommandUnpair(BT_t *bt)
 {
     char command[7] = "UNPAIR";
     BC127SendCommand(bt, command);
+    BTPairedDevicesErase(bt);
 }
 
 /**
@@ -1120,6 +1179,53 @@ uint8_t BC127GetDeviceId(char *str)
     return UtilsStrToInt(deviceIdStr);
 }
 
+/**
+ * BC127GetEventId()
+ *     Description:
+ *         Look up the event identifier for the first token of a message.
+ *         The hash table is built on first use; a hash hit is confirmed with
+ *         a single string compare.
+ *     Params:
+ *         const char *command - The first token of the message
+ *         uint32_t hash - UtilsHashBytes() of the token
+ *     Returns:
+ *         uint8_t - The BC127_EVENT_* identifier or BC127_EVENT_UNKNOWN
+ */
+uint8_t BC127GetEventId(const char *command, uint32_t hash)
+{
+    uint8_t slot;
+    if (BC127_EVENT_TABLE_READY == 0) {
+        uint8_t eventId;
+        memset(BC127_EVENT_TABLE, 0, sizeof(BC127_EVENT_TABLE));
+        for (eventId = 0; eventId < BC127_EVENT_COUNT; eventId++) {
+            const char *name = BC127_EVENT_NAMES[eventId];
+            uint32_t eventHash = UtilsHashBytes(
+                UTILS_HASH_SEED,
+                (const uint8_t *) name,
+                strlen(name)
+            );
+            BC127_EVENT_HASHES[eventId] = eventHash;
+            slot = eventHash & (BC127_EVENT_TABLE_SIZE - 1);
+            while (BC127_EVENT_TABLE[slot] != 0) {
+                slot = (slot + 1) & (BC127_EVENT_TABLE_SIZE - 1);
+            }
+            BC127_EVENT_TABLE[slot] = eventId + 1;
+        }
+        BC127_EVENT_TABLE_READY = 1;
+    }
+    slot = hash & (BC127_EVENT_TABLE_SIZE - 1);
+    while (BC127_EVENT_TABLE[slot] != 0) {
+        uint8_t eventId = BC127_EVENT_TABLE[slot] - 1;
+        if (BC127_EVENT_HASHES[eventId] == hash &&
+            strcmp(BC127_EVENT_NAMES[eventId], command) == 0
+        ) {
+            return eventId;
+        }
+        slot = (slot + 1) & (BC127_EVENT_TABLE_SIZE - 1);
+    }
+    return BC127_EVENT_UNKNOWN;
+}
+
 /**
  * BC127ProcessEventA2DPStreamSuspend()
  *     Description:
@@ -1292,14 +1398,15 @@ void BC127ProcessEventAT(BT_t *bt, char **msgBuf, uint8_t delimCount)
  *     Params:
  *         BT_t *bt - A pointer to the module object
  *         char **msgBuf - The message buffer split into an array using spaces as the delimiter
+ *         char *value - The metadata value, which is empty if none was sent
  *     Returns:
  *         void
  */
-void BC127ProcessEventAVRCPMedia(BT_t *bt, char **msgBuf, char *msg)
+void BC127ProcessEventAVRCPMedia(BT_t *bt, char **msgBuf, char *value)
 {
     if (strcmp(msgBuf[2], "TITLE:") == 0) {
         char title[BT_METADATA_MAX_SIZE] = {0};
-        UtilsNormalizeText(title, &msg[BC127_METADATA_TITLE_OFFSET], BT_METADATA_MAX_SIZE);
+        UtilsNormalizeText(title, value, BT_METADATA_MAX_SIZE);
         if(strncmp(bt->title, title, BT_METADATA_FIELD_SIZE - 1) != 0) {
             bt->metadataStatus = BT_METADATA_STATUS_UPD;
             memset(bt->title, 0, BT_METADATA_FIELD_SIZE);
@@ -1309,7 +1416,7 @@ void BC127ProcessEventAVRCPMedia(BT_t *bt, char **msgBuf, char *msg)
         }
     } else if (strcmp(msgBuf[2], "ARTIST:") == 0) {
         char artist[BT_METADATA_MAX_SIZE] = {0};
-        UtilsNormalizeText(artist, &msg[BC127_METADATA_ARTIST_OFFSET], BT_METADATA_MAX_SIZE);
+        UtilsNormalizeText(artist, value, BT_METADATA_MAX_SIZE);
         if(strncmp(bt->artist, artist, BT_METADATA_FIELD_SIZE - 1) != 0) {
             bt->metadataStatus = BT_METADATA_STATUS_UPD;
             memset(bt->artist, 0, BT_METADATA_FIELD_SIZE);
@@ -1318,7 +1425,7 @@ void BC127ProcessEventAVRCPMedia(BT_t *bt, char **msgBuf, char *msg)
     } else {
         if (strcmp(msgBuf[2], "ALBUM:") == 0) {
             char album[BT_METADATA_MAX_SIZE] = {0};
-            UtilsNormalizeText(album, &msg[BC127_METADATA_ALBUM_OFFSET], BT_METADATA_MAX_SIZE);
+            UtilsNormalizeText(album, value, BT_METADATA_MAX_SIZE);
             if(strncmp(bt->album, album, BT_METADATA_FIELD_SIZE - 1) != 0) {
                 bt->metadataStatus = BT_METADATA_STATUS_UPD;
                 memset(bt->album, 0, BT_METADATA_FIELD_SIZE);
@@ -1537,6 +1644,9 @@ void BC127ProcessEventList(BT_t *bt, char **msgBuf)
     // Request the device name. Note that the name will only be returned
     // if the device is in range
     LogDebug(LOG_SOURCE_BT, "BT: Paired Device %s", msgBuf[1]);
+    uint8_t macId[BT_MAC_ID_LEN] = {0};
+    BC127ConvertMACIDToHex(msgBuf[1], macId);
+    BTPairedDeviceConfirm(bt, macId);
     BC127CommandGetDeviceName(bt, msgBuf[1]);
 }
 
@@ -1555,7 +1665,8 @@ void BC127ProcessEventName(BT_t *bt, char **msgBuf, char *msg)
     char deviceName[BT_DEVICE_NAME_LEN] = {0};
     uint8_t idx;
     uint8_t strIdx = 0;
-    uint8_t nameLen = strlen(msg);
+    // The message is split in place up to msgBuf[2], so measure from there
+    uint8_t nameLen = (msgBuf[2] - msg) + strlen(msgBuf[2]);
     if (nameLen > BC127_DEVICE_NAME_OFFSET) {
         for (idx = 0; idx < nameLen - BC127_DEVICE_NAME_OFFSET; idx++) {
             char c = msg[idx + BC127_DEVICE_NAME_OFFSET];
@@ -1725,6 +1836,144 @@ void BC127ProcessEventState(BT_t *bt, char **msgBuf)
     }
 }
 
+/**
+ * BC127TXQueueComplete()
+ *     Description:
+ *         Remove a command from the outstanding command table and notify
+ *         BT_EVENT_COMMAND_COMPLETE listeners of the outcome
+ *     Params:
+ *         uint8_t idx - The index of the command in the table
+ *         uint8_t status - The BC127_TX_STATUS_* outcome
+ *     Returns:
+ *         void
+ */
+static void BC127TXQueueComplete(uint8_t idx, uint8_t status)
+{
+    BC127TXCommand_t command = BC127_TX_QUEUE[idx];
+    BC127_TX_QUEUE_COUNT--;
+    if (idx < BC127_TX_QUEUE_COUNT) {
+        memmove(
+            &BC127_TX_QUEUE[idx],
+            &BC127_TX_QUEUE[idx + 1],
+            (BC127_TX_QUEUE_COUNT - idx) * sizeof(BC127TXCommand_t)
+        );
+    }
+    uint32_t latency = TimerGetMillis() - command.timestamp;
+    if (latency > 0xFFFF) {
+        latency = 0xFFFF;
+    }
+    BC127CommandResult_t result = {command.command, status, latency};
+    if (status == BC127_TX_STATUS_OK) {
+        LogDebug(LOG_SOURCE_BT, "BT: '%s' OK in %ums", command.command, result.latency);
+    } else if (status == BC127_TX_STATUS_ERROR) {
+        LogWarning("BT: '%s' failed after %ums", command.command, result.latency);
+    } else {
+        LogWarning("BT: '%s' timed out", command.command);
+    }
+    EventTriggerCallback(BT_EVENT_COMMAND_COMPLETE, (uint8_t *) &result);
+}
+
+/**
+ * BC127ProcessCommandResponse()
+ *     Description:
+ *         Complete the oldest in-flight command that expects the given kind
+ *         of response. The BC127 replies to commands in the order it
+ *         receives them.
+ *     Params:
+ *         uint8_t response - BC127_TX_RESPONSE_OK or BC127_TX_RESPONSE_OPEN
+ *         uint8_t status - The BC127_TX_STATUS_* outcome
+ *     Returns:
+ *         void
+ */
+void BC127ProcessCommandResponse(uint8_t response, uint8_t status)
+{
+    uint8_t idx;
+    for (idx = 0; idx < BC127_TX_QUEUE_COUNT; idx++) {
+        if (BC127_TX_QUEUE[idx].state == BC127_TX_STATE_IN_FLIGHT &&
+            BC127_TX_QUEUE[idx].response == response
+        ) {
+            BC127TXQueueComplete(idx, status);
+            return;
+        }
+    }
+}
+
+/**
+ * BC127ProcessTXQueue()
+ *     Description:
+ *         Time out commands that never got a reply, and send the next queued
+ *         OPEN once no other OPEN is in flight. The BC127 does not handle
+ *         overlapping profile connection requests reliably.
+ *     Params:
+ *         BT_t *bt - A pointer to the module object
+ *     Returns:
+ *         void
+ */
+void BC127ProcessTXQueue(BT_t *bt)
+{
+    uint32_t now = TimerGetMillis();
+    uint8_t openInFlight = 0;
+    uint8_t idx = 0;
+    while (idx < BC127_TX_QUEUE_COUNT) {
+        BC127TXCommand_t *command = &BC127_TX_QUEUE[idx];
+        if (command->state == BC127_TX_STATE_IN_FLIGHT) {
+            uint16_t timeout = BC127_TX_TIMEOUT;
+            if (command->response == BC127_TX_RESPONSE_OPEN) {
+                timeout = BC127_TX_OPEN_TIMEOUT;
+            }
+            if ((now - command->timestamp) > timeout) {
+                // Completing the command shifts the table down
+                BC127TXQueueComplete(idx, BC127_TX_STATUS_TIMEOUT);
+                continue;
+            }
+            if (command->response == BC127_TX_RESPONSE_OPEN) {
+                openInFlight = 1;
+            }
+        } else if (openInFlight == 0) {
+            LogDebug(LOG_SOURCE_BT, "BT: W: '%s'", command->command);
+            command->state = BC127_TX_STATE_IN_FLIGHT;
+            command->timestamp = now;
+            TraceRecord(
+                TRACE_POINT_BT_TX,
+                0,
+                ((uint16_t) command->command[0] << 8) | command->command[1]
+            );
+            UARTSendData(
+                &bt->uart,
+                (unsigned char *) command->command,
+                strlen(command->command)
+            );
+            UARTSendChar(&bt->uart, BC127_MSG_END_CHAR);
+            openInFlight = 1;
+        }
+        idx++;
+    }
+}
+
+/**
+ * BC127ProcessJoinTokens()
+ *     Description:
+ *         Undo the in-place split of a message from the given token onward,
+ *         for handlers that read free-form text out of the raw message.
+ *         Tokens before the given one stay null terminated.
+ *     Params:
+ *         char *msg - The message
+ *         char *token - The first token to rejoin
+ *         uint16_t messageLength - The message length, including the terminator
+ *     Returns:
+ *         void
+ */
+static void BC127ProcessJoinTokens(char *msg, char *token, uint16_t messageLength)
+{
+    char *end = &msg[messageLength - 1];
+    while (token < end) {
+        if (*token == '\0') {
+            *token = BC127_MSG_DELIMETER;
+        }
+        token++;
+    }
+}
+
 /**
  * BC127Process()
  *     Description:
@@ -1736,6 +1985,8 @@ void BC127ProcessEventState(BT_t *bt, char **msgBuf)
  */
 void BC127Process(BT_t *bt)
 {
+    BC127ProcessTXQueue(bt);
+    UARTRXDrainIdle(&bt->uart);
     uint16_t messageLength = CharQueueSeek(&bt->uart.rxQueue, BC127_MSG_END_CHAR);
     if (messageLength > 0) {
         // We received a valid message, so set the power & state to on
@@ -1743,75 +1994,164 @@ void BC127Process(BT_t *bt)
         char msg[messageLength];
         uint16_t i;
         uint16_t delimCount = 1;
+        // Hash the first token as it is copied out of the queue, so the
+        // event lookup does not depend on its position in the event list
+        uint32_t commandHash = UTILS_HASH_SEED;
+        uint8_t commandState = 0;
         for (i = 0; i < messageLength; i++) {
             char c = CharQueueNext(&bt->uart.rxQueue);
             if (c == BC127_MSG_DELIMETER) {
                 delimCount++;
+                if (commandState == 1) {
+                    commandState = 2;
+                }
             }
             if (c != BC127_MSG_END_CHAR) {
                 msg[i] = c;
+                if (commandState < 2 && c != BC127_MSG_DELIMETER) {
+                    commandHash = UtilsHashBytes(commandHash, (uint8_t *) &c, 1);
+                    commandState = 1;
+                }
             } else {
                 // The protocol states that 0x0D delimits messages,
                 // so we change it to a null terminator instead
                 msg[i] = '\0';
             }
         }
-        // Copy the message, since strtok adds a null terminator after the first
-        // occurence of the delimiter, causes issues with any functions used going forward
-        char tmpMsg[messageLength];
-        strcpy(tmpMsg, msg);
+        LogDebug(LOG_SOURCE_BT, "BT: R: '%s'", msg);
+        // Messages are delimited rather than framed, so the arrival of the
+        // last burst on an empty queue stands in for the start of this one
+        TraceRecordAt(bt->uart.rxTimestamp, TRACE_POINT_UART_RX, BT_UART_MODULE, 0);
+        if (messageLength > 1) {
+            TraceRecord(
+                TRACE_POINT_BT_RX,
+                0,
+                ((uint16_t) msg[0] << 8) | (uint8_t) msg[1]
+            );
+        }
+        // Split the message in place. Unused entries point at the terminator
+        // so that handlers reading past the last token see an empty string.
         char *msgBuf[delimCount];
-        char delimeter[] = " ";
-        char *p = strtok(tmpMsg, delimeter);
-        i = 0;
-        while (p != 0x00) {
-            msgBuf[i++] = p;
-            p = strtok(0x00, delimeter);
+        uint16_t tokenCount = 0;
+        uint8_t inToken = 0;
+        for (i = 0; i < messageLength - 1; i++) {
+            if (msg[i] == BC127_MSG_DELIMETER) {
+                msg[i] = '\0';
+                inToken = 0;
+            } else if (inToken == 0 && msg[i] != '\0') {
+                msgBuf[tokenCount++] = &msg[i];
+                inToken = 1;
+            }
         }
-        LogDebug(LOG_SOURCE_BT, "BT: R: '%s'", msg);
-        if (strcmp(msgBuf[0], "A2DP_STREAM_SUSPEND") == 0) {
-            BC127ProcessEventA2DPStreamSuspend(bt, msgBuf);
-        } else if (strcmp(msgBuf[0], "ABS_VOL") == 0) {
-            BC127ProcessEventAbsVol(bt, msgBuf);
-        } else if (strcmp(msgBuf[0], "AT") == 0) {
-            BC127ProcessEventAT(bt, msgBuf, delimCount);
-        } else if (strcmp(msgBuf[0], "AVRCP_MEDIA") == 0) {
-            BC127ProcessEventAVRCPMedia(bt, msgBuf, msg);
-        } else if (strcmp(msgBuf[0], "AVRCP_PLAY") == 0) {
-            BC127ProcessEventAVRCPPlay(bt, msgBuf);
-        } else if (strcmp(msgBuf[0], "AVRCP_PAUSE") == 0) {
-            BC127ProcessEventAVRCPPause(bt, msgBuf);
-        } else if (strcmp(msgBuf[0], "AVRCP_STOP") == 0) {
-            BC127ProcessEventAVRCPPause(bt, msgBuf);
-        } else if (strcmp(msgBuf[0], "Build:") == 0) {
-            BC127ProcessEventBuild(bt, msgBuf);
-        } else if (strcmp(msgBuf[0], "CALL_ACTIVE") == 0) {
-            BC127ProcessEventCall(bt, (uint8_t)BT_CALL_ACTIVE);
-        } else if (strcmp(msgBuf[0], "CALL_END") == 0) {
-            BC127ProcessEventCall(bt, (uint8_t)BT_CALL_INACTIVE);
-        } else if (strcmp(msgBuf[0], "CALL_INCOMING") == 0) {
-            BC127ProcessEventCall(bt, (uint8_t)BT_CALL_INCOMING);
-        } else if (strcmp(msgBuf[0], "CALL_OUTGOING") == 0) {
-            BC127ProcessEventCall(bt, (uint8_t)BT_CALL_OUTGOING);
-        } else if (strcmp(msgBuf[0], "CLOSE_OK") == 0) {
-            BC127ProcessEventCloseOk(bt, msgBuf);
-        } else if (strcmp(msgBuf[0], "LINK") == 0) {
-            BC127ProcessEventLink(bt, msgBuf);
-        } else if (strcmp(msgBuf[0], "LIST") == 0) {
-            BC127ProcessEventList(bt, msgBuf);
-        } else if (strcmp(msgBuf[0], "NAME") == 0) {
-            BC127ProcessEventName(bt, msgBuf, msg);
-        } else if (strcmp(msgBuf[0], "OPEN_ERROR") == 0) {
-            BC127ProcessEventOpenError(bt, msgBuf);
-        } else if (strcmp(msgBuf[0], "OPEN_OK") == 0) {
-            BC127ProcessEventOpenOk(bt, msgBuf);
-        } else if (strcmp(msgBuf[0], "SCO_CLOSE") == 0) {
-            BC127ProcessEventSCO(bt, (uint8_t)BT_CALL_SCO_CLOSE);
-        } else if (strcmp(msgBuf[0], "SCO_OPEN") == 0) {
-            BC127ProcessEventSCO(bt, (uint8_t)BT_CALL_SCO_OPEN);
-        } else if (strcmp(msgBuf[0], "STATE") == 0) {
-            BC127ProcessEventState(bt, msgBuf);
+        for (i = tokenCount; i < delimCount; i++) {
+            msgBuf[i] = &msg[messageLength - 1];
         }
+        switch (BC127GetEventId(msgBuf[0], commandHash)) {
+            case BC127_EVENT_A2DP_STREAM_SUSPEND:
+                BC127ProcessEventA2DPStreamSuspend(bt, msgBuf);
+                break;
+            case BC127_EVENT_ABS_VOL:
+                BC127ProcessEventAbsVol(bt, msgBuf);
+                break;
+            case BC127_EVENT_AT:
+                BC127ProcessEventAT(bt, msgBuf, delimCount);
+                break;
+            case BC127_EVENT_AVRCP_MEDIA:
+                // The metadata value runs to the end of the raw message. It
+                // may be empty, in which case there is no fourth token.
+                if (delimCount >= 3) {
+                    char *value = &msg[messageLength - 1];
+                    if (delimCount >= 4) {
+                        value = msgBuf[3];
+                        BC127ProcessJoinTokens(msg, value, messageLength);
+                    }
+                    BC127ProcessEventAVRCPMedia(bt, msgBuf, value);
+                }
+                break;
+            case BC127_EVENT_AVRCP_PLAY:
+                BC127ProcessEventAVRCPPlay(bt, msgBuf);
+                break;
+            case BC127_EVENT_AVRCP_PAUSE:
+            case BC127_EVENT_AVRCP_STOP:
+                BC127ProcessEventAVRCPPause(bt, msgBuf);
+                break;
+            case BC127_EVENT_BUILD:
+                BC127ProcessEventBuild(bt, msgBuf);
+                break;
+            case BC127_EVENT_CALL_ACTIVE:
+                BC127ProcessEventCall(bt, (uint8_t)BT_CALL_ACTIVE);
+                break;
+            case BC127_EVENT_CALL_END:
+                BC127ProcessEventCall(bt, (uint8_t)BT_CALL_INACTIVE);
+                break;
+            case BC127_EVENT_CALL_INCOMING:
+                BC127ProcessEventCall(bt, (uint8_t)BT_CALL_INCOMING);
+                break;
+            case BC127_EVENT_CALL_OUTGOING:
+                BC127ProcessEventCall(bt, (uint8_t)BT_CALL_OUTGOING);
+                break;
+            case BC127_EVENT_CLOSE_OK:
+                BC127ProcessEventCloseOk(bt, msgBuf);
+                break;
+            case BC127_EVENT_LINK:
+                BC127ProcessEventLink(bt, msgBuf);
+                break;
+            case BC127_EVENT_LIST:
+                BC127ProcessEventList(bt, msgBuf);
+                break;
+            case BC127_EVENT_NAME:
+                // The device name is read from the raw message
+                if (delimCount >= 3) {
+                    BC127ProcessJoinTokens(msg, msgBuf[2], messageLength);
+                    BC127ProcessEventName(bt, msgBuf, msg);
+                }
+                break;
+            case BC127_EVENT_OPEN_ERROR:
+                BC127ProcessEventOpenError(bt, msgBuf);
+                BC127ProcessCommandResponse(
+                    BC127_TX_RESPONSE_OPEN,
+                    BC127_TX_STATUS_ERROR
+                );
+                break;
+            case BC127_EVENT_OPEN_OK:
+                BC127ProcessEventOpenOk(bt, msgBuf);
+                BC127ProcessCommandResponse(
+                    BC127_TX_RESPONSE_OPEN,
+                    BC127_TX_STATUS_OK
+                );
+                break;
+            case BC127_EVENT_SCO_CLOSE:
+                BC127ProcessEventSCO(bt, (uint8_t)BT_CALL_SCO_CLOSE);
+                break;
+            case BC127_EVENT_SCO_OPEN:
+                BC127ProcessEventSCO(bt, (uint8_t)BT_CALL_SCO_OPEN);
+                break;
+            case BC127_EVENT_STATE:
+                BC127ProcessEventState(bt, msgBuf);
+                break;
+            case BC127_EVENT_OK:
+                BC127ProcessCommandResponse(
+                    BC127_TX_RESPONSE_OK,
+                    BC127_TX_STATUS_OK
+                );
+                break;
+            case BC127_EVENT_ERROR:
+                BC127ProcessCommandResponse(
+                    BC127_TX_RESPONSE_OK,
+                    BC127_TX_STATUS_ERROR
+                );
+                break;
+            default:
+                // Phonebook pulls stream the vCards as plain lines
+                if (PhonebookSyncIsActive() == 1) {
+                    BC127ProcessJoinTokens(msg, msg, messageLength);
+                    PhonebookSyncFeed(msg, messageLength - 1);
+                    PhonebookSyncFeed("\r", 1);
+                }
+                break;
+        }
+        // An OPEN may be waiting on the one that just completed
+        BC127ProcessTXQueue(bt);
         // Reset the age of the Rx queue
         bt->rxQueueAge = 0;
     } else if (CharQueueGetSize(&bt->uart.rxQueue) > 0) {
@@ -1831,7 +2171,9 @@ void BC127Process(BT_t *bt)
 /**
  * BC127SendCommand()
  *     Description:
- *         Send data over UART
+ *         Send a command over UART and record it in the outstanding command
+ *         table so its reply can be matched to it. An OPEN is held back
+ *         while another OPEN is outstanding.
  *     Params:
  *         BT_t *bt - A pointer to the module object
  *         char *command - A command to send, with null termination included
@@ -1840,16 +2182,42 @@ void BC127Process(BT_t *bt)
  */
 void BC127SendCommand(BT_t *bt, char *command)
 {
-    LogDebug(LOG_SOURCE_BT, "BT: W: '%s'", command);
-    uint8_t idx = 0;
-    uint16_t cmdLength = strlen(command) + 1;
-    uint8_t data[cmdLength];
-    memset(data, 0, cmdLength);
-    for (idx = 0; idx < strlen(command); idx++) {
-        data[idx] = command[idx];
+    uint8_t response = BC127_TX_RESPONSE_OK;
+    if (strncmp(command, "OPEN ", 5) == 0) {
+        response = BC127_TX_RESPONSE_OPEN;
+    }
+    uint8_t queued = 0;
+    if (BC127_TX_QUEUE_COUNT == BC127_TX_QUEUE_SIZE) {
+        LogWarning("BT: Command table full, sending '%s' untracked", command);
+    } else {
+        BC127TXCommand_t *entry = &BC127_TX_QUEUE[BC127_TX_QUEUE_COUNT++];
+        UtilsStrncpy(entry->command, command, BC127_TX_COMMAND_SIZE);
+        entry->state = BC127_TX_STATE_IN_FLIGHT;
+        entry->response = response;
+        entry->timestamp = TimerGetMillis();
+        if (response == BC127_TX_RESPONSE_OPEN) {
+            // Only one OPEN may be outstanding, so queue it behind any other
+            uint8_t idx;
+            for (idx = 0; idx < BC127_TX_QUEUE_COUNT - 1; idx++) {
+                if (BC127_TX_QUEUE[idx].response == BC127_TX_RESPONSE_OPEN) {
+                    entry->state = BC127_TX_STATE_QUEUED;
+                    queued = 1;
+                    LogDebug(LOG_SOURCE_BT, "BT: Q: '%s'", command);
+                    break;
+                }
+            }
+        }
+    }
+    if (queued == 0) {
+        LogDebug(LOG_SOURCE_BT, "BT: W: '%s'", command);
+        TraceRecord(
+            TRACE_POINT_BT_TX,
+            0,
+            ((uint16_t) command[0] << 8) | command[1]
+        );
+        UARTSendData(&bt->uart, (unsigned char *) command, strlen(command));
+        UARTSendChar(&bt->uart, BC127_MSG_END_CHAR);
     }
-    data[idx++] = BC127_MSG_END_CHAR;
-    UARTSendData(&bt->uart, data, cmdLength);
 }
 
 /**
@@ -11,6 +11,7 @@
 #include <stdio.h>
 #include "../../mappings.h"
 #include "../log.h"
+#include "../phonebook.h"
 #include "../event.h"
 #include "../timer.h"
 #include "../uart.h"
@@ -24,9 +25,6 @@
 #define BC127_DEVICE_NAME_OFFSET 19
 #define BC127_MAX_DEVICE_PAIRED 8
 #define BC127_MAX_DEVICE_PROFILES 5
-#define BC127_METADATA_TITLE_OFFSET 22
-#define BC127_METADATA_ARTIST_OFFSET 23
-#define BC127_METADATA_ALBUM_OFFSET 22
 #define BC127_MSG_END_CHAR 0x0D
 #define BC127_MSG_LF_CHAR 0x0A
 #define BC127_MSG_DELIMETER 0x20
@@ -44,6 +42,81 @@
 #define BC127_AT_DATE_HOUR 3
 #define BC127_AT_DATE_MIN 4
 #define BC127_AT_DATE_SEC 5
+#define BC127_EVENT_A2DP_STREAM_SUSPEND 0
+#define BC127_EVENT_ABS_VOL 1
+#define BC127_EVENT_AT 2
+#define BC127_EVENT_AVRCP_MEDIA 3
+#define BC127_EVENT_AVRCP_PLAY 4
+#define BC127_EVENT_AVRCP_PAUSE 5
+#define BC127_EVENT_AVRCP_STOP 6
+#define BC127_EVENT_BUILD 7
+#define BC127_EVENT_CALL_ACTIVE 8
+#define BC127_EVENT_CALL_END 9
+#define BC127_EVENT_CALL_INCOMING 10
+#define BC127_EVENT_CALL_OUTGOING 11
+#define BC127_EVENT_CLOSE_OK 12
+#define BC127_EVENT_LINK 13
+#define BC127_EVENT_LIST 14
+#define BC127_EVENT_NAME 15
+#define BC127_EVENT_OPEN_ERROR 16
+#define BC127_EVENT_OPEN_OK 17
+#define BC127_EVENT_SCO_CLOSE 18
+#define BC127_EVENT_SCO_OPEN 19
+#define BC127_EVENT_STATE 20
+#define BC127_EVENT_OK 21
+#define BC127_EVENT_ERROR 22
+#define BC127_EVENT_COUNT 23
+#define BC127_EVENT_UNKNOWN 0xFF
+// Must be a power of two, larger than BC127_EVENT_COUNT
+#define BC127_EVENT_TABLE_SIZE 32
+
+#define BC127_TX_QUEUE_SIZE 8
+#define BC127_TX_COMMAND_SIZE 32
+#define BC127_TX_TIMEOUT 1000
+// Opening a profile can take a while if the phone prompts the user
+#define BC127_TX_OPEN_TIMEOUT 10000
+#define BC127_TX_STATE_QUEUED 0
+#define BC127_TX_STATE_IN_FLIGHT 1
+#define BC127_TX_RESPONSE_OK 0
+#define BC127_TX_RESPONSE_OPEN 1
+#define BC127_TX_STATUS_OK 0
+#define BC127_TX_STATUS_ERROR 1
+#define BC127_TX_STATUS_TIMEOUT 2
+
+/**
+ * BC127TXCommand_t
+ *     Description:
+ *         A command sent to the BC127 that is waiting for its reply, or a
+ *         command that has to wait for an earlier one of its kind to finish
+ *     Fields:
+ *         command - The command text, truncated to fit
+ *         state - BC127_TX_STATE_QUEUED or BC127_TX_STATE_IN_FLIGHT
+ *         response - BC127_TX_RESPONSE_OK if the command completes with OK
+ *             or ERROR, BC127_TX_RESPONSE_OPEN for OPEN_OK or OPEN_ERROR
+ *         timestamp - When the command was written to the UART
+ */
+typedef struct BC127TXCommand_t {
+    char command[BC127_TX_COMMAND_SIZE];
+    uint8_t state;
+    uint8_t response;
+    uint32_t timestamp;
+} BC127TXCommand_t;
+
+/**
+ * BC127CommandResult_t
+ *     Description:
+ *         Passed to BT_EVENT_COMMAND_COMPLETE listeners
+ *     Fields:
+ *         command - The command text, truncated to BC127_TX_COMMAND_SIZE
+ *         status - BC127_TX_STATUS_OK, BC127_TX_STATUS_ERROR or
+ *             BC127_TX_STATUS_TIMEOUT
+ *         latency - Time from sending the command to its reply, in ms
+ */
+typedef struct BC127CommandResult_t {
+    char *command;
+    uint8_t status;
+    uint16_t latency;
+} BC127CommandResult_t;
 
 extern int8_t BTBC127MicGainTable[];
 
@@ -73,6 +146,7 @@ void BC127CommandGetMetadata(BT_t *);
 void BC127CommandLicense(BT_t *, char *, char *);
 void BC127CommandList(BT_t *);
 void BC127CommandPause(BT_t *);
+void BC127CommandPhonebookPull(BT_t *);
 void BC127CommandPlay(BT_t *);
 void BC127CommandProfileClose(BT_t *, uint8_t);
 void BC127CommandProfileOpen(BT_t *, char *);
@@ -101,6 +175,7 @@ void BC127CommandVolume(BT_t *, uint8_t, char *);
 void BC127CommandWrite(BT_t *);
 uint8_t BC127GetConnectedDeviceCount(BT_t *);
 uint8_t BC127GetDeviceId(char *);
+uint8_t BC127GetEventId(const char *, uint32_t);
 void BC127ProcessEventA2DPStreamSuspend(BT_t *, char **);
 void BC127ProcessEventAbsVol(BT_t *, char **);
 void BC127ProcessEventAT(BT_t *, char **, uint8_t);
@@ -119,6 +194,8 @@ void BC127ProcessEventOpenOk(BT_t *, char **);
 void BC127ProcessEventSCO(BT_t *, uint8_t);
 void BC127ProcessEventState(BT_t *, char **);
 void BC127Process(BT_t *);
+void BC127ProcessCommandResponse(uint8_t, uint8_t);
+void BC127ProcessTXQueue(BT_t *);
 void BC127SendCommand(BT_t *, char *);
 void BC127SendCommandEmpty(BT_t *);
 
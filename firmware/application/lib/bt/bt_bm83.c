@@ -26,6 +26,215 @@ int8_t BTBM83MicGainTable[] = {
     46
 };
 
+/* RX frame parser state. Frames are assembled here as bytes arrive. */
+static uint8_t BM83_FRAME_STATE = BM83_FRAME_STATE_START;
+static uint8_t BM83_FRAME_CHECKSUM = 0;
+static uint16_t BM83_FRAME_LENGTH = 0;
+static uint16_t BM83_FRAME_INDEX = 0;
+static uint32_t BM83_FRAME_TIMESTAMP = 0;
+static uint32_t BM83_FRAME_ARRIVAL = 0;
+static uint8_t BM83_FRAME_DATA[BM83_FRAME_BUFFER_SIZE];
+static BM83FrameStats_t BM83_FRAME_STATS;
+
+/* TX queue, ordered oldest first. In-flight commands are always at the front. */
+static BM83TXCommand_t BM83_TX_QUEUE[BM83_TX_QUEUE_SIZE];
+static uint8_t BM83_TX_QUEUE_COUNT = 0;
+static uint8_t BM83_TX_QUEUE_BUSY = 0;
+static BM83CommandStats_t BM83_TX_STATS[BM83_TX_STATS_SIZE];
+static uint8_t BM83_TX_STATS_COUNT = 0;
+
+/**
+ * BM83GetCommandStats()
+ *     Description:
+ *         Get the TX counters for the opcode in the given slot. Slots are
+ *         handed out in the order opcodes are first sent.
+ *     Params:
+ *         uint8_t idx - The stats slot
+ *     Returns:
+ *         BM83CommandStats_t * - A pointer to the counters, or 0 if the
+ *         slot is unused
+ */
+BM83CommandStats_t *BM83GetCommandStats(uint8_t idx)
+{
+    if (idx >= BM83_TX_STATS_COUNT) {
+        return 0;
+    }
+    return &BM83_TX_STATS[idx];
+}
+
+/**
+ * BM83TXStatsGet()
+ *     Description:
+ *         Find the counters for the given opcode, allocating a slot for it
+ *         if it has not been seen yet
+ *     Params:
+ *         uint8_t opcode - The command opcode
+ *     Returns:
+ *         BM83CommandStats_t * - The counters, or 0 if all slots are taken
+ */
+static BM83CommandStats_t *BM83TXStatsGet(uint8_t opcode)
+{
+    uint8_t idx;
+    for (idx = 0; idx < BM83_TX_STATS_COUNT; idx++) {
+        if (BM83_TX_STATS[idx].opcode == opcode) {
+            return &BM83_TX_STATS[idx];
+        }
+    }
+    if (BM83_TX_STATS_COUNT == BM83_TX_STATS_SIZE) {
+        return 0;
+    }
+    BM83CommandStats_t *stats = &BM83_TX_STATS[BM83_TX_STATS_COUNT++];
+    memset(stats, 0, sizeof(BM83CommandStats_t));
+    stats->opcode = opcode;
+    return stats;
+}
+
+/**
+ * BM83TXQueueComplete()
+ *     Description:
+ *         Remove a command from the TX queue, update its counters and notify
+ *         listeners of the outcome
+ *     Params:
+ *         uint8_t idx - The index of the command in the TX queue
+ *         uint8_t status - The ACK status, or BM83_DATA_ACK_STATUS_TIMEOUT
+ *     Returns:
+ *         void
+ */
+static void BM83TXQueueComplete(uint8_t idx, uint8_t status)
+{
+    BM83TXCommand_t *command = &BM83_TX_QUEUE[idx];
+    uint8_t result[2] = {command->data[0], status};
+    BM83CommandStats_t *stats = BM83TXStatsGet(command->data[0]);
+    if (stats != 0) {
+        if (status == BM83_DATA_ACK_STATUS_COMPLETE) {
+            uint32_t latency = TimerGetMillis() - command->firstSent;
+            if (latency > 0xFFFF) {
+                latency = 0xFFFF;
+            }
+            stats->acked++;
+            stats->latencyTotal += latency;
+            if (latency > stats->latencyMax) {
+                stats->latencyMax = latency;
+            }
+        } else {
+            stats->failed++;
+        }
+    }
+    if (status != BM83_DATA_ACK_STATUS_COMPLETE) {
+        LogWarning(
+            "BM83: Command %02X failed with status %02X",
+            command->data[0],
+            status
+        );
+    }
+    BM83_TX_QUEUE_COUNT--;
+    if (idx < BM83_TX_QUEUE_COUNT) {
+        memmove(
+            &BM83_TX_QUEUE[idx],
+            &BM83_TX_QUEUE[idx + 1],
+            (BM83_TX_QUEUE_COUNT - idx) * sizeof(BM83TXCommand_t)
+        );
+    }
+    EventTriggerCallback(BT_EVENT_COMMAND_COMPLETE, result);
+}
+
+/**
+ * BM83TXQueueExpire()
+ *     Description:
+ *         Fail the in-flight commands whose ACK is overdue. They are not sent
+ *         again, since the BM83 may have run a command whose ACK was lost,
+ *         and MMI or volume commands must not run twice.
+ *     Params:
+ *         None
+ *     Returns:
+ *         void
+ */
+static void BM83TXQueueExpire()
+{
+    uint32_t now = TimerGetMillis();
+    uint8_t idx = 0;
+    while (idx < BM83_TX_QUEUE_COUNT) {
+        BM83TXCommand_t *command = &BM83_TX_QUEUE[idx];
+        if (command->state == BM83_TX_STATE_IN_FLIGHT &&
+            (now - command->lastSent) > BM83_TX_ACK_TIMEOUT
+        ) {
+            // Completing the command shifts the queue down
+            BM83TXQueueComplete(idx, BM83_DATA_ACK_STATUS_TIMEOUT);
+            continue;
+        }
+        idx++;
+    }
+}
+
+/**
+ * BM83CommandAVRCPBrowseChangePath()
+ *     Description:
+ *         Move the browsed folder up, or down into the given folder
+ *         (AVRCP_Browsing_Cmd -> 0x41, ChangePath)
+ *     Params:
+ *         BT_t *bt - A pointer to the module object
+ *         uint8_t direction - BM83_AVRCP_DATA_CHANGE_PATH_UP / DOWN
+ *         uint8_t *uid - The folder UID, ignored when moving up
+ *     Returns:
+ *         void
+ */
+void BM83CommandAVRCPBrowseChangePath(BT_t *bt, uint8_t direction, uint8_t *uid)
+{
+    uint8_t command[16] = {
+        BM83_CMD_AVRCP_BROWSING_CMD,
+        bt->activeDevice.deviceId & 0xF, // Linked Database, the lower nibble
+        BM83_AVRCP_PDU_CHANGE_PATH,
+        0x00, // LL
+        0x0B, // LL
+        bt->browse.uidCounter >> 8,
+        bt->browse.uidCounter & 0xFF,
+        direction
+    };
+    if (direction == BM83_AVRCP_DATA_CHANGE_PATH_DOWN) {
+        memcpy(&command[8], uid, BT_BROWSE_UID_LEN);
+    }
+    BM83SendCommand(bt, command, sizeof(command));
+}
+
+/**
+ * BM83CommandAVRCPBrowseGetFolderItems()
+ *     Description:
+ *         Request a range of items from the browsed folder, names only
+ *         (AVRCP_Browsing_Cmd -> 0x41, GetFolderItems)
+ *     Params:
+ *         BT_t *bt - A pointer to the module object
+ *         uint8_t scope - The scope to browse (BT_BROWSE_SCOPE_*)
+ *         uint16_t start - The first item
+ *         uint16_t end - The last item
+ *     Returns:
+ *         void
+ */
+void BM83CommandAVRCPBrowseGetFolderItems(
+    BT_t *bt,
+    uint8_t scope,
+    uint16_t start,
+    uint16_t end
+) {
+    uint8_t command[] = {
+        BM83_CMD_AVRCP_BROWSING_CMD,
+        bt->activeDevice.deviceId & 0xF, // Linked Database, the lower nibble
+        BM83_AVRCP_PDU_GET_FOLDER_ITEMS,
+        0x00, // LL
+        0x0A, // LL
+        scope,
+        0x00,
+        0x00,
+        start >> 8,
+        start & 0xFF,
+        0x00,
+        0x00,
+        end >> 8,
+        end & 0xFF,
+        BM83_AVRCP_DATA_BROWSE_NO_ATTRIBUTES
+    };
+    BM83SendCommand(bt, command, sizeof(command));
+}
+
 /**
  * BM83CommandAVRCPGetCapabilities()
  *     Description:
@@ -80,6 +289,34 @@ void BM83CommandAVRCPGetElementAttributesAll(BT_t *bt)
     BM83SendCommand(bt, command, sizeof(command));
 }
 
+/**
+ * BM83CommandAVRCPPlayItem()
+ *     Description:
+ *         Play a browsed item (AVC_Vendor_Dependent_Cmd -> 0x0B, PlayItem)
+ *     Params:
+ *         BT_t *bt - A pointer to the module object
+ *         uint8_t scope - The scope the item was browsed in
+ *         uint8_t *uid - The item UID
+ *     Returns:
+ *         void
+ */
+void BM83CommandAVRCPPlayItem(BT_t *bt, uint8_t scope, uint8_t *uid)
+{
+    uint8_t command[17] = {
+        BM83_CMD_AVC_VENDOR_DEPENDENT_CMD,
+        bt->activeDevice.deviceId & 0xF, // Linked Database, the lower nibble
+        BM83_AVRCP_PDU_PLAY_ITEM,
+        0x00, // Reserved
+        0x00, // LL
+        0x0B, // LL
+        scope
+    };
+    memcpy(&command[7], uid, BT_BROWSE_UID_LEN);
+    command[15] = bt->browse.uidCounter >> 8;
+    command[16] = bt->browse.uidCounter & 0xFF;
+    BM83SendCommand(bt, command, sizeof(command));
+}
+
 /**
  * BM83CommandAVRCPRegisterNotification()
  *     Description:
@@ -332,6 +569,28 @@ void BM83CommandPairingDisable(BT_t *bt)
     BM83SendCommand(bt, command, sizeof(command));
 }
 
+/**
+ * BM83CommandPBAPPullPhonebook()
+ *     Description:
+ *         Pull the phonebook of the connected device (PBAPC_CMD -> 0x3F) and
+ *         store it in the EEPROM as it arrives
+ *     Params:
+ *         BT_t *bt - A pointer to the module object
+ *     Returns:
+ *         void
+ */
+void BM83CommandPBAPPullPhonebook(BT_t *bt)
+{
+    uint8_t command[] = {
+        BM83_CMD_PBAPC_CMD,
+        0x00,
+        BM83_DATA_PBAPC_CMD_PULL_PHONEBOOK,
+        BM83_DATA_PBAPC_REPOSITORY_PHONEBOOK
+    };
+    PhonebookSyncStart(bt->activeDevice.macId);
+    BM83SendCommand(bt, command, sizeof(command));
+}
+
 /**
  * BM83CommandPowerOn()
  *     Description:
@@ -453,6 +712,7 @@ void BM83CommandRestore(BT_t *bt)
         BM83_CMD_MMI_ACTION_RESTORE
     };
     BM83SendCommand(bt, command, sizeof(command));
+    BTPairedDevicesErase(bt);
 }
 
 /**
@@ -538,6 +798,25 @@ void BM83CommandVoiceRecognitionOpen(BT_t *bt)
     BM83SendCommand(bt, command, sizeof(command));
 }
 
+/**
+ * BM83ProcessAVRCPCapabilitiesUnavailable()
+ *     Description:
+ *         The device refused to list its AVRCP events. Record that no
+ *         notifications are available so that the metadata falls back to
+ *         polling.
+ *     Params:
+ *         BT_t *bt - A pointer to the module object
+ *     Returns:
+ *         void
+ */
+void BM83ProcessAVRCPCapabilitiesUnavailable(BT_t *bt)
+{
+    memset(&bt->activeDevice.avrcpCaps, 0, sizeof(BTConnectionAVRCPCapabilities_t));
+    bt->activeDevice.avrcpCaps.received = 1;
+    uint8_t updateData[2] = {BM83_AVRCP_PDU_GET_CAPABILITIES, 0x00};
+    EventTriggerCallback(BT_EVENT_AVRCP_PDU_CHANGE, updateData);
+}
+
 /**
  * BM83ProcessEventAVCSpecificRsp()
  *     Description:
@@ -558,6 +837,9 @@ void BM83ProcessEventAVCSpecificRsp(BT_t *bt, uint8_t *data, uint16_t length)
     switch (data[BM83_FRAME_DB1]) {
         case BM83_DATA_AVC_RSP_NOT_IMPL: {
             LogWarning("BT: AVRCP Not Implemented: %02X", pduId);
+            if (pduId == BM83_AVRCP_PDU_GET_CAPABILITIES) {
+                BM83ProcessAVRCPCapabilitiesUnavailable(bt);
+            }
             break;
         }
         case BM83_DATA_AVC_RSP_ACCEPT: {
@@ -566,6 +848,9 @@ void BM83ProcessEventAVCSpecificRsp(BT_t *bt, uint8_t *data, uint16_t length)
         }
         case BM83_DATA_AVC_RSP_REJECT: {
             LogWarning("BT: AVRCP Reject: %02X", pduId);
+            if (pduId == BM83_AVRCP_PDU_GET_CAPABILITIES) {
+                BM83ProcessAVRCPCapabilitiesUnavailable(bt);
+            }
             break;
         }
         case BM83_DATA_AVC_RSP_STABLE: {
@@ -575,6 +860,7 @@ void BM83ProcessEventAVCSpecificRsp(BT_t *bt, uint8_t *data, uint16_t length)
             ) {
                 // Clear the available capabilities
                 memset(&bt->activeDevice.avrcpCaps, 0, sizeof(BTConnectionAVRCPCapabilities_t));
+                bt->activeDevice.avrcpCaps.received = 1;
                 uint8_t length = data[BM83_FRAME_DB12];
                 uint8_t i = 0;
                 for (i = 0; i < length; i++) {
@@ -650,9 +936,15 @@ void BM83ProcessEventAVCSpecificRsp(BT_t *bt, uint8_t *data, uint16_t length)
                     uint8_t updateData[2] = {updateType, status};
                     EventTriggerCallback(BT_EVENT_AVRCP_PDU_CHANGE, updateData);
                 } else if (updateType == BM83_AVRCP_EVT_PLAYBACK_TRACK_CHANGED) {
-                    uint8_t updateData[2] = {updateType, status};
+                    // DB12 is the start of the track identifier, not a status,
+                    // so do not pass it on where it could read as "interim"
+                    uint8_t updateData[2] = {updateType, 0x00};
                     EventTriggerCallback(BT_EVENT_AVRCP_PDU_CHANGE, updateData);
                     LogDebug(LOG_SOURCE_BT, "BT: Track Changed");
+                } else if (updateType == BM83_AVRCP_EVT_NOW_PLAYING_CONTENT_CHANGED) {
+                    uint8_t updateData[2] = {updateType, 0x00};
+                    EventTriggerCallback(BT_EVENT_AVRCP_PDU_CHANGE, updateData);
+                    LogDebug(LOG_SOURCE_BT, "BT: Now Playing Changed");
                 } else if (updateType == BM83_AVRCP_EVT_ADDRESSED_PLAYER_CHANGED) {
                     uint8_t updateData[2] = {updateType, 0x00};
                     EventTriggerCallback(BT_EVENT_AVRCP_PDU_CHANGE, updateData);
@@ -692,6 +984,158 @@ void BM83ProcessEventAVCVendorDependentRsp(BT_t *bt, uint8_t *data, uint16_t len
     }
 }
 
+/**
+ * BM83ProcessEventAVRCPBrowsing()
+ *     Description:
+ *         Process AVRCP browsing responses. Folder items are parsed straight
+ *         into the page slot that was requested, keeping the raw names.
+ *     Params:
+ *         BT_t *bt - A pointer to the module object
+ *         uint8_t *data - The data portion of the frame,
+ *             beginning with the byte after the event code
+ *         uint16_t length - The length of the data
+ *     Returns:
+ *         void
+ */
+void BM83ProcessEventAVRCPBrowsing(BT_t *bt, uint8_t *data, uint16_t length)
+{
+    if (length <= BM83_AVRCP_BROWSE_PARAMS) {
+        return;
+    }
+    uint8_t pdu = data[BM83_FRAME_DB1];
+    uint8_t status = data[BM83_AVRCP_BROWSE_PARAMS];
+    if (pdu == BM83_AVRCP_PDU_CHANGE_PATH) {
+        if (bt->browse.pending != BT_BROWSE_PAGE_PATH) {
+            return;
+        }
+        if (status != BM83_AVRCP_DATA_BROWSE_STATUS_OK || length < 9) {
+            // The device stayed in the folder, so keep its window and depth
+            LogWarning("BT: AVRCP ChangePath failed (%02X)", status);
+            bt->browse.pending = BT_BROWSE_PAGE_NONE;
+            EventTriggerCallback(BT_EVENT_BROWSE_UPDATE, 0);
+            return;
+        }
+        BTBrowseClear(bt, bt->browse.scope);
+        bt->browse.depth = bt->browse.pendingDepth;
+        uint32_t count = ((uint32_t) data[5] << 24) |
+            ((uint32_t) data[6] << 16) |
+            ((uint16_t) data[7] << 8) |
+            data[8];
+        if (count < BT_BROWSE_COUNT_UNKNOWN) {
+            bt->browse.itemCount = count;
+        }
+        EventTriggerCallback(BT_EVENT_BROWSE_UPDATE, 0);
+    } else if (pdu == BM83_AVRCP_PDU_GET_FOLDER_ITEMS) {
+        uint16_t page = bt->browse.pending;
+        if (page >= BT_BROWSE_PAGE_PATH) {
+            return;
+        }
+        if (status == BM83_AVRCP_DATA_BROWSE_STATUS_OUT_OF_BOUNDS) {
+            // The page starts past the last item
+            BTBrowseStorePage(bt, page, 0);
+            return;
+        }
+        if (status != BM83_AVRCP_DATA_BROWSE_STATUS_OK || length < 9) {
+            // Leave the request pending so that it is sent again once it
+            // times out, and keep the item count
+            LogWarning("BT: AVRCP GetFolderItems failed (%02X)", status);
+            return;
+        }
+        uint16_t uidCounter = (data[5] << 8) | data[6];
+        if (uidCounter != bt->browse.uidCounter) {
+            // The folder changed underneath us, so the other page is stale
+            uint8_t slot;
+            for (slot = 0; slot < BT_BROWSE_WINDOW_PAGES; slot++) {
+                bt->browse.pageTags[slot] = BT_BROWSE_PAGE_NONE;
+            }
+            bt->browse.uidCounter = uidCounter;
+        }
+        uint16_t itemCount = (data[7] << 8) | data[8];
+        uint16_t bytePos = 9;
+        uint8_t stored = 0;
+        BTBrowseItem_t *items = bt->browse.items[page % BT_BROWSE_WINDOW_PAGES];
+        while (itemCount > 0 && stored < BT_BROWSE_PAGE_SIZE &&
+            bytePos + 3 <= length
+        ) {
+            uint8_t type = data[bytePos];
+            uint16_t itemLength = (data[bytePos + 1] << 8) | data[bytePos + 2];
+            uint16_t itemPos = bytePos + 3;
+            bytePos = itemPos + itemLength;
+            itemCount--;
+            if (bytePos > length) {
+                break;
+            }
+            // Folders carry a folder type and playable flag before the
+            // charset, media elements only a media type
+            uint16_t namePos = itemPos + BT_BROWSE_UID_LEN + 3;
+            if (type == BT_BROWSE_ITEM_TYPE_FOLDER) {
+                namePos++;
+            } else if (type != BT_BROWSE_ITEM_TYPE_MEDIA) {
+                continue;
+            }
+            if (namePos + 2 > bytePos) {
+                continue;
+            }
+            uint16_t nameLength = (data[namePos] << 8) | data[namePos + 1];
+            namePos += 2;
+            if (namePos + nameLength > bytePos) {
+                nameLength = bytePos - namePos;
+            }
+            if (nameLength > BT_BROWSE_NAME_SIZE - 1) {
+                nameLength = BT_BROWSE_NAME_SIZE - 1;
+            }
+            BTBrowseItem_t *item = &items[stored++];
+            memcpy(item->uid, &data[itemPos], BT_BROWSE_UID_LEN);
+            item->type = type;
+            memcpy(item->name, &data[namePos], nameLength);
+            item->name[nameLength] = 0;
+        }
+        BTBrowseStorePage(bt, page, stored);
+    }
+}
+
+/**
+ * BM83ProcessEventCommandACK()
+ *     Description:
+ *         Match a Command ACK to the oldest in-flight command with the same
+ *         opcode. A command that the BM83 was too busy to run is sent again
+ *         after BM83_TX_BUSY_DELAY.
+ *     Params:
+ *         BT_t *bt - A pointer to the module object
+ *         uint8_t *data - The event data
+ *         uint16_t length - The size of the event data
+ *     Returns:
+ *         void
+ */
+void BM83ProcessEventCommandACK(BT_t *bt, uint8_t *data, uint16_t length)
+{
+    if (length < 2) {
+        return;
+    }
+    uint8_t opcode = data[0];
+    uint8_t status = data[1];
+    uint8_t idx;
+    for (idx = 0; idx < BM83_TX_QUEUE_COUNT; idx++) {
+        BM83TXCommand_t *command = &BM83_TX_QUEUE[idx];
+        if (command->state == BM83_TX_STATE_IN_FLIGHT &&
+            command->data[0] == opcode
+        ) {
+            if (status == BM83_DATA_ACK_STATUS_BUSY &&
+                command->retries < BM83_TX_RETRIES_MAX
+            ) {
+                // The BM83 did not run the command, so it is safe to resend
+                command->state = BM83_TX_STATE_BUSY;
+                command->lastSent = TimerGetMillis();
+                return;
+            }
+            BM83TXQueueComplete(idx, status);
+            // Fill the slot that just opened up
+            BM83ProcessTXQueue(bt);
+            return;
+        }
+    }
+}
+
 /**
  * BM83ProcessEventBTMStatus()
  *     Description:
@@ -801,6 +1245,8 @@ void BM83ProcessEventBTMStatus(BT_t *bt, uint8_t *data, uint16_t length)
             LogDebug(LOG_SOURCE_BT, "BT: ARVCP Closed");
             bt->status = BT_STATUS_DISCONNECTED;
             bt->activeDevice.avrcpId = 0;
+            memset(&bt->activeDevice.avrcpCaps, 0, sizeof(BTConnectionAVRCPCapabilities_t));
+            BTBrowseClear(bt, BT_BROWSE_SCOPE_NONE);
             uint8_t linkType = BT_LINK_TYPE_AVRCP;
             EventTriggerCallback(BT_EVENT_DEVICE_LINK_DISCONNECTED, &linkType);
             break;
@@ -961,6 +1407,39 @@ void BM83ProcessEventCallerID(BT_t *bt, uint8_t *data, uint16_t length)
     EventTriggerCallback(BT_EVENT_CALLER_ID_UPDATE, 0);
 }
 
+/**
+ * BM83ProcessEventPBAPC()
+ *     Description:
+ *         Process PBAP client events, passing the vCard data of a phonebook
+ *         pull on to the phonebook store
+ *     Params:
+ *         BT_t *bt - A pointer to the module object
+ *         uint8_t *data - The data portion of the frame,
+ *             beginning with the byte after the event code
+ *         uint16_t length - The length of the data
+ *     Returns:
+ *         void
+ */
+void BM83ProcessEventPBAPC(BT_t *bt, uint8_t *data, uint16_t length)
+{
+    // DB0 = Database Index, DB1 = Event Type, DB2 onward = vCard data
+    if (length < 2) {
+        return;
+    }
+    switch (data[BM83_FRAME_DB1]) {
+        case BM83_DATA_PBAPC_EVT_PULL_DATA:
+            PhonebookSyncFeed((char *) &data[BM83_FRAME_DB1 + 1], length - 2);
+            break;
+        case BM83_DATA_PBAPC_EVT_PULL_COMPLETE:
+            PhonebookSyncEnd();
+            break;
+        case BM83_DATA_PBAPC_EVT_PULL_FAILED:
+            LogWarning("BT: Phonebook pull failed");
+            PhonebookSyncEnd();
+            break;
+    }
+}
+
 /**
  * BM83ProcessEventReadLinkStatus()
  *     Description:
@@ -1073,6 +1552,8 @@ void BM83ProcessEventReadPairedDeviceRecord(BT_t *bt, uint8_t *data, uint16_t le
         BTPairedDeviceInit(bt, macId, "", number);
         pairedDevices--;
     }
+    // The record holds the whole PDL, so any cached device not in it is gone
+    BTPairedDevicesReconcile(bt);
     EventTriggerCallback(BT_EVENT_DEVICE_FOUND, 0);
 }
 
@@ -1127,6 +1608,21 @@ void BM83ProcessEventReportTypeCodec(BT_t *bt, uint8_t *data, uint16_t length)
     EventTriggerCallback(BT_EVENT_DSP_STATUS, eventData);
 }
 
+/**
+ * BM83ProcessDataGetAllAttributes()
+ *     Description:
+ *         Parse the element attributes from a Get Element Attributes response
+ *         into the metadata fields. The raw bytes of each attribute are hashed
+ *         first so that unchanged attributes, which most phones resend every
+ *         few seconds, are skipped without being copied or normalized.
+ *     Params:
+ *         BT_t *bt - A pointer to the module object
+ *         uint8_t *data - The frame data
+ *         uint8_t attributeCount - The number of attributes in the frame
+ *         uint16_t bytePos - The position of the first attribute
+ *     Returns:
+ *         void
+ */
 void BM83ProcessDataGetAllAttributes(
     BT_t *bt,
     uint8_t *data,
@@ -1145,57 +1641,46 @@ void BM83ProcessDataGetAllAttributes(
         uint16_t attributeLen = (data[bytePos + 1] & 0xFF) | (data[bytePos] << 8);
         // Skip over the length and to the beginning of the data
         bytePos = bytePos + 2;
-        char tempString[BT_METADATA_MAX_SIZE] = {0};
+        char *field = 0;
+        uint32_t *fieldHash = 0;
         switch (attributeType) {
-            case BM83_AVRCP_DATA_ELEMENT_TYPE_TITLE: {
-                uint16_t j = 0;
-                for (j = 0; j < attributeLen; j++) {
-                    tempString[j] = data[bytePos];
-                    bytePos++;
-                }
-                char text[BT_METADATA_MAX_SIZE] = {0};
-                UtilsNormalizeText(text, tempString, BT_METADATA_MAX_SIZE);
-                if (memcmp(text, bt->title, BT_METADATA_FIELD_SIZE) != 0) {
-                    dataDiffers = 1;
-                    memset(bt->title, 0, BT_METADATA_FIELD_SIZE);
-                    UtilsStrncpy(bt->title, text, BT_METADATA_FIELD_SIZE);
-                }
+            case BM83_AVRCP_DATA_ELEMENT_TYPE_TITLE:
+                field = bt->title;
+                fieldHash = &bt->titleHash;
                 break;
-            }
-            case BM83_AVRCP_DATA_ELEMENT_TYPE_ARTIST: {
-                uint16_t j = 0;
-                for (j = 0; j < attributeLen; j++) {
-                    tempString[j] = data[bytePos];
-                    bytePos++;
-                }
-                char text[BT_METADATA_MAX_SIZE] = {0};
-                UtilsNormalizeText(text, tempString, BT_METADATA_MAX_SIZE);
-                if (memcmp(text, bt->artist, BT_METADATA_FIELD_SIZE) != 0) {
-                    dataDiffers = 1;
-                    memset(bt->artist, 0, BT_METADATA_FIELD_SIZE);
-                    UtilsStrncpy(bt->artist, text, BT_METADATA_FIELD_SIZE);
-                }
+            case BM83_AVRCP_DATA_ELEMENT_TYPE_ARTIST:
+                field = bt->artist;
+                fieldHash = &bt->artistHash;
                 break;
-            }
-            case BM83_AVRCP_DATA_ELEMENT_TYPE_ALBUM: {
-                uint16_t j = 0;
-                for (j = 0; j < attributeLen; j++) {
-                    tempString[j] = data[bytePos];
-                    bytePos++;
+            case BM83_AVRCP_DATA_ELEMENT_TYPE_ALBUM:
+                field = bt->album;
+                fieldHash = &bt->albumHash;
+                break;
+        }
+        if (field != 0) {
+            uint32_t hash = UtilsHashBytes(
+                UTILS_HASH_SEED,
+                &data[bytePos],
+                attributeLen
+            );
+            if (hash != *fieldHash) {
+                *fieldHash = hash;
+                uint16_t copyLen = attributeLen;
+                if (copyLen > BT_METADATA_MAX_SIZE - 1) {
+                    copyLen = BT_METADATA_MAX_SIZE - 1;
                 }
-                char text[BT_METADATA_MAX_SIZE] = {0};
-                UtilsNormalizeText(text, tempString, BT_METADATA_MAX_SIZE);
-                if (memcmp(text, bt->album, BT_METADATA_FIELD_SIZE) != 0) {
+                char tempString[BT_METADATA_MAX_SIZE];
+                memcpy(tempString, &data[bytePos], copyLen);
+                tempString[copyLen] = '\0';
+                char text[BT_METADATA_FIELD_SIZE] = {0};
+                UtilsNormalizeText(text, tempString, BT_METADATA_FIELD_SIZE);
+                if (memcmp(text, field, BT_METADATA_FIELD_SIZE) != 0) {
                     dataDiffers = 1;
-                    memset(bt->album, 0, BT_METADATA_FIELD_SIZE);
-                    UtilsStrncpy(bt->album, text, BT_METADATA_FIELD_SIZE);
+                    memcpy(field, text, BT_METADATA_FIELD_SIZE);
                 }
-                break;
             }
-            default:
-                bytePos = bytePos + attributeLen;
-                break;
         }
+        bytePos = bytePos + attributeLen;
     }
     if (dataDiffers == 1) {
         LogDebug(
@@ -1209,10 +1694,125 @@ void BM83ProcessDataGetAllAttributes(
     }
 }
 
+/**
+ * BM83GetFrameStats()
+ *     Description:
+ *         Get the RX frame parser counters
+ *     Params:
+ *         None
+ *     Returns:
+ *         BM83FrameStats_t * - A pointer to the counters
+ */
+BM83FrameStats_t *BM83GetFrameStats()
+{
+    return &BM83_FRAME_STATS;
+}
+
+/**
+ * BM83ProcessFrame()
+ *     Description:
+ *         Acknowledge and dispatch a complete, checksum-verified frame
+ *     Params:
+ *         BT_t *bt - A pointer to the module object
+ *         uint8_t event - The event code
+ *         uint8_t *eventData - The event data
+ *         uint16_t dataLength - The length of the event data
+ *     Returns:
+ *         void
+ */
+void BM83ProcessFrame(
+    BT_t *bt,
+    uint8_t event,
+    uint8_t *eventData,
+    uint16_t dataLength
+) {
+    // Always acknowledge reception of the frame first
+    if (event != BM83_EVT_COMMAND_ACK) {
+        // The BM83 does not acknowledge an event ACK, so bypass the queue
+        uint8_t ack[] = {BM83_CMD_EVENT_ACK, event};
+        BM83SendFrame(bt, ack, sizeof(ack));
+    }
+    if (event == BM83_EVT_COMMAND_ACK) {
+        BM83ProcessEventCommandACK(bt, eventData, dataLength);
+    }
+    if (event == BM83_EVT_AVC_SPECIFIC_RSP) {
+        BM83ProcessEventAVCSpecificRsp(bt, eventData, dataLength);
+    }
+    if (event == BM83_EVT_AVRCP_VENDOR_DEPENDENT_RSP) {
+        BM83ProcessEventAVCVendorDependentRsp(bt, eventData, dataLength);
+    }
+    if (event == BM83_EVT_AVRCP_BROWSING_EVENT) {
+        BM83ProcessEventAVRCPBrowsing(bt, eventData, dataLength);
+    }
+    if (event == BM83_EVT_BTM_STATUS) {
+        BM83ProcessEventBTMStatus(bt, eventData, dataLength);
+    }
+    if (event == BM83_EVT_CALL_STATUS) {
+        BM83ProcessEventCallStatus(bt, eventData, dataLength);
+    }
+    if (event == BM83_EVT_CALLER_ID) {
+        BM83ProcessEventCallerID(bt, eventData, dataLength);
+    }
+    if (event == BM83_EVT_PBAPC_EVENT) {
+        BM83ProcessEventPBAPC(bt, eventData, dataLength);
+    }
+    if (event == BM83_EVT_READ_LINK_STATUS_REPLY) {
+        BM83ProcessEventReadLinkStatus(bt, eventData, dataLength);
+    }
+    if (event == BM83_EVT_READ_LINKED_DEVICE_INFORMATION_REPLY) {
+        BM83ProcessEventReadLinkedDeviceInformation(
+            bt,
+            eventData,
+            dataLength
+        );
+    }
+    if (event == BM83_EVT_READ_PAIRED_DEVICE_RECORD_REPLY) {
+        BM83ProcessEventReadPairedDeviceRecord(
+            bt,
+            eventData,
+            dataLength
+        );
+    }
+    if (event == BM83_EVT_READ_LOCAL_BD_ADDRESS_REPLY) {
+        if (dataLength == 0x06) {
+            uint8_t data[6] = {
+                eventData[5],
+                eventData[4],
+                eventData[3],
+                eventData[2],
+                eventData[1],
+                eventData[0]
+            };
+            EventTriggerCallback(BT_EVENT_BTM_ADDRESS, data);
+        }
+    }
+    if (event == BM83_EVT_REPORT_BTM_INITIAL_STATUS) {
+        if (eventData[BM83_FRAME_DB0] ==
+            BM83_DATA_BTM_INITIAL_STATUS_BOOT_COMPLETE
+        ) {
+            EventTriggerCallback(BT_EVENT_BOOT, 0);
+        }
+    }
+    if (event == BM83_EVT_REPORT_LINK_BACK_STATUS) {
+        BM83ProcessEventReportLinkBackStatus(
+            bt,
+            eventData,
+            dataLength
+        );
+    }
+    if (event == BM83_EVT_REPORT_TYPE_CODEC) {
+        BM83ProcessEventReportTypeCodec(bt, eventData, dataLength);
+    }
+}
+
 /**
  * BM83Process()
  *     Description:
- *         Read the RX queue and process the messages into meaningful data
+ *         Read the RX queue and process the messages into meaningful data.
+ *         Bytes are fed through a resumable parser that checks the length
+ *         and the checksum as the frame arrives, so a partial frame costs
+ *         nothing until the rest of it is received. At most one frame is
+ *         dispatched per call.
  *     Params:
  *         BT_t *bt - A pointer to the module object
  *     Returns:
@@ -1220,126 +1820,193 @@ void BM83ProcessDataGetAllAttributes(
  */
 void BM83Process(BT_t *bt)
 {
-    uint16_t hasStartWord = CharQueueSeek(&bt->uart.rxQueue, BM83_UART_START_WORD);
-    uint16_t queueSize = CharQueueGetSize(&bt->uart.rxQueue);
-    if (queueSize >= BM83_FRAME_SIZE_MIN && hasStartWord != 0) {
-        if (hasStartWord != 1) {
-            LogRawDebug(LOG_SOURCE_BT, "BT: Trash Bytes: ");
-            while (hasStartWord > 1) {
-                uint8_t byte = CharQueueNext(&bt->uart.rxQueue);
-                LogRawDebug(LOG_SOURCE_BT, "%02X ", byte);
-                hasStartWord--;
-            }
-            LogRawDebug(LOG_SOURCE_BT, "\r\n");
+    uint32_t now = TimerGetMillis();
+    UARTRXDrainIdle(&bt->uart);
+    if (BM83_FRAME_STATE != BM83_FRAME_STATE_START &&
+        (now - BM83_FRAME_TIMESTAMP) > BM83_FRAME_TIMEOUT
+    ) {
+        LogWarning("BM83: Dropped partial frame after timeout");
+        BM83_FRAME_STATS.droppedTimeout++;
+        BM83_FRAME_STATE = BM83_FRAME_STATE_START;
+    }
+    uint8_t frameReady = 0;
+    while (frameReady == 0 && CharQueueGetSize(&bt->uart.rxQueue) > 0) {
+        uint32_t arrival = 0;
+        if (BM83_FRAME_STATE == BM83_FRAME_STATE_START) {
+            arrival = UARTGetRXTimestamp(&bt->uart);
         }
-        uint8_t lengthHigh = CharQueueGetOffset(&bt->uart.rxQueue, 1);
-        uint8_t lengthLow = CharQueueGetOffset(&bt->uart.rxQueue, 2);
-        uint16_t frameLength = (lengthLow & 0xFF) | (lengthHigh << 8);
-        // Get the queue size again in case it has changed
-        queueSize = CharQueueGetSize(&bt->uart.rxQueue) - BM83_FRAME_CTRL_BYTE_COUNT;
-        if (queueSize >= frameLength && frameLength > 0) {
-            long long unsigned int ts = (long long unsigned int) TimerGetMillis();
-            LogRawDebug(LOG_SOURCE_BT, "[%llu] DEBUG: BM83: RX: ", ts);
-            uint16_t frameSize = frameLength + BM83_FRAME_CTRL_BYTE_COUNT;
-            uint16_t dataLength = frameLength - 1;
-            uint8_t eventData[dataLength];
-            memset(eventData, 0, dataLength);
-            uint8_t event = 0x00;
-            uint16_t i = 0;
-            uint16_t j = 0;
-            // lastIdx is the index of the checksum
-            uint16_t lastIdx = frameSize - 1;
-            // Get the data
-            for (i = 0; i < frameSize; i++) {
-                uint8_t byte = CharQueueNext(&bt->uart.rxQueue);
-                LogRawDebug(LOG_SOURCE_BT, "%02X ", byte);
-                if (i == BM83_OFFSET_EVENT_CODE) {
-                    event = byte;
+        uint8_t byte = CharQueueNext(&bt->uart.rxQueue);
+        BM83_FRAME_TIMESTAMP = now;
+        switch (BM83_FRAME_STATE) {
+            case BM83_FRAME_STATE_START:
+                if (byte == BM83_UART_START_WORD) {
+                    BM83_FRAME_ARRIVAL = arrival;
+                    BM83_FRAME_CHECKSUM = 0;
+                    BM83_FRAME_STATE = BM83_FRAME_STATE_LENGTH_HIGH;
+                } else {
+                    BM83_FRAME_STATS.trashBytes++;
                 }
-                if (i >= BM83_OFFSET_EVENT_DATA &&
-                    i < lastIdx
-                ) {
-                    eventData[j] = byte;
-                    j++;
+                break;
+            case BM83_FRAME_STATE_LENGTH_HIGH:
+                BM83_FRAME_LENGTH = (uint16_t) byte << 8;
+                BM83_FRAME_CHECKSUM += byte;
+                BM83_FRAME_STATE = BM83_FRAME_STATE_LENGTH_LOW;
+                break;
+            case BM83_FRAME_STATE_LENGTH_LOW:
+                BM83_FRAME_LENGTH |= byte;
+                BM83_FRAME_CHECKSUM += byte;
+                BM83_FRAME_INDEX = 0;
+                if (BM83_FRAME_LENGTH == 0) {
+                    LogWarning("BM83: Dropped frame with no data");
+                    BM83_FRAME_STATS.droppedLength++;
+                    BM83_FRAME_STATE = BM83_FRAME_STATE_START;
+                } else if (BM83_FRAME_LENGTH > BM83_FRAME_BUFFER_SIZE) {
+                    LogWarning(
+                        "BM83: Dropped frame of length %u",
+                        BM83_FRAME_LENGTH
+                    );
+                    BM83_FRAME_STATS.droppedLength++;
+                    // Skip over the data and checksum
+                    BM83_FRAME_LENGTH++;
+                    BM83_FRAME_STATE = BM83_FRAME_STATE_SKIP;
+                } else {
+                    BM83_FRAME_STATE = BM83_FRAME_STATE_DATA;
                 }
-            }
-            LogRawDebug(LOG_SOURCE_BT, "\r\n");
-            // Always acknowledge reception of the frame first
-            if (event != BM83_EVT_COMMAND_ACK) {
-                uint8_t ack[] = {BM83_CMD_EVENT_ACK, event};
-                BM83SendCommand(bt, ack, sizeof(ack));
-            }
-            if (event == BM83_EVT_AVC_SPECIFIC_RSP) {
-                BM83ProcessEventAVCSpecificRsp(bt, eventData, dataLength);
-            }
-            if (event == BM83_EVT_AVRCP_VENDOR_DEPENDENT_RSP) {
-                BM83ProcessEventAVCVendorDependentRsp(bt, eventData, dataLength);
-            }
-            if (event == BM83_EVT_BTM_STATUS) {
-                BM83ProcessEventBTMStatus(bt, eventData, dataLength);
-            }
-            if (event == BM83_EVT_CALL_STATUS) {
-                BM83ProcessEventCallStatus(bt, eventData, dataLength);
-            }
-            if (event == BM83_EVT_CALLER_ID) {
-                BM83ProcessEventCallerID(bt, eventData, dataLength);
-            }
-            if (event == BM83_EVT_READ_LINK_STATUS_REPLY) {
-                BM83ProcessEventReadLinkStatus(bt, eventData, dataLength);
-            }
-            if (event == BM83_EVT_READ_LINKED_DEVICE_INFORMATION_REPLY) {
-                BM83ProcessEventReadLinkedDeviceInformation(
-                    bt,
-                    eventData,
-                    dataLength
-                );
-            }
-            if (event == BM83_EVT_READ_PAIRED_DEVICE_RECORD_REPLY) {
-                BM83ProcessEventReadPairedDeviceRecord(
-                    bt,
-                    eventData,
-                    dataLength
-                );
-            }
-            if (event == BM83_EVT_READ_LOCAL_BD_ADDRESS_REPLY) {
-                if (dataLength == 0x06) {
-                    uint8_t data[6] = {
-                        eventData[5],
-                        eventData[4],
-                        eventData[3],
-                        eventData[2],
-                        eventData[1],
-                        eventData[0]
-                    };
-                    EventTriggerCallback(BT_EVENT_BTM_ADDRESS, data);
+                break;
+            case BM83_FRAME_STATE_DATA:
+                BM83_FRAME_DATA[BM83_FRAME_INDEX++] = byte;
+                BM83_FRAME_CHECKSUM += byte;
+                if (BM83_FRAME_INDEX == BM83_FRAME_LENGTH) {
+                    BM83_FRAME_STATE = BM83_FRAME_STATE_CHECKSUM;
                 }
-            }
-            if (event == BM83_EVT_REPORT_BTM_INITIAL_STATUS) {
-                if (eventData[BM83_FRAME_DB0] ==
-                    BM83_DATA_BTM_INITIAL_STATUS_BOOT_COMPLETE
-                ) {
-                    EventTriggerCallback(BT_EVENT_BOOT, 0);
+                break;
+            case BM83_FRAME_STATE_CHECKSUM:
+                // The checksum brings the sum of the length, opcode and data
+                // bytes to zero
+                BM83_FRAME_CHECKSUM += byte;
+                BM83_FRAME_STATE = BM83_FRAME_STATE_START;
+                if (BM83_FRAME_CHECKSUM == 0) {
+                    BM83_FRAME_STATS.received++;
+                    frameReady = 1;
+                } else {
+                    LogWarning(
+                        "BM83: Dropped frame %02X with bad checksum",
+                        BM83_FRAME_DATA[0]
+                    );
+                    BM83_FRAME_STATS.droppedChecksum++;
+                }
+                break;
+            case BM83_FRAME_STATE_SKIP:
+                BM83_FRAME_INDEX++;
+                if (BM83_FRAME_INDEX == BM83_FRAME_LENGTH) {
+                    BM83_FRAME_STATE = BM83_FRAME_STATE_START;
                 }
+                break;
+        }
+    }
+    if (frameReady == 1) {
+        uint16_t dataLength = BM83_FRAME_LENGTH - 1;
+        uint16_t traceDetail = 0;
+        if (dataLength >= 2) {
+            traceDetail = ((uint16_t) BM83_FRAME_DATA[1] << 8) | BM83_FRAME_DATA[2];
+        }
+        TraceRecordAt(BM83_FRAME_ARRIVAL, TRACE_POINT_UART_RX, BT_UART_MODULE, 0);
+        TraceRecord(TRACE_POINT_BT_RX, BM83_FRAME_DATA[0], traceDetail);
+        if (ConfigGetLog(LOG_SOURCE_BT) != 0) {
+            long long unsigned int ts = (long long unsigned int) now;
+            LogRawDebug(
+                LOG_SOURCE_BT,
+                "[%llu] DEBUG: BM83: RX: AA %02X %02X ",
+                ts,
+                BM83_FRAME_LENGTH >> 8,
+                BM83_FRAME_LENGTH & 0xFF
+            );
+            uint16_t i;
+            for (i = 0; i < BM83_FRAME_LENGTH; i++) {
+                LogRawDebug(LOG_SOURCE_BT, "%02X ", BM83_FRAME_DATA[i]);
             }
-            if (event == BM83_EVT_REPORT_LINK_BACK_STATUS) {
-                BM83ProcessEventReportLinkBackStatus(
-                    bt,
-                    eventData,
-                    dataLength
-                );
+            LogRawDebug(LOG_SOURCE_BT, "\r\n");
+        }
+        BM83ProcessFrame(
+            bt,
+            BM83_FRAME_DATA[0],
+            &BM83_FRAME_DATA[1],
+            dataLength
+        );
+    }
+    // An ACK still waiting in the RX queue is not overdue, however long the
+    // main loop took to get to it
+    if (CharQueueGetSize(&bt->uart.rxQueue) == 0 &&
+        BM83_FRAME_STATE == BM83_FRAME_STATE_START
+    ) {
+        BM83TXQueueExpire();
+    }
+    BM83ProcessTXQueue(bt);
+    UARTReportErrors(&bt->uart);
+}
+
+/**
+ * BM83ProcessTXQueue()
+ *     Description:
+ *         Resend the commands that the BM83 reported busy, and send queued
+ *         commands while fewer than BM83_TX_IN_FLIGHT_MAX are awaiting an ACK
+ *     Params:
+ *         BT_t *bt - A pointer to the module object
+ *     Returns:
+ *         void
+ */
+void BM83ProcessTXQueue(BT_t *bt)
+{
+    // Completion listeners may queue commands. They are picked up by the
+    // pass that is already running.
+    if (BM83_TX_QUEUE_BUSY == 1) {
+        return;
+    }
+    BM83_TX_QUEUE_BUSY = 1;
+    uint32_t now = TimerGetMillis();
+    uint8_t inFlight = 0;
+    uint8_t idx = 0;
+    while (idx < BM83_TX_QUEUE_COUNT) {
+        BM83TXCommand_t *command = &BM83_TX_QUEUE[idx];
+        if (command->state == BM83_TX_STATE_IN_FLIGHT) {
+            inFlight++;
+        } else if (command->state == BM83_TX_STATE_BUSY) {
+            if ((now - command->lastSent) >= BM83_TX_BUSY_DELAY) {
+                BM83CommandStats_t *stats = BM83TXStatsGet(command->data[0]);
+                if (stats != 0) {
+                    stats->retries++;
+                }
+                command->state = BM83_TX_STATE_IN_FLIGHT;
+                command->retries++;
+                command->lastSent = now;
+                BM83SendFrame(bt, command->data, command->size);
             }
-            if (event == BM83_EVT_REPORT_TYPE_CODEC) {
-                BM83ProcessEventReportTypeCodec(bt, eventData, dataLength);
+            inFlight++;
+        } else if (inFlight < BM83_TX_IN_FLIGHT_MAX) {
+            BM83CommandStats_t *stats = BM83TXStatsGet(command->data[0]);
+            if (stats != 0) {
+                stats->sent++;
             }
+            command->state = BM83_TX_STATE_IN_FLIGHT;
+            command->firstSent = now;
+            command->lastSent = now;
+            BM83SendFrame(bt, command->data, command->size);
+            inFlight++;
+        } else {
+            break;
         }
+        idx++;
     }
-    UARTReportErrors(&bt->uart);
+    BM83_TX_QUEUE_BUSY = 0;
 }
 
 /**
  * BM83SendCommand()
  *     Description:
- *         Send data over UART
+ *         Queue a command for the BM83. It is sent right away if the in-flight
+ *         limit allows, and retransmitted until the BM83 acknowledges it.
+ *         Listeners of BT_EVENT_COMMAND_COMPLETE receive the opcode and the
+ *         ACK status once it completes.
  *     Params:
  *         BT_t *bt - A pointer to the module object
  *         uint8_t *targetData - A command to send along with its data
@@ -1351,8 +2018,47 @@ void BM83SendCommand(
     BT_t *bt,
     uint8_t *targetData,
     size_t size
+) {
+    if (size == 0) {
+        return;
+    }
+    if (size > BM83_TX_COMMAND_MAX_SIZE ||
+        BM83_TX_QUEUE_COUNT == BM83_TX_QUEUE_SIZE
+    ) {
+        LogWarning("BM83: TX queue unavailable, sending %02X untracked", targetData[0]);
+        BM83SendFrame(bt, targetData, size);
+        return;
+    }
+    BM83TXCommand_t *command = &BM83_TX_QUEUE[BM83_TX_QUEUE_COUNT++];
+    memset(command, 0, sizeof(BM83TXCommand_t));
+    memcpy(command->data, targetData, size);
+    command->size = size;
+    command->state = BM83_TX_STATE_QUEUED;
+    BM83ProcessTXQueue(bt);
+}
+
+/**
+ * BM83SendFrame()
+ *     Description:
+ *         Frame the given command and write it to the UART immediately
+ *     Params:
+ *         BT_t *bt - A pointer to the module object
+ *         uint8_t *targetData - A command to send along with its data
+ *         size_t size - The target length of the frame
+ *     Returns:
+ *         void
+ */
+void BM83SendFrame(
+    BT_t *bt,
+    uint8_t *targetData,
+    size_t size
 ) {
     uint8_t idx = 0;
+    uint16_t traceDetail = 0;
+    if (size >= 3) {
+        traceDetail = ((uint16_t) targetData[1] << 8) | targetData[2];
+    }
+    TraceRecord(TRACE_POINT_BT_TX, targetData[0], traceDetail);
     long long unsigned int ts = (long long unsigned int) TimerGetMillis();
     LogRawDebug(
         LOG_SOURCE_BT,
@@ -8,6 +8,7 @@
 #define BM83_H
 #include <stdint.h>
 #include "bt_common.h"
+#include "../phonebook.h"
 
 extern int8_t BTBM83MicGainTable[];
 
@@ -32,6 +33,18 @@ extern int8_t BTBM83MicGainTable[];
 #define BM83_AVRCP_PDU_GET_ELEMENT_ATTRIBUTES 0x20
 #define BM83_AVRCP_PDU_GET_PLAY_STATUS 0x30
 #define BM83_AVRCP_PDU_NOTIFICATION 0x31
+#define BM83_AVRCP_PDU_GET_FOLDER_ITEMS 0x71
+#define BM83_AVRCP_PDU_CHANGE_PATH 0x72
+#define BM83_AVRCP_PDU_PLAY_ITEM 0x74
+
+#define BM83_AVRCP_DATA_CHANGE_PATH_UP 0x00
+#define BM83_AVRCP_DATA_CHANGE_PATH_DOWN 0x01
+#define BM83_AVRCP_DATA_BROWSE_STATUS_OK 0x04
+#define BM83_AVRCP_DATA_BROWSE_STATUS_OUT_OF_BOUNDS 0x0B
+// Ask for the displayable names only, without any element attributes
+#define BM83_AVRCP_DATA_BROWSE_NO_ATTRIBUTES 0xFF
+// DB0 = Database Index, DB1 = PDU ID, DB2-DB3 = Parameter Length
+#define BM83_AVRCP_BROWSE_PARAMS 4
 
 #define BM83_LINKED_DEVICE_QUERY_NAME 0x00
 
@@ -237,6 +250,25 @@ extern int8_t BTBM83MicGainTable[];
 
 #define BM83_DATA_BOOT_STATUS_POWER_ON 0x01
 
+// PBAP client sub-commands (PBAPC_CMD -> 0x3F) and events (PBAPC_EVENT -> 0x43)
+#define BM83_DATA_PBAPC_CMD_CONNECT 0x00
+#define BM83_DATA_PBAPC_CMD_DISCONNECT 0x01
+#define BM83_DATA_PBAPC_CMD_PULL_PHONEBOOK 0x02
+#define BM83_DATA_PBAPC_REPOSITORY_PHONEBOOK 0x00
+#define BM83_DATA_PBAPC_EVT_CONNECTED 0x00
+#define BM83_DATA_PBAPC_EVT_DISCONNECTED 0x01
+#define BM83_DATA_PBAPC_EVT_PULL_DATA 0x02
+#define BM83_DATA_PBAPC_EVT_PULL_COMPLETE 0x03
+#define BM83_DATA_PBAPC_EVT_PULL_FAILED 0x04
+
+#define BM83_DATA_ACK_STATUS_COMPLETE 0x00
+#define BM83_DATA_ACK_STATUS_DISALLOWED 0x01
+#define BM83_DATA_ACK_STATUS_UNKNOWN 0x02
+#define BM83_DATA_ACK_STATUS_INVALID_PARAMS 0x03
+#define BM83_DATA_ACK_STATUS_BUSY 0x04
+#define BM83_DATA_ACK_STATUS_MEMORY_FULL 0x05
+// Not sent by the BM83: reported when the ACK never arrived
+#define BM83_DATA_ACK_STATUS_TIMEOUT 0xFF
 
 #define BM83_EVT_COMMAND_ACK 0x00
 #define BM83_EVT_BTM_STATUS 0x01
@@ -311,9 +343,102 @@ extern int8_t BTBM83MicGainTable[];
 
 #define BM83_UART_START_WORD 0xAA
 
+// Largest opcode + data length we accept. Longer frames are dropped.
+#define BM83_FRAME_BUFFER_SIZE 512
+// Drop a partially received frame if no byte arrives within this many ms
+#define BM83_FRAME_TIMEOUT 750
+
+#define BM83_FRAME_STATE_START 0
+#define BM83_FRAME_STATE_LENGTH_HIGH 1
+#define BM83_FRAME_STATE_LENGTH_LOW 2
+#define BM83_FRAME_STATE_DATA 3
+#define BM83_FRAME_STATE_CHECKSUM 4
+#define BM83_FRAME_STATE_SKIP 5
+
+/**
+ * BM83FrameStats_t
+ *     Description:
+ *         Counters kept by the RX frame parser
+ *     Fields:
+ *         received - Frames that passed the checksum and were dispatched
+ *         droppedChecksum - Frames dropped due to a bad checksum
+ *         droppedLength - Frames dropped for a zero or oversized length
+ *         droppedTimeout - Partial frames dropped after BM83_FRAME_TIMEOUT
+ *         trashBytes - Bytes discarded while looking for the start word
+ */
+typedef struct BM83FrameStats_t {
+    uint16_t received;
+    uint16_t droppedChecksum;
+    uint16_t droppedLength;
+    uint16_t droppedTimeout;
+    uint16_t trashBytes;
+} BM83FrameStats_t;
+
+#define BM83_TX_QUEUE_SIZE 8
+// Commands sent to the BM83 that may be awaiting an ACK at the same time
+#define BM83_TX_IN_FLIGHT_MAX 2
+#define BM83_TX_COMMAND_MAX_SIZE 32
+#define BM83_TX_ACK_TIMEOUT 200
+// Wait before resending a command that the BM83 was too busy to run
+#define BM83_TX_BUSY_DELAY 50
+#define BM83_TX_RETRIES_MAX 2
+#define BM83_TX_STATS_SIZE 16
+#define BM83_TX_STATE_QUEUED 0
+#define BM83_TX_STATE_IN_FLIGHT 1
+#define BM83_TX_STATE_BUSY 2
+
+/**
+ * BM83TXCommand_t
+ *     Description:
+ *         A command waiting to be sent, or waiting for its ACK
+ *     Fields:
+ *         data - The opcode followed by the command parameters
+ *         size - The number of bytes in data
+ *         state - BM83_TX_STATE_QUEUED, BM83_TX_STATE_IN_FLIGHT or
+ *             BM83_TX_STATE_BUSY
+ *         retries - How many times the command has been resent after a busy
+ *             ACK
+ *         firstSent - When the command was first written to the UART
+ *         lastSent - When the command was last written to the UART
+ */
+typedef struct BM83TXCommand_t {
+    uint8_t data[BM83_TX_COMMAND_MAX_SIZE];
+    uint8_t size;
+    uint8_t state;
+    uint8_t retries;
+    uint32_t firstSent;
+    uint32_t lastSent;
+} BM83TXCommand_t;
+
+/**
+ * BM83CommandStats_t
+ *     Description:
+ *         Per-opcode counters kept by the TX queue
+ *     Fields:
+ *         opcode - The command opcode
+ *         sent - Commands sent, not counting retransmissions
+ *         acked - Commands acknowledged by the BM83
+ *         retries - Resends after a busy ACK
+ *         failed - Commands rejected by the BM83 or never acknowledged
+ *         latencyMax - Longest time from first send to ACK, in ms
+ *         latencyTotal - Sum of the send to ACK times, in ms
+ */
+typedef struct BM83CommandStats_t {
+    uint8_t opcode;
+    uint16_t sent;
+    uint16_t acked;
+    uint16_t retries;
+    uint16_t failed;
+    uint16_t latencyMax;
+    uint32_t latencyTotal;
+} BM83CommandStats_t;
+
 /* Define commands */
+void BM83CommandAVRCPBrowseChangePath(BT_t *, uint8_t, uint8_t *);
+void BM83CommandAVRCPBrowseGetFolderItems(BT_t *, uint8_t, uint16_t, uint16_t);
 void BM83CommandAVRCPGetCapabilities(BT_t *);
 void BM83CommandAVRCPGetElementAttributesAll(BT_t *);
+void BM83CommandAVRCPPlayItem(BT_t *, uint8_t, uint8_t *);
 void BM83CommandAVRCPRegisterNotification(BT_t *, uint8_t);
 void BM83CommandBTMUtilityFunction(BT_t *, uint8_t, uint8_t);
 void BM83CommandCallAccept(BT_t *);
@@ -328,6 +453,7 @@ void BM83CommandMicGainUp(BT_t *);
 void BM83CommandMusicControl(BT_t *, uint8_t);
 void BM83CommandPairingEnable(BT_t *);
 void BM83CommandPairingDisable(BT_t *);
+void BM83CommandPBAPPullPhonebook(BT_t *);
 void BM83CommandPowerOn(BT_t *);
 void BM83CommandReadLinkStatus(BT_t *);
 void BM83CommandReadLinkedDeviceInformation(BT_t *, uint8_t);
@@ -339,11 +465,14 @@ void BM83CommandVendorATCommand(BT_t *, char *);
 void BM83CommandVoiceRecognitionClose(BT_t *);
 void BM83CommandVoiceRecognitionOpen(BT_t *);
 /* Process Events */
+void BM83ProcessAVRCPCapabilitiesUnavailable(BT_t *);
 void BM83ProcessEventAVCSpecificRsp(BT_t *, uint8_t *, uint16_t);
 void BM83ProcessEventAVCVendorDependentRsp(BT_t *, uint8_t *, uint16_t);
+void BM83ProcessEventAVRCPBrowsing(BT_t *, uint8_t *, uint16_t);
 void BM83ProcessEventBTMStatus(BT_t *, uint8_t *, uint16_t);
 void BM83ProcessEventCallStatus(BT_t *, uint8_t *, uint16_t);
 void BM83ProcessEventCallerID(BT_t *, uint8_t *, uint16_t);
+void BM83ProcessEventPBAPC(BT_t *, uint8_t *, uint16_t);
 void BM83ProcessEventReadLinkStatus(BT_t *, uint8_t *, uint16_t);
 void BM83ProcessEventReadLinkedDeviceInformation(BT_t *, uint8_t *, uint16_t);
 void BM83ProcessEventReadPairedDeviceRecord(BT_t *, uint8_t *, uint16_t);
@@ -351,7 +480,13 @@ void BM83ProcessEventReportLinkBackStatus(BT_t *, uint8_t *, uint16_t);
 void BM83ProcessEventReportTypeCodec(BT_t *, uint8_t *, uint16_t );
 void BM83ProcessDataGetAllAttributes(BT_t *, uint8_t *, uint8_t, uint16_t);
 /* RX / TX */
+BM83CommandStats_t *BM83GetCommandStats(uint8_t);
+BM83FrameStats_t *BM83GetFrameStats();
 void BM83Process(BT_t *);
+void BM83ProcessFrame(BT_t *, uint8_t, uint8_t *, uint16_t);
+void BM83ProcessEventCommandACK(BT_t *, uint8_t *, uint16_t);
+void BM83ProcessTXQueue(BT_t *);
 void BM83SendCommand(BT_t *, uint8_t *, size_t);
+void BM83SendFrame(BT_t *, uint8_t *, size_t);
 
 #endif /* BM83_H */
@@ -7,6 +7,94 @@
 #include "bt_common.h"
 
 
+/**
+ * BTBrowseClear()
+ *     Description:
+ *        Drop the browsing window and start over in the given scope
+ *     Params:
+ *         BT_t *bt - A pointer to the module object
+ *         uint8_t scope - The scope to browse (BT_BROWSE_SCOPE_*)
+ *     Returns:
+ *         void
+ */
+void BTBrowseClear(BT_t *bt, uint8_t scope)
+{
+    uint8_t slot;
+    bt->browse.scope = scope;
+    bt->browse.itemCount = BT_BROWSE_COUNT_UNKNOWN;
+    bt->browse.position = 0;
+    bt->browse.pending = BT_BROWSE_PAGE_NONE;
+    for (slot = 0; slot < BT_BROWSE_WINDOW_PAGES; slot++) {
+        bt->browse.pageTags[slot] = BT_BROWSE_PAGE_NONE;
+        bt->browse.pageCounts[slot] = 0;
+    }
+}
+
+/**
+ * BTBrowseGetItem()
+ *     Description:
+ *        Get an item from the browsing window
+ *     Params:
+ *         BT_t *bt - A pointer to the module object
+ *         uint16_t index - The index of the item in the folder
+ *     Returns:
+ *         BTBrowseItem_t * - The item, or 0 if it is not cached
+ */
+BTBrowseItem_t *BTBrowseGetItem(BT_t *bt, uint16_t index)
+{
+    uint16_t page = index / BT_BROWSE_PAGE_SIZE;
+    uint8_t offset = index % BT_BROWSE_PAGE_SIZE;
+    uint8_t slot = page % BT_BROWSE_WINDOW_PAGES;
+    if (bt->browse.pageTags[slot] != page ||
+        offset >= bt->browse.pageCounts[slot]
+    ) {
+        return 0;
+    }
+    return &bt->browse.items[slot][offset];
+}
+
+/**
+ * BTBrowseGetItemName()
+ *     Description:
+ *        Normalize the name of an item for display
+ *     Params:
+ *         BTBrowseItem_t *item - The item
+ *         char *name - The buffer to write the name to
+ *         uint8_t size - The size of the buffer
+ *     Returns:
+ *         void
+ */
+void BTBrowseGetItemName(BTBrowseItem_t *item, char *name, uint8_t size)
+{
+    UtilsNormalizeText(name, item->name, size);
+}
+
+/**
+ * BTBrowseStorePage()
+ *     Description:
+ *        Mark a page slot as filled once its items have been parsed into it.
+ *        A short page marks the end of the folder.
+ *     Params:
+ *         BT_t *bt - A pointer to the module object
+ *         uint16_t page - The page number
+ *         uint8_t count - The number of items in the page
+ *     Returns:
+ *         void
+ */
+void BTBrowseStorePage(BT_t *bt, uint16_t page, uint8_t count)
+{
+    uint8_t slot = page % BT_BROWSE_WINDOW_PAGES;
+    bt->browse.pageTags[slot] = page;
+    bt->browse.pageCounts[slot] = count;
+    if (bt->browse.pending == page) {
+        bt->browse.pending = BT_BROWSE_PAGE_NONE;
+    }
+    if (count < BT_BROWSE_PAGE_SIZE) {
+        bt->browse.itemCount = (page * BT_BROWSE_PAGE_SIZE) + count;
+    }
+    EventTriggerCallback(BT_EVENT_BROWSE_UPDATE, 0);
+}
+
 /**
  * BTClearActiveDevice()
  *     Description:
@@ -35,12 +123,16 @@ void BTClearMetadata(BT_t *bt)
     memset(bt->title, 0, BT_METADATA_FIELD_SIZE);
     memset(bt->artist, 0, BT_METADATA_FIELD_SIZE);
     memset(bt->album, 0, BT_METADATA_FIELD_SIZE);
+    bt->titleHash = 0;
+    bt->artistHash = 0;
+    bt->albumHash = 0;
 }
 
 /**
  * BC127ClearPairedDevices()
  *     Description:
- *        Clear the paired devices list
+ *        Clear the paired devices list. Clearing all devices falls back to the
+ *        stored table, so that the devices that are not in range are kept
  *     Params:
  *         BT_t *bt - A pointer to the module object
  *     Returns:
@@ -68,6 +160,9 @@ void BTClearPairedDevices(BT_t *bt, uint8_t clearType)
     memset(bt->pairingErrors, 0, sizeof(bt->pairingErrors));
     if ((clearType != BT_TYPE_CLEAR_ALL) && (found == 1)) {
         BTPairedDeviceInit(bt, btActiveConn.macId, btActiveConn.deviceName, btActiveConn.number);
+        bt->pairedDevices[0].lastSeen = btActiveConn.lastSeen;
+    } else if (clearType == BT_TYPE_CLEAR_ALL) {
+        BTPairedDevicesLoad(bt);
     }
 }
 
@@ -113,16 +208,26 @@ void BTPairedDeviceInit(
         BTPairedDevice_t *btDevice = &bt->pairedDevices[idx];
         if (memcmp(macId, btDevice->macId, BT_MAC_ID_LEN) == 0) {
             deviceExists = 1;
+            // The module knows this device, so a cached entry is now current
+            btDevice->cached = 0;
+            if (deviceNumber > 0) {
+                btDevice->number = deviceNumber;
+            }
+            if (deviceName[0] != 0) {
+                UtilsStrncpy(btDevice->deviceName, deviceName, BT_DEVICE_NAME_LEN);
+            }
             EventTriggerCallback(BT_EVENT_DEVICE_FOUND, (uint8_t *) macId);
         }
     }
     // Create a connection for this device since one does not exist
     if (deviceExists == 0) {
         BTPairedDevice_t pairedDevice;
+        memset(&pairedDevice, 0, sizeof(BTPairedDevice_t));
         memcpy(pairedDevice.macId, macId, BT_MAC_ID_LEN);
-        memset(pairedDevice.deviceName, 0, BT_DEVICE_NAME_LEN);
         UtilsStrncpy(pairedDevice.deviceName, deviceName, BT_DEVICE_NAME_LEN);
-        if (deviceNumber > 0 && deviceNumber <= BT_MAX_DEVICE_PAIRED) {
+        if (deviceNumber > 0 && deviceNumber <= BT_MAX_DEVICE_PAIRED &&
+            deviceNumber > bt->pairedDevicesCount
+        ) {
             pairedDevice.number = deviceNumber;
             LogDebug(LOG_SOURCE_BT, "Add PD: %d", deviceNumber - 1);
             bt->pairedDevices[deviceNumber - 1] = pairedDevice;
@@ -130,7 +235,12 @@ void BTPairedDeviceInit(
             EventTriggerCallback(BT_EVENT_DEVICE_FOUND, (uint8_t *) macId);
             LogDebug(LOG_SOURCE_BT, "BT: Rewrite Pairing Profile");
         } else if (bt->pairedDevicesCount+1 < BT_MAX_DEVICE_PAIRED) {
+            // Keep the module's record number if the slot it maps to is
+            // already taken by a cached device
             pairedDevice.number = bt->pairedDevicesCount + 1;
+            if (deviceNumber > 0) {
+                pairedDevice.number = deviceNumber;
+            }
             bt->pairedDevices[bt->pairedDevicesCount++] = pairedDevice;
             EventTriggerCallback(BT_EVENT_DEVICE_FOUND, (uint8_t *) macId);
             LogDebug(LOG_SOURCE_BT, "BT: New Pairing Profile");
@@ -162,3 +272,378 @@ char *BTPairedDeviceGetName(BT_t *bt, uint8_t *macId)
     }
     return deviceName;
 }
+
+/**
+ * BTPairedDeviceConfirm()
+ *     Description:
+ *         Mark a cached device as still paired with the module
+ *     Params:
+ *         BT_t *bt - A pointer to the module object
+ *         uint8_t *macId - The MAC ID of the device
+ *     Returns:
+ *         void
+ */
+void BTPairedDeviceConfirm(BT_t *bt, uint8_t *macId)
+{
+    uint8_t idx;
+    for (idx = 0; idx < bt->pairedDevicesCount; idx++) {
+        if (memcmp(macId, bt->pairedDevices[idx].macId, BT_MAC_ID_LEN) == 0) {
+            bt->pairedDevices[idx].cached = 0;
+        }
+    }
+}
+
+/**
+ * BTPairedDeviceGetScore()
+ *     Description:
+ *         Score how likely a reconnect to the device is to succeed, from its
+ *         attempt history. A device without history scores in the middle.
+ *     Params:
+ *         BTPairedDevice_t *dev - The device
+ *     Returns:
+ *         uint8_t - The score, from 0 to 255
+ */
+static uint8_t BTPairedDeviceGetScore(BTPairedDevice_t *dev)
+{
+    uint16_t attempts = dev->connectSuccesses + dev->connectFailures + 2;
+    return ((dev->connectSuccesses + 1) * 255) / attempts;
+}
+
+/**
+ * BTPairedDeviceGetLikely()
+ *     Description:
+ *         Rank the devices by how likely a reconnect to them is to succeed,
+ *         and get the device at the given rank. Devices that score the
+ *         same are ranked by how recently they connected.
+ *     Params:
+ *         BT_t *bt - A pointer to the module object
+ *         uint8_t rank - The rank, where 0 is the most likely device
+ *     Returns:
+ *         int8_t - The index of the device, or -1 if there is no such rank
+ */
+int8_t BTPairedDeviceGetLikely(BT_t *bt, uint8_t rank)
+{
+    uint8_t ranked = 0;
+    int8_t best = -1;
+    if (rank >= bt->pairedDevicesCount) {
+        return -1;
+    }
+    do {
+        uint8_t idx;
+        best = -1;
+        for (idx = 0; idx < bt->pairedDevicesCount; idx++) {
+            if ((ranked & (1 << idx)) != 0) {
+                continue;
+            }
+            if (best == -1) {
+                best = idx;
+                continue;
+            }
+            BTPairedDevice_t *dev = &bt->pairedDevices[idx];
+            BTPairedDevice_t *bestDev = &bt->pairedDevices[best];
+            uint8_t score = BTPairedDeviceGetScore(dev);
+            uint8_t bestScore = BTPairedDeviceGetScore(bestDev);
+            if (score > bestScore ||
+                (score == bestScore && dev->lastSeen > bestDev->lastSeen)
+            ) {
+                best = idx;
+            }
+        }
+        ranked |= 1 << best;
+    } while (rank-- > 0);
+    return best;
+}
+
+/**
+ * BTPairedDeviceGetRecent()
+ *     Description:
+ *         Get the device that connected most recently
+ *     Params:
+ *         BT_t *bt - A pointer to the module object
+ *     Returns:
+ *         int8_t - The index of the device, or -1 if no device has connected
+ */
+int8_t BTPairedDeviceGetRecent(BT_t *bt)
+{
+    int8_t recent = -1;
+    uint16_t lastSeen = 0;
+    uint8_t idx;
+    for (idx = 0; idx < bt->pairedDevicesCount; idx++) {
+        if (bt->pairedDevices[idx].lastSeen > lastSeen) {
+            lastSeen = bt->pairedDevices[idx].lastSeen;
+            recent = idx;
+        }
+    }
+    return recent;
+}
+
+/**
+ * BTPairedDeviceSetResult()
+ *     Description:
+ *         Count the outcome of a reconnect attempt to a device. Both counts
+ *         are halved when one of them fills up, so that the recent history
+ *         weighs the most. The counts are stored with the next table write.
+ *     Params:
+ *         BT_t *bt - A pointer to the module object
+ *         uint8_t *macId - The MAC ID of the device
+ *         uint8_t success - 1 if the attempt connected, 0 otherwise
+ *     Returns:
+ *         void
+ */
+void BTPairedDeviceSetResult(BT_t *bt, uint8_t *macId, uint8_t success)
+{
+    uint8_t idx;
+    for (idx = 0; idx < bt->pairedDevicesCount; idx++) {
+        BTPairedDevice_t *dev = &bt->pairedDevices[idx];
+        if (memcmp(macId, dev->macId, BT_MAC_ID_LEN) != 0) {
+            continue;
+        }
+        if (dev->connectSuccesses == 0xFF || dev->connectFailures == 0xFF) {
+            dev->connectSuccesses = dev->connectSuccesses / 2;
+            dev->connectFailures = dev->connectFailures / 2;
+        }
+        if (success == 1) {
+            dev->connectSuccesses++;
+        } else {
+            dev->connectFailures++;
+        }
+    }
+}
+
+/**
+ * BTPairedDeviceSetSeen()
+ *     Description:
+ *         Record that a device connected, and store the table. Nothing is
+ *         written if it was already the device that connected last, so the
+ *         same phone reconnecting does not wear the EEPROM.
+ *     Params:
+ *         BT_t *bt - A pointer to the module object
+ *         uint8_t *macId - The MAC ID of the device
+ *     Returns:
+ *         void
+ */
+void BTPairedDeviceSetSeen(BT_t *bt, uint8_t *macId)
+{
+    uint8_t idx;
+    int8_t recent = BTPairedDeviceGetRecent(bt);
+    for (idx = 0; idx < bt->pairedDevicesCount; idx++) {
+        BTPairedDevice_t *dev = &bt->pairedDevices[idx];
+        if (memcmp(macId, dev->macId, BT_MAC_ID_LEN) == 0 && recent != idx) {
+            // BTPairedDevicesSave() moves the generation on to match
+            dev->lastSeen = bt->pairedDevicesGeneration + 1;
+            BTPairedDevicesSave(bt);
+        }
+    }
+}
+
+/**
+ * BTPairedDevicesErase()
+ *     Description:
+ *         Invalidate the stored table, for when the module drops its pairings
+ *     Params:
+ *         BT_t *bt - A pointer to the module object
+ *     Returns:
+ *         void
+ */
+void BTPairedDevicesErase(BT_t *bt)
+{
+    EEPROMWriteByte(BT_PAIRED_DEVICES_ADDRESS, 0xFF);
+    bt->pairedDevicesGeneration = 0;
+}
+
+/**
+ * BTPairedDevicesPackRecord()
+ *     Description:
+ *         Pack a paired device into its EEPROM record
+ *     Params:
+ *         BTPairedDevice_t *dev - The device, or 0 for an empty record
+ *         uint8_t *record - The BT_PAIRED_DEVICES_RECORD_SIZE byte record
+ *     Returns:
+ *         void
+ */
+static void BTPairedDevicesPackRecord(BTPairedDevice_t *dev, uint8_t *record)
+{
+    memset(record, 0xFF, BT_PAIRED_DEVICES_RECORD_SIZE);
+    if (dev == 0) {
+        return;
+    }
+    memcpy(&record[BT_PAIRED_DEVICES_RECORD_MAC_ID], dev->macId, BT_MAC_ID_LEN);
+    record[BT_PAIRED_DEVICES_RECORD_NUMBER] = dev->number;
+    record[BT_PAIRED_DEVICES_RECORD_LAST_SEEN] = dev->lastSeen >> 8;
+    record[BT_PAIRED_DEVICES_RECORD_LAST_SEEN + 1] = dev->lastSeen & 0xFF;
+    record[BT_PAIRED_DEVICES_RECORD_SUCCESSES] = dev->connectSuccesses;
+    record[BT_PAIRED_DEVICES_RECORD_FAILURES] = dev->connectFailures;
+    // The name is null terminated unless it fills the record
+    strncpy(
+        (char *) &record[BT_PAIRED_DEVICES_RECORD_NAME],
+        dev->deviceName,
+        BT_PAIRED_DEVICES_RECORD_SIZE - BT_PAIRED_DEVICES_RECORD_NAME
+    );
+}
+
+/**
+ * BTPairedDevicesLoad()
+ *     Description:
+ *         Load the stored paired device table. The devices are marked as
+ *         cached until the module confirms them.
+ *     Params:
+ *         BT_t *bt - A pointer to the module object
+ *     Returns:
+ *         void
+ */
+void BTPairedDevicesLoad(BT_t *bt)
+{
+    uint8_t header[BT_PAIRED_DEVICES_HEADER_SIZE];
+    uint8_t record[BT_PAIRED_DEVICES_RECORD_SIZE];
+    uint8_t idx;
+    EEPROMReadBytes(BT_PAIRED_DEVICES_ADDRESS, header, sizeof(header));
+    uint8_t count = header[1];
+    if (header[0] != BT_PAIRED_DEVICES_MAGIC || count > BT_MAX_DEVICE_PAIRED) {
+        return;
+    }
+    uint32_t checksum = ((uint32_t) header[4] << 24) |
+        ((uint32_t) header[5] << 16) |
+        ((uint16_t) header[6] << 8) |
+        header[7];
+    uint32_t hash = UTILS_HASH_SEED;
+    for (idx = 0; idx < count; idx++) {
+        EEPROMReadBytes(
+            BT_PAIRED_DEVICES_ADDRESS + BT_PAIRED_DEVICES_HEADER_SIZE +
+                (idx * BT_PAIRED_DEVICES_RECORD_SIZE),
+            record,
+            BT_PAIRED_DEVICES_RECORD_SIZE
+        );
+        hash = UtilsHashBytes(hash, record, BT_PAIRED_DEVICES_RECORD_SIZE);
+        BTPairedDevice_t *dev = &bt->pairedDevices[idx];
+        memset(dev, 0, sizeof(BTPairedDevice_t));
+        memcpy(dev->macId, &record[BT_PAIRED_DEVICES_RECORD_MAC_ID], BT_MAC_ID_LEN);
+        dev->number = record[BT_PAIRED_DEVICES_RECORD_NUMBER];
+        dev->lastSeen = (record[BT_PAIRED_DEVICES_RECORD_LAST_SEEN] << 8) |
+            record[BT_PAIRED_DEVICES_RECORD_LAST_SEEN + 1];
+        dev->connectSuccesses = record[BT_PAIRED_DEVICES_RECORD_SUCCESSES];
+        dev->connectFailures = record[BT_PAIRED_DEVICES_RECORD_FAILURES];
+        memcpy(
+            dev->deviceName,
+            &record[BT_PAIRED_DEVICES_RECORD_NAME],
+            BT_PAIRED_DEVICES_RECORD_SIZE - BT_PAIRED_DEVICES_RECORD_NAME
+        );
+        dev->cached = 1;
+    }
+    if (hash != checksum) {
+        // A write was interrupted, so the module list has to be waited for
+        LogWarning("BT: Stored paired devices are corrupt");
+        memset(bt->pairedDevices, 0, sizeof(bt->pairedDevices));
+        return;
+    }
+    bt->pairedDevicesCount = count;
+    bt->pairedDevicesGeneration = (header[2] << 8) | header[3];
+    LogDebug(LOG_SOURCE_BT, "BT: Loaded %d stored paired devices", count);
+}
+
+/**
+ * BTPairedDevicesReconcile()
+ *     Description:
+ *         Drop the devices that the module did not list, once its list is
+ *         complete, and store the result
+ *     Params:
+ *         BT_t *bt - A pointer to the module object
+ *     Returns:
+ *         void
+ */
+void BTPairedDevicesReconcile(BT_t *bt)
+{
+    uint8_t idx;
+    uint8_t kept = 0;
+    for (idx = 0; idx < bt->pairedDevicesCount; idx++) {
+        if (bt->pairedDevices[idx].cached == 0) {
+            if (kept != idx) {
+                bt->pairedDevices[kept] = bt->pairedDevices[idx];
+            }
+            kept++;
+        } else {
+            LogDebug(LOG_SOURCE_BT, "BT: Dropping stale paired device %d", idx);
+        }
+    }
+    for (idx = kept; idx < bt->pairedDevicesCount; idx++) {
+        memset(&bt->pairedDevices[idx], 0, sizeof(BTPairedDevice_t));
+    }
+    bt->pairedDevicesCount = kept;
+    BTPairedDevicesSave(bt);
+}
+
+/**
+ * BTPairedDevicesSave()
+ *     Description:
+ *         Store the paired device table. Only the pages that changed are
+ *         written, and the header goes last with the next generation and a
+ *         checksum, so an interrupted write is caught by BTPairedDevicesLoad()
+ *     Params:
+ *         BT_t *bt - A pointer to the module object
+ *     Returns:
+ *         void
+ */
+void BTPairedDevicesSave(BT_t *bt)
+{
+    uint8_t page[EEPROM_PAGE_SIZE];
+    uint8_t stored[EEPROM_PAGE_SIZE];
+    uint8_t record[BT_PAIRED_DEVICES_RECORD_SIZE];
+    uint8_t header[BT_PAIRED_DEVICES_HEADER_SIZE];
+    uint8_t changed = 0;
+    uint32_t hash = UTILS_HASH_SEED;
+    uint16_t offset = 0;
+    int8_t packed = -1;
+    while (offset < BT_PAIRED_DEVICES_SIZE) {
+        uint8_t length = EEPROM_PAGE_SIZE;
+        uint8_t i;
+        if (BT_PAIRED_DEVICES_SIZE - offset < length) {
+            length = BT_PAIRED_DEVICES_SIZE - offset;
+        }
+        for (i = 0; i < length; i++) {
+            uint16_t position = offset + i;
+            if (position < BT_PAIRED_DEVICES_HEADER_SIZE) {
+                // Filled in once the checksum is known
+                page[i] = 0;
+                continue;
+            }
+            position -= BT_PAIRED_DEVICES_HEADER_SIZE;
+            uint8_t idx = position / BT_PAIRED_DEVICES_RECORD_SIZE;
+            if (idx != packed) {
+                if (idx < bt->pairedDevicesCount) {
+                    BTPairedDevicesPackRecord(&bt->pairedDevices[idx], record);
+                    hash = UtilsHashBytes(hash, record, BT_PAIRED_DEVICES_RECORD_SIZE);
+                } else {
+                    BTPairedDevicesPackRecord(0, record);
+                }
+                packed = idx;
+            }
+            page[i] = record[position % BT_PAIRED_DEVICES_RECORD_SIZE];
+        }
+        EEPROMReadBytes(BT_PAIRED_DEVICES_ADDRESS + offset, stored, length);
+        if (offset == 0) {
+            // Keep the stored header until the records are written
+            memcpy(page, stored, BT_PAIRED_DEVICES_HEADER_SIZE);
+        }
+        if (memcmp(page, stored, length) != 0) {
+            EEPROMWritePage(BT_PAIRED_DEVICES_ADDRESS + offset, page, length);
+            changed = 1;
+        }
+        offset += length;
+    }
+    EEPROMReadBytes(BT_PAIRED_DEVICES_ADDRESS, header, sizeof(header));
+    if (changed == 0 &&
+        header[0] == BT_PAIRED_DEVICES_MAGIC &&
+        header[1] == bt->pairedDevicesCount
+    ) {
+        return;
+    }
+    bt->pairedDevicesGeneration++;
+    header[0] = BT_PAIRED_DEVICES_MAGIC;
+    header[1] = bt->pairedDevicesCount;
+    header[2] = bt->pairedDevicesGeneration >> 8;
+    header[3] = bt->pairedDevicesGeneration & 0xFF;
+    header[4] = hash >> 24;
+    header[5] = hash >> 16;
+    header[6] = hash >> 8;
+    header[7] = hash & 0xFF;
+    EEPROMWritePage(BT_PAIRED_DEVICES_ADDRESS, header, sizeof(header));
+}
@@ -7,12 +7,18 @@
 #ifndef BT_COMMON_H
 #define BT_COMMON_H
 #include "../../mappings.h"
+#include "../eeprom.h"
 #include "../log.h"
 #include "../event.h"
+#include "../trace.h"
 #include "../uart.h"
+#include "../utils.h"
 
 #define BT_AVRCP_ACTION_GET_METADATA 0
 #define BT_AVRCP_ACTION_SET_TRACK_CHANGE_NOTIF 1
+#define BT_AVRCP_ACTION_GET_CAPABILITIES 2
+#define BT_AVRCP_ACTION_SET_PLAYBACK_CHANGE_NOTIF 3
+#define BT_AVRCP_ACTION_SET_NOW_PLAYING_NOTIF 4
 
 #define BT_AVRCP_STATUS_PAUSED 0
 #define BT_AVRCP_STATUS_PLAYING 1
@@ -56,9 +62,62 @@
 #define BT_EVENT_BTM_ADDRESS 15
 #define BT_EVENT_TIME_UPDATE 16
 #define BT_EVENT_DSP_STATUS 17
+#define BT_EVENT_COMMAND_COMPLETE 18
+#define BT_EVENT_BROWSE_UPDATE 19
+
+/*
+ * Browsing is fetched in pages that fill the GT index rows of a list menu.
+ * Only the visible page and one page of prefetch are held in RAM, however
+ * long the folder or playlist is.
+ */
+#define BT_BROWSE_PAGE_SIZE 6
+#define BT_BROWSE_WINDOW_PAGES 2
+#define BT_BROWSE_NAME_SIZE 32
+#define BT_BROWSE_UID_LEN 8
+#define BT_BROWSE_COUNT_UNKNOWN 0xFFFF
+#define BT_BROWSE_PAGE_NONE 0xFFFF
+// Set as the pending page while a folder change is outstanding
+#define BT_BROWSE_PAGE_PATH 0xFFFE
+#define BT_BROWSE_REQUEST_TIMEOUT 2000
+#define BT_BROWSE_SCOPE_NONE 0x00
+#define BT_BROWSE_SCOPE_FILESYSTEM 0x01
+#define BT_BROWSE_SCOPE_NOW_PLAYING 0x03
+#define BT_BROWSE_ITEM_TYPE_FOLDER 0x02
+#define BT_BROWSE_ITEM_TYPE_MEDIA 0x03
 
 #define BT_LEN_MAC_ID 6
 
+/*
+ * The paired device table is kept in the EEPROM so the menus and the
+ * reconnect logic can use it at boot, before the module has been queried.
+ * It sits between the configuration and the phonebook:
+ *     Header - Magic, device count, generation (2), checksum (4)
+ *     Records - BT_MAX_DEVICE_PAIRED records of BT_PAIRED_DEVICES_RECORD_SIZE
+ */
+#define BT_PAIRED_DEVICES_ADDRESS 0x0100
+// Change the magic when the record layout changes, so old tables are rebuilt
+#define BT_PAIRED_DEVICES_MAGIC 0xD4
+#define BT_PAIRED_DEVICES_HEADER_SIZE 8
+#define BT_PAIRED_DEVICES_RECORD_SIZE 40
+#define BT_PAIRED_DEVICES_RECORD_MAC_ID 0
+#define BT_PAIRED_DEVICES_RECORD_NUMBER 6
+#define BT_PAIRED_DEVICES_RECORD_LAST_SEEN 7
+#define BT_PAIRED_DEVICES_RECORD_SUCCESSES 9
+#define BT_PAIRED_DEVICES_RECORD_FAILURES 10
+#define BT_PAIRED_DEVICES_RECORD_NAME 11
+#define BT_PAIRED_DEVICES_SIZE (BT_PAIRED_DEVICES_HEADER_SIZE + \
+    (BT_MAX_DEVICE_PAIRED * BT_PAIRED_DEVICES_RECORD_SIZE))
+
+/*
+ * Reconnect scheduling. The first attempt goes out straight away, then the
+ * delay doubles after each round over the paired devices, with up to a
+ * quarter of it added as jitter
+ */
+#define BT_RECONNECT_DELAY_MIN 4000
+#define BT_RECONNECT_DELAY_MAX 64000
+#define BT_RECONNECT_STATUS_IDLE 0
+#define BT_RECONNECT_STATUS_ACTIVE 1
+
 #define BT_LINK_ID_BLE 4
 #define BT_MAX_DEVICE_PAIRED 8
 #define BT_MAX_DEVICE_PROFILES 5
@@ -96,19 +155,74 @@
  *     Fields:
  *         macId - The MAC ID of the device (6 bytes)
  *         deviceName - The friendly name of the device
+ *         number - The pairing record number on the module
+ *         lastSeen - The table generation when the device last connected
+ *         connectSuccesses - Reconnect attempts to the device that succeeded
+ *         connectFailures - Reconnect attempts to the device that failed
+ *         cached - Loaded from the EEPROM and not yet confirmed by the module
  */
 typedef struct BTPairedDevice_t {
     uint8_t macId[BT_MAC_ID_LEN];
     char deviceName[BT_DEVICE_NAME_LEN];
     uint8_t number;
+    uint16_t lastSeen;
+    uint8_t connectSuccesses;
+    uint8_t connectFailures;
+    uint8_t cached;
 } BTPairedDevice_t;
 
+/**
+ * BTReconnect_t
+ *     Description:
+ *         The reconnect scheduler state and its statistics
+ *     Fields:
+ *         status - BT_RECONNECT_STATUS_IDLE or BT_RECONNECT_STATUS_ACTIVE
+ *         pending - Set while an attempt is in flight
+ *         tried - The devices tried in this round, one bit per device
+ *         macId - The MAC ID of the device the attempt in flight is for
+ *         preferred - The MAC ID of a device known to be in range, to be
+ *             tried next, or all zeros
+ *         attempts - The attempts made since the scheduler started
+ *         delay - The current delay between attempts, before jitter
+ *         start - The time the scheduler started
+ *         scheduled - The time the next attempt was scheduled at
+ *         wait - The time from scheduled to the next attempt
+ *         seed - The jitter generator state
+ *         connects - The connections made by the scheduler
+ *         lastAttempts - The attempts the last connection took
+ *         lastDuration - The time the last connection took
+ */
+typedef struct BTReconnect_t {
+    uint8_t status;
+    uint8_t pending;
+    uint8_t tried;
+    uint8_t macId[BT_MAC_ID_LEN];
+    uint8_t preferred[BT_MAC_ID_LEN];
+    uint16_t attempts;
+    uint16_t delay;
+    uint32_t start;
+    uint32_t scheduled;
+    uint32_t wait;
+    uint32_t seed;
+    uint16_t connects;
+    uint16_t lastAttempts;
+    uint32_t lastDuration;
+} BTReconnect_t;
+
 /**
  * BTConnectionAVRCPCapbilities_t
  *     Description:
  *         This object defines the capabilities of the currently connected
  *         devices
  *     Fields:
+ *         playbackChanged - EVENT_PLAYBACK_STATUS_CHANGED is supported
+ *         trackChanged - EVENT_TRACK_CHANGED is supported
+ *         trackReachedEnd - EVENT_TRACK_REACHED_END is supported
+ *         trackReachedStart - EVENT_TRACK_REACHED_START is supported
+ *         playbackPosChanged - EVENT_PLAYBACK_POS_CHANGED is supported
+ *         nowPlayingChanged - EVENT_NOW_PLAYING_CONTENT_CHANGED is supported
+ *         volumeChanged - EVENT_VOLUME_CHANGED is supported
+ *         received - The device has answered the capabilities request
  */
 typedef struct BTConnectionAVRCPCapabilities_t {
     uint8_t playbackChanged: 1;
@@ -118,8 +232,58 @@ typedef struct BTConnectionAVRCPCapabilities_t {
     uint8_t playbackPosChanged: 1;
     uint8_t nowPlayingChanged: 1;
     uint8_t volumeChanged: 1;
+    uint8_t received: 1;
 } BTConnectionAVRCPCapabilities_t;
 
+/**
+ * BTBrowseItem_t
+ *     Description:
+ *         A folder or media item, as received from the device. The name is
+ *         kept raw and only normalized when it is displayed.
+ *     Fields:
+ *         uid - The item UID
+ *         type - The item type (BT_BROWSE_ITEM_TYPE_*)
+ *         name - The raw item name, null terminated and truncated
+ */
+typedef struct BTBrowseItem_t {
+    uint8_t uid[BT_BROWSE_UID_LEN];
+    uint8_t type;
+    char name[BT_BROWSE_NAME_SIZE];
+} BTBrowseItem_t;
+
+/**
+ * BTBrowse_t
+ *     Description:
+ *         The browsing window of the current folder or playlist. Each page
+ *         slot holds one page of items, tagged with the page number.
+ *     Fields:
+ *         scope - The browsed scope (BT_BROWSE_SCOPE_*)
+ *         depth - The number of folders entered below the root
+ *         pendingDepth - The depth once the pending folder change succeeds
+ *         uidCounter - The UID counter the device last reported
+ *         itemCount - The number of items, or BT_BROWSE_COUNT_UNKNOWN
+ *         position - The index of the first visible item
+ *         pending - The page that was requested, BT_BROWSE_PAGE_PATH for a
+ *             folder change, or BT_BROWSE_PAGE_NONE
+ *         requestTimestamp - The time the pending request was sent
+ *         pageTags - The page held in each slot, or BT_BROWSE_PAGE_NONE
+ *         pageCounts - The number of items in each slot
+ *         items - The page slots
+ */
+typedef struct BTBrowse_t {
+    uint8_t scope;
+    uint8_t depth;
+    uint8_t pendingDepth;
+    uint16_t uidCounter;
+    uint16_t itemCount;
+    uint16_t position;
+    uint16_t pending;
+    uint32_t requestTimestamp;
+    uint16_t pageTags[BT_BROWSE_WINDOW_PAGES];
+    uint8_t pageCounts[BT_BROWSE_WINDOW_PAGES];
+    BTBrowseItem_t items[BT_BROWSE_WINDOW_PAGES][BT_BROWSE_PAGE_SIZE];
+} BTBrowse_t;
+
 /**
  * BTConnection_t
  *     Description:
@@ -174,12 +338,19 @@ typedef struct BTConnection_t {
  *         powerState - 2/1/0 1 Standby, On, Off
  *         pairedDevicesCount - The number of devices that have paired with us
  *            in all of time. The max is 8.
+ *         pairedDevicesGeneration - The generation of the paired device table
+ *            stored in the EEPROM
  *         pairingErrors - The key indicates the profile in error and the value
  *             in error. This is used to track what profiles we need to re-attempt
  *             a connection with.
  *         metadataTimestamp - The last time we got metadata of any kind
+ *         titleHash - Hash of the raw title bytes last reported by the device
+ *         artistHash - Hash of the raw artist bytes last reported by the device
+ *         albumHash - Hash of the raw album bytes last reported by the device
  *         rxQueueAge - Used to track how long data has been sitting on the
  *             RX queue without getting a MSG_END_CHAR.
+ *         browse - The AVRCP browsing window
+ *         reconnect - The reconnect scheduler
  */
 typedef struct BT_t {
     BTConnection_t activeDevice;
@@ -188,7 +359,7 @@ typedef struct BT_t {
     uint8_t type: 1;
     uint8_t connectable: 1;
     uint8_t discoverable: 1;
-    uint8_t avrcpUpdates: 2;
+    uint8_t avrcpUpdates: 5;
     uint8_t metadataStatus: 1;
     uint8_t playbackStatus: 1;
     uint8_t vrStatus: 1;
@@ -197,21 +368,40 @@ typedef struct BT_t {
     uint8_t powerState: 2;
     uint8_t pairedDevicesCount: 4;
     uint8_t pairingErrors[BT_PROFILE_COUNT];
+    uint16_t pairedDevicesGeneration;
     uint32_t metadataTimestamp;
+    uint32_t titleHash;
+    uint32_t artistHash;
+    uint32_t albumHash;
     uint32_t rxQueueAge;
     char title[BT_METADATA_FIELD_SIZE];
     char artist[BT_METADATA_FIELD_SIZE];
     char album[BT_METADATA_FIELD_SIZE];
     char callerId[BT_CALLER_ID_FIELD_SIZE];
     char dialBuffer[BT_DIAL_BUFFER_FIELD_SIZE];
+    BTBrowse_t browse;
+    BTReconnect_t reconnect;
     UART_t uart;
 } BT_t;
 
+void BTBrowseClear(BT_t *, uint8_t);
+BTBrowseItem_t *BTBrowseGetItem(BT_t *, uint16_t);
+void BTBrowseGetItemName(BTBrowseItem_t *, char *, uint8_t);
+void BTBrowseStorePage(BT_t *, uint16_t, uint8_t);
 void BTClearMetadata(BT_t *);
 void BTClearActiveDevice(BT_t *);
 void BTClearMetadata(BT_t *);
 void BTClearPairedDevices(BT_t *, uint8_t);
 BTConnection_t BTConnectionInit();
+void BTPairedDeviceConfirm(BT_t *, uint8_t *);
 void BTPairedDeviceInit(BT_t *, uint8_t *, char *, uint8_t);
 char *BTPairedDeviceGetName(BT_t *, uint8_t *);
+int8_t BTPairedDeviceGetLikely(BT_t *, uint8_t);
+int8_t BTPairedDeviceGetRecent(BT_t *);
+void BTPairedDeviceSetResult(BT_t *, uint8_t *, uint8_t);
+void BTPairedDeviceSetSeen(BT_t *, uint8_t *);
+void BTPairedDevicesErase(BT_t *);
+void BTPairedDevicesLoad(BT_t *);
+void BTPairedDevicesReconcile(BT_t *);
+void BTPairedDevicesSave(BT_t *);
 #endif /* BT_COMMON_H */
\ No newline at end of file
@@ -20,6 +20,7 @@ CharQueue_t CharQueueInit()
     volatile CharQueue_t queue;
     // Initialize size and cursors
     CharQueueReset(&queue);
+    queue.maxSize = 0;
     return queue;
 }
 
@@ -42,6 +43,9 @@ void CharQueueAdd(volatile CharQueue_t *queue, const uint8_t value)
         if (queue->writeCursor >= CHAR_QUEUE_SIZE) {
             queue->writeCursor = 0;
         }
+        if (size >= queue->maxSize) {
+            queue->maxSize = size + 1;
+        }
     }
 }
 
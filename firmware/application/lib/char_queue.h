@@ -19,11 +19,13 @@
  *         needs to be read from and where the next byte should be added.
  *         Once those cursors are exhausted, meaning they've hit capacity, they
  *         are reset. If data is not removed from the buffer before it hits
- *         capacity, the data will be lost.
+ *         capacity, the data will be lost. The most bytes it has held at once
+ *         is kept in maxSize.
  */
 typedef struct CharQueue_t {
     volatile uint16_t readCursor;
     volatile uint16_t writeCursor;
+    volatile uint16_t maxSize;
     volatile uint8_t data[CHAR_QUEUE_SIZE];
 } CharQueue_t;
 
@@ -5,6 +5,7 @@
  *     Get & Set Configuration items on the EEPROM
  */
 #include "config.h"
+#include "locale.h"
 
 uint8_t CONFIG_SETTING_CACHE[CONFIG_SETTING_CACHE_SIZE] = {0};
 uint8_t CONFIG_VALUE_CACHE[CONFIG_VALUE_CACHE_SIZE] = {0};
@@ -376,6 +377,26 @@ void ConfigGetString(uint8_t address, char *string, uint8_t size)
     }
 }
 
+/**
+ * ConfigGetStackHighWaterMark()
+ *     Description:
+ *         Get the most stack that has ever been used
+ *     Params:
+ *         None
+ *     Returns:
+ *         uint16_t - The stack high water mark in bytes
+ */
+uint16_t ConfigGetStackHighWaterMark()
+{
+    uint8_t lsb = ConfigGetValue(CONFIG_INFO_STACK_HIGH_WATER_MARK_LSB);
+    uint8_t msb = ConfigGetValue(CONFIG_INFO_STACK_HIGH_WATER_MARK_MSB);
+    // The EEPROM is blank, so nothing has been recorded
+    if (lsb == 0xFF && msb == 0xFF) {
+        return 0;
+    }
+    return (msb << 8) + lsb;
+}
+
 /**
  * ConfigGetTelephonyFeaturesActive()
  *     Description:
@@ -750,6 +771,9 @@ void ConfigSetSetting(uint8_t setting, uint8_t value)
         setting <= CONFIG_SETTING_END_ADDRESS
     ) {
         ConfigSetByte(setting, value);
+        if (setting == CONFIG_SETTING_LANGUAGE) {
+            LocaleSetLanguage(value);
+        }
     }
 }
 
@@ -774,6 +798,21 @@ void ConfigSetString(uint8_t address, char *string, uint8_t size)
     ConfigSetByte(address, 0);
 }
 
+/**
+ * ConfigSetStackHighWaterMark()
+ *     Description:
+ *         Set the most stack that has ever been used
+ *     Params:
+ *         uint16_t highWaterMark - The stack high water mark in bytes
+ *     Returns:
+ *         void
+ */
+void ConfigSetStackHighWaterMark(uint16_t highWaterMark)
+{
+    ConfigSetValue(CONFIG_INFO_STACK_HIGH_WATER_MARK_MSB, highWaterMark >> 8);
+    ConfigSetValue(CONFIG_INFO_STACK_HIGH_WATER_MARK_LSB, highWaterMark & 0xFF);
+}
+
 /**
  * ConfigSetTempDisplay()
  *     Description:
@@ -894,6 +933,7 @@ void ConfigSetValue(uint8_t address, uint8_t value)
     if (address >= CONFIG_VALUE_START_ADDRESS &&
         address <= CONFIG_VALUE_END_ADDRESS
     ) {
+        CONFIG_VALUE_CACHE[address - CONFIG_VALUE_START_ADDRESS] = value;
         ConfigSetByte(address, value);
     }
 }
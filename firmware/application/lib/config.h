@@ -76,6 +76,8 @@
 /* Values 0xA0 - 0xB0: Informational & Counters */
 #define CONFIG_INFO_BC127_BOOT_FAIL_COUNTER_MSB_ADDRESS 0xA0
 #define CONFIG_INFO_BC127_BOOT_FAIL_COUNTER_LSB_ADDRESS 0xA1
+#define CONFIG_INFO_STACK_HIGH_WATER_MARK_MSB_ADDRESS 0xA2
+#define CONFIG_INFO_STACK_HIGH_WATER_MARK_LSB_ADDRESS 0xA3
 
 #define CONFIG_DEVICE_LOG_BT 2
 #define CONFIG_DEVICE_LOG_IBUS 3
@@ -167,6 +169,8 @@
 /* Values 0xA0 - 0xB0: Informational & Counters */
 #define CONFIG_INFO_BC127_BOOT_FAIL_COUNTER_MSB CONFIG_INFO_BC127_BOOT_FAIL_COUNTER_MSB_ADDRESS
 #define CONFIG_INFO_BC127_BOOT_FAIL_COUNTER_LSB CONFIG_INFO_BC127_BOOT_FAIL_COUNTER_LSB_ADDRESS
+#define CONFIG_INFO_STACK_HIGH_WATER_MARK_MSB CONFIG_INFO_STACK_HIGH_WATER_MARK_MSB_ADDRESS
+#define CONFIG_INFO_STACK_HIGH_WATER_MARK_LSB CONFIG_INFO_STACK_HIGH_WATER_MARK_LSB_ADDRESS
 /* Settings Boundary Helpers */
 #define CONFIG_SETTING_START_ADDRESS CONFIG_UI_MODE_ADDRESS
 #define CONFIG_SETTING_END_ADDRESS 0x70
@@ -193,6 +197,7 @@ uint8_t ConfigGetLog(uint8_t);
 uint8_t ConfigGetNavType();
 uint16_t ConfigGetSerialNumber();
 uint8_t ConfigGetSetting(uint8_t);
+uint16_t ConfigGetStackHighWaterMark();
 uint8_t ConfigGetTelephonyFeaturesActive();
 uint8_t ConfigGetTempDisplay();
 uint8_t ConfigGetTempUnit();
@@ -214,6 +219,7 @@ void ConfigSetIKEType(uint8_t);
 void ConfigSetLMVariant(uint8_t);
 void ConfigSetLog(uint8_t, uint8_t);
 void ConfigSetSetting(uint8_t, uint8_t);
+void ConfigSetStackHighWaterMark(uint16_t);
 void ConfigSetString(uint8_t, char *, uint8_t);
 void ConfigSetNavType(uint8_t);
 void ConfigSetTempDisplay(uint8_t);
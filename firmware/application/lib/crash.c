@@ -0,0 +1,135 @@
+/*
+ * File:   crash.c
+ * Author: agent <agent@local>
+ * Description:
+ *     Keep a record of the state of the device when a trap was raised in
+ *     the EEPROM, so that the crash can be traced back to the code that
+ *     caused it. utility/crash_decoder.py maps the record to the symbols in
+ *     the firmware ELF.
+ */
+#include "crash.h"
+volatile uint16_t CRASH_CAPTURE[CRASH_CAPTURE_SIZE];
+
+/**
+ * CrashGetRecord()
+ *     Description:
+ *         Read the crash record from the EEPROM
+ *     Params:
+ *         CrashRecord_t *record - The record to read into
+ *     Returns:
+ *         uint8_t - 1 if there is a crash on record, 0 otherwise
+ */
+uint8_t CrashGetRecord(CrashRecord_t *record)
+{
+    EEPROMReadBytes(CRASH_RECORD_ADDRESS, (uint8_t *) record, CRASH_RECORD_SIZE);
+    if (record->magic != CRASH_RECORD_MAGIC) {
+        return 0;
+    }
+    return 1;
+}
+
+/**
+ * CrashGetReturnAddress()
+ *     Description:
+ *         Get the address that the trap would have returned to, which is
+ *         the instruction after the one that caused it
+ *     Params:
+ *         CrashRecord_t *record - The crash record
+ *     Returns:
+ *         uint32_t - The program address
+ */
+uint32_t CrashGetReturnAddress(CrashRecord_t *record)
+{
+    return ((uint32_t) (record->pc[1] & 0x7F) << 16) | record->pc[0];
+}
+
+/**
+ * CrashGetTrapName()
+ *     Description:
+ *         Get the name of a trap
+ *     Params:
+ *         uint8_t trap - The CONFIG_TRAP_* counter of the trap
+ *     Returns:
+ *         const char * - The name
+ */
+const char *CrashGetTrapName(uint8_t trap)
+{
+    switch (trap) {
+        case CONFIG_TRAP_OSC:
+            return "Oscillator Failure";
+        case CONFIG_TRAP_ADDR:
+            return "Address Error";
+        case CONFIG_TRAP_STACK:
+            return "Stack Error";
+        case CONFIG_TRAP_MATH:
+            return "Math Error";
+        case CONFIG_TRAP_NVM:
+            return "NVM Error";
+        case CONFIG_TRAP_GEN:
+            return "General Error";
+    }
+    return "Unknown";
+}
+
+/**
+ * CrashRecord()
+ *     Description:
+ *         Write what the trap entry captured, and the state of the main loop,
+ *         the queues and the stack to the EEPROM. This is only called from
+ *         a trap, and blocks until the EEPROM has been written.
+ *     Params:
+ *         uint8_t trap - The CONFIG_TRAP_* counter of the trap
+ *     Returns:
+ *         void
+ */
+void CrashRecord(uint8_t trap)
+{
+    CrashRecord_t record;
+    uint8_t i;
+    memset(&record, 0, sizeof(record));
+    record.magic = CRASH_RECORD_MAGIC;
+    record.trap = trap;
+    record.intcon1 = CRASH_CAPTURE[CRASH_CAPTURE_INTCON1];
+    record.uptime = TimerGetMillis();
+    for (i = 0; i < 16; i++) {
+        record.w[i] = CRASH_CAPTURE[i];
+    }
+    record.pc[0] = CRASH_CAPTURE[CRASH_CAPTURE_PC];
+    record.pc[1] = CRASH_CAPTURE[CRASH_CAPTURE_PC + 1];
+    for (i = 0; i < CRASH_STACK_WORDS; i++) {
+        record.stack[i] = CRASH_CAPTURE[CRASH_CAPTURE_STACK + i];
+    }
+    record.splim = SPLIM;
+    record.stackHighWaterMark = StackGetHighWaterMark();
+    for (i = 0; i < CRASH_UART_COUNT; i++) {
+        UART_t *uart = UARTGetModuleHandler(i + 1);
+        if (uart != 0) {
+            record.rxQueueMax[i] = uart->rxQueue.maxSize;
+            record.txQueueMax[i] = uart->txQueueMax;
+        }
+    }
+    ProfileGetStageHistory(record.stages);
+    record.version[0] = FIRMWARE_VERSION_MAJOR;
+    record.version[1] = FIRMWARE_VERSION_MINOR;
+    record.version[2] = FIRMWARE_VERSION_PATCH;
+    record.version[3] = UtilsGetBoardVersion();
+    uint8_t *data = (uint8_t *) &record;
+    for (i = 0; i < CRASH_RECORD_SIZE; i += EEPROM_PAGE_SIZE) {
+        EEPROMWritePage(CRASH_RECORD_ADDRESS + i, &data[i], EEPROM_PAGE_SIZE);
+    }
+    EEPROMIsReady();
+}
+
+/**
+ * CrashReset()
+ *     Description:
+ *         Forget the crash on record
+ *     Params:
+ *         None
+ *     Returns:
+ *         void
+ */
+void CrashReset()
+{
+    EEPROMWriteByte(CRASH_RECORD_ADDRESS, 0xFF);
+}
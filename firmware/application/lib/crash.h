@@ -0,0 +1,89 @@
+/*
+ * File:   crash.h
+ * Author: agent <agent@local>
+ * Description:
+ *     Keep a record of the state of the device when a trap was raised in
+ *     the EEPROM, so that the crash can be traced back to the code that
+ *     caused it. utility/crash_decoder.py maps the record to the symbols in
+ *     the firmware ELF.
+ */
+#ifndef CRASH_H
+#define CRASH_H
+#include <stdint.h>
+#include <string.h>
+#include <xc.h>
+#include "../mappings.h"
+#include "config.h"
+#include "eeprom.h"
+#include "profile.h"
+#include "stack.h"
+#include "timer.h"
+#include "uart.h"
+#include "utils.h"
+
+/* EEPROM 0x300 - 0x37F: Reserved for the crash record */
+#define CRASH_RECORD_ADDRESS 0x300
+#define CRASH_RECORD_SIZE 128
+#define CRASH_RECORD_MAGIC 0xC5
+// The UART modules that the queue high water marks are kept for
+#define CRASH_UART_COUNT 4
+// The words from the top of the stack when the trap was raised. This must
+// match the number that crash_trap.s copies.
+#define CRASH_STACK_WORDS 26
+// The trap entries in crash_trap.s copy W0 - W15, the two words of the
+// return address, INTCON1 and the top of the stack into CRASH_CAPTURE, in
+// order
+#define CRASH_CAPTURE_PC 16
+#define CRASH_CAPTURE_INTCON1 18
+#define CRASH_CAPTURE_STACK 19
+#define CRASH_CAPTURE_SIZE (CRASH_CAPTURE_STACK + CRASH_STACK_WORDS)
+
+/**
+ * CrashRecord_t
+ *     Description:
+ *         The state of the device when a trap was raised, as it is kept in
+ *         the EEPROM. Every field sits on a multiple of its own size, so the
+ *         layout is the same for every compiler.
+ *     Fields:
+ *         magic - CRASH_RECORD_MAGIC if the record is in use
+ *         trap - The CONFIG_TRAP_* counter of the trap
+ *         intcon1 - INTCON1, which says what caused the trap
+ *         uptime - The milliseconds since boot
+ *         pc - The return address pushed by the trap: PC<15:0>, then
+ *             SR<7:0>, IPL3 and PC<22:16>
+ *         w - W0 - W15. W15 is the stack pointer after the trap pushed pc.
+ *         splim - The stack pointer limit
+ *         stackHighWaterMark - The most bytes of stack used since boot
+ *         rxQueueMax - The most bytes each UART RX queue has held
+ *         txQueueMax - The most bytes each UART TX queue has held
+ *         stages - The last main loop stages to finish, oldest first. The
+ *             stage after the newest one was running.
+ *         version - The firmware major, minor and patch version, and the
+ *             board version
+ *         stack - The words below pc on the stack, the oldest first
+ */
+typedef struct CrashRecord_t {
+    uint8_t magic;
+    uint8_t trap;
+    uint16_t intcon1;
+    uint32_t uptime;
+    uint16_t pc[2];
+    uint16_t w[16];
+    uint16_t splim;
+    uint16_t stackHighWaterMark;
+    uint16_t rxQueueMax[CRASH_UART_COUNT];
+    uint16_t txQueueMax[CRASH_UART_COUNT];
+    uint8_t stages[PROFILE_STAGE_HISTORY_SIZE];
+    uint8_t version[4];
+    uint16_t stack[CRASH_STACK_WORDS];
+} CrashRecord_t;
+
+// Filled by the trap entries in crash_trap.s
+extern volatile uint16_t CRASH_CAPTURE[CRASH_CAPTURE_SIZE];
+
+uint8_t CrashGetRecord(CrashRecord_t *);
+uint32_t CrashGetReturnAddress(CrashRecord_t *);
+const char *CrashGetTrapName(uint8_t);
+void CrashRecord(uint8_t);
+void CrashReset();
+#endif /* CRASH_H */
@@ -0,0 +1,60 @@
+;
+; File: crash_trap.s
+; Author: agent <agent@local>
+; Description:
+;     The trap vectors. Each one copies W0 - W15, the return address, INTCON1
+;     and the top of the stack into CRASH_CAPTURE before the compiler's
+;     prologue or the trap handler can change them. It then moves the stack
+;     pointer back to where main() left it, so that a stack error has room to
+;     be handled, and calls the trap handler in main.c, which does not return.
+;
+.include "p24Fxxxx.inc"
+.text
+
+; The stack words to copy, which is CRASH_STACK_WORDS in crash.h
+.equ CRASH_STACK_WORDS, 26
+
+.macro TRAP_ENTRY vector, handler
+    .global __\vector
+    __\vector:
+        mov    w0, _CRASH_CAPTURE ; Keep W0 before it becomes the cursor
+        mov    #(_CRASH_CAPTURE + 2), w0
+        mov    w1, [w0++]
+        mov    w2, [w0++]
+        mov    w3, [w0++]
+        mov    w4, [w0++]
+        mov    w5, [w0++]
+        mov    w6, [w0++]
+        mov    w7, [w0++]
+        mov    w8, [w0++]
+        mov    w9, [w0++]
+        mov    w10, [w0++]
+        mov    w11, [w0++]
+        mov    w12, [w0++]
+        mov    w13, [w0++]
+        mov    w14, [w0++]
+        mov    w15, [w0++]
+        mov    [w15 - 4], w1 ; PC<15:0>
+        mov    w1, [w0++]
+        mov    [w15 - 2], w1 ; SR<7:0>, IPL3 and PC<22:16>
+        mov    w1, [w0++]
+        mov    INTCON1, w1 ; The trap flags, before the handler clears them
+        mov    w1, [w0++]
+        mov    #(4 + 2 * CRASH_STACK_WORDS), w2
+        sub    w15, w2, w1 ; The stack words below the return address
+        repeat #(CRASH_STACK_WORDS - 1)
+        mov    [w1++], [w0++]
+        mov    _STACK_BASE, w1 ; Zero until the stack has been painted
+        cp0    w1
+        bra    z, 1f
+        mov    w1, w15
+    1:
+        call   _\handler
+.endm
+
+TRAP_ENTRY AltOscillatorFail, TrapOscillatorFail
+TRAP_ENTRY AltAddressError, TrapAddressError
+TRAP_ENTRY AltStackError, TrapStackError
+TRAP_ENTRY AltMathError, TrapMathError
+TRAP_ENTRY AltNVMError, TrapNVMError
+TRAP_ENTRY AltGeneralError, TrapGeneralError
@@ -99,6 +99,28 @@ void EEPROMErase()
     EEPROM_CS_PIN = 1;
 }
 
+/**
+ * EEPROMIsBusy()
+ *     Description:
+ *         Check if the EEPROM is still busy with a write cycle, without
+ *         waiting for it to finish
+ *     Params:
+ *         void
+ *     Returns:
+ *         uint8_t - 1 if the EEPROM is busy, 0 otherwise
+ */
+uint8_t EEPROMIsBusy()
+{
+    EEPROM_CS_PIN = 0;
+    EEPROMSend(EEPROM_COMMAND_RDSR);
+    char status = EEPROMSend(EEPROM_COMMAND_GET);
+    EEPROM_CS_PIN = 1;
+    if (status & EEPROM_STATUS_BUSY) {
+        return 1;
+    }
+    return 0;
+}
+
 /**
  * EEPROMIsReady()
  *     Description:
@@ -148,6 +170,51 @@ unsigned char EEPROMReadByte(uint32_t address)
     return data;
 }
 
+/**
+ * EEPROMSendAddress()
+ *     Description:
+ *         Clock out the address for a read or write sequence
+ *     Params:
+ *         uint32_t address - The memory address
+ *     Returns:
+ *         void
+ */
+static void EEPROMSendAddress(uint32_t address)
+{
+    // The HW1 boards use a 1024kB EEPROM while the HW2 boards use a
+    // 128kB EEPROM. This means that we need not send as many address bytes
+    if (UtilsGetBoardVersion() == BOARD_VERSION_ONE) {
+        EEPROMSend(address >> 16 & 0xFF);
+    }
+    EEPROMSend(address >> 8 & 0xFF);
+    EEPROMSend(address & 0xFF);
+}
+
+/**
+ * EEPROMReadBytes()
+ *     Description:
+ *         Read a run of bytes starting at the given address in a single
+ *         read sequence
+ *     Params:
+ *         uint32_t address - The memory address of the first byte
+ *         uint8_t *data - The buffer to read into
+ *         uint16_t length - The number of bytes to read
+ *     Returns:
+ *         void
+ */
+void EEPROMReadBytes(uint32_t address, uint8_t *data, uint16_t length)
+{
+    uint16_t i;
+    EEPROMIsReady();
+    EEPROM_CS_PIN = 0;
+    EEPROMSend(EEPROM_COMMAND_READ);
+    EEPROMSendAddress(address);
+    for (i = 0; i < length; i++) {
+        data[i] = (uint8_t) EEPROMSend(EEPROM_COMMAND_GET);
+    }
+    EEPROM_CS_PIN = 1;
+}
+
 /**
  * EEPROMWriteByte()
  *     Description:
@@ -174,3 +241,30 @@ void EEPROMWriteByte(uint32_t address, unsigned char data)
     EEPROMSend(data);
     EEPROM_CS_PIN = 1;
 }
+
+/**
+ * EEPROMWritePage()
+ *     Description:
+ *         Write up to a page of bytes in a single write cycle. The bytes must
+ *         not cross an EEPROM_PAGE_SIZE boundary. This waits for a previous
+ *         write to complete, but not for this one, so callers that must not
+ *         block should check EEPROMIsBusy() first.
+ *     Params:
+ *         uint32_t address - The memory address of the first byte
+ *         const uint8_t *data - The bytes to write
+ *         uint8_t length - The number of bytes to write
+ *     Returns:
+ *         void
+ */
+void EEPROMWritePage(uint32_t address, const uint8_t *data, uint8_t length)
+{
+    uint8_t i;
+    EEPROMEnableWrite();
+    EEPROM_CS_PIN = 0;
+    EEPROMSend(EEPROM_COMMAND_WRITE);
+    EEPROMSendAddress(address);
+    for (i = 0; i < length; i++) {
+        EEPROMSend(data[i]);
+    }
+    EEPROM_CS_PIN = 1;
+}
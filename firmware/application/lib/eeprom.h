@@ -22,10 +22,16 @@
 #define EEPROM_COMMAND_RDSR 0x05 // Read the status register
 #define EEPROM_COMMAND_GET 0x00 // Dummy byte used to retrieve data
 #define EEPROM_STATUS_BUSY 0x01 // EEPROM Busy status response
+// The smallest page of the EEPROMs we use (25LC128). Page writes must not
+// cross a page boundary, or they wrap around to the start of the page.
+#define EEPROM_PAGE_SIZE 64
 
 void EEPROMInit();
 void EEPROMErase();
+uint8_t EEPROMIsBusy();
 void EEPROMIsReady();
 unsigned char EEPROMReadByte(uint32_t);
+void EEPROMReadBytes(uint32_t, uint8_t *, uint16_t);
 void EEPROMWriteByte(uint32_t, unsigned char);
+void EEPROMWritePage(uint32_t, const uint8_t *, uint8_t);
 #endif /* EEPROM_H */
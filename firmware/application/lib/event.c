@@ -5,9 +5,29 @@
  *     Implement an event system so that modules can interact with each other
  */
 #include "event.h"
+#include "profile.h"
+#include "trace.h"
 volatile Event_t EVENT_CALLBACKS[EVENT_MAX_CALLBACKS];
 uint8_t EVENT_CALLBACKS_COUNT = 0;
 
+/**
+ * EventGetCallback()
+ *     Description:
+ *         Get a registered callback
+ *     Params:
+ *         uint8_t idx - The index of the callback in the callbacks array
+ *     Returns:
+ *         volatile Event_t * - The callback, or 0 if the index has never
+ *             been registered
+ */
+volatile Event_t *EventGetCallback(uint8_t idx)
+{
+    if (idx >= EVENT_CALLBACKS_COUNT) {
+        return 0;
+    }
+    return &EVENT_CALLBACKS[idx];
+}
+
 /**
  * EventRegisterCallback()
  *     Description:
@@ -69,10 +89,13 @@ uint8_t EventUnregisterCallback(uint8_t eventType, void *callback)
 void EventTriggerCallback(uint8_t eventType, unsigned char *data)
 {
     uint8_t idx;
+    TraceRecord(TRACE_POINT_EVENT, eventType, 0);
     for (idx = 0; idx < EVENT_CALLBACKS_COUNT; idx++) {
         volatile Event_t *cb = &EVENT_CALLBACKS[idx];
         if (cb->type == eventType) {
+            uint32_t begin = TimerGetCycles();
             cb->callback(cb->context, data);
+            ProfileRecordCallback(idx, begin);
         }
     }
 }
@@ -14,6 +14,7 @@ typedef struct Event_t {
     void *context;
     void (*callback) (void *, unsigned char *);
 } Event_t;
+volatile Event_t *EventGetCallback(uint8_t);
 void EventRegisterCallback(uint8_t, void *, void *);
 uint8_t EventUnregisterCallback(uint8_t, void *);
 void EventTriggerCallback(uint8_t, unsigned char *);
@@ -62,10 +62,11 @@ IBus_t IBusInit()
     ibus.pdcSensors = pdcSensors;
     ibus.rxBufferIdx = 0;
     ibus.rxLastStamp = 0;
+    ibus.rxFrameTimestamp = 0;
     ibus.txBufferReadIdx = 0;
     ibus.txBufferReadbackIdx = 0;
     ibus.txBufferWriteIdx = 0;
-    ibus.txLastStamp = TimerGetMillis();
+    ibus.txLastStamp = TimerGetMicros();
     return ibus;
 }
 
@@ -773,7 +774,17 @@ static void IBusHandleVMMessage(IBus_t *ibus, uint8_t *pkt)
     }
 }
 
-static uint8_t IBusValidateChecksum(uint8_t *msg)
+/**
+ * IBusValidateChecksum()
+ *     Description:
+ *         Check that the XOR of every byte of a message, including its
+ *         checksum, is zero
+ *     Params:
+ *         uint8_t *msg - The message, whose length is in its second byte
+ *     Returns:
+ *         uint8_t - 1 if the checksum is valid, 0 otherwise
+ */
+uint8_t IBusValidateChecksum(uint8_t *msg)
 {
     uint8_t chk = 0;
     uint8_t msgSize = msg[1] + 2;
@@ -802,6 +813,9 @@ void IBusProcess(IBus_t *ibus)
     // Read messages from the IBus and if none are available, attempt to
     // transmit whatever is sitting in the transmit buffer
     if (CharQueueGetSize(&ibus->uart.rxQueue) > 0) {
+        if (ibus->rxBufferIdx == 0) {
+            ibus->rxFrameTimestamp = UARTGetRXTimestamp(&ibus->uart);
+        }
         ibus->rxBuffer[ibus->rxBufferIdx++] = CharQueueNext(&ibus->uart.rxQueue);
         if (ibus->rxBufferIdx > 1) {
             uint8_t msgLength = ibus->rxBuffer[1] + 2;
@@ -844,6 +858,18 @@ void IBusProcess(IBus_t *ibus)
                 }
                 LogRawDebug(LOG_SOURCE_IBUS, "\r\n");
                 if (IBusValidateChecksum(pkt) == 1) {
+                    BootTraceMark(BOOT_TRACE_IBUS_FIRST_RX);
+                    TraceRecordAt(
+                        ibus->rxFrameTimestamp,
+                        TRACE_POINT_UART_RX,
+                        IBUS_UART_MODULE,
+                        0
+                    );
+                    TraceRecord(
+                        TRACE_POINT_IBUS_RX,
+                        pkt[IBUS_PKT_SRC],
+                        ((uint16_t) pkt[IBUS_PKT_DST] << 8) | pkt[IBUS_PKT_CMD]
+                    );
                     uint8_t srcSystem = pkt[IBUS_PKT_SRC];
                     if (srcSystem == IBUS_DEVICE_BLUEBUS &&
                         pkt[IBUS_PKT_DST] == IBUS_DEVICE_LOC
@@ -912,12 +938,13 @@ void IBusProcess(IBus_t *ibus)
     } else if (ibus->txBufferWriteIdx != ibus->txBufferReadIdx) {
         // Flush the transmit buffer out to the bus
         uint8_t txTimeout = IBUS_TX_TIMEOUT_OFF;
-        uint8_t beginTxTimestamp = TimerGetMillis();
+        uint32_t beginTxTimestamp = TimerGetMillis();
         while (ibus->txBufferWriteIdx != ibus->txBufferReadIdx &&
                txTimeout != IBUS_TX_TIMEOUT_ON
         ) {
             uint32_t now = TimerGetMillis();
-            if ((now - ibus->txLastStamp) >= IBUS_TX_BUFFER_WAIT) {
+            uint32_t idle = (TimerGetMicros() - ibus->txLastStamp) & TIMER_MICROS_MASK;
+            if (idle >= IBUS_TX_BUFFER_WAIT) {
                 uint8_t msgLen = ibus->txBuffer[ibus->txBufferReadIdx][1] + 2;
                 uint8_t idx;
                 /*
@@ -926,17 +953,25 @@ void IBusProcess(IBus_t *ibus)
                  */
                 if (IBUS_UART_STATUS == 0) {
                     for (idx = 0; idx < msgLen; idx++) {
-                        ibus->uart.registers->uxtxreg = ibus->txBuffer[ibus->txBufferReadIdx][idx];
-                        // Wait for the data to leave the TX buffer
-                        while ((ibus->uart.registers->uxsta & (1 << 9)) != 0);
+                        UARTSendCharBlocking(
+                            &ibus->uart,
+                            ibus->txBuffer[ibus->txBufferReadIdx][idx]
+                        );
                     }
                     txTimeout = IBUS_TX_TIMEOUT_DATA_SENT;
+                    BootTraceMark(BOOT_TRACE_IBUS_FIRST_TX);
+                    uint8_t *sent = ibus->txBuffer[ibus->txBufferReadIdx];
+                    TraceRecord(
+                        TRACE_POINT_IBUS_TX,
+                        sent[IBUS_PKT_SRC],
+                        ((uint16_t) sent[IBUS_PKT_DST] << 8) | sent[IBUS_PKT_CMD]
+                    );
                     if (ibus->txBufferReadIdx + 1 == IBUS_TX_BUFFER_SIZE) {
                         ibus->txBufferReadIdx = 0;
                     } else {
                         ibus->txBufferReadIdx++;
                     }
-                    ibus->txLastStamp = TimerGetMillis();
+                    ibus->txLastStamp = TimerGetMicros();
                 } else if (txTimeout != IBUS_TX_TIMEOUT_DATA_SENT) {
                     if ((now - beginTxTimestamp) > IBUS_TX_TIMEOUT_WAIT) {
                         txTimeout = IBUS_TX_TIMEOUT_ON;
@@ -1006,6 +1041,11 @@ void IBusSendCommand(
         crc ^= msg[idx];
     }
     msg[msgSize - 1] = crc;
+    TraceRecord(
+        TRACE_POINT_IBUS_TX_QUEUE,
+        src,
+        ((uint16_t) dst << 8) | msg[IBUS_PKT_CMD]
+    );
     // Store the data into a buffer, so we can spread out their transmission
     memcpy(ibus->txBuffer[ibus->txBufferWriteIdx], msg, msgSize);
     if (ibus->txBufferWriteIdx + 1 == IBUS_TX_BUFFER_SIZE) {
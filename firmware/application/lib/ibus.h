@@ -10,11 +10,13 @@
 #include <stdint.h>
 #include <string.h>
 #include "../mappings.h"
+#include "boot_trace.h"
 #include "char_queue.h"
 #include "log.h"
 #include "event.h"
 #include "ibus.h"
 #include "timer.h"
+#include "trace.h"
 #include "uart.h"
 #include "utils.h"
 
@@ -483,7 +485,7 @@
 #define IBUS_RX_BUFFER_SIZE 255 // 8-bit Max
 #define IBUS_TX_BUFFER_SIZE 16
 #define IBUS_RX_BUFFER_TIMEOUT 70 // At 9600 baud, we transmit ~1.5 byte/ms
-#define IBUS_TX_BUFFER_WAIT 7 // If we transmit faster, other modules may not hear us
+#define IBUS_TX_BUFFER_WAIT 7000 // In microseconds. If we transmit faster, other modules may not hear us
 #define IBUS_TX_TIMEOUT_OFF 0
 #define IBUS_TX_TIMEOUT_ON 1
 #define IBUS_TX_TIMEOUT_DATA_SENT 2
@@ -540,6 +542,7 @@ typedef struct IBus_t {
     uint8_t txBufferReadIdx;
     uint8_t txBufferWriteIdx;
     uint32_t rxLastStamp;
+    uint32_t rxFrameTimestamp;
     uint32_t txLastStamp;
     signed char ambientTemperature;
     char ambientTemperatureCalculated[7];
@@ -567,6 +570,7 @@ IBus_t IBusInit();
 void IBusProcess(IBus_t *);
 void IBusSendCommand(IBus_t *, const uint8_t, const uint8_t, const uint8_t *, const size_t);
 void IBusSetInternalIgnitionStatus(IBus_t *, uint8_t);
+uint8_t IBusValidateChecksum(uint8_t *);
 uint8_t IBusGetLMCodingIndex(uint8_t *);
 uint8_t IBusGetLMDiagnosticIndex(uint8_t *);
 uint8_t IBusGetLMDimmerChecksum(uint8_t *);
@@ -735,6 +735,11 @@ static char *LOCALE_LANG_POLISH[] = {
     "PDC: %s",
 };
 
+/* The active string table, with the English fallback resolved per index */
+static char *LOCALE_ACTIVE_TABLE[LOCALE_STRING_MAX_INDEX + 1];
+static uint8_t LOCALE_ACTIVE_LENGTH[LOCALE_STRING_MAX_INDEX + 1];
+static uint8_t LOCALE_ACTIVE_LANGUAGE = LOCALE_LANGUAGE_UNSET;
+
 /**
  * LocaleGetText()
  *     Description:
@@ -749,43 +754,90 @@ char *LocaleGetText(uint16_t stringIndex)
     if (stringIndex>LOCALE_STRING_MAX_INDEX) {
         return "i18n Missing";
     }
-
-    char *text = 0;
-    unsigned char language = ConfigGetSetting(CONFIG_SETTING_LANGUAGE) & 0x0F;
-
-    switch (language) {
-        case CONFIG_SETTING_LANGUAGE_DUTCH:
-            text = LOCALE_LANG_DUTCH[stringIndex];
-            break;
-        case CONFIG_SETTING_LANGUAGE_ESTONIAN:
-            text = LOCALE_LANG_ESTONIAN[stringIndex];
-            break;
-        case CONFIG_SETTING_LANGUAGE_GERMAN:
-            text = LOCALE_LANG_GERMAN[stringIndex];
-            break;
-        case CONFIG_SETTING_LANGUAGE_ITALIAN:
-            text = LOCALE_LANG_ITALIAN[stringIndex];
-            break;
-        case CONFIG_SETTING_LANGUAGE_RUSSIAN:
-            text = LOCALE_LANG_RUSSIAN[stringIndex];
-            break;
-        case CONFIG_SETTING_LANGUAGE_SPANISH:
-            text = LOCALE_LANG_SPANISH[stringIndex];
-            break;
-        case CONFIG_SETTING_LANGUAGE_POLISH:
-            text = LOCALE_LANG_POLISH[stringIndex];
-            break;
-        case CONFIG_SETTING_LANGUAGE_FRENCH:
-            text = LOCALE_LANG_FRENCH[stringIndex];
-            break;
-        case CONFIG_SETTING_LANGUAGE_ENGLISH:
-        default:
-            text = LOCALE_LANG_ENGLISH[stringIndex];
+    if (LOCALE_ACTIVE_LANGUAGE == LOCALE_LANGUAGE_UNSET) {
+        LocaleSetLanguage(ConfigGetSetting(CONFIG_SETTING_LANGUAGE));
     }
+    return LOCALE_ACTIVE_TABLE[stringIndex];
+}
 
-    if (text == 0) {
-        text = LOCALE_LANG_ENGLISH[stringIndex];
+/**
+ * LocaleGetTextLength()
+ *     Description:
+ *         Returns the length of the localized string, as computed when the
+ *         active string table was built
+ *     Params:
+ *         uint16_t stringIndex - string identifier
+ *     Returns:
+ *         uint8_t - The string length in bytes
+ */
+uint8_t LocaleGetTextLength(uint16_t stringIndex)
+{
+    if (stringIndex>LOCALE_STRING_MAX_INDEX) {
+        return strlen("i18n Missing");
+    }
+    if (LOCALE_ACTIVE_LANGUAGE == LOCALE_LANGUAGE_UNSET) {
+        LocaleSetLanguage(ConfigGetSetting(CONFIG_SETTING_LANGUAGE));
     }
+    return LOCALE_ACTIVE_LENGTH[stringIndex];
+}
 
-    return text;
+/**
+ * LocaleSetLanguage()
+ *     Description:
+ *         Build the active string table for the given language. Strings that
+ *         the language does not define fall back to English. The length of
+ *         each string is stored alongside it so the UI does not have to
+ *         measure the same constant text on every redraw. The strings stay
+ *         unpadded, each UI pads them to its own layout as it writes them.
+ *     Params:
+ *         uint8_t language - The language setting
+ *     Returns:
+ *         void
+ */
+void LocaleSetLanguage(uint8_t language)
+{
+    language = language & 0x0F;
+    uint16_t stringIndex;
+    for (stringIndex = 0; stringIndex <= LOCALE_STRING_MAX_INDEX; stringIndex++) {
+        char *text = 0;
+        switch (language) {
+            case CONFIG_SETTING_LANGUAGE_DUTCH:
+                text = LOCALE_LANG_DUTCH[stringIndex];
+                break;
+            case CONFIG_SETTING_LANGUAGE_ESTONIAN:
+                text = LOCALE_LANG_ESTONIAN[stringIndex];
+                break;
+            case CONFIG_SETTING_LANGUAGE_GERMAN:
+                text = LOCALE_LANG_GERMAN[stringIndex];
+                break;
+            case CONFIG_SETTING_LANGUAGE_ITALIAN:
+                text = LOCALE_LANG_ITALIAN[stringIndex];
+                break;
+            case CONFIG_SETTING_LANGUAGE_RUSSIAN:
+                text = LOCALE_LANG_RUSSIAN[stringIndex];
+                break;
+            case CONFIG_SETTING_LANGUAGE_SPANISH:
+                text = LOCALE_LANG_SPANISH[stringIndex];
+                break;
+            case CONFIG_SETTING_LANGUAGE_POLISH:
+                text = LOCALE_LANG_POLISH[stringIndex];
+                break;
+            case CONFIG_SETTING_LANGUAGE_FRENCH:
+                text = LOCALE_LANG_FRENCH[stringIndex];
+                break;
+            case CONFIG_SETTING_LANGUAGE_ENGLISH:
+            default:
+                text = LOCALE_LANG_ENGLISH[stringIndex];
+        }
+        if (text == 0) {
+            text = LOCALE_LANG_ENGLISH[stringIndex];
+        }
+        LOCALE_ACTIVE_TABLE[stringIndex] = text;
+        size_t length = strlen(text);
+        if (length > 0xFF) {
+            length = 0xFF;
+        }
+        LOCALE_ACTIVE_LENGTH[stringIndex] = (uint8_t) length;
+    }
+    LOCALE_ACTIVE_LANGUAGE = language;
 }
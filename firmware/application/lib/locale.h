@@ -91,5 +91,9 @@
 
 #define LOCALE_STRING_MAX_INDEX 77
 
+#define LOCALE_LANGUAGE_UNSET 0xFF
+
 char *LocaleGetText(uint16_t);
+uint8_t LocaleGetTextLength(uint16_t);
+void LocaleSetLanguage(uint8_t);
 #endif /* LOCALE_H */
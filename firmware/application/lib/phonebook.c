@@ -0,0 +1,762 @@
+/*
+ * File:   phonebook.c
+ * Author: agent <agent@local>
+ * Description:
+ *     Store the phonebook of the connected device in the EEPROM, as a list of
+ *     fixed size contact records and an index of them sorted by name
+ */
+#include "phonebook.h"
+
+static PhonebookSync_t PHONEBOOK;
+
+/**
+ * PhonebookGetLetter()
+ *     Description:
+ *         Get the letter table slot that a name falls into
+ *     Params:
+ *         char c - The first character of the name
+ *     Returns:
+ *         uint8_t - 0-25 for A-Z, 26 for anything else
+ */
+static uint8_t PhonebookGetLetter(char c)
+{
+    c = toupper((uint8_t) c);
+    if (c >= 'A' && c <= 'Z') {
+        return c - 'A';
+    }
+    return PHONEBOOK_LETTER_COUNT - 1;
+}
+
+/**
+ * PhonebookCompare()
+ *     Description:
+ *         Order two records by name, ignoring case. Records with the same
+ *         name are ordered by record number, so every record has a distinct
+ *         place in the index.
+ *     Params:
+ *         const char *name - The name of the first record
+ *         uint16_t record - The first record number
+ *         const char *compare - The name of the second record
+ *         uint16_t compareRecord - The second record number
+ *     Returns:
+ *         int16_t - Less than, equal to or greater than zero
+ */
+static int16_t PhonebookCompare(
+    const char *name,
+    uint16_t record,
+    const char *compare,
+    uint16_t compareRecord
+) {
+    uint8_t i;
+    for (i = 0; i < PHONEBOOK_NAME_SIZE; i++) {
+        int16_t result = (int16_t) toupper((uint8_t) name[i]) -
+            (int16_t) toupper((uint8_t) compare[i]);
+        if (result != 0) {
+            return result;
+        }
+        if (name[i] == 0) {
+            break;
+        }
+    }
+    return (int16_t) record - (int16_t) compareRecord;
+}
+
+/**
+ * PhonebookPropertyIs()
+ *     Description:
+ *         Check if a vCard line holds the given property, ignoring case and
+ *         any parameters
+ *     Params:
+ *         const char *line - The vCard line
+ *         const char *property - The upper case property name
+ *     Returns:
+ *         uint8_t - 1 if the line holds the property, 0 otherwise
+ */
+static uint8_t PhonebookPropertyIs(const char *line, const char *property)
+{
+    while (*property != 0) {
+        if (toupper((uint8_t) *line) != *property) {
+            return 0;
+        }
+        line++;
+        property++;
+    }
+    if (*line == ':' || *line == ';') {
+        return 1;
+    }
+    return 0;
+}
+
+/**
+ * PhonebookWritePending()
+ *     Description:
+ *         Write the page of records that is waiting to be stored. The page is
+ *         compared to what is already stored first, so that an unchanged
+ *         phonebook does not cost any write cycles.
+ *     Params:
+ *         void
+ *     Returns:
+ *         void
+ */
+static void PhonebookWritePending()
+{
+    if (PHONEBOOK.pendingLength == 0) {
+        return;
+    }
+    uint32_t address = PHONEBOOK_RECORD_ADDRESS +
+        ((uint32_t) PHONEBOOK.pendingRecord * PHONEBOOK_RECORD_SIZE);
+    uint8_t stored[EEPROM_PAGE_SIZE];
+    EEPROMReadBytes(address, stored, PHONEBOOK.pendingLength);
+    if (memcmp(stored, PHONEBOOK.pending, PHONEBOOK.pendingLength) != 0) {
+        EEPROMWritePage(address, PHONEBOOK.pending, PHONEBOOK.pendingLength);
+        PHONEBOOK.changed = 1;
+    }
+    PHONEBOOK.pendingLength = 0;
+}
+
+/**
+ * PhonebookWriteRecords()
+ *     Description:
+ *         Hand the buffered records to PhonebookProcess(), which writes them
+ *         once the EEPROM has finished the last write cycle. Only if the page
+ *         before is still waiting, because the device sends faster than the
+ *         EEPROM writes, is that page written here.
+ *     Params:
+ *         void
+ *     Returns:
+ *         void
+ */
+static void PhonebookWriteRecords()
+{
+    if (PHONEBOOK.pageRecords == 0) {
+        return;
+    }
+    PhonebookWritePending();
+    PHONEBOOK.pendingLength = PHONEBOOK.pageRecords * PHONEBOOK_RECORD_SIZE;
+    PHONEBOOK.pendingRecord = PHONEBOOK.count - PHONEBOOK.pageRecords;
+    memcpy(PHONEBOOK.pending, PHONEBOOK.page, PHONEBOOK.pendingLength);
+    PHONEBOOK.pageRecords = 0;
+}
+
+/**
+ * PhonebookAddRecord()
+ *     Description:
+ *         Pack the contact parsed from the current vCard into a record
+ *     Params:
+ *         void
+ *     Returns:
+ *         void
+ */
+static void PhonebookAddRecord()
+{
+    if (PHONEBOOK.count >= PHONEBOOK_MAX_CONTACTS) {
+        if (PHONEBOOK.count == PHONEBOOK_MAX_CONTACTS) {
+            LogWarning("Phonebook: Full at %d contacts", PHONEBOOK_MAX_CONTACTS);
+            // Only warn once per sync
+            PHONEBOOK.count++;
+        }
+        return;
+    }
+    if (PHONEBOOK.rawName[0] == 0 && PHONEBOOK.numberDigits == 0) {
+        return;
+    }
+    uint8_t *record = &PHONEBOOK.page[
+        PHONEBOOK.pageRecords * PHONEBOOK_RECORD_SIZE
+    ];
+    char name[PHONEBOOK_NAME_SIZE + 1] = {0};
+    memset(record, 0, PHONEBOOK_RECORD_SIZE);
+    UtilsNormalizeText(name, PHONEBOOK.rawName, PHONEBOOK_NAME_SIZE + 1);
+    memcpy(&record[PHONEBOOK_RECORD_NAME], name, PHONEBOOK_NAME_SIZE);
+    record[PHONEBOOK_RECORD_TYPE] = PHONEBOOK.numberType;
+    record[PHONEBOOK_RECORD_DIGITS] = PHONEBOOK.numberDigits |
+        PHONEBOOK.numberFlags;
+    memcpy(
+        &record[PHONEBOOK_RECORD_BCD],
+        PHONEBOOK.numberBCD,
+        PHONEBOOK_NUMBER_DIGITS / 2
+    );
+    PHONEBOOK.pageRecords++;
+    PHONEBOOK.count++;
+    if (PHONEBOOK.pageRecords * PHONEBOOK_RECORD_SIZE == EEPROM_PAGE_SIZE) {
+        PhonebookWriteRecords();
+    }
+}
+
+/**
+ * PhonebookParseNumber()
+ *     Description:
+ *         Take the number from a TEL line. A mobile number is preferred
+ *         over any other, otherwise the first number is kept.
+ *     Params:
+ *         const char *line - The vCard line
+ *         const char *value - The property value
+ *     Returns:
+ *         void
+ */
+static void PhonebookParseNumber(const char *line, const char *value)
+{
+    uint8_t type = PHONEBOOK_NUMBER_TYPE_OTHER;
+    const char *c = line;
+    while (c < value) {
+        if (toupper((uint8_t) c[0]) == 'C' && toupper((uint8_t) c[1]) == 'E' &&
+            toupper((uint8_t) c[2]) == 'L' && toupper((uint8_t) c[3]) == 'L'
+        ) {
+            type = PHONEBOOK_NUMBER_TYPE_CELL;
+        } else if (toupper((uint8_t) c[0]) == 'H' && toupper((uint8_t) c[1]) == 'O' &&
+            toupper((uint8_t) c[2]) == 'M' && toupper((uint8_t) c[3]) == 'E'
+        ) {
+            type = PHONEBOOK_NUMBER_TYPE_HOME;
+        } else if (toupper((uint8_t) c[0]) == 'W' && toupper((uint8_t) c[1]) == 'O' &&
+            toupper((uint8_t) c[2]) == 'R' && toupper((uint8_t) c[3]) == 'K'
+        ) {
+            type = PHONEBOOK_NUMBER_TYPE_WORK;
+        }
+        c++;
+    }
+    if (PHONEBOOK.numberDigits != 0 &&
+        (PHONEBOOK.numberType == PHONEBOOK_NUMBER_TYPE_CELL ||
+        type != PHONEBOOK_NUMBER_TYPE_CELL)
+    ) {
+        return;
+    }
+    PHONEBOOK.numberType = type;
+    PHONEBOOK.numberDigits = 0;
+    PHONEBOOK.numberFlags = 0;
+    memset(PHONEBOOK.numberBCD, 0, sizeof(PHONEBOOK.numberBCD));
+    while (*value == ' ') {
+        value++;
+    }
+    if (*value == '+') {
+        PHONEBOOK.numberFlags = PHONEBOOK_NUMBER_INTL;
+    }
+    while (*value != 0 && PHONEBOOK.numberDigits < PHONEBOOK_NUMBER_DIGITS) {
+        uint8_t nibble = 0xFF;
+        if (*value >= '0' && *value <= '9') {
+            nibble = *value - '0';
+        } else if (*value == '*') {
+            nibble = 0x0A;
+        } else if (*value == '#') {
+            nibble = 0x0B;
+        }
+        if (nibble != 0xFF) {
+            uint8_t idx = PHONEBOOK.numberDigits / 2;
+            if ((PHONEBOOK.numberDigits & 1) == 0) {
+                PHONEBOOK.numberBCD[idx] = nibble << 4;
+            } else {
+                PHONEBOOK.numberBCD[idx] |= nibble;
+            }
+            PHONEBOOK.numberDigits++;
+        }
+        value++;
+    }
+}
+
+/**
+ * PhonebookParseLine()
+ *     Description:
+ *         Process a single vCard line. Only the properties that make up a
+ *         record are looked at: BEGIN, FN, N, TEL and END.
+ *     Params:
+ *         char *line - The null terminated vCard line
+ *     Returns:
+ *         void
+ */
+static void PhonebookParseLine(char *line)
+{
+    char *value = strchr(line, ':');
+    if (value == 0) {
+        return;
+    }
+    value++;
+    if (PhonebookPropertyIs(line, "BEGIN") == 1) {
+        PHONEBOOK.inCard = 1;
+        PHONEBOOK.hasFullName = 0;
+        PHONEBOOK.rawName[0] = 0;
+        PHONEBOOK.numberDigits = 0;
+        PHONEBOOK.numberFlags = 0;
+        PHONEBOOK.numberType = PHONEBOOK_NUMBER_TYPE_OTHER;
+    } else if (PHONEBOOK.inCard == 0) {
+        return;
+    } else if (PhonebookPropertyIs(line, "FN") == 1) {
+        UtilsStrncpy(PHONEBOOK.rawName, value, PHONEBOOK_RAW_NAME_SIZE);
+        PHONEBOOK.hasFullName = 1;
+    } else if (PhonebookPropertyIs(line, "N") == 1 &&
+        PHONEBOOK.hasFullName == 0
+    ) {
+        // Structured name -- "Last;First;Middle;Prefix;Suffix"
+        char *first = strchr(value, ';');
+        uint8_t idx = 0;
+        if (first != 0) {
+            *first = 0;
+            first++;
+            while (*first != 0 && *first != ';' &&
+                idx < PHONEBOOK_RAW_NAME_SIZE - 1
+            ) {
+                PHONEBOOK.rawName[idx++] = *first++;
+            }
+            if (idx > 0 && *value != 0 && idx < PHONEBOOK_RAW_NAME_SIZE - 1) {
+                PHONEBOOK.rawName[idx++] = ' ';
+            }
+        }
+        while (*value != 0 && idx < PHONEBOOK_RAW_NAME_SIZE - 1) {
+            PHONEBOOK.rawName[idx++] = *value++;
+        }
+        PHONEBOOK.rawName[idx] = 0;
+    } else if (PhonebookPropertyIs(line, "TEL") == 1) {
+        PhonebookParseNumber(line, value);
+    } else if (PhonebookPropertyIs(line, "END") == 1) {
+        PhonebookAddRecord();
+        PHONEBOOK.inCard = 0;
+    }
+}
+
+/**
+ * PhonebookWriteHeader()
+ *     Description:
+ *         Write the phonebook header page
+ *     Params:
+ *         void
+ *     Returns:
+ *         void
+ */
+static void PhonebookWriteHeader()
+{
+    uint8_t header[EEPROM_PAGE_SIZE] = {0};
+    uint8_t i;
+    header[PHONEBOOK_HEADER_MAGIC] = PHONEBOOK_MAGIC;
+    header[PHONEBOOK_HEADER_STATUS] = PHONEBOOK.status;
+    header[PHONEBOOK_HEADER_COUNT] = PHONEBOOK.count >> 8;
+    header[PHONEBOOK_HEADER_COUNT + 1] = PHONEBOOK.count & 0xFF;
+    memcpy(&header[PHONEBOOK_HEADER_MAC_ID], PHONEBOOK.macId, PHONEBOOK_MAC_ID_LEN);
+    for (i = 0; i < PHONEBOOK_LETTER_COUNT; i++) {
+        header[PHONEBOOK_HEADER_LETTERS + (i * 2)] = PHONEBOOK.letters[i] >> 8;
+        header[PHONEBOOK_HEADER_LETTERS + (i * 2) + 1] = PHONEBOOK.letters[i] & 0xFF;
+    }
+    EEPROMWritePage(PHONEBOOK_HEADER_ADDRESS, header, EEPROM_PAGE_SIZE);
+}
+
+/**
+ * PhonebookSortStep()
+ *     Description:
+ *         Build the sorted index a few records at a time. Each pass over the
+ *         records selects the smallest name that comes after the last one
+ *         placed, so only the record names in the EEPROM are needed and no
+ *         list is held in RAM. At most one page is written per call, and
+ *         none while the EEPROM is still busy with the last one.
+ *     Params:
+ *         void
+ *     Returns:
+ *         void
+ */
+static void PhonebookSortStep()
+{
+    // Do not wait on a page write that is still in progress
+    if (EEPROMIsBusy() == 1) {
+        return;
+    }
+    if (PHONEBOOK.sortPosition == PHONEBOOK.count) {
+        // The last index page went out on the pass before
+        uint8_t i = PHONEBOOK_LETTER_COUNT;
+        uint16_t next = PHONEBOOK.count;
+        // Letters without any names point at the next letter that has some
+        while (i > 0) {
+            i--;
+            if (PHONEBOOK.letters[i] == PHONEBOOK_MAX_CONTACTS) {
+                PHONEBOOK.letters[i] = next;
+            } else {
+                next = PHONEBOOK.letters[i];
+            }
+        }
+        PHONEBOOK.status = PHONEBOOK_STATUS_VALID;
+        PhonebookWriteHeader();
+        LogInfo(LOG_SOURCE_BT, "Phonebook: Indexed %d contacts", PHONEBOOK.count);
+        return;
+    }
+    uint8_t steps = 0;
+    while (steps < PHONEBOOK_SORT_STEPS && PHONEBOOK.sortScan < PHONEBOOK.count) {
+        char name[PHONEBOOK_NAME_SIZE];
+        uint16_t record = PHONEBOOK.sortScan;
+        EEPROMReadBytes(
+            PHONEBOOK_RECORD_ADDRESS + ((uint32_t) record * PHONEBOOK_RECORD_SIZE),
+            (uint8_t *) name,
+            PHONEBOOK_NAME_SIZE
+        );
+        if ((PHONEBOOK.sortLast == PHONEBOOK_MAX_CONTACTS ||
+            PhonebookCompare(name, record, PHONEBOOK.lastName, PHONEBOOK.sortLast) > 0) &&
+            (PHONEBOOK.sortBest == PHONEBOOK_MAX_CONTACTS ||
+            PhonebookCompare(name, record, PHONEBOOK.bestName, PHONEBOOK.sortBest) < 0)
+        ) {
+            PHONEBOOK.sortBest = record;
+            memcpy(PHONEBOOK.bestName, name, PHONEBOOK_NAME_SIZE);
+        }
+        PHONEBOOK.sortScan++;
+        steps++;
+    }
+    if (PHONEBOOK.sortScan < PHONEBOOK.count) {
+        return;
+    }
+    // Place the record that this pass selected
+    uint16_t position = PHONEBOOK.sortPosition;
+    uint8_t slot = (position * 2) % EEPROM_PAGE_SIZE;
+    PHONEBOOK.page[slot] = PHONEBOOK.sortBest >> 8;
+    PHONEBOOK.page[slot + 1] = PHONEBOOK.sortBest & 0xFF;
+    uint8_t letter = PhonebookGetLetter(PHONEBOOK.bestName[0]);
+    if (PHONEBOOK.letters[letter] == PHONEBOOK_MAX_CONTACTS) {
+        PHONEBOOK.letters[letter] = position;
+    }
+    memcpy(PHONEBOOK.lastName, PHONEBOOK.bestName, PHONEBOOK_NAME_SIZE);
+    PHONEBOOK.sortLast = PHONEBOOK.sortBest;
+    PHONEBOOK.sortBest = PHONEBOOK_MAX_CONTACTS;
+    PHONEBOOK.sortScan = 0;
+    PHONEBOOK.sortPosition++;
+    if (slot + 2 == EEPROM_PAGE_SIZE || PHONEBOOK.sortPosition == PHONEBOOK.count) {
+        uint16_t pageStart = position - (slot / 2);
+        EEPROMWritePage(
+            PHONEBOOK_INDEX_ADDRESS + ((uint32_t) pageStart * 2),
+            PHONEBOOK.page,
+            slot + 2
+        );
+    }
+}
+
+/**
+ * PhonebookSyncFinish()
+ *     Description:
+ *         Start building the index once every record is stored. If nothing
+ *         changed since the last sync, the existing index is kept.
+ *     Params:
+ *         void
+ *     Returns:
+ *         void
+ */
+static void PhonebookSyncFinish()
+{
+    if (PHONEBOOK.count > PHONEBOOK_MAX_CONTACTS) {
+        PHONEBOOK.count = PHONEBOOK_MAX_CONTACTS;
+    }
+    if (PHONEBOOK.count != PHONEBOOK.previousCount) {
+        PHONEBOOK.changed = 1;
+    }
+    if (PHONEBOOK.changed == 0) {
+        LogInfo(LOG_SOURCE_BT, "Phonebook: Unchanged");
+        PHONEBOOK.status = PHONEBOOK_STATUS_VALID;
+        EEPROMWriteByte(
+            PHONEBOOK_HEADER_ADDRESS + PHONEBOOK_HEADER_STATUS,
+            PHONEBOOK_STATUS_VALID
+        );
+        return;
+    }
+    uint8_t i;
+    for (i = 0; i < PHONEBOOK_LETTER_COUNT; i++) {
+        PHONEBOOK.letters[i] = PHONEBOOK_MAX_CONTACTS;
+    }
+    PHONEBOOK.sortPosition = 0;
+    PHONEBOOK.sortScan = 0;
+    PHONEBOOK.sortBest = PHONEBOOK_MAX_CONTACTS;
+    PHONEBOOK.sortLast = PHONEBOOK_MAX_CONTACTS;
+    if (PHONEBOOK.count == 0) {
+        PHONEBOOK.status = PHONEBOOK_STATUS_VALID;
+        PhonebookWriteHeader();
+    } else {
+        PHONEBOOK.status = PHONEBOOK_STATUS_SORT;
+    }
+}
+
+/**
+ * PhonebookInit()
+ *     Description:
+ *         Load the phonebook header from the EEPROM. A sync that was cut off
+ *         by a reset leaves the phonebook empty.
+ *     Params:
+ *         void
+ *     Returns:
+ *         void
+ */
+void PhonebookInit()
+{
+    uint8_t header[EEPROM_PAGE_SIZE];
+    uint8_t i;
+    memset(&PHONEBOOK, 0, sizeof(PhonebookSync_t));
+    EEPROMReadBytes(PHONEBOOK_HEADER_ADDRESS, header, EEPROM_PAGE_SIZE);
+    uint16_t count = (header[PHONEBOOK_HEADER_COUNT] << 8) |
+        header[PHONEBOOK_HEADER_COUNT + 1];
+    if (header[PHONEBOOK_HEADER_MAGIC] == PHONEBOOK_MAGIC &&
+        header[PHONEBOOK_HEADER_STATUS] == PHONEBOOK_STATUS_VALID &&
+        count <= PHONEBOOK_MAX_CONTACTS
+    ) {
+        PHONEBOOK.status = PHONEBOOK_STATUS_VALID;
+        PHONEBOOK.count = count;
+        memcpy(PHONEBOOK.macId, &header[PHONEBOOK_HEADER_MAC_ID], PHONEBOOK_MAC_ID_LEN);
+        for (i = 0; i < PHONEBOOK_LETTER_COUNT; i++) {
+            PHONEBOOK.letters[i] = (header[PHONEBOOK_HEADER_LETTERS + (i * 2)] << 8) |
+                header[PHONEBOOK_HEADER_LETTERS + (i * 2) + 1];
+        }
+    } else {
+        PHONEBOOK.status = PHONEBOOK_STATUS_EMPTY;
+    }
+}
+
+/**
+ * PhonebookGetContact()
+ *     Description:
+ *         Read the contact at the given position in name order
+ *     Params:
+ *         uint16_t position - The position in the sorted index
+ *         PhonebookContact_t *contact - The contact to fill in
+ *     Returns:
+ *         uint8_t - 1 if the contact was read, 0 otherwise
+ */
+uint8_t PhonebookGetContact(uint16_t position, PhonebookContact_t *contact)
+{
+    if (PHONEBOOK.status != PHONEBOOK_STATUS_VALID ||
+        position >= PHONEBOOK.count
+    ) {
+        return 0;
+    }
+    uint8_t entry[2];
+    uint8_t record[PHONEBOOK_RECORD_SIZE];
+    EEPROMReadBytes(PHONEBOOK_INDEX_ADDRESS + ((uint32_t) position * 2), entry, 2);
+    uint16_t recordId = (entry[0] << 8) | entry[1];
+    if (recordId >= PHONEBOOK.count) {
+        return 0;
+    }
+    EEPROMReadBytes(
+        PHONEBOOK_RECORD_ADDRESS + ((uint32_t) recordId * PHONEBOOK_RECORD_SIZE),
+        record,
+        PHONEBOOK_RECORD_SIZE
+    );
+    memset(contact, 0, sizeof(PhonebookContact_t));
+    memcpy(contact->name, &record[PHONEBOOK_RECORD_NAME], PHONEBOOK_NAME_SIZE);
+    contact->type = record[PHONEBOOK_RECORD_TYPE];
+    uint8_t digits = record[PHONEBOOK_RECORD_DIGITS] & ~PHONEBOOK_NUMBER_INTL;
+    uint8_t idx = 0;
+    uint8_t i;
+    if ((record[PHONEBOOK_RECORD_DIGITS] & PHONEBOOK_NUMBER_INTL) != 0) {
+        contact->number[idx++] = '+';
+    }
+    for (i = 0; i < digits && i < PHONEBOOK_NUMBER_DIGITS; i++) {
+        uint8_t nibble = record[PHONEBOOK_RECORD_BCD + (i / 2)];
+        if ((i & 1) == 0) {
+            nibble = nibble >> 4;
+        }
+        nibble = nibble & 0x0F;
+        if (nibble == 0x0A) {
+            contact->number[idx++] = '*';
+        } else if (nibble == 0x0B) {
+            contact->number[idx++] = '#';
+        } else {
+            contact->number[idx++] = '0' + nibble;
+        }
+    }
+    return 1;
+}
+
+/**
+ * PhonebookGetCount()
+ *     Description:
+ *         Get the number of contacts that can be browsed
+ *     Params:
+ *         void
+ *     Returns:
+ *         uint16_t - The contact count, or 0 while a sync is running
+ */
+uint16_t PhonebookGetCount()
+{
+    if (PHONEBOOK.status != PHONEBOOK_STATUS_VALID) {
+        return 0;
+    }
+    return PHONEBOOK.count;
+}
+
+/**
+ * PhonebookGetLetterPosition()
+ *     Description:
+ *         Get the position of the first contact whose name starts with the
+ *         given letter, or with the next letter that has contacts
+ *     Params:
+ *         char letter - The letter to jump to
+ *     Returns:
+ *         uint16_t - The position in the sorted index
+ */
+uint16_t PhonebookGetLetterPosition(char letter)
+{
+    if (PHONEBOOK.status != PHONEBOOK_STATUS_VALID) {
+        return 0;
+    }
+    return PHONEBOOK.letters[PhonebookGetLetter(letter)];
+}
+
+/**
+ * PhonebookGetPage()
+ *     Description:
+ *         Read a page of contacts in name order, for the UIs to display
+ *     Params:
+ *         uint16_t position - The position of the first contact
+ *         PhonebookContact_t *contacts - The contacts to fill in
+ *         uint8_t count - The number of contacts to read
+ *     Returns:
+ *         uint8_t - The number of contacts read
+ */
+uint8_t PhonebookGetPage(
+    uint16_t position,
+    PhonebookContact_t *contacts,
+    uint8_t count
+) {
+    uint8_t i = 0;
+    while (i < count && PhonebookGetContact(position + i, &contacts[i]) == 1) {
+        i++;
+    }
+    return i;
+}
+
+/**
+ * PhonebookGetStatus()
+ *     Description:
+ *         Get the phonebook status
+ *     Params:
+ *         void
+ *     Returns:
+ *         uint8_t - PHONEBOOK_STATUS_*
+ */
+uint8_t PhonebookGetStatus()
+{
+    return PHONEBOOK.status;
+}
+
+/**
+ * PhonebookProcess()
+ *     Description:
+ *         Write the page of records that is waiting, finish a sync that has
+ *         gone quiet and advance the index build. Each call writes at most
+ *         one page, and only once the EEPROM is done with the last one, so
+ *         the main loop never waits on a write cycle.
+ *     Params:
+ *         void
+ *     Returns:
+ *         void
+ */
+void PhonebookProcess()
+{
+    if (PHONEBOOK.pendingLength != 0) {
+        if (EEPROMIsBusy() == 0) {
+            PhonebookWritePending();
+        }
+        return;
+    }
+    if (PHONEBOOK.status == PHONEBOOK_STATUS_INGEST &&
+        (TimerGetMillis() - PHONEBOOK.lastFeed) > PHONEBOOK_SYNC_TIMEOUT
+    ) {
+        PhonebookSyncEnd();
+    } else if (PHONEBOOK.status == PHONEBOOK_STATUS_STORE) {
+        if (EEPROMIsBusy() == 0) {
+            PhonebookSyncFinish();
+        }
+    } else if (PHONEBOOK.status == PHONEBOOK_STATUS_SORT) {
+        PhonebookSortStep();
+    }
+}
+
+/**
+ * PhonebookSyncEnd()
+ *     Description:
+ *         Stop taking in vCard data and hand the last records to
+ *         PhonebookProcess(), which stores them and then finishes the sync
+ *     Params:
+ *         void
+ *     Returns:
+ *         void
+ */
+void PhonebookSyncEnd()
+{
+    if (PHONEBOOK.status != PHONEBOOK_STATUS_INGEST) {
+        return;
+    }
+    PhonebookWriteRecords();
+    PHONEBOOK.status = PHONEBOOK_STATUS_STORE;
+}
+
+/**
+ * PhonebookSyncFeed()
+ *     Description:
+ *         Feed vCard data into the phonebook as it arrives. The data does not
+ *         have to line up with vCard lines.
+ *     Params:
+ *         const char *data - The vCard data
+ *         uint16_t length - The length of the data
+ *     Returns:
+ *         void
+ */
+void PhonebookSyncFeed(const char *data, uint16_t length)
+{
+    uint16_t i;
+    if (PHONEBOOK.status != PHONEBOOK_STATUS_INGEST) {
+        return;
+    }
+    for (i = 0; i < length; i++) {
+        char c = data[i];
+        if (c == '\r' || c == '\n') {
+            if (PHONEBOOK.lineLength > 0) {
+                PHONEBOOK.line[PHONEBOOK.lineLength] = 0;
+                PhonebookParseLine(PHONEBOOK.line);
+                PHONEBOOK.lineLength = 0;
+            }
+        } else if (PHONEBOOK.lineLength < PHONEBOOK_LINE_SIZE - 1) {
+            PHONEBOOK.line[PHONEBOOK.lineLength++] = c;
+        }
+    }
+    PHONEBOOK.lastFeed = TimerGetMillis();
+}
+
+/**
+ * PhonebookSyncIsActive()
+ *     Description:
+ *         Check if vCard data is currently being taken in
+ *     Params:
+ *         void
+ *     Returns:
+ *         uint8_t - 1 if a sync is taking in data, 0 otherwise
+ */
+uint8_t PhonebookSyncIsActive()
+{
+    if (PHONEBOOK.status == PHONEBOOK_STATUS_INGEST) {
+        return 1;
+    }
+    return 0;
+}
+
+/**
+ * PhonebookSyncStart()
+ *     Description:
+ *         Begin taking in the phonebook of the given device. The stored
+ *         phonebook is not available until the sync completes.
+ *     Params:
+ *         const uint8_t *macId - The MAC ID of the device
+ *     Returns:
+ *         void
+ */
+void PhonebookSyncStart(const uint8_t *macId)
+{
+    if (PHONEBOOK.status == PHONEBOOK_STATUS_VALID) {
+        PHONEBOOK.previousCount = PHONEBOOK.count;
+    } else {
+        PHONEBOOK.previousCount = PHONEBOOK_MAX_CONTACTS + 1;
+    }
+    PHONEBOOK.changed = 0;
+    if (memcmp(PHONEBOOK.macId, macId, PHONEBOOK_MAC_ID_LEN) != 0) {
+        PHONEBOOK.changed = 1;
+        memcpy(PHONEBOOK.macId, macId, PHONEBOOK_MAC_ID_LEN);
+    }
+    PHONEBOOK.status = PHONEBOOK_STATUS_INGEST;
+    PHONEBOOK.count = 0;
+    PHONEBOOK.pageRecords = 0;
+    // Records of a sync that was cut off are written over anyway
+    PHONEBOOK.pendingLength = 0;
+    PHONEBOOK.lineLength = 0;
+    PHONEBOOK.inCard = 0;
+    PHONEBOOK.lastFeed = TimerGetMillis();
+    EEPROMWriteByte(
+        PHONEBOOK_HEADER_ADDRESS + PHONEBOOK_HEADER_STATUS,
+        PHONEBOOK_STATUS_INGEST
+    );
+    LogInfo(LOG_SOURCE_BT, "Phonebook: Sync started");
+}
@@ -0,0 +1,161 @@
+/*
+ * File:   phonebook.h
+ * Author: agent <agent@local>
+ * Description:
+ *     Store the phonebook of the connected device in the EEPROM, as a list of
+ *     fixed size contact records and an index of them sorted by name
+ */
+#ifndef PHONEBOOK_H
+#define PHONEBOOK_H
+#include <ctype.h>
+#include <stdint.h>
+#include <string.h>
+#include "eeprom.h"
+#include "log.h"
+#include "timer.h"
+#include "utils.h"
+
+/*
+ * EEPROM layout. The phonebook lives above the configuration, in the part
+ * of the EEPROM that is present on both hardware revisions:
+ *     Header - 64 bytes (one page)
+ *     Index - PHONEBOOK_MAX_CONTACTS record numbers, sorted by name
+ *     Records - PHONEBOOK_MAX_CONTACTS records of PHONEBOOK_RECORD_SIZE bytes
+ */
+#define PHONEBOOK_EEPROM_START 0x1000
+#define PHONEBOOK_HEADER_ADDRESS PHONEBOOK_EEPROM_START
+#define PHONEBOOK_INDEX_ADDRESS (PHONEBOOK_EEPROM_START + 0x40)
+#define PHONEBOOK_RECORD_ADDRESS (PHONEBOOK_EEPROM_START + 0x340)
+#define PHONEBOOK_MAX_CONTACTS 352
+#define PHONEBOOK_MAGIC 0xB5
+
+#define PHONEBOOK_HEADER_MAGIC 0
+#define PHONEBOOK_HEADER_STATUS 1
+#define PHONEBOOK_HEADER_COUNT 2
+#define PHONEBOOK_HEADER_MAC_ID 4
+#define PHONEBOOK_HEADER_LETTERS 10
+#define PHONEBOOK_MAC_ID_LEN 6
+// A-Z, then everything else
+#define PHONEBOOK_LETTER_COUNT 27
+
+// Record layout -- the name is normalized, the number is packed as BCD
+#define PHONEBOOK_RECORD_SIZE 32
+#define PHONEBOOK_RECORD_NAME 0
+#define PHONEBOOK_RECORD_TYPE 20
+#define PHONEBOOK_RECORD_DIGITS 21
+#define PHONEBOOK_RECORD_BCD 22
+#define PHONEBOOK_NAME_SIZE 20
+#define PHONEBOOK_NUMBER_DIGITS 20
+// Set in the digit count byte when the number starts with "+"
+#define PHONEBOOK_NUMBER_INTL 0x80
+
+#define PHONEBOOK_NUMBER_TYPE_OTHER 0
+#define PHONEBOOK_NUMBER_TYPE_CELL 1
+#define PHONEBOOK_NUMBER_TYPE_HOME 2
+#define PHONEBOOK_NUMBER_TYPE_WORK 3
+
+#define PHONEBOOK_STATUS_EMPTY 0
+#define PHONEBOOK_STATUS_VALID 1
+#define PHONEBOOK_STATUS_INGEST 2
+#define PHONEBOOK_STATUS_SORT 3
+// The sync is over and its last records are being written
+#define PHONEBOOK_STATUS_STORE 4
+
+// Sync without new vCard data for this long is considered complete
+#define PHONEBOOK_SYNC_TIMEOUT 3000
+// Records compared per call to PhonebookProcess() while sorting
+#define PHONEBOOK_SORT_STEPS 16
+#define PHONEBOOK_LINE_SIZE 96
+#define PHONEBOOK_RAW_NAME_SIZE 48
+
+/**
+ * PhonebookContact_t
+ *     Description:
+ *         A contact, unpacked from its EEPROM record
+ *     Fields:
+ *         name - The normalized name
+ *         number - The phone number as text
+ *         type - The number type (PHONEBOOK_NUMBER_TYPE_*)
+ */
+typedef struct PhonebookContact_t {
+    char name[PHONEBOOK_NAME_SIZE + 1];
+    char number[PHONEBOOK_NUMBER_DIGITS + 2];
+    uint8_t type;
+} PhonebookContact_t;
+
+/**
+ * PhonebookSync_t
+ *     Description:
+ *         The phonebook state, including the vCard parser and the index
+ *         build that run while a sync is in progress
+ *     Fields:
+ *         status - The phonebook status (PHONEBOOK_STATUS_*)
+ *         count - The number of stored records
+ *         previousCount - The record count before the current sync
+ *         macId - The MAC ID of the device the phonebook belongs to
+ *         letters - The index position of the first name for each letter
+ *         changed - Set when the sync wrote any record that differed
+ *         lastFeed - The time vCard data was last received
+ *         line - The vCard line being assembled
+ *         lineLength - The length of the vCard line
+ *         inCard - Set between BEGIN:VCARD and END:VCARD
+ *         hasFullName - Set once an FN property was seen
+ *         rawName - The name of the current vCard, before normalization
+ *         numberType - The type of the number kept for the current vCard
+ *         numberDigits - The number of digits kept
+ *         numberFlags - PHONEBOOK_NUMBER_INTL if the number is international
+ *         numberBCD - The digits kept, packed as BCD
+ *         page - Records or index entries being collected
+ *         pageRecords - The number of records in the page
+ *         pending - A full page of records waiting for the EEPROM
+ *         pendingLength - The number of bytes in pending, 0 if none
+ *         pendingRecord - The number of the first record in pending
+ *         sortPosition - The index position being selected
+ *         sortScan - The next record to compare in the current pass
+ *         sortBest - The record selected so far in the current pass
+ *         sortLast - The record placed by the last pass
+ *         bestName - The name of sortBest
+ *         lastName - The name of sortLast
+ */
+typedef struct PhonebookSync_t {
+    uint8_t status;
+    uint16_t count;
+    uint16_t previousCount;
+    uint8_t macId[PHONEBOOK_MAC_ID_LEN];
+    uint16_t letters[PHONEBOOK_LETTER_COUNT];
+    uint8_t changed;
+    uint32_t lastFeed;
+    char line[PHONEBOOK_LINE_SIZE];
+    uint8_t lineLength;
+    uint8_t inCard;
+    uint8_t hasFullName;
+    char rawName[PHONEBOOK_RAW_NAME_SIZE];
+    uint8_t numberType;
+    uint8_t numberDigits;
+    uint8_t numberFlags;
+    uint8_t numberBCD[PHONEBOOK_NUMBER_DIGITS / 2];
+    uint8_t page[EEPROM_PAGE_SIZE];
+    uint8_t pageRecords;
+    uint8_t pending[EEPROM_PAGE_SIZE];
+    uint8_t pendingLength;
+    uint16_t pendingRecord;
+    uint16_t sortPosition;
+    uint16_t sortScan;
+    uint16_t sortBest;
+    uint16_t sortLast;
+    char bestName[PHONEBOOK_NAME_SIZE];
+    char lastName[PHONEBOOK_NAME_SIZE];
+} PhonebookSync_t;
+
+uint16_t PhonebookGetCount();
+uint8_t PhonebookGetContact(uint16_t, PhonebookContact_t *);
+uint16_t PhonebookGetLetterPosition(char);
+uint8_t PhonebookGetPage(uint16_t, PhonebookContact_t *, uint8_t);
+uint8_t PhonebookGetStatus();
+void PhonebookInit();
+void PhonebookProcess();
+void PhonebookSyncEnd();
+void PhonebookSyncFeed(const char *, uint16_t);
+uint8_t PhonebookSyncIsActive();
+void PhonebookSyncStart(const uint8_t *);
+#endif /* PHONEBOOK_H */
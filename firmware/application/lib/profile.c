@@ -0,0 +1,309 @@
+/*
+ * File:   profile.c
+ * Author: agent <agent@local>
+ * Description:
+ *     Account for the cycles spent in each stage of the main loop, in each
+ *     scheduled task and in each event callback, so that whatever stalls
+ *     the loop can be found on a running device. The cycles that the loop
+ *     spends idle are kept too, for its duty cycle.
+ */
+#include "profile.h"
+
+/**
+ * Profile_t
+ *     Description:
+ *         Everything recorded since the last reset
+ *     Fields:
+ *         resetTime - The milliseconds since boot at the last reset
+ *         stages - The cost of each main loop stage
+ *         tasks - The cost of each scheduled task, by task ID
+ *         callbacks - The cost of each event callback, by callback index,
+ *             for the first PROFILE_CALLBACKS_MAX callbacks
+ *         idle - The time the main loop spent idle, waiting for an interrupt
+ *         stageHistory - The last stages to finish, as a ring
+ *         stageHistoryIdx - The slot in stageHistory to write next
+ */
+typedef struct Profile_t {
+    uint32_t resetTime;
+    ProfileStat_t stages[PROFILE_STAGE_COUNT];
+    ProfileSlotStat_t tasks[TIMER_TASKS_MAX];
+    ProfileSlotStat_t callbacks[PROFILE_CALLBACKS_MAX];
+    ProfileStat_t idle;
+    uint8_t stageHistory[PROFILE_STAGE_HISTORY_SIZE];
+    uint8_t stageHistoryIdx;
+} Profile_t;
+static Profile_t PROFILE;
+
+static const char *PROFILE_STAGE_NAMES[PROFILE_STAGE_COUNT] = {
+    "Loop",
+    "BT",
+    "IBus",
+    "Timer",
+    "Phonebook",
+    "CLI",
+    "Deferred Init"
+};
+
+/**
+ * ProfileRecord()
+ *     Description:
+ *         Add a run to a stage or to the idle time
+ *     Params:
+ *         ProfileStat_t *stat - The stage or the idle time
+ *         uint32_t cycles - The cycles that the run took
+ *     Returns:
+ *         void
+ */
+static void ProfileRecord(ProfileStat_t *stat, uint32_t cycles)
+{
+    uint32_t limit = PROFILE_HISTOGRAM_BASE;
+    uint8_t bucket = 0;
+    while (bucket < PROFILE_HISTOGRAM_BUCKETS - 1 && cycles >= limit) {
+        limit <<= PROFILE_HISTOGRAM_SHIFT;
+        bucket++;
+    }
+    if (stat->histogram[bucket] != 0xFFFF) {
+        stat->histogram[bucket]++;
+    }
+    if (cycles > stat->max) {
+        stat->max = cycles;
+    }
+    stat->total += cycles;
+    stat->count++;
+}
+
+/**
+ * ProfileRecordSlot()
+ *     Description:
+ *         Add a run to a task or callback slot, unless one of its counters
+ *         would overflow
+ *     Params:
+ *         ProfileSlotStat_t *stat - The task or callback
+ *         uint32_t cycles - The cycles that the run took
+ *     Returns:
+ *         void
+ */
+static void ProfileRecordSlot(ProfileSlotStat_t *stat, uint32_t cycles)
+{
+    uint32_t micros = cycles / TIMER_CYCLES_PER_MICROSECOND;
+    if (stat->count == 0xFFFF || cycles > 0xFFFFFFFF - stat->total) {
+        return;
+    }
+    if (micros > 0xFFFF) {
+        micros = 0xFFFF;
+    }
+    if (micros > stat->max) {
+        stat->max = micros;
+    }
+    stat->total += cycles;
+    stat->count++;
+}
+
+/**
+ * ProfileGetCallback()
+ *     Description:
+ *         Get the cost of an event callback
+ *     Params:
+ *         uint8_t idx - The index of the callback in the callbacks array
+ *     Returns:
+ *         ProfileSlotStat_t * - The callback cost, or 0 if the index is
+ *             out of range
+ */
+ProfileSlotStat_t *ProfileGetCallback(uint8_t idx)
+{
+    if (idx >= PROFILE_CALLBACKS_MAX) {
+        return 0;
+    }
+    return &PROFILE.callbacks[idx];
+}
+
+/**
+ * ProfileGetIdle()
+ *     Description:
+ *         Get the time that the main loop spent idle
+ *     Params:
+ *         None
+ *     Returns:
+ *         ProfileStat_t * - The idle periods
+ */
+ProfileStat_t *ProfileGetIdle()
+{
+    return &PROFILE.idle;
+}
+
+/**
+ * ProfileGetResetTime()
+ *     Description:
+ *         Get the time at which recording started over
+ *     Params:
+ *         None
+ *     Returns:
+ *         uint32_t - The milliseconds since boot at the last reset
+ */
+uint32_t ProfileGetResetTime()
+{
+    return PROFILE.resetTime;
+}
+
+/**
+ * ProfileGetStage()
+ *     Description:
+ *         Get the cost of a main loop stage
+ *     Params:
+ *         uint8_t stage - The stage
+ *     Returns:
+ *         ProfileStat_t * - The stage cost, or 0 if there is no such stage
+ */
+ProfileStat_t *ProfileGetStage(uint8_t stage)
+{
+    if (stage >= PROFILE_STAGE_COUNT) {
+        return 0;
+    }
+    return &PROFILE.stages[stage];
+}
+
+/**
+ * ProfileGetStageHistory()
+ *     Description:
+ *         Copy out the last stages to finish, oldest first. The stage that
+ *         follows the newest one was running when this was called. Slots
+ *         that have not been used yet hold PROFILE_STAGE_NONE.
+ *     Params:
+ *         uint8_t *stages - Filled with PROFILE_STAGE_HISTORY_SIZE stages
+ *     Returns:
+ *         void
+ */
+void ProfileGetStageHistory(uint8_t *stages)
+{
+    uint8_t idx = PROFILE.stageHistoryIdx;
+    uint8_t i;
+    for (i = 0; i < PROFILE_STAGE_HISTORY_SIZE; i++) {
+        stages[i] = PROFILE.stageHistory[idx];
+        idx = (idx + 1) % PROFILE_STAGE_HISTORY_SIZE;
+    }
+}
+
+/**
+ * ProfileGetStageName()
+ *     Description:
+ *         Get the name of a main loop stage
+ *     Params:
+ *         uint8_t stage - The stage
+ *     Returns:
+ *         const char * - The stage name
+ */
+const char *ProfileGetStageName(uint8_t stage)
+{
+    if (stage >= PROFILE_STAGE_COUNT) {
+        return "";
+    }
+    return PROFILE_STAGE_NAMES[stage];
+}
+
+/**
+ * ProfileGetTask()
+ *     Description:
+ *         Get the cost of a scheduled task
+ *     Params:
+ *         uint8_t taskId - The index of the scheduled task in the tasks array
+ *     Returns:
+ *         ProfileSlotStat_t * - The task cost, or 0 if the index is out of
+ *             range
+ */
+ProfileSlotStat_t *ProfileGetTask(uint8_t taskId)
+{
+    if (taskId >= TIMER_TASKS_MAX) {
+        return 0;
+    }
+    return &PROFILE.tasks[taskId];
+}
+
+/**
+ * ProfileRecordCallback()
+ *     Description:
+ *         Record a run of an event callback that started at the given cycle.
+ *         Callbacks past the first PROFILE_CALLBACKS_MAX are not recorded.
+ *     Params:
+ *         uint8_t idx - The index of the callback in the callbacks array
+ *         uint32_t begin - The cycle count when the callback was called
+ *     Returns:
+ *         void
+ */
+void ProfileRecordCallback(uint8_t idx, uint32_t begin)
+{
+    if (idx >= PROFILE_CALLBACKS_MAX) {
+        return;
+    }
+    ProfileRecordSlot(&PROFILE.callbacks[idx], TimerGetCycles() - begin);
+}
+
+/**
+ * ProfileRecordIdle()
+ *     Description:
+ *         Record an idle period of the main loop that started at the given
+ *         cycle. The interrupt that ends the period is counted as idle
+ *         time.
+ *     Params:
+ *         uint32_t begin - The cycle count when the loop went idle
+ *     Returns:
+ *         void
+ */
+void ProfileRecordIdle(uint32_t begin)
+{
+    ProfileRecord(&PROFILE.idle, TimerGetCycles() - begin);
+}
+
+/**
+ * ProfileRecordStage()
+ *     Description:
+ *         Record a run of a main loop stage that started at the given cycle.
+ *         The time it ended is returned, so that the next stage can start
+ *         from it without reading the timer again.
+ *     Params:
+ *         uint8_t stage - The stage
+ *         uint32_t begin - The cycle count when the stage started
+ *     Returns:
+ *         uint32_t - The cycle count when the stage ended
+ */
+uint32_t ProfileRecordStage(uint8_t stage, uint32_t begin)
+{
+    uint32_t now = TimerGetCycles();
+    ProfileRecord(&PROFILE.stages[stage], now - begin);
+    if (stage != PROFILE_STAGE_LOOP) {
+        PROFILE.stageHistory[PROFILE.stageHistoryIdx] = stage;
+        PROFILE.stageHistoryIdx = (PROFILE.stageHistoryIdx + 1) %
+            PROFILE_STAGE_HISTORY_SIZE;
+    }
+    return now;
+}
+
+/**
+ * ProfileRecordTask()
+ *     Description:
+ *         Record a run of a scheduled task that started at the given cycle
+ *     Params:
+ *         uint8_t taskId - The index of the scheduled task in the tasks array
+ *         uint32_t begin - The cycle count when the task was called
+ *     Returns:
+ *         void
+ */
+void ProfileRecordTask(uint8_t taskId, uint32_t begin)
+{
+    ProfileRecordSlot(&PROFILE.tasks[taskId], TimerGetCycles() - begin);
+}
+
+/**
+ * ProfileReset()
+ *     Description:
+ *         Forget everything recorded so far and start over
+ *     Params:
+ *         None
+ *     Returns:
+ *         void
+ */
+void ProfileReset()
+{
+    memset(&PROFILE, 0, sizeof(PROFILE));
+    memset(PROFILE.stageHistory, PROFILE_STAGE_NONE, PROFILE_STAGE_HISTORY_SIZE);
+    PROFILE.resetTime = TimerGetMillis();
+}
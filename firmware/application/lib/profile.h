@@ -0,0 +1,92 @@
+/*
+ * File:   profile.h
+ * Author: agent <agent@local>
+ * Description:
+ *     Account for the cycles spent in each stage of the main loop, in each
+ *     scheduled task and in each event callback, so that whatever stalls
+ *     the loop can be found on a running device. The cycles that the loop
+ *     spends idle are kept too, for its duty cycle.
+ */
+#ifndef PROFILE_H
+#define PROFILE_H
+#include <stdint.h>
+#include "event.h"
+#include "timer.h"
+
+// Stages of the main loop. The loop stage is the whole pass.
+#define PROFILE_STAGE_LOOP 0
+#define PROFILE_STAGE_BT 1
+#define PROFILE_STAGE_IBUS 2
+#define PROFILE_STAGE_TIMER 3
+#define PROFILE_STAGE_PHONEBOOK 4
+#define PROFILE_STAGE_CLI 5
+#define PROFILE_STAGE_DEFERRED_INIT 6
+#define PROFILE_STAGE_COUNT 7
+
+// How many of the last stages to run are kept, for the crash record
+#define PROFILE_STAGE_HISTORY_SIZE 8
+// An unused slot in the stage history
+#define PROFILE_STAGE_NONE 0xFF
+
+// Event callbacks are recorded by callback slot. The handlers and the CLI
+// register 46 callbacks and the UIs up to 28 more, so slots past this are
+// only reached once the UI has been switched a few times, and go unrecorded.
+#define PROFILE_CALLBACKS_MAX 96
+
+// The first bucket holds anything under 256 cycles (16us), and each bucket
+// after it is four times as wide as the one before. The last one holds
+// everything from 1048576 cycles (65ms) up.
+#define PROFILE_HISTOGRAM_BUCKETS 8
+#define PROFILE_HISTOGRAM_BASE 256
+#define PROFILE_HISTOGRAM_SHIFT 2
+
+/**
+ * ProfileStat_t
+ *     Description:
+ *         The cost of a main loop stage
+ *     Fields:
+ *         count - The number of times it ran
+ *         total - The cycles spent in it
+ *         max - The most cycles that a single run took
+ *         histogram - The number of runs that fell in each bucket,
+ *             saturating at 0xFFFF
+ */
+typedef struct ProfileStat_t {
+    uint32_t count;
+    uint64_t total;
+    uint32_t max;
+    uint16_t histogram[PROFILE_HISTOGRAM_BUCKETS];
+} ProfileStat_t;
+
+/**
+ * ProfileSlotStat_t
+ *     Description:
+ *         The cost of a scheduled task or an event callback. There is one of
+ *         these for every task and callback slot, so it is kept small and
+ *         has no histogram. Once either counter would overflow, the slot is
+ *         no longer recorded so that the average stays true.
+ *     Fields:
+ *         count - The number of times it ran
+ *         max - The most microseconds that a single run took, saturating
+ *             at 0xFFFF
+ *         total - The cycles spent in it
+ */
+typedef struct ProfileSlotStat_t {
+    uint16_t count;
+    uint16_t max;
+    uint32_t total;
+} ProfileSlotStat_t;
+
+ProfileSlotStat_t *ProfileGetCallback(uint8_t);
+ProfileStat_t *ProfileGetIdle();
+uint32_t ProfileGetResetTime();
+ProfileStat_t *ProfileGetStage(uint8_t);
+void ProfileGetStageHistory(uint8_t *);
+const char *ProfileGetStageName(uint8_t);
+ProfileSlotStat_t *ProfileGetTask(uint8_t);
+void ProfileRecordCallback(uint8_t, uint32_t);
+void ProfileRecordIdle(uint32_t);
+uint32_t ProfileRecordStage(uint8_t, uint32_t);
+void ProfileRecordTask(uint8_t, uint32_t);
+void ProfileReset();
+#endif /* PROFILE_H */
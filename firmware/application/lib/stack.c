@@ -0,0 +1,95 @@
+/*
+ * File:   stack.c
+ * Author: agent <agent@local>
+ * Description:
+ *     Paint the free stack at boot so that the deepest it has grown can be
+ *     read back, and keep the deepest it has ever grown in the EEPROM
+ */
+#include "stack.h"
+// The stack pointer when the stack was painted
+uint16_t STACK_BASE = 0;
+
+/**
+ * StackGetHighWaterMark()
+ *     Description:
+ *         Find the deepest the stack has grown since boot. The stack grows
+ *         up towards SPLIM, so this is the highest word that no longer holds
+ *         the paint.
+ *     Params:
+ *         None
+ *     Returns:
+ *         uint16_t - The most bytes of stack used since boot
+ */
+uint16_t StackGetHighWaterMark()
+{
+    if (STACK_BASE == 0) {
+        return 0;
+    }
+    volatile uint16_t *word = (volatile uint16_t *) SPLIM;
+    while ((uint16_t) word > STACK_BASE && *(word - 1) == STACK_PAINT_PATTERN) {
+        word--;
+    }
+    return (uint16_t) word - STACK_BASE;
+}
+
+/**
+ * StackGetSize()
+ *     Description:
+ *         Get the size of the stack, from where it was painted to SPLIM
+ *     Params:
+ *         None
+ *     Returns:
+ *         uint16_t - The size of the stack in bytes
+ */
+uint16_t StackGetSize()
+{
+    if (STACK_BASE == 0) {
+        return 0;
+    }
+    return SPLIM - STACK_BASE;
+}
+
+/**
+ * StackInit()
+ *     Description:
+ *         Paint the stack above the stack pointer up to SPLIM, and check
+ *         the high water mark on a schedule. This must be the first thing
+ *         main() does, before any interrupt is enabled, or an ISR frame
+ *         could be painted over.
+ *     Params:
+ *         None
+ *     Returns:
+ *         void
+ */
+void StackInit()
+{
+    STACK_BASE = WREG15;
+    volatile uint16_t *word = (volatile uint16_t *) (STACK_BASE + STACK_PAINT_MARGIN);
+    volatile uint16_t *limit = (volatile uint16_t *) SPLIM;
+    while (word < limit) {
+        *word++ = STACK_PAINT_PATTERN;
+    }
+    TimerRegisterScheduledTask(
+        &StackTimerRecordHighWaterMark,
+        0,
+        STACK_RECORD_INTERVAL
+    );
+}
+
+/**
+ * StackTimerRecordHighWaterMark()
+ *     Description:
+ *         Write the high water mark to the EEPROM if it is deeper than the
+ *         one recorded, so the EEPROM is only written as the stack grows
+ *     Params:
+ *         void *ctx - Unused
+ *     Returns:
+ *         void
+ */
+void StackTimerRecordHighWaterMark(void *ctx)
+{
+    uint16_t highWaterMark = StackGetHighWaterMark();
+    if (highWaterMark > ConfigGetStackHighWaterMark()) {
+        ConfigSetStackHighWaterMark(highWaterMark);
+    }
+}
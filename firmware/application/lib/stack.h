@@ -0,0 +1,32 @@
+/*
+ * File:   stack.h
+ * Author: agent <agent@local>
+ * Description:
+ *     Paint the free stack at boot so that the deepest it has grown can be
+ *     read back, and keep the deepest it has ever grown in the EEPROM
+ */
+#ifndef STACK_H
+#define STACK_H
+#include <stdint.h>
+#include <xc.h>
+#include "config.h"
+#include "timer.h"
+
+// The word that the free stack is painted with
+#define STACK_PAINT_PATTERN 0xA55A
+// The stack just above the stack pointer is left alone while painting, since
+// the painting itself is using it
+#define STACK_PAINT_MARGIN 32
+// How often the high water mark is compared with the recorded one, in
+// milliseconds
+#define STACK_RECORD_INTERVAL 10000
+
+// The stack pointer when the stack was painted, which is above the frame of
+// main(). The trap entries in crash_trap.s move the stack pointer back here.
+extern uint16_t STACK_BASE;
+
+uint16_t StackGetHighWaterMark();
+uint16_t StackGetSize();
+void StackInit();
+void StackTimerRecordHighWaterMark(void *);
+#endif /* STACK_H */
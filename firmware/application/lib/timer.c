@@ -6,6 +6,7 @@
  *     time events in the application. Implement a scheduled task queue.
  */
 #include "timer.h"
+#include "profile.h"
 volatile uint32_t TimerCurrentMillis = 0;
 volatile TimerScheduledTask_t TimerRegisteredTasks[TIMER_TASKS_MAX];
 uint8_t TimerRegisteredTasksCount = 0;
@@ -13,7 +14,10 @@ uint8_t TimerRegisteredTasksCount = 0;
 /**
  * TimerInit()
  *     Description:
- *         Initialize the system Timer (Timer1)
+ *         Initialize the system Timer (Timer1), and the free running cycle
+ *         counter (Timer4/5) that the profiler times the main loop with.
+ *         Timer1 keeps running in idle mode, since its interrupt is what
+ *         wakes an idle main loop at least once per millisecond.
  *     Params:
  *         None
  *     Returns:
@@ -22,11 +26,20 @@ uint8_t TimerRegisteredTasksCount = 0;
 void TimerInit()
 {
     T1CON = 0;
-    T1CON = TIMER_ON | STOP_TIMER_IN_IDLE_MODE | TIMER_SOURCE_INTERNAL | GATED_TIME_DISABLED | TIMER_16BIT_MODE | CLOCK_DIVIDER;
+    T1CON = TIMER_ON | TIMER_SOURCE_INTERNAL | GATED_TIME_DISABLED | TIMER_16BIT_MODE | CLOCK_DIVIDER;
     PR1 = PR1_SETTING;
     SetTIMERIP(TIMER_INDEX, TIMER_INTERRUPT_PRIORITY);
     SetTIMERIF(TIMER_INDEX, 0);
     SetTIMERIE(TIMER_INDEX, 1);
+    // Timer4/5 run as one 32-bit timer with no interrupt, and keep counting
+    // in idle mode
+    T4CON = 0;
+    T5CON = 0;
+    TMR5 = 0;
+    TMR4 = 0;
+    PR5 = 0xFFFF;
+    PR4 = 0xFFFF;
+    T4CON = TIMER_ON | TIMER_SOURCE_INTERNAL | GATED_TIME_DISABLED | TIMER_32BIT_MODE | CLOCK_DIVIDER;
 }
 
 /**
@@ -51,10 +64,68 @@ void TimerDelayMicroseconds(uint16_t delay)
     T2CONbits.TON = 0;
 }
 
+/**
+ * TimerGetCycles()
+ *     Description:
+ *         Return the number of instruction cycles counted by Timer4/5. Reading
+ *         the low word latches the high word into TMR5HLD, so the two halves
+ *         always belong together.
+ *     Params:
+ *         None
+ *     Returns:
+ *         uint32_t - The free running cycle count
+ */
+uint32_t TimerGetCycles()
+{
+    uint16_t low = TMR4;
+    return ((uint32_t) TMR5HLD << 16) | low;
+}
+
+/**
+ * TimerGetCyclesFromISR()
+ *     Description:
+ *         Return the number of instruction cycles counted by Timer4/5 from an
+ *         interrupt. The ISR may have interrupted TimerGetCycles() between
+ *         its two reads, so the high word that it latched is put back.
+ *     Params:
+ *         None
+ *     Returns:
+ *         uint32_t - The free running cycle count
+ */
+uint32_t TimerGetCyclesFromISR()
+{
+    uint16_t hold = TMR5HLD;
+    uint32_t cycles = TimerGetCycles();
+    TMR5HLD = hold;
+    return cycles;
+}
+
+/**
+ * TimerGetMicros()
+ *     Description:
+ *         Return the microseconds counted by Timer4/5. The count runs freely
+ *         without an interrupt, so it is finer than the milliseconds for no
+ *         extra ISR load, but it only has 28 bits and wraps every 268
+ *         seconds. Mask the difference of two readings with
+ *         TIMER_MICROS_MASK to get the time between them.
+ *     Params:
+ *         None
+ *     Returns:
+ *         uint32_t - The free running microsecond count
+ */
+uint32_t TimerGetMicros()
+{
+    return TimerGetCycles() / TIMER_CYCLES_PER_MICROSECOND;
+}
+
 /**
  * TimerGetMillis()
  *     Description:
- *         Return the number of elapsed milliseconds since boot
+ *         Return the number of elapsed milliseconds since boot. The count
+ *         is two words wide, so the Timer1 ISR may carry into the high word
+ *         between the reads of its halves. It is read again until two
+ *         reads agree rather than masking the interrupt, which would delay
+ *         the UART ISRs as well.
  *     Params:
  *         None
  *     Returns:
@@ -62,7 +133,50 @@ void TimerDelayMicroseconds(uint16_t delay)
  */
 uint32_t TimerGetMillis()
 {
-    return (uint32_t) TimerCurrentMillis;
+    uint32_t millis;
+    do {
+        millis = TimerCurrentMillis;
+    } while (millis != TimerCurrentMillis);
+    return millis;
+}
+
+/**
+ * TimerGetScheduledTask()
+ *     Description:
+ *         Get a registered scheduled task
+ *     Params:
+ *         uint8_t taskId - The index of the scheduled task in the tasks array
+ *     Returns:
+ *         volatile TimerScheduledTask_t * - The task, or 0 if the index has
+ *             never been registered
+ */
+volatile TimerScheduledTask_t *TimerGetScheduledTask(uint8_t taskId)
+{
+    if (taskId >= TimerRegisteredTasksCount) {
+        return 0;
+    }
+    return &TimerRegisteredTasks[taskId];
+}
+
+/**
+ * TimerHasTaskDue()
+ *     Description:
+ *         Check if any scheduled task is due to run
+ *     Params:
+ *         None
+ *     Returns:
+ *         uint8_t - 1 if a task is due, 0 otherwise
+ */
+uint8_t TimerHasTaskDue()
+{
+    uint8_t idx;
+    for (idx = 0; idx < TimerRegisteredTasksCount; idx++) {
+        volatile TimerScheduledTask_t *t = &TimerRegisteredTasks[idx];
+        if (t->ticks >= t->interval && t->task != 0 && t->interval > 0) {
+            return 1;
+        }
+    }
+    return 0;
 }
 
 /**
@@ -80,7 +194,9 @@ void TimerProcessScheduledTasks()
     for (idx = 0; idx < TimerRegisteredTasksCount; idx++) {
         volatile TimerScheduledTask_t *t = &TimerRegisteredTasks[idx];
         if (t->ticks >= t->interval && t->task != 0 && t->interval > 0) {
+            uint32_t begin = TimerGetCycles();
             t->task(t->context);
+            ProfileRecordTask(idx, begin);
             t->ticks = 0;
         }
     }
@@ -201,7 +317,9 @@ void TimerTriggerScheduledTask(uint8_t taskId)
     if (t->task != 0) {
         // Prevent it from executing immediately
         t->ticks = 0;
+        uint32_t begin = TimerGetCycles();
         t->task(t->context);
+        ProfileRecordTask(taskId, begin);
         // Reset the ticks so it runs exactly `interval` times before firing
         t->ticks = 0;
     }
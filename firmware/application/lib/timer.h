@@ -20,6 +20,10 @@
 #define PR1_SETTING (SYS_CLOCK / 1000 / 1)
 #define TIMER_TASKS_MAX 32
 #define TIMER_INDEX 0
+// Timer4/5 count instruction cycles, so they wrap every 268 seconds
+#define TIMER_CYCLES_PER_MICROSECOND (SYS_CLOCK / 1000000)
+// The microseconds derived from them have the remaining 28 bits
+#define TIMER_MICROS_MASK 0x0FFFFFFF
 #define TIMER_TASK_DISABLED 0
 #include <stdint.h>
 #include <string.h>
@@ -45,7 +49,12 @@ typedef struct TimerScheduledTask_t {
 
 void TimerInit();
 void TimerDelayMicroseconds(uint16_t);
+uint32_t TimerGetCycles();
+uint32_t TimerGetCyclesFromISR();
+uint32_t TimerGetMicros();
 uint32_t TimerGetMillis();
+volatile TimerScheduledTask_t *TimerGetScheduledTask(uint8_t);
+uint8_t TimerHasTaskDue();
 void TimerProcessScheduledTasks();
 uint8_t TimerRegisterScheduledTask(void *, void *, uint16_t);
 uint8_t TimerUnregisterScheduledTask(void *);
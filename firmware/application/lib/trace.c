@@ -0,0 +1,202 @@
+/*
+ * File:   trace.c
+ * Author: agent <agent@local>
+ * Description:
+ *     Timestamp frames as they pass from the UART RX ISR through the parsers
+ *     and handlers to the bus, into a ring of records that can be dumped
+ *     over the CLI or streamed in binary, so that the latency between any
+ *     two points can be measured
+ */
+#include "trace.h"
+
+/**
+ * Trace_t
+ *     Description:
+ *         The trace ring. Records are only written from the main loop, so
+ *         the ring needs no protection from the ISRs.
+ *     Fields:
+ *         mode - TRACE_MODE_OFF, TRACE_MODE_RING or TRACE_MODE_STREAM
+ *         writeIdx - Where the next record goes
+ *         count - The number of records in the ring
+ *         records - The ring
+ */
+typedef struct Trace_t {
+    uint8_t mode;
+    uint8_t writeIdx;
+    uint8_t count;
+    TraceRecord_t records[TRACE_SIZE];
+} Trace_t;
+static Trace_t TRACE;
+
+static const char *TRACE_POINT_NAMES[TRACE_POINT_COUNT] = {
+    "UART RX",
+    "IBus RX",
+    "BT RX",
+    "Event",
+    "IBus TX Queue",
+    "IBus TX",
+    "BT TX"
+};
+
+/**
+ * TraceGet()
+ *     Description:
+ *         Get a record from the ring, oldest first
+ *     Params:
+ *         uint8_t idx - The position of the record, from the oldest
+ *     Returns:
+ *         TraceRecord_t * - The record, or 0 if there are not that many
+ */
+TraceRecord_t *TraceGet(uint8_t idx)
+{
+    if (idx >= TRACE.count) {
+        return 0;
+    }
+    uint16_t position = TRACE.writeIdx + TRACE_SIZE - TRACE.count + idx;
+    return &TRACE.records[position % TRACE_SIZE];
+}
+
+/**
+ * TraceGetCount()
+ *     Description:
+ *         Get the number of records in the ring
+ *     Params:
+ *         None
+ *     Returns:
+ *         uint8_t - The number of records
+ */
+uint8_t TraceGetCount()
+{
+    return TRACE.count;
+}
+
+/**
+ * TraceGetMode()
+ *     Description:
+ *         Get the trace mode
+ *     Params:
+ *         None
+ *     Returns:
+ *         uint8_t - TRACE_MODE_OFF, TRACE_MODE_RING or TRACE_MODE_STREAM
+ */
+uint8_t TraceGetMode()
+{
+    return TRACE.mode;
+}
+
+/**
+ * TraceGetPointName()
+ *     Description:
+ *         Get the name of a trace point
+ *     Params:
+ *         uint8_t point - The trace point
+ *     Returns:
+ *         const char * - The trace point name
+ */
+const char *TraceGetPointName(uint8_t point)
+{
+    if (point >= TRACE_POINT_COUNT) {
+        return "";
+    }
+    return TRACE_POINT_NAMES[point];
+}
+
+/**
+ * TraceRecord()
+ *     Description:
+ *         Record something passing a trace point now
+ *     Params:
+ *         uint8_t point - The trace point
+ *         uint8_t value - The value that identifies it
+ *         uint16_t detail - More identification
+ *     Returns:
+ *         void
+ */
+void TraceRecord(uint8_t point, uint8_t value, uint16_t detail)
+{
+    if (TRACE.mode == TRACE_MODE_OFF) {
+        return;
+    }
+    TraceRecordAt(TimerGetCycles(), point, value, detail);
+}
+
+/**
+ * TraceRecordAt()
+ *     Description:
+ *         Record something that passed a trace point at the given time. In
+ *         stream mode, the record is also sent to the system UART.
+ *     Params:
+ *         uint32_t timestamp - The Timer4/5 cycle count when it passed
+ *         uint8_t point - The trace point
+ *         uint8_t value - The value that identifies it
+ *         uint16_t detail - More identification
+ *     Returns:
+ *         void
+ */
+void TraceRecordAt(uint32_t timestamp, uint8_t point, uint8_t value, uint16_t detail)
+{
+    if (TRACE.mode == TRACE_MODE_OFF) {
+        return;
+    }
+    TraceRecord_t *record = &TRACE.records[TRACE.writeIdx];
+    record->timestamp = timestamp;
+    record->point = point;
+    record->value = value;
+    record->detail = detail;
+    TRACE.writeIdx = (TRACE.writeIdx + 1) % TRACE_SIZE;
+    if (TRACE.count < TRACE_SIZE) {
+        TRACE.count++;
+    }
+    if (TRACE.mode == TRACE_MODE_STREAM) {
+        UART_t *uart = UARTGetModuleHandler(SYSTEM_UART_MODULE);
+        uint8_t frame[TRACE_STREAM_FRAME_SIZE] = {
+            TRACE_STREAM_SYNC,
+            timestamp & 0xFF,
+            (timestamp >> 8) & 0xFF,
+            (timestamp >> 16) & 0xFF,
+            timestamp >> 24,
+            point,
+            value,
+            detail & 0xFF,
+            detail >> 8,
+            0
+        };
+        uint8_t idx;
+        for (idx = 1; idx < TRACE_STREAM_FRAME_SIZE - 1; idx++) {
+            frame[TRACE_STREAM_FRAME_SIZE - 1] -= frame[idx];
+        }
+        if (uart != 0) {
+            UARTSendData(uart, frame, TRACE_STREAM_FRAME_SIZE);
+        }
+    }
+}
+
+/**
+ * TraceReset()
+ *     Description:
+ *         Empty the ring
+ *     Params:
+ *         None
+ *     Returns:
+ *         void
+ */
+void TraceReset()
+{
+    TRACE.writeIdx = 0;
+    TRACE.count = 0;
+}
+
+/**
+ * TraceSetMode()
+ *     Description:
+ *         Turn tracing off, record to the ring only, or record to the ring
+ *         and stream every record
+ *     Params:
+ *         uint8_t mode - TRACE_MODE_OFF, TRACE_MODE_RING or TRACE_MODE_STREAM
+ *     Returns:
+ *         void
+ */
+void TraceSetMode(uint8_t mode)
+{
+    TRACE.mode = mode;
+}
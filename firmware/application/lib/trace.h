@@ -0,0 +1,74 @@
+/*
+ * File:   trace.h
+ * Author: agent <agent@local>
+ * Description:
+ *     Timestamp frames as they pass from the UART RX ISR through the parsers
+ *     and handlers to the bus, into a ring of records that can be dumped
+ *     over the CLI or streamed in binary, so that the latency between any
+ *     two points can be measured
+ */
+#ifndef TRACE_H
+#define TRACE_H
+#include <stdint.h>
+#include "../mappings.h"
+#include "timer.h"
+#include "uart.h"
+
+#define TRACE_SIZE 128
+
+// The points that a frame passes, and what value and detail hold for each
+// The first byte of a frame reached the RX queue. Value: UART module
+#define TRACE_POINT_UART_RX 0
+// An IBus frame was received. Value: source, detail: destination << 8 | command
+#define TRACE_POINT_IBUS_RX 1
+// A Bluetooth frame was received. BM83 value: event, detail: the first two
+// data bytes. BC127 value: 0, detail: the first two characters.
+#define TRACE_POINT_BT_RX 2
+// An event was triggered. Value: event type
+#define TRACE_POINT_EVENT 3
+// An IBus frame was queued. Value: source, detail: destination << 8 | command
+#define TRACE_POINT_IBUS_TX_QUEUE 4
+// An IBus frame was sent on the bus. Value and detail as above
+#define TRACE_POINT_IBUS_TX 5
+// A Bluetooth frame was sent. BM83 value: command, detail: the first two
+// data bytes. BC127 value: 0, detail: the first two characters.
+#define TRACE_POINT_BT_TX 6
+#define TRACE_POINT_COUNT 7
+
+#define TRACE_MODE_OFF 0
+#define TRACE_MODE_RING 1
+#define TRACE_MODE_STREAM 2
+
+// A streamed record is sent as the sync byte, the record in little endian
+// order and a checksum that brings the sum of the record bytes to zero.
+// The CLI only sends printable characters, so the sync byte never appears
+// in text.
+#define TRACE_STREAM_SYNC 0xFF
+#define TRACE_STREAM_FRAME_SIZE 10
+
+/**
+ * TraceRecord_t
+ *     Description:
+ *         A frame or event passing a trace point
+ *     Fields:
+ *         timestamp - The Timer4/5 cycle count when it passed
+ *         point - The trace point
+ *         value - The value that identifies it, which depends on the point
+ *         detail - More identification, which depends on the point
+ */
+typedef struct TraceRecord_t {
+    uint32_t timestamp;
+    uint8_t point;
+    uint8_t value;
+    uint16_t detail;
+} TraceRecord_t;
+
+TraceRecord_t *TraceGet(uint8_t);
+uint8_t TraceGetCount();
+uint8_t TraceGetMode();
+const char *TraceGetPointName(uint8_t);
+void TraceRecord(uint8_t, uint8_t, uint16_t);
+void TraceRecordAt(uint32_t, uint8_t, uint8_t, uint16_t);
+void TraceReset();
+void TraceSetMode(uint8_t);
+#endif /* TRACE_H */
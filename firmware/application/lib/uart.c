@@ -23,8 +23,17 @@ UART_t UARTInit(
 ) {
     UART_t uart;
     uart.rxQueue = CharQueueInit();
+    uart.txQueue = 0;
+    uart.txReadCursor = 0;
+    uart.txWriteCursor = 0;
+    uart.txDropped = 0;
+    uart.txQueueMax = 0;
+    uart.txFullMode = UART_TX_FULL_WAIT;
+    uart.rxWatermark = UART_RX_WATERMARK_CHAR;
     uart.moduleIndex = uartModule - 1;
     uart.rxError = 0;
+    uart.rxTimestamp = 0;
+    uart.rxTimestampCursor = UART_RX_TIMESTAMP_TAKEN;
     uart.txPin = txPin;
     // Unlock the reprogrammable pin register
     __builtin_write_OSCCONL(OSCCON & 0xBF);
@@ -53,7 +62,7 @@ UART_t UARTInit(
     __builtin_write_OSCCONL(OSCCON & 0x40);
     //Set the BAUD Rate
     uart.registers->uxbrg = baudRate;
-    // Disable the TX ISR, since we handle it manually and Enable the RX ISR
+    // The TX ISR is only enabled while the TX queue holds data. Enable the RX ISR
     SetUARTTXIE(uart.moduleIndex, 0);
     SetUARTRXIE(uart.moduleIndex, 1);
     // Set the ISR Flag to disabled for RX (as it should be when the hardware
@@ -146,13 +155,29 @@ UART_t * UARTGetModuleHandler(uint8_t moduleIndex)
     return UARTModules[moduleIndex - 1];
 }
 
-static uint8_t UARTRXInterruptHandler(uint8_t moduleIndex)
+/**
+ * UARTRXDrain()
+ *     Description:
+ *         Move every byte in the hardware RX FIFO onto the RX queue. The
+ *         queue cursors are kept in registers and the write cursor is only
+ *         published once the FIFO is empty, along with the queue's high
+ *         water mark. If the queue is full, the byte is discarded. Bytes
+ *         that arrive on an empty queue start a new frame as far as the
+ *         latency trace is concerned, so the time is kept. The caller must
+ *         make sure the RX ISR cannot run at the same time.
+ *     Params:
+ *         UART_t *uart - The UART
+ *     Returns:
+ *         void
+ */
+static void UARTRXDrain(UART_t *uart)
 {
-    UART_t *uart = UARTModules[moduleIndex];
-    if (uart == 0) {
-        // Nothing to do -- Clear the interrupt flag
-        SetUARTRXIF(moduleIndex, 0);
-        return 0;
+    volatile CharQueue_t *queue = &uart->rxQueue;
+    uint16_t readCursor = queue->readCursor;
+    uint16_t writeCursor = queue->writeCursor;
+    if (readCursor == writeCursor) {
+        uart->rxTimestamp = TimerGetCyclesFromISR();
+        uart->rxTimestampCursor = writeCursor;
     }
     // While there is data in the RX buffer
     while ((uart->registers->uxsta & 0x1) == 1) {
@@ -163,7 +188,15 @@ static uint8_t UARTRXInterruptHandler(uint8_t moduleIndex)
                 uart->rxError ^= UART_ERR_OERR;
                 uart->registers->uxsta ^= 0x2;
             }
-            CharQueueAdd(&uart->rxQueue, uart->registers->uxrxreg);
+            uint8_t value = uart->registers->uxrxreg;
+            uint16_t nextCursor = writeCursor + 1;
+            if (nextCursor >= CHAR_QUEUE_SIZE) {
+                nextCursor = 0;
+            }
+            if (nextCursor != readCursor) {
+                queue->data[writeCursor] = value;
+                writeCursor = nextCursor;
+            }
         } else {
             // Set a "General" Error
             uart->rxError ^= UART_ERR_GERR;
@@ -181,29 +214,130 @@ static uint8_t UARTRXInterruptHandler(uint8_t moduleIndex)
             // Clear the byte in the RX buffer
             // DO NOT use uart->registers->uxrxreg. As of xc16 2.0.0 it will
             // not clear the byte when an error has occurred
-            if (moduleIndex == 0) {
+            if (uart->moduleIndex == 0) {
                 U1RXREG;
             }
-            if (moduleIndex == 1) {
+            if (uart->moduleIndex == 1) {
                 U2RXREG;
             }
-            if (moduleIndex == 2) {
+            if (uart->moduleIndex == 2) {
                 U3RXREG;
             }
-            if (moduleIndex == 3) {
+            if (uart->moduleIndex == 3) {
                 U4RXREG;
             }
         }
-        if ((uart->registers->uxsta & 0x1) == 0) {
-            // Buffer is clear -- immediately clear the interrupt flag
-            SetUARTRXIF(moduleIndex, 0);
-            return 0;
-        }
     }
+    // The bytes bypass CharQueueAdd(), so keep the high water mark here
+    uint16_t size = writeCursor - readCursor;
+    if (writeCursor < readCursor) {
+        size = CHAR_QUEUE_SIZE - readCursor + writeCursor;
+    }
+    if (size > queue->maxSize) {
+        queue->maxSize = size;
+    }
+    queue->writeCursor = writeCursor;
+}
+
+static uint8_t UARTRXInterruptHandler(uint8_t moduleIndex)
+{
+    UART_t *uart = UARTModules[moduleIndex];
+    // Clear the flag before draining, so that a byte arriving while we
+    // drain raises the interrupt again instead of being stranded
     SetUARTRXIF(moduleIndex, 0);
+    if (uart == 0) {
+        // Nothing to do
+        return 0;
+    }
+    UARTRXDrain(uart);
     return 0;
 }
 
+/**
+ * UARTGetRXTimestamp()
+ *     Description:
+ *         Get the cycle count at which the byte at the head of the RX queue
+ *         arrived. That is only known for a byte that reached an empty
+ *         queue. Any other byte came in behind it, so the time it is read
+ *         is the closest bound there is. Call it before the byte is taken
+ *         from the queue; the stamp is used up so that a stream that never
+ *         lets the queue drain cannot wrap back onto it.
+ *     Params:
+ *         UART_t *uart - The UART
+ *     Returns:
+ *         uint32_t - The cycle count
+ */
+uint32_t UARTGetRXTimestamp(UART_t *uart)
+{
+    // The RX ISR only moves the stamp while the queue is empty
+    if (uart->rxQueue.readCursor == uart->rxTimestampCursor) {
+        uart->rxTimestampCursor = UART_RX_TIMESTAMP_TAKEN;
+        return uart->rxTimestamp;
+    }
+    return TimerGetCycles();
+}
+
+/**
+ * UARTHasRXData()
+ *     Description:
+ *         Check if bytes are waiting in the hardware RX FIFO. Below the RX
+ *         watermark, they do not raise the RX interrupt.
+ *     Params:
+ *         UART_t *uart - The UART
+ *     Returns:
+ *         uint8_t - 1 if the FIFO holds data, 0 otherwise
+ */
+uint8_t UARTHasRXData(UART_t *uart)
+{
+    // URXDA is UxSTA<0>
+    return uart->registers->uxsta & 0x1;
+}
+
+/**
+ * UARTRXDrainIdle()
+ *     Description:
+ *         When the RX interrupt fires at a FIFO watermark, the tail of a
+ *         burst can stay in the hardware FIFO below the watermark. Pull
+ *         those bytes onto the RX queue once the receiver has gone idle.
+ *         Call this before reading the RX queue.
+ *     Params:
+ *         UART_t *uart - The UART
+ *     Returns:
+ *         void
+ */
+void UARTRXDrainIdle(UART_t *uart)
+{
+    if (uart->rxWatermark == UART_RX_WATERMARK_CHAR) {
+        return;
+    }
+    // Data is available (URXDA) and no byte is being received (RIDLE)
+    if ((uart->registers->uxsta & 0x11) == 0x11) {
+        SetUARTRXIE(uart->moduleIndex, 0);
+        UARTRXDrain(uart);
+        SetUARTRXIE(uart->moduleIndex, 1);
+    }
+}
+
+/**
+ * UARTSetRXWatermark()
+ *     Description:
+ *         Set how full the hardware RX FIFO must be before the RX interrupt
+ *         fires. Any watermark above a single character must be paired with
+ *         calls to UARTRXDrainIdle() so that the end of a burst is received.
+ *     Params:
+ *         UART_t *uart - The UART
+ *         uint8_t watermark - UART_RX_WATERMARK_CHAR or UART_RX_WATERMARK_3_4
+ *     Returns:
+ *         void
+ */
+void UARTSetRXWatermark(UART_t *uart, uint8_t watermark)
+{
+    uart->rxWatermark = watermark;
+    // URXISEL is UxSTA<7:6>
+    uart->registers->uxsta = (uart->registers->uxsta & 0xFF3F) |
+        ((uint16_t) watermark << 6);
+}
+
 void UARTReportErrors(UART_t *uart)
 {
     if (uart->rxError != 0) {
@@ -229,6 +363,15 @@ void UARTReportErrors(UART_t *uart)
         LogRawDebug(LOG_SOURCE_SYSTEM, "\r\n");
         uart->rxError = 0;
     }
+    if (uart->txDropped != 0) {
+        uint16_t txDropped = uart->txDropped;
+        uart->txDropped = 0;
+        LogWarning(
+            "UART[%d]: Dropped %u TX bytes",
+            uart->moduleIndex + 1,
+            txDropped
+        );
+    }
 }
 
 void UARTRXQueueReset(UART_t *uart)
@@ -236,10 +379,142 @@ void UARTRXQueueReset(UART_t *uart)
     CharQueueReset(&uart->rxQueue);
 }
 
+/**
+ * UARTTXQueueFill()
+ *     Description:
+ *         Move bytes from the TX queue into the hardware TX FIFO until either
+ *         the FIFO is full or the queue is empty. The caller must make sure
+ *         the TX ISR cannot run at the same time.
+ *     Params:
+ *         UART_t *uart - The UART
+ *     Returns:
+ *         void
+ */
+static void UARTTXQueueFill(UART_t *uart)
+{
+    uint16_t readCursor = uart->txReadCursor;
+    while (readCursor != uart->txWriteCursor &&
+        (uart->registers->uxsta & (1 << 9)) == 0
+    ) {
+        uart->registers->uxtxreg = uart->txQueue[readCursor];
+        readCursor++;
+        if (readCursor >= UART_TX_QUEUE_SIZE) {
+            readCursor = 0;
+        }
+    }
+    uart->txReadCursor = readCursor;
+}
+
+/**
+ * UARTTXQueueAdd()
+ *     Description:
+ *         Add a byte to the TX queue. If the queue is full, either drop the
+ *         byte or make room by feeding the hardware FIFO directly, depending
+ *         on the configured mode. Feeding the FIFO directly also works when
+ *         called from a context that the TX ISR cannot preempt. A UART
+ *         without a TX queue writes the byte to the hardware FIFO instead.
+ *     Params:
+ *         UART_t *uart - The UART
+ *         uint8_t data - The byte to send
+ *     Returns:
+ *         void
+ */
+static void UARTTXQueueAdd(UART_t *uart, uint8_t data)
+{
+    if (uart->txQueue == 0) {
+        UARTSendCharBlocking(uart, data);
+        return;
+    }
+    uint16_t nextCursor = uart->txWriteCursor + 1;
+    if (nextCursor >= UART_TX_QUEUE_SIZE) {
+        nextCursor = 0;
+    }
+    while (nextCursor == uart->txReadCursor) {
+        if (uart->txFullMode == UART_TX_FULL_DROP) {
+            uart->txDropped++;
+            return;
+        }
+        SetUARTTXIE(uart->moduleIndex, 0);
+        UARTTXQueueFill(uart);
+        SetUARTTXIE(uart->moduleIndex, 1);
+    }
+    uart->txQueue[uart->txWriteCursor] = data;
+    uart->txWriteCursor = nextCursor;
+    // The TX ISR moves the read cursor, so read it once
+    uint16_t readCursor = uart->txReadCursor;
+    uint16_t size = nextCursor - readCursor;
+    if (nextCursor < readCursor) {
+        size += UART_TX_QUEUE_SIZE;
+    }
+    if (size > uart->txQueueMax) {
+        uart->txQueueMax = size;
+    }
+}
+
+/**
+ * UARTTXQueueStart()
+ *     Description:
+ *         Prime the hardware FIFO from the TX queue and enable the TX ISR so
+ *         that it drains the rest
+ *     Params:
+ *         UART_t *uart - The UART
+ *     Returns:
+ *         void
+ */
+static void UARTTXQueueStart(UART_t *uart)
+{
+    SetUARTTXIE(uart->moduleIndex, 0);
+    UARTTXQueueFill(uart);
+    if (uart->txReadCursor != uart->txWriteCursor) {
+        SetUARTTXIE(uart->moduleIndex, 1);
+    }
+}
+
+/**
+ * UARTFlush()
+ *     Description:
+ *         Send everything on the TX queue by polling the hardware, and wait
+ *         for the last byte to leave the shift register. For use before a
+ *         reset and in trap handlers, where interrupts may not be serviced.
+ *     Params:
+ *         UART_t *uart - The UART
+ *     Returns:
+ *         void
+ */
+void UARTFlush(UART_t *uart)
+{
+    if (uart == 0) {
+        return;
+    }
+    SetUARTTXIE(uart->moduleIndex, 0);
+    while (uart->txReadCursor != uart->txWriteCursor) {
+        UARTTXQueueFill(uart);
+    }
+    // Wait for the transmit shift register to empty
+    while ((uart->registers->uxsta & (1 << 8)) == 0);
+}
+
 void UARTSendChar(UART_t *uart, unsigned char data)
+{
+    UARTTXQueueAdd(uart, data);
+    UARTTXQueueStart(uart);
+}
+
+/**
+ * UARTSendCharBlocking()
+ *     Description:
+ *         Write a byte straight to the hardware FIFO, bypassing the TX queue,
+ *         and wait for it to leave the FIFO. For callers that must control
+ *         when every byte goes out on the wire.
+ *     Params:
+ *         UART_t *uart - The UART
+ *         uint8_t data - The byte to send
+ *     Returns:
+ *         void
+ */
+void UARTSendCharBlocking(UART_t *uart, uint8_t data)
 {
     uart->registers->uxtxreg = data;
-    // Wait for the data to leave the tx buffer
     while ((uart->registers->uxsta & (1 << 9)) != 0);
 }
 
@@ -247,10 +522,9 @@ void UARTSendData(UART_t *uart, unsigned char *data, uint16_t length)
 {
     uint16_t i;
     for (i = 0; i < length; i++) {
-        uart->registers->uxtxreg = data[i];
-        // Wait for the data to leave the tx buffer
-        while ((uart->registers->uxsta & (1 << 9)) != 0);
+        UARTTXQueueAdd(uart, data[i]);
     }
+    UARTTXQueueStart(uart);
 }
 
 void UARTSendString(UART_t *uart, char *data)
@@ -261,11 +535,59 @@ void UARTSendString(UART_t *uart, char *data)
         char c = data[i];
         // Print only readable and newline characters
         if ((c >= 0x20 && c <= 0x7E) || c == 0x0D || c == 0x0A) {
-            uart->registers->uxtxreg = c;
-            // Wait for the data to leave the tx buffer
-            while ((uart->registers->uxsta & (1 << 9)) != 0);
+            UARTTXQueueAdd(uart, c);
         }
     }
+    UARTTXQueueStart(uart);
+}
+
+/**
+ * UARTSetTXFullMode()
+ *     Description:
+ *         Choose what happens when data is sent while the TX queue is full
+ *     Params:
+ *         UART_t *uart - The UART
+ *         uint8_t mode - UART_TX_FULL_WAIT or UART_TX_FULL_DROP
+ *     Returns:
+ *         void
+ */
+void UARTSetTXFullMode(UART_t *uart, uint8_t mode)
+{
+    uart->txFullMode = mode;
+}
+
+/**
+ * UARTSetTXQueue()
+ *     Description:
+ *         Give the UART a buffer of UART_TX_QUEUE_SIZE bytes to use as its
+ *         TX queue. Only the UARTs that send bursts need one, so the buffer
+ *         is owned by the caller rather than by every UART_t.
+ *     Params:
+ *         UART_t *uart - The UART
+ *         volatile uint8_t *queue - The buffer for the TX queue
+ *     Returns:
+ *         void
+ */
+void UARTSetTXQueue(UART_t *uart, volatile uint8_t *queue)
+{
+    uart->txReadCursor = 0;
+    uart->txWriteCursor = 0;
+    uart->txQueue = queue;
+}
+
+static void UARTTXInterruptHandler(uint8_t moduleIndex)
+{
+    UART_t *uart = UARTModules[moduleIndex];
+    SetUARTTXIF(moduleIndex, 0);
+    if (uart == 0) {
+        SetUARTTXIE(moduleIndex, 0);
+        return;
+    }
+    UARTTXQueueFill(uart);
+    if (uart->txReadCursor == uart->txWriteCursor) {
+        // Nothing left to send -- the next send re-enables the ISR
+        SetUARTTXIE(moduleIndex, 0);
+    }
 }
 
 /*
@@ -286,4 +608,24 @@ void __attribute__((__interrupt__, auto_psv)) _AltU3RXInterrupt()
 void __attribute__((__interrupt__, auto_psv)) _AltU4RXInterrupt()
 {
     UARTRXInterruptHandler(3);
+}
+
+/*
+ * Define the TX interrupt handlers that will pass off to our handler above
+ */
+void __attribute__((__interrupt__, auto_psv)) _AltU1TXInterrupt()
+{
+    UARTTXInterruptHandler(0);
+}
+void __attribute__((__interrupt__, auto_psv)) _AltU2TXInterrupt()
+{
+    UARTTXInterruptHandler(1);
+}
+void __attribute__((__interrupt__, auto_psv)) _AltU3TXInterrupt()
+{
+    UARTTXInterruptHandler(2);
+}
+void __attribute__((__interrupt__, auto_psv)) _AltU4TXInterrupt()
+{
+    UARTTXInterruptHandler(3);
 }
\ No newline at end of file
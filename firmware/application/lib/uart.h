@@ -23,28 +23,62 @@
 #define UART_PARITY_NONE 0
 #define UART_PARITY_EVEN 1
 #define UART_PARITY_ODD 2
+// RX interrupt select modes (URXISEL) -- interrupt on every character,
+// or once the 4 byte hardware FIFO is 3/4 full
+#define UART_RX_TIMESTAMP_TAKEN 0xFFFF
+#define UART_RX_WATERMARK_CHAR 0b00
+#define UART_RX_WATERMARK_3_4 0b10
+#define UART_TX_QUEUE_SIZE 256
+// When the TX queue is full, move bytes to the hardware FIFO inline
+#define UART_TX_FULL_WAIT 0
+// When the TX queue is full, discard the bytes that do not fit
+#define UART_TX_FULL_DROP 1
 
 /**
  * UART_t
  *     Description:
  *         This object defines helper functionality to allow us to read and
- *         write data from the UART module
+ *         write data from the UART module. Outgoing data is placed on the
+ *         TX queue and moved to the hardware FIFO by the TX interrupt. The
+ *         TX queue buffer is given with UARTSetTXQueue(). Without one, bytes
+ *         are written to the hardware FIFO as they are sent. The
+ *         cycle count at which bytes last reached an empty RX queue is kept
+ *         in rxTimestamp, and the queue position of the first of them in
+ *         rxTimestampCursor, for the latency trace. The most bytes the TX queue
+ *         has held at once is kept in txQueueMax.
  */
 typedef struct UART_t {
     volatile CharQueue_t rxQueue;
+    volatile uint8_t *txQueue;
+    volatile uint16_t txReadCursor;
+    volatile uint16_t txWriteCursor;
+    volatile uint16_t txDropped;
+    volatile uint16_t txQueueMax;
+    uint8_t txFullMode;
+    uint8_t rxWatermark;
     uint8_t moduleIndex;
     uint8_t txPin;
     volatile uint16_t rxError;
+    volatile uint32_t rxTimestamp;
+    volatile uint16_t rxTimestampCursor;
     volatile UART *registers;
 } UART_t;
 
 UART_t UARTInit(uint8_t, uint8_t, uint8_t, uint8_t, uint8_t, uint8_t, uint8_t);
 void UARTAddModuleHandler(UART_t *uart);
 void UARTDestroy(uint8_t);
+void UARTFlush(UART_t *);
 UART_t * UARTGetModuleHandler(uint8_t);
+uint32_t UARTGetRXTimestamp(UART_t *);
+uint8_t UARTHasRXData(UART_t *);
 void UARTRXQueueReset(UART_t *);
 void UARTReportErrors(UART_t *);
+void UARTRXDrainIdle(UART_t *);
 void UARTSendChar(UART_t *, uint8_t);
+void UARTSendCharBlocking(UART_t *, uint8_t);
 void UARTSendData(UART_t *, uint8_t *, uint16_t);
 void UARTSendString(UART_t *, char *);
+void UARTSetRXWatermark(UART_t *, uint8_t);
+void UARTSetTXFullMode(UART_t *, uint8_t);
+void UARTSetTXQueue(UART_t *, volatile uint8_t *);
 #endif /* UART_H */
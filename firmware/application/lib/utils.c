@@ -122,6 +122,29 @@ uint8_t UtilsGetUnicodeByteLength(uint8_t byte)
     return bytesInChar;
 }
 
+/**
+ * UtilsHashBytes()
+ *     Description:
+ *         Compute a 32-bit FNV-1a hash over the given bytes. The hash can be
+ *         built up incrementally by passing a previous result back in as the
+ *         seed. Start with UTILS_HASH_SEED.
+ *     Params:
+ *         uint32_t hash - The seed, or the hash of the preceding bytes
+ *         const uint8_t *data - The bytes to hash
+ *         uint16_t length - The number of bytes to hash
+ *     Returns:
+ *         uint32_t The hash
+ */
+uint32_t UtilsHashBytes(uint32_t hash, const uint8_t *data, uint16_t length)
+{
+    uint16_t i;
+    for (i = 0; i < length; i++) {
+        hash ^= data[i];
+        hash *= UTILS_HASH_PRIME;
+    }
+    return hash;
+}
+
 /**
  * UtilsNormalizeText()
  *     Description:
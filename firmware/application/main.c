@@ -11,21 +11,170 @@
 #include "handler.h"
 #include "mappings.h"
 #include "upgrade.h"
+#include "lib/boot_trace.h"
 #include "lib/bt.h"
 #include "lib/config.h"
+#include "lib/crash.h"
 #include "lib/eeprom.h"
 #include "lib/log.h"
 #include "lib/i2c.h"
 #include "lib/ibus.h"
 #include "lib/pcm51xx.h"
+#include "lib/phonebook.h"
+#include "lib/profile.h"
+#include "lib/stack.h"
 #include "lib/timer.h"
 #include "lib/uart.h"
 #include "lib/utils.h"
 #include "lib/wm88xx.h"
 #include "ui/cli.h"
+// The UARTs that the main loop serves: Bluetooth, IBus and the system UART
+#define MAIN_UART_COUNT 3
+
+// IBus writes straight to the hardware FIFO, so only the system UART and the
+// Bluetooth UART have a TX queue
+static uint8_t MAIN_SYSTEM_UART_TX_QUEUE[UART_TX_QUEUE_SIZE];
+
+/**
+ * MainGetUARTActivity()
+ *     Description:
+ *         Pack the queue cursors of a UART into one value, which changes
+ *         whenever a byte is received, read or queued to be sent
+ *     Params:
+ *         UART_t *uart - The UART
+ *     Returns:
+ *         uint32_t - The queue cursors
+ */
+static uint32_t MainGetUARTActivity(UART_t *uart)
+{
+    return ((uint32_t) uart->rxQueue.readCursor << 18) |
+        ((uint32_t) uart->rxQueue.writeCursor << 8) |
+        uart->txWriteCursor;
+}
+
+/**
+ * MainIsIdle()
+ *     Description:
+ *         Check if the pass of the main loop that just ended left work for
+ *         the next one. Work is pending if a UART received, read or queued
+ *         bytes during the pass, if bytes wait in a hardware RX FIFO, if
+ *         IBus frames wait to be sent, if a scheduled task is due, if the
+ *         phonebook is being sorted or if start up steps are left. Without
+ *         any, the next pass would do nothing until an interrupt arrives.
+ *         The caller masks the interrupts around the check and Idle(). Work
+ *         that no interrupt announces, such as a state change polled by a
+ *         handler, waits for the Timer1 interrupt. That bound of a
+ *         millisecond is intended.
+ *     Params:
+ *         UART_t **uarts - The UARTs that the main loop serves
+ *         uint32_t *activity - The activity of each UART at the end of the
+ *             last pass, which is updated to its activity now
+ *         IBus_t *ibus - The IBus object
+ *         uint8_t deferredStage - The next start up step to run
+ *     Returns:
+ *         uint8_t - 1 if the main loop can idle until the next interrupt
+ */
+static uint8_t MainIsIdle(
+    UART_t **uarts,
+    uint32_t *activity,
+    IBus_t *ibus,
+    uint8_t deferredStage
+) {
+    uint8_t idle = 1;
+    uint8_t idx;
+    for (idx = 0; idx < MAIN_UART_COUNT; idx++) {
+        uint32_t current = MainGetUARTActivity(uarts[idx]);
+        if (current != activity[idx] || UARTHasRXData(uarts[idx]) == 1) {
+            idle = 0;
+        }
+        activity[idx] = current;
+    }
+    if (idle == 0 ||
+        ibus->txBufferWriteIdx != ibus->txBufferReadIdx ||
+        TimerHasTaskDue() == 1 ||
+        PhonebookGetStatus() == PHONEBOOK_STATUS_SORT ||
+        PhonebookGetStatus() == PHONEBOOK_STATUS_STORE ||
+        deferredStage != BOOT_TRACE_STAGE_COUNT
+    ) {
+        return 0;
+    }
+    return 1;
+}
+
+/**
+ * MainProcessDeferredInit()
+ *     Description:
+ *         Run the next step of the start up work that the CD Changer does not
+ *         need in order to answer the radio. It waits until we have been on
+ *         the bus, or for BOOT_TRACE_DEFER_TIMEOUT, and then runs one step
+ *         per pass of the main loop so that the bus keeps being serviced.
+ *     Params:
+ *         uint8_t stage - The step to run
+ *         BT_t *bt - The Bluetooth module object
+ *         uint8_t boardVersion - The hardware version
+ *     Returns:
+ *         uint8_t - The next step, or BOOT_TRACE_STAGE_COUNT when done
+ */
+static uint8_t MainProcessDeferredInit(
+    uint8_t stage,
+    BT_t *bt,
+    uint8_t boardVersion
+) {
+    switch (stage) {
+        case BOOT_TRACE_DEFERRED_START: {
+            uint32_t loopStart = BootTraceGet()->timestamps[BOOT_TRACE_MAIN_LOOP];
+            if (BootTraceIsMarked(BOOT_TRACE_IBUS_FIRST_TX) == 0 &&
+                TimerGetMillis() - loopStart < BOOT_TRACE_DEFER_TIMEOUT
+            ) {
+                return stage;
+            }
+            break;
+        }
+        case BOOT_TRACE_PAIRED_DEVICES:
+            // The module may have listed its devices already
+            if (bt->pairedDevicesCount == 0) {
+                BTPairedDevicesLoad(bt);
+            }
+            // A BM83 that powered on before now skipped its PDL query
+            if (bt->type == BT_BTM_TYPE_BM83 && bt->powerState == BT_STATE_ON) {
+                BM83CommandReadPairedDevices(bt);
+            }
+            break;
+        case BOOT_TRACE_PHONEBOOK:
+            PhonebookInit();
+            break;
+        case BOOT_TRACE_DAC_INIT:
+            // WM8804 and PCM5122 must be initialized after the I2C Bus
+            if (boardVersion == BOARD_VERSION_ONE) {
+                WM88XXInit();
+            }
+            PCM51XXInit();
+            // SPDIF_RST is reused from version one where it was TEL_MUTE
+            // Do not alter its state on v1.x boards
+            if (boardVersion == BOARD_VERSION_TWO) {
+                // Enable the SPDIF Transmitter (after being low for >= 500ns)
+                SPDIF_RST = 1;
+            }
+            break;
+        case BOOT_TRACE_DAC_STARTUP:
+            // Run the PCM51XX Start-up process
+            PCM51XXStartup();
+            break;
+        case BOOT_TRACE_READY:
+            // Reset the Boot flag in the EEPROM to indicate a valid boot
+            ConfigSetBootloaderMode(0x00);
+            break;
+        default:
+            return BOOT_TRACE_STAGE_COUNT;
+    }
+    BootTraceMark(stage);
+    return stage + 1;
+}
 
 int main(void)
 {
+    // Paint the stack before anything else can use it
+    StackInit();
     // Set the IVT mode
     IVT_MODE = IVT_MODE_APP;
 
@@ -106,6 +255,7 @@ int main(void)
         UART_BAUD_115200,
         UART_PARITY_NONE
     );
+    UARTSetTXQueue(&systemUart, MAIN_SYSTEM_UART_TX_QUEUE);
     // Grab the hardware version
     uint8_t boardVersion = UtilsGetBoardVersion();
 
@@ -114,48 +264,81 @@ int main(void)
     UARTAddModuleHandler(&systemUart);
     LogMessage("", "**** BlueBus ****");
 
-    // Initialize low level modules
-    EEPROMInit();
+    // Initialize low level modules. The timer goes first so that every
+    // stage of the boot can be timed
     TimerInit();
+    BootTraceMark(BOOT_TRACE_TIMER);
+    EEPROMInit();
+    BootTraceMark(BOOT_TRACE_EEPROM);
     I2CInit();
+    BootTraceMark(BOOT_TRACE_I2C);
 
     struct BT_t bt = BTInit();
     UARTAddModuleHandler(&bt.uart);
+    BootTraceMark(BOOT_TRACE_BT);
 
     struct IBus_t ibus = IBusInit();
     UARTAddModuleHandler(&ibus.uart);
+    BootTraceMark(BOOT_TRACE_IBUS);
 
-    // WM8804 and PCM5122 must be initialized after the I2C Bus
-    if (boardVersion == BOARD_VERSION_ONE) {
-        WM88XXInit();
-    }
-    PCM51XXInit();
-
-    // SPDIF_RST is reused from version one where it was TEL_MUTE
-    // Do not alter its state on v1.x boards
-    if (boardVersion == BOARD_VERSION_TWO) {
-        // Enable the SPDIF Transmitter (after being low for >= 500ns)
-        SPDIF_RST = 1;
-    }
+    // Run any applicable updates. The handlers read the configuration as
+    // they start, so the settings must be migrated first
+    UpgradeProcess(&bt, &ibus);
+    BootTraceMark(BOOT_TRACE_UPGRADE);
 
     ON_LED = 1;
     // Initialize handlers
     HandlerInit(&bt, &ibus);
+    BootTraceMark(BOOT_TRACE_HANDLER);
     // Initialize the CLI
     CLIInit(&systemUart, &bt, &ibus);
-    // Run any applicable updates
-    UpgradeProcess(&bt, &ibus);
-    // Run the PCM51XX Start-up process
-    PCM51XXStartup();
-    // Reset the Boot flag in the EEPROM to indicate a valid boot
-    ConfigSetBootloaderMode(0x00);
+    BootTraceMark(BOOT_TRACE_CLI);
+
+    // The DAC, the stored paired devices, the PDL query and the phonebook
+    // are brought up from the main loop, once the CD Changer can answer
+    uint8_t deferredStage = BOOT_TRACE_DEFERRED_START;
+    BootTraceMark(BOOT_TRACE_MAIN_LOOP);
+
+    UART_t *uarts[MAIN_UART_COUNT] = {&bt.uart, &ibus.uart, &systemUart};
+    uint32_t uartActivity[MAIN_UART_COUNT] = {0};
 
-    // Process events
+    // Process events, timing each stage from the end of the one before.
+    // Once a pass leaves nothing to do, idle the CPU until an interrupt.
+    ProfileReset();
     while (1) {
+        uint32_t passStart = TimerGetCycles();
+        uint32_t stageStart = passStart;
         BTProcess(&bt);
+        stageStart = ProfileRecordStage(PROFILE_STAGE_BT, stageStart);
         IBusProcess(&ibus);
+        stageStart = ProfileRecordStage(PROFILE_STAGE_IBUS, stageStart);
         TimerProcessScheduledTasks();
+        stageStart = ProfileRecordStage(PROFILE_STAGE_TIMER, stageStart);
+        PhonebookProcess();
+        stageStart = ProfileRecordStage(PROFILE_STAGE_PHONEBOOK, stageStart);
         CLIProcess();
+        stageStart = ProfileRecordStage(PROFILE_STAGE_CLI, stageStart);
+        if (deferredStage != BOOT_TRACE_STAGE_COUNT) {
+            deferredStage = MainProcessDeferredInit(
+                deferredStage,
+                &bt,
+                boardVersion
+            );
+            ProfileRecordStage(PROFILE_STAGE_DEFERRED_INIT, stageStart);
+        }
+        ProfileRecordStage(PROFILE_STAGE_LOOP, passStart);
+        // Mask the interrupts from the check until Idle(), so that one which
+        // queues work in between is not left waiting for the next Timer1
+        // tick. The sources stay enabled and still wake the core from Idle.
+        // Their ISRs run once the priority is restored.
+        uint16_t cpuIPL;
+        SET_AND_SAVE_CPU_IPL(cpuIPL, 7);
+        if (MainIsIdle(uarts, uartActivity, &ibus, deferredStage) == 1) {
+            uint32_t idleStart = TimerGetCycles();
+            Idle();
+            ProfileRecordIdle(idleStart);
+        }
+        RESTORE_CPU_IPL(cpuIPL);
     }
 
     return 0;
@@ -165,6 +348,9 @@ int main(void)
 void TrapWait()
 {
     ON_LED = 0;
+    // Interrupts at our priority are not serviced, so push out any
+    // pending log output by hand
+    UARTFlush(UARTGetModuleHandler(SYSTEM_UART_MODULE));
     // Wait five seconds before resetting
     uint32_t sleepCount = 0;
     while (sleepCount <= 50000) {
@@ -174,46 +360,53 @@ void TrapWait()
     UtilsReset();
 }
 
-void __attribute__ ((__interrupt__, auto_psv)) _AltOscillatorFail()
+// The trap vectors in lib/crash_trap.s capture the registers and call these
+void TrapOscillatorFail()
 {
     // Clear the trap flag
     INTCON1bits.OSCFAIL = 0;
     ConfigSetTrapIncrement(CONFIG_TRAP_OSC);
+    CrashRecord(CONFIG_TRAP_OSC);
     TrapWait();
 }
 
-void __attribute__ ((__interrupt__, auto_psv)) _AltAddressError()
+void TrapAddressError()
 {
     // Clear the trap flag
     INTCON1bits.ADDRERR = 0;
     ConfigSetTrapIncrement(CONFIG_TRAP_ADDR);
+    CrashRecord(CONFIG_TRAP_ADDR);
     TrapWait();
 }
 
-void __attribute__ ((__interrupt__, auto_psv)) _AltStackError()
+void TrapStackError()
 {
     // Clear the trap flag
     INTCON1bits.STKERR = 0;
     ConfigSetTrapIncrement(CONFIG_TRAP_STACK);
+    CrashRecord(CONFIG_TRAP_STACK);
     TrapWait();
 }
 
-void __attribute__ ((__interrupt__, auto_psv)) _AltMathError()
+void TrapMathError()
 {
     // Clear the trap flag
     INTCON1bits.MATHERR = 0;
     ConfigSetTrapIncrement(CONFIG_TRAP_MATH);
+    CrashRecord(CONFIG_TRAP_MATH);
     TrapWait();
 }
 
-void __attribute__ ((__interrupt__, auto_psv)) _AltNVMError()
+void TrapNVMError()
 {
     ConfigSetTrapIncrement(CONFIG_TRAP_NVM);
+    CrashRecord(CONFIG_TRAP_NVM);
     TrapWait();
 }
 
-void __attribute__ ((__interrupt__, auto_psv)) _AltGeneralError()
+void TrapGeneralError()
 {
     ConfigSetTrapIncrement(CONFIG_TRAP_GEN);
+    CrashRecord(CONFIG_TRAP_GEN);
     TrapWait();
 }
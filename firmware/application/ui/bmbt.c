@@ -437,31 +437,31 @@ static void BMBTHeaderWriteDeviceName(BMBTContext_t *context, char *text)
 }
 
 /**
- * BMBTGTWriteIndex()
+ * BMBTGTWriteIndexLength()
  *     Description:
- *         Wrapper to automatically push the nav type into the I-Bus Library
- *         Command so that we can save verbosity in these calls
+ *         Write the given text of a known length to the given index, padding
+ *         or truncating it for the nav type in use. The padding is applied
+ *         here rather than stored with the locale strings, since it depends
+ *         on the GT version seen on the bus and on the rows being cleared.
  *     Params:
  *         BMBTContext_t *context - The context
  *         uint8_t index - The index to write to
  *         char *text - The text to write
+ *         uint8_t stringLength - The length of the text
  *         uint8_t clearIdxs - Number of additional rows to clear
- *         uint8_t lastIdx - Number of additional rows to clear
  *     Returns:
  *         void
  */
-static void BMBTGTWriteIndex(
+static void BMBTGTWriteIndexLength(
     BMBTContext_t *context,
     uint8_t index,
     char *text,
+    uint8_t stringLength,
     uint8_t clearIdxs
 ) {
-
-    uint8_t stringLength = strlen(text);
     uint8_t newTextLength = stringLength + clearIdxs + 1;
     if (context->ibus->gtVersion < IBUS_GT_MKIII_NEW_UI) {
         if (stringLength > IBUS_DATA_GT_MKIII_MAX_IDX_LEN) {
-            newTextLength = newTextLength - (stringLength - IBUS_DATA_GT_MKIII_MAX_IDX_LEN);
             stringLength = IBUS_DATA_GT_MKIII_MAX_IDX_LEN;
         }
         if (index + clearIdxs < 7) {
@@ -474,7 +474,7 @@ static void BMBTGTWriteIndex(
     context->status.navIndexType = IBUS_CMD_GT_WRITE_INDEX_TMC;
     char newText[newTextLength + 1];
     memset(&newText, 0x20, newTextLength);
-    strncpy(newText, text, stringLength);
+    memcpy(newText, text, stringLength);
     stringLength = newTextLength - (clearIdxs + 1);
     while (stringLength < newTextLength) {
         newText[stringLength] = 0x06;
@@ -484,6 +484,56 @@ static void BMBTGTWriteIndex(
     IBusCommandGTWriteIndexTMC(context->ibus, index, newText);
 }
 
+/**
+ * BMBTGTWriteIndex()
+ *     Description:
+ *         Wrapper to automatically push the nav type into the I-Bus Library
+ *         Command so that we can save verbosity in these calls
+ *     Params:
+ *         BMBTContext_t *context - The context
+ *         uint8_t index - The index to write to
+ *         char *text - The text to write
+ *         uint8_t clearIdxs - Number of additional rows to clear
+ *     Returns:
+ *         void
+ */
+static void BMBTGTWriteIndex(
+    BMBTContext_t *context,
+    uint8_t index,
+    char *text,
+    uint8_t clearIdxs
+) {
+    BMBTGTWriteIndexLength(context, index, text, strlen(text), clearIdxs);
+}
+
+/**
+ * BMBTGTWriteIndexLocale()
+ *     Description:
+ *         Write a localized string to the given index, using the length
+ *         stored in the active locale table
+ *     Params:
+ *         BMBTContext_t *context - The context
+ *         uint8_t index - The index to write to
+ *         uint16_t stringIndex - The locale string identifier
+ *         uint8_t clearIdxs - Number of additional rows to clear
+ *     Returns:
+ *         void
+ */
+static void BMBTGTWriteIndexLocale(
+    BMBTContext_t *context,
+    uint8_t index,
+    uint16_t stringIndex,
+    uint8_t clearIdxs
+) {
+    BMBTGTWriteIndexLength(
+        context,
+        index,
+        LocaleGetText(stringIndex),
+        LocaleGetTextLength(stringIndex),
+        clearIdxs
+    );
+}
+
 /**
  * BMBTGTWriteTitle()
  *     Description:
@@ -580,9 +630,9 @@ static void BMBTHeaderWrite(BMBTContext_t *context)
 static void BMBTMenuMain(BMBTContext_t *context)
 {
     BMBTGTWriteTitleIndex(context, LocaleGetText(LOCALE_STRING_MAIN_MENU));
-    BMBTGTWriteIndex(context, BMBT_MENU_IDX_DASHBOARD, LocaleGetText(LOCALE_STRING_DASHBOARD), 0);
-    BMBTGTWriteIndex(context, BMBT_MENU_IDX_DEVICE_SELECTION, LocaleGetText(LOCALE_STRING_DEVICES), 0);
-    BMBTGTWriteIndex(context, BMBT_MENU_IDX_SETTINGS, LocaleGetText(LOCALE_STRING_SETTINGS), 5);
+    BMBTGTWriteIndexLocale(context, BMBT_MENU_IDX_DASHBOARD, LOCALE_STRING_DASHBOARD, 0);
+    BMBTGTWriteIndexLocale(context, BMBT_MENU_IDX_DEVICE_SELECTION, LOCALE_STRING_DEVICES, 0);
+    BMBTGTWriteIndexLocale(context, BMBT_MENU_IDX_SETTINGS, LOCALE_STRING_SETTINGS, 5);
     BMBTGTBufferFlush(context);
     context->menu = BMBT_MENU_MAIN;
 }
@@ -740,9 +790,9 @@ static void BMBTMenuDeviceSelection(BMBTContext_t *context)
     uint8_t idx;
     uint8_t screenIdx = 2;
     if (context->bt->discoverable == BT_STATE_ON) {
-        BMBTGTWriteIndex(context, BMBT_MENU_IDX_PAIRING_MODE, LocaleGetText(LOCALE_STRING_PAIRING_ON), 0);
+        BMBTGTWriteIndexLocale(context, BMBT_MENU_IDX_PAIRING_MODE, LOCALE_STRING_PAIRING_ON, 0);
     } else {
-        BMBTGTWriteIndex(context, BMBT_MENU_IDX_PAIRING_MODE, LocaleGetText(LOCALE_STRING_PAIRING_OFF), 0);
+        BMBTGTWriteIndexLocale(context, BMBT_MENU_IDX_PAIRING_MODE, LOCALE_STRING_PAIRING_OFF, 0);
     }
     BTPairedDevice_t *dev = 0;
     uint8_t devicesCount = 0;
@@ -753,9 +803,9 @@ static void BMBTMenuDeviceSelection(BMBTContext_t *context)
         }
     }
     if (devicesCount == 0) {
-        BMBTGTWriteIndex(context, BMBT_MENU_IDX_CLEAR_PAIRING, LocaleGetText(LOCALE_STRING_CLEAR_PAIRINGS), 5);
+        BMBTGTWriteIndexLocale(context, BMBT_MENU_IDX_CLEAR_PAIRING, LOCALE_STRING_CLEAR_PAIRINGS, 5);
     } else {
-        BMBTGTWriteIndex(context, BMBT_MENU_IDX_CLEAR_PAIRING, LocaleGetText(LOCALE_STRING_CLEAR_PAIRINGS), 0);
+        BMBTGTWriteIndexLocale(context, BMBT_MENU_IDX_CLEAR_PAIRING, LOCALE_STRING_CLEAR_PAIRINGS, 0);
     }
     for (idx = 0; idx < context->bt->pairedDevicesCount; idx++) {
         dev = &context->bt->pairedDevices[idx];
@@ -785,7 +835,7 @@ static void BMBTMenuDeviceSelection(BMBTContext_t *context)
             screenIdx++;
         }
     }
-    BMBTGTWriteIndex(context, BMBT_MENU_IDX_BACK, LocaleGetText(LOCALE_STRING_BACK), 0);
+    BMBTGTWriteIndexLocale(context, BMBT_MENU_IDX_BACK, LOCALE_STRING_BACK, 0);
     BMBTGTBufferFlush(context);
     context->menu = BMBT_MENU_DEVICE_SELECTION;
 }
@@ -800,14 +850,14 @@ static void BMBTMenuSettings(BMBTContext_t *context)
         if (idx == (menuSettingsSize - 1)) {
             feedCount = BMBT_MENU_IDX_BACK - menuSettingsSize;
         }
-        BMBTGTWriteIndex(
+        BMBTGTWriteIndexLocale(
             context,
             menuSettings[idx],
-            LocaleGetText(menuSettingsLabelIndices[idx]),
+            menuSettingsLabelIndices[idx],
             feedCount
         );
     }
-    BMBTGTWriteIndex(context, BMBT_MENU_IDX_BACK, LocaleGetText(LOCALE_STRING_BACK), 0);
+    BMBTGTWriteIndexLocale(context, BMBT_MENU_IDX_BACK, LOCALE_STRING_BACK, 0);
     BMBTGTBufferFlush(context);
     BMBTGTBufferFlush(context);
     context->menu = BMBT_MENU_SETTINGS;
@@ -842,7 +892,7 @@ static void BMBTMenuSettingsAbout(BMBTContext_t *context)
         serialNumberString,
         4
     );
-    BMBTGTWriteIndex(context, BMBT_MENU_IDX_BACK, LocaleGetText(LOCALE_STRING_BACK), 0);
+    BMBTGTWriteIndexLocale(context, BMBT_MENU_IDX_BACK, LOCALE_STRING_BACK, 0);
     BMBTGTBufferFlush(context);
     context->menu = BMBT_MENU_SETTINGS_ABOUT;
 }
@@ -851,17 +901,17 @@ static void BMBTMenuSettingsAudio(BMBTContext_t *context)
 {
     BMBTGTWriteTitleIndex(context, LocaleGetText(LOCALE_STRING_SETTINGS_AUDIO));
     if (ConfigGetSetting(CONFIG_SETTING_AUTOPLAY) == CONFIG_SETTING_OFF) {
-        BMBTGTWriteIndex(
+        BMBTGTWriteIndexLocale(
             context,
             BMBT_MENU_IDX_SETTINGS_AUDIO_AUTOPLAY,
-            LocaleGetText(LOCALE_STRING_AUTOPLAY_OFF),
+            LOCALE_STRING_AUTOPLAY_OFF,
             0
         );
     } else {
-        BMBTGTWriteIndex(
+        BMBTGTWriteIndexLocale(
             context,
             BMBT_MENU_IDX_SETTINGS_AUDIO_AUTOPLAY,
-            LocaleGetText(LOCALE_STRING_AUTOPLAY_ON),
+            LOCALE_STRING_AUTOPLAY_ON,
             0
         );
     }
@@ -886,58 +936,58 @@ static void BMBTMenuSettingsAudio(BMBTContext_t *context)
     );
     uint8_t dspInput = ConfigGetSetting(CONFIG_SETTING_DSP_INPUT_SRC);
     if (dspInput == CONFIG_SETTING_DSP_INPUT_SPDIF) {
-        BMBTGTWriteIndex(
+        BMBTGTWriteIndexLocale(
             context,
             BMBT_MENU_IDX_SETTINGS_AUDIO_DSP_INPUT,
-            LocaleGetText(LOCALE_STRING_DSP_DIGITAL),
+            LOCALE_STRING_DSP_DIGITAL,
             0
         );
     } else if (dspInput == CONFIG_SETTING_DSP_INPUT_ANALOG) {
-        BMBTGTWriteIndex(
+        BMBTGTWriteIndexLocale(
             context,
             BMBT_MENU_IDX_SETTINGS_AUDIO_DSP_INPUT,
-            LocaleGetText(LOCALE_STRING_DSP_ANALOG),
+            LOCALE_STRING_DSP_ANALOG,
             0
         );
     } else {
-        BMBTGTWriteIndex(
+        BMBTGTWriteIndexLocale(
             context,
             BMBT_MENU_IDX_SETTINGS_AUDIO_DSP_INPUT,
-            LocaleGetText(LOCALE_STRING_DSP_DEFAULT),
+            LOCALE_STRING_DSP_DEFAULT,
             0
         );
     }
     if (ConfigGetSetting(CONFIG_SETTING_MANAGE_VOLUME) == CONFIG_SETTING_ON) {
-        BMBTGTWriteIndex(
+        BMBTGTWriteIndexLocale(
             context,
             BMBT_MENU_IDX_SETTINGS_AUDIO_MANAGE_VOL,
-            LocaleGetText(LOCALE_STRING_MANAGE_VOL_ON),
+            LOCALE_STRING_MANAGE_VOL_ON,
             0
         );
     } else {
-        BMBTGTWriteIndex(
+        BMBTGTWriteIndexLocale(
             context,
             BMBT_MENU_IDX_SETTINGS_AUDIO_MANAGE_VOL,
-            LocaleGetText(LOCALE_STRING_MANAGE_VOL_OFF),
+            LOCALE_STRING_MANAGE_VOL_OFF,
             0
         );
     }
     if (ConfigGetSetting(CONFIG_SETTING_VOLUME_LOWER_ON_REV) == CONFIG_SETTING_ON) {
-        BMBTGTWriteIndex(
+        BMBTGTWriteIndexLocale(
             context,
             BMBT_MENU_IDX_SETTINGS_AUDIO_REV_VOL,
-            LocaleGetText(LOCALE_STRING_REV_VOL_LOW_ON),
+            LOCALE_STRING_REV_VOL_LOW_ON,
             2
         );
     } else {
-        BMBTGTWriteIndex(
+        BMBTGTWriteIndexLocale(
             context,
             BMBT_MENU_IDX_SETTINGS_AUDIO_REV_VOL,
-            LocaleGetText(LOCALE_STRING_REV_VOL_LOW_OFF),
+            LOCALE_STRING_REV_VOL_LOW_OFF,
             2
         );
     }
-    BMBTGTWriteIndex(context, BMBT_MENU_IDX_BACK, LocaleGetText(LOCALE_STRING_BACK), 0);
+    BMBTGTWriteIndexLocale(context, BMBT_MENU_IDX_BACK, LOCALE_STRING_BACK, 0);
     BMBTGTBufferFlush(context);
     context->menu = BMBT_MENU_SETTINGS_AUDIO;
 }
@@ -947,47 +997,47 @@ static void BMBTMenuSettingsComfort(BMBTContext_t *context)
     BMBTGTWriteTitleIndex(context, LocaleGetText(LOCALE_STRING_SETTINGS_COMFORT));
     uint8_t comfortLock = ConfigGetComfortLock();
     if (comfortLock == CONFIG_SETTING_COMFORT_LOCK_10KM) {
-        BMBTGTWriteIndex(
+        BMBTGTWriteIndexLocale(
             context,
             BMBT_MENU_IDX_SETTINGS_COMFORT_LOCK,
-            LocaleGetText(LOCALE_STRING_LOCK_10KMH),
+            LOCALE_STRING_LOCK_10KMH,
             0
         );
     } else if (comfortLock == CONFIG_SETTING_COMFORT_LOCK_20KM) {
-        BMBTGTWriteIndex(
+        BMBTGTWriteIndexLocale(
             context,
             BMBT_MENU_IDX_SETTINGS_COMFORT_LOCK,
-            LocaleGetText(LOCALE_STRING_LOCK_20KMH),
+            LOCALE_STRING_LOCK_20KMH,
             0
         );
     } else {
-        BMBTGTWriteIndex(
+        BMBTGTWriteIndexLocale(
             context,
             BMBT_MENU_IDX_SETTINGS_COMFORT_LOCK,
-            LocaleGetText(LOCALE_STRING_LOCK_OFF),
+            LOCALE_STRING_LOCK_OFF,
             0
         );
     }
     uint8_t comfortUnlock = ConfigGetComfortUnlock();
     if (comfortUnlock == CONFIG_SETTING_COMFORT_UNLOCK_POS_1) {
-        BMBTGTWriteIndex(
+        BMBTGTWriteIndexLocale(
             context,
             BMBT_MENU_IDX_SETTINGS_COMFORT_UNLOCK,
-            LocaleGetText(LOCALE_STRING_UNLOCK_POS_1),
+            LOCALE_STRING_UNLOCK_POS_1,
             0
         );
     } else if (comfortUnlock == CONFIG_SETTING_COMFORT_UNLOCK_POS_0) {
-        BMBTGTWriteIndex(
+        BMBTGTWriteIndexLocale(
             context,
             BMBT_MENU_IDX_SETTINGS_COMFORT_UNLOCK,
-            LocaleGetText(LOCALE_STRING_UNLOCK_POS_0),
+            LOCALE_STRING_UNLOCK_POS_0,
             0
         );
     } else {
-        BMBTGTWriteIndex(
+        BMBTGTWriteIndexLocale(
             context,
             BMBT_MENU_IDX_SETTINGS_COMFORT_UNLOCK,
-            LocaleGetText(LOCALE_STRING_UNLOCK_OFF),
+            LOCALE_STRING_UNLOCK_OFF,
             0
         );
     }
@@ -1004,17 +1054,17 @@ static void BMBTMenuSettingsComfort(BMBTContext_t *context)
         0
     );
     if (ConfigGetSetting(CONFIG_SETTING_COMFORT_PARKING_LAMPS) == CONFIG_SETTING_ON) {
-        BMBTGTWriteIndex(
+        BMBTGTWriteIndexLocale(
             context,
             BMBT_MENU_IDX_SETTINGS_COMFORT_PARKING_LAMPS,
-            LocaleGetText(LOCALE_STRING_PARK_LAMPS_ON),
+            LOCALE_STRING_PARK_LAMPS_ON,
             0
         );
     } else {
-        BMBTGTWriteIndex(
+        BMBTGTWriteIndexLocale(
             context,
             BMBT_MENU_IDX_SETTINGS_COMFORT_PARKING_LAMPS,
-            LocaleGetText(LOCALE_STRING_PARK_LAMPS_OFF),
+            LOCALE_STRING_PARK_LAMPS_OFF,
             0
         );
     }
@@ -1048,7 +1098,7 @@ static void BMBTMenuSettingsComfort(BMBTContext_t *context)
         }
     }
     BMBTGTWriteIndex(context, BMBT_MENU_IDX_SETTINGS_COMFORT_AUTOZOOM, autoZoomText, 1);
-    BMBTGTWriteIndex(context, BMBT_MENU_IDX_BACK, LocaleGetText(LOCALE_STRING_BACK), 0);
+    BMBTGTWriteIndexLocale(context, BMBT_MENU_IDX_BACK, LOCALE_STRING_BACK, 0);
     BMBTGTBufferFlush(context);
     context->menu = BMBT_MENU_SETTINGS_COMFORT;
 }
@@ -1057,17 +1107,17 @@ static void BMBTMenuSettingsCalling(BMBTContext_t *context)
 {
     BMBTGTWriteTitleIndex(context, LocaleGetText(LOCALE_STRING_SETTINGS_CALLING));
     if (ConfigGetSetting(CONFIG_SETTING_HFP) == CONFIG_SETTING_OFF) {
-        BMBTGTWriteIndex(
+        BMBTGTWriteIndexLocale(
             context,
             BMBT_MENU_IDX_SETTINGS_CALLING_HFP,
-            LocaleGetText(LOCALE_STRING_HANDSFREE_OFF),
+            LOCALE_STRING_HANDSFREE_OFF,
             0
         );
     } else {
-        BMBTGTWriteIndex(
+        BMBTGTWriteIndexLocale(
             context,
             BMBT_MENU_IDX_SETTINGS_CALLING_HFP,
-            LocaleGetText(LOCALE_STRING_HANDSFREE_ON),
+            LOCALE_STRING_HANDSFREE_ON,
             0
         );
     }
@@ -1122,29 +1172,29 @@ static void BMBTMenuSettingsCalling(BMBTContext_t *context)
     if (context->bt->type != BT_BTM_TYPE_BC127) {
         uint8_t telMode = ConfigGetSetting(CONFIG_SETTING_TEL_MODE);
         if (telMode == CONFIG_SETTING_TEL_MODE_TCU) {
-            BMBTGTWriteIndex(
+            BMBTGTWriteIndexLocale(
                 context,
                 BMBT_MENU_IDX_SETTINGS_CALLING_MODE,
-                LocaleGetText(LOCALE_STRING_MODE_TCU),
+                LOCALE_STRING_MODE_TCU,
                 3
             );
         } else if (telMode == CONFIG_SETTING_TEL_MODE_NO_MUTE) {
-            BMBTGTWriteIndex(
+            BMBTGTWriteIndexLocale(
                 context,
                 BMBT_MENU_IDX_SETTINGS_CALLING_MODE,
-                LocaleGetText(LOCALE_STRING_MODE_NO_MUTE),
+                LOCALE_STRING_MODE_NO_MUTE,
                 3
             );
         } else {
-            BMBTGTWriteIndex(
+            BMBTGTWriteIndexLocale(
                 context,
                 BMBT_MENU_IDX_SETTINGS_CALLING_MODE,
-                LocaleGetText(LOCALE_STRING_MODE_DEFAULT),
+                LOCALE_STRING_MODE_DEFAULT,
                 3
             );
         }
     }
-    BMBTGTWriteIndex(context, BMBT_MENU_IDX_BACK, LocaleGetText(LOCALE_STRING_BACK), 0);
+    BMBTGTWriteIndexLocale(context, BMBT_MENU_IDX_BACK, LOCALE_STRING_BACK, 0);
     BMBTGTBufferFlush(context);
     context->menu = BMBT_MENU_SETTINGS_CALLING;
 }
@@ -1153,101 +1203,101 @@ static void BMBTMenuSettingsUI(BMBTContext_t *context)
 {
     BMBTGTWriteTitleIndex(context, LocaleGetText(LOCALE_STRING_SETTINGS_UI));
     if (ConfigGetSetting(CONFIG_SETTING_BMBT_DEFAULT_MENU) == CONFIG_SETTING_OFF) {
-        BMBTGTWriteIndex(
+        BMBTGTWriteIndexLocale(
             context,
             BMBT_MENU_IDX_SETTINGS_UI_DEFAULT_MENU,
-            LocaleGetText(LOCALE_STRING_MENU_MAIN),
+            LOCALE_STRING_MENU_MAIN,
             0
         );
     } else {
-        BMBTGTWriteIndex(
+        BMBTGTWriteIndexLocale(
             context,
             BMBT_MENU_IDX_SETTINGS_UI_DEFAULT_MENU,
-            LocaleGetText(LOCALE_STRING_MENU_DASHBOARD),
+            LOCALE_STRING_MENU_DASHBOARD,
             0
         );
     }
     uint8_t metadataMode = ConfigGetSetting(CONFIG_SETTING_METADATA_MODE);
     if (metadataMode == BMBT_METADATA_MODE_PARTY) {
-        BMBTGTWriteIndex(
+        BMBTGTWriteIndexLocale(
             context,
             BMBT_MENU_IDX_SETTINGS_UI_METADATA_MODE,
-            LocaleGetText(LOCALE_STRING_METADATA_PARTY),
+            LOCALE_STRING_METADATA_PARTY,
             0
         );
     } else if (metadataMode == BMBT_METADATA_MODE_CHUNK) {
-        BMBTGTWriteIndex(
+        BMBTGTWriteIndexLocale(
             context,
             BMBT_MENU_IDX_SETTINGS_UI_METADATA_MODE,
-            LocaleGetText(LOCALE_STRING_METADATA_CHUNK),
+            LOCALE_STRING_METADATA_CHUNK,
             0
         );
     } else {
-        BMBTGTWriteIndex(
+        BMBTGTWriteIndexLocale(
             context,
             BMBT_MENU_IDX_SETTINGS_UI_METADATA_MODE,
-            LocaleGetText(LOCALE_STRING_METADATA_OFF),
+            LOCALE_STRING_METADATA_OFF,
             0
         );
     }
     uint8_t tempMode = ConfigGetTempDisplay();
     if (tempMode == CONFIG_SETTING_OFF) {
-        BMBTGTWriteIndex(
+        BMBTGTWriteIndexLocale(
             context,
             BMBT_MENU_IDX_SETTINGS_UI_TEMPS,
-            LocaleGetText(LOCALE_STRING_TEMPS_OFF),
+            LOCALE_STRING_TEMPS_OFF,
             0
         );
     } else if (tempMode == CONFIG_SETTING_TEMP_COOLANT) {
-        BMBTGTWriteIndex(
+        BMBTGTWriteIndexLocale(
             context,
             BMBT_MENU_IDX_SETTINGS_UI_TEMPS,
-            LocaleGetText(LOCALE_STRING_TEMPS_COOLANT),
+            LOCALE_STRING_TEMPS_COOLANT,
             0
         );
     } else if (tempMode == CONFIG_SETTING_TEMP_AMBIENT) {
-        BMBTGTWriteIndex(
+        BMBTGTWriteIndexLocale(
             context,
             BMBT_MENU_IDX_SETTINGS_UI_TEMPS,
-            LocaleGetText(LOCALE_STRING_TEMPS_AMBIENT),
+            LOCALE_STRING_TEMPS_AMBIENT,
             0
         );
     } else if (tempMode == CONFIG_SETTING_TEMP_OIL) {
-        BMBTGTWriteIndex(
+        BMBTGTWriteIndexLocale(
             context,
             BMBT_MENU_IDX_SETTINGS_UI_TEMPS,
-            LocaleGetText(LOCALE_STRING_TEMPS_OIL),
+            LOCALE_STRING_TEMPS_OIL,
             0
         );
     }
     uint8_t dashboardOBC = ConfigGetSetting(CONFIG_SETTING_BMBT_DASHBOARD_OBC);
     if (dashboardOBC == CONFIG_SETTING_ON) {
-        BMBTGTWriteIndex(
+        BMBTGTWriteIndexLocale(
             context,
             BMBT_MENU_IDX_SETTINGS_IU_DASH_OBC,
-            LocaleGetText(LOCALE_STRING_DASH_OBC_ON),
+            LOCALE_STRING_DASH_OBC_ON,
             0
         );
     } else if (dashboardOBC == CONFIG_SETTING_OFF) {
-        BMBTGTWriteIndex(
+        BMBTGTWriteIndexLocale(
             context,
             BMBT_MENU_IDX_SETTINGS_IU_DASH_OBC,
-            LocaleGetText(LOCALE_STRING_DASH_OBC_OFF),
+            LOCALE_STRING_DASH_OBC_OFF,
             0
         );
     }
     if (ConfigGetSetting(CONFIG_SETTING_MONITOR_OFF) == CONFIG_SETTING_ON) {
-        BMBTGTWriteIndex(
+        BMBTGTWriteIndexLocale(
             context,
             BMBT_MENU_IDX_SETTINGS_UI_MONITOR_OFF,
-            LocaleGetText(LOCALE_STRING_BMBT_OFF_ON),
+            LOCALE_STRING_BMBT_OFF_ON,
             0
         );
     } else {
-        BMBTGTWriteIndex(
+        BMBTGTWriteIndexLocale(
             context,
             BMBT_MENU_IDX_SETTINGS_UI_MONITOR_OFF,
-            LocaleGetText(LOCALE_STRING_BMBT_OFF_OFF),
+            LOCALE_STRING_BMBT_OFF_OFF,
             0
         );
     }
@@ -1299,7 +1349,7 @@ static void BMBTMenuSettingsUI(BMBTContext_t *context)
         langStr,
         1
     );
-    BMBTGTWriteIndex(context, BMBT_MENU_IDX_BACK, LocaleGetText(LOCALE_STRING_BACK), 0);
+    BMBTGTWriteIndexLocale(context, BMBT_MENU_IDX_BACK, LOCALE_STRING_BACK, 0);
     BMBTGTBufferFlush(context);
     context->menu = BMBT_MENU_SETTINGS_UI;
 }
@@ -1339,38 +1389,38 @@ static void BMBTSettingsUpdateAudio(BMBTContext_t *context, uint8_t selectedIdx)
         if (dspInput == CONFIG_SETTING_OFF) {
             ConfigSetSetting(CONFIG_SETTING_DSP_INPUT_SRC, CONFIG_SETTING_DSP_INPUT_SPDIF);
             IBusCommandDSPSetMode(context->ibus, IBUS_DSP_CONFIG_SET_INPUT_SPDIF);
-            BMBTGTWriteIndex(context, selectedIdx, LocaleGetText(LOCALE_STRING_DSP_DIGITAL), 0);
+            BMBTGTWriteIndexLocale(context, selectedIdx, LOCALE_STRING_DSP_DIGITAL, 0);
         } else if (dspInput == CONFIG_SETTING_DSP_INPUT_SPDIF) {
             ConfigSetSetting(CONFIG_SETTING_DSP_INPUT_SRC, CONFIG_SETTING_DSP_INPUT_ANALOG);
             IBusCommandDSPSetMode(context->ibus, IBUS_DSP_CONFIG_SET_INPUT_RADIO);
-            BMBTGTWriteIndex(context, selectedIdx, LocaleGetText(LOCALE_STRING_DSP_ANALOG), 0);
+            BMBTGTWriteIndexLocale(context, selectedIdx, LOCALE_STRING_DSP_ANALOG, 0);
         } else {
             ConfigSetSetting(CONFIG_SETTING_DSP_INPUT_SRC, CONFIG_SETTING_OFF);
-            BMBTGTWriteIndex(context, selectedIdx, LocaleGetText(LOCALE_STRING_DSP_DEFAULT), 0);
+            BMBTGTWriteIndexLocale(context, selectedIdx, LOCALE_STRING_DSP_DEFAULT, 0);
         }
     } else if (selectedIdx == BMBT_MENU_IDX_SETTINGS_AUDIO_AUTOPLAY) {
         if (ConfigGetSetting(CONFIG_SETTING_AUTOPLAY) == CONFIG_SETTING_OFF) {
             ConfigSetSetting(CONFIG_SETTING_AUTOPLAY, CONFIG_SETTING_ON);
-            BMBTGTWriteIndex(context, selectedIdx, LocaleGetText(LOCALE_STRING_AUTOPLAY_ON), 0);
+            BMBTGTWriteIndexLocale(context, selectedIdx, LOCALE_STRING_AUTOPLAY_ON, 0);
         } else {
             ConfigSetSetting(CONFIG_SETTING_AUTOPLAY, CONFIG_SETTING_OFF);
-            BMBTGTWriteIndex(context, selectedIdx, LocaleGetText(LOCALE_STRING_AUTOPLAY_OFF), 0);
+            BMBTGTWriteIndexLocale(context, selectedIdx, LOCALE_STRING_AUTOPLAY_OFF, 0);
         }
     } else if (selectedIdx == BMBT_MENU_IDX_SETTINGS_AUDIO_MANAGE_VOL) {
         if (ConfigGetSetting(CONFIG_SETTING_MANAGE_VOLUME) == CONFIG_SETTING_OFF) {
             ConfigSetSetting(CONFIG_SETTING_MANAGE_VOLUME, CONFIG_SETTING_ON);
-            BMBTGTWriteIndex(context, selectedIdx, LocaleGetText(LOCALE_STRING_MANAGE_VOL_ON), 0);
+            BMBTGTWriteIndexLocale(context, selectedIdx, LOCALE_STRING_MANAGE_VOL_ON, 0);
         } else {
             ConfigSetSetting(CONFIG_SETTING_MANAGE_VOLUME, CONFIG_SETTING_OFF);
-            BMBTGTWriteIndex(context, selectedIdx, LocaleGetText(LOCALE_STRING_MANAGE_VOL_OFF), 0);
+            BMBTGTWriteIndexLocale(context, selectedIdx, LOCALE_STRING_MANAGE_VOL_OFF, 0);
         }
     } else if (selectedIdx == BMBT_MENU_IDX_SETTINGS_AUDIO_REV_VOL) {
         if (ConfigGetSetting(CONFIG_SETTING_VOLUME_LOWER_ON_REV) == CONFIG_SETTING_OFF) {
             ConfigSetSetting(CONFIG_SETTING_VOLUME_LOWER_ON_REV, CONFIG_SETTING_ON);
-            BMBTGTWriteIndex(context, selectedIdx, LocaleGetText(LOCALE_STRING_REV_VOL_LOW_ON), 0);
+            BMBTGTWriteIndexLocale(context, selectedIdx, LOCALE_STRING_REV_VOL_LOW_ON, 0);
         } else {
             ConfigSetSetting(CONFIG_SETTING_VOLUME_LOWER_ON_REV, CONFIG_SETTING_OFF);
-            BMBTGTWriteIndex(context, selectedIdx, LocaleGetText(LOCALE_STRING_REV_VOL_LOW_OFF), 0);
+            BMBTGTWriteIndexLocale(context, selectedIdx, LOCALE_STRING_REV_VOL_LOW_OFF, 0);
         }
     } else if (selectedIdx == BMBT_MENU_IDX_BACK) {
         BMBTMenuSettings(context);
@@ -1398,10 +1448,10 @@ static void BMBTSettingsUpdateComfort(BMBTContext_t *context, uint8_t selectedId
         uint8_t value = ConfigGetSetting(CONFIG_SETTING_COMFORT_PARKING_LAMPS);
         if (value == CONFIG_SETTING_OFF) {
             value = CONFIG_SETTING_ON;
-            BMBTGTWriteIndex(context, selectedIdx, LocaleGetText(LOCALE_STRING_PARK_LAMPS_ON), 0);
+            BMBTGTWriteIndexLocale(context, selectedIdx, LOCALE_STRING_PARK_LAMPS_ON, 0);
         } else {
             value = CONFIG_SETTING_OFF;
-            BMBTGTWriteIndex(context, selectedIdx, LocaleGetText(LOCALE_STRING_PARK_LAMPS_OFF), 0);
+            BMBTGTWriteIndexLocale(context, selectedIdx, LOCALE_STRING_PARK_LAMPS_OFF, 0);
         }
         // Request cluster indicators so we can trigger the new light setting
         // when the response (0x5B) is received
@@ -1413,13 +1463,13 @@ static void BMBTSettingsUpdateComfort(BMBTContext_t *context, uint8_t selectedId
             comfortLock > CONFIG_SETTING_COMFORT_LOCK_20KM
         ) {
             ConfigSetComfortLock(CONFIG_SETTING_COMFORT_LOCK_10KM);
-            BMBTGTWriteIndex(context, selectedIdx, LocaleGetText(LOCALE_STRING_LOCK_10KMH), 0);
+            BMBTGTWriteIndexLocale(context, selectedIdx, LOCALE_STRING_LOCK_10KMH, 0);
         } else if (comfortLock == CONFIG_SETTING_COMFORT_LOCK_10KM) {
             ConfigSetComfortLock(CONFIG_SETTING_COMFORT_LOCK_20KM);
-            BMBTGTWriteIndex(context, selectedIdx, LocaleGetText(LOCALE_STRING_LOCK_20KMH), 0);
+            BMBTGTWriteIndexLocale(context, selectedIdx, LOCALE_STRING_LOCK_20KMH, 0);
         } else {
             ConfigSetComfortLock(CONFIG_SETTING_OFF);
-            BMBTGTWriteIndex(context, selectedIdx, LocaleGetText(LOCALE_STRING_LOCK_OFF), 0);
+            BMBTGTWriteIndexLocale(context, selectedIdx, LOCALE_STRING_LOCK_OFF, 0);
         }
     } else if (selectedIdx == BMBT_MENU_IDX_SETTINGS_COMFORT_UNLOCK) {
         uint8_t comfortUnlock = ConfigGetComfortUnlock();
@@ -1427,13 +1477,13 @@ static void BMBTSettingsUpdateComfort(BMBTContext_t *context, uint8_t selectedId
             comfortUnlock > CONFIG_SETTING_COMFORT_UNLOCK_POS_0
         ) {
             ConfigSetComfortUnlock(CONFIG_SETTING_COMFORT_UNLOCK_POS_1);
-            BMBTGTWriteIndex(context, selectedIdx, LocaleGetText(LOCALE_STRING_UNLOCK_POS_1), 0);
+            BMBTGTWriteIndexLocale(context, selectedIdx, LOCALE_STRING_UNLOCK_POS_1, 0);
         } else if (comfortUnlock == CONFIG_SETTING_COMFORT_UNLOCK_POS_1) {
             ConfigSetComfortUnlock(CONFIG_SETTING_COMFORT_UNLOCK_POS_0);
-            BMBTGTWriteIndex(context, selectedIdx, LocaleGetText(LOCALE_STRING_UNLOCK_POS_0), 0);
+            BMBTGTWriteIndexLocale(context, selectedIdx, LOCALE_STRING_UNLOCK_POS_0, 0);
         } else {
             ConfigSetComfortUnlock(CONFIG_SETTING_OFF);
-            BMBTGTWriteIndex(context, selectedIdx, LocaleGetText(LOCALE_STRING_UNLOCK_OFF), 0);
+            BMBTGTWriteIndexLocale(context, selectedIdx, LOCALE_STRING_UNLOCK_OFF, 0);
         }
     } else if (selectedIdx == BMBT_MENU_IDX_SETTINGS_COMFORT_AUTOZOOM) {
         uint8_t autozoom = ConfigGetSetting(CONFIG_SETTING_COMFORT_AUTOZOOM);
@@ -1483,18 +1533,18 @@ static void BMBTSettingsUpdateCalling(BMBTContext_t *context, uint8_t selectedId
         if (context->bt->type == BT_BTM_TYPE_BC127) {
             if (value == 0x00) {
                 ConfigSetSetting(CONFIG_SETTING_HFP, CONFIG_SETTING_ON);
-                BMBTGTWriteIndex(context, selectedIdx, LocaleGetText(LOCALE_STRING_HANDSFREE_ON), 0);
+                BMBTGTWriteIndexLocale(context, selectedIdx, LOCALE_STRING_HANDSFREE_ON, 0);
                 BC127CommandProfileOpen(context->bt, "HFP");
             } else {
                 ConfigSetSetting(CONFIG_SETTING_HFP, CONFIG_SETTING_OFF);
                 BC127CommandClose(context->bt, context->bt->activeDevice.hfpId);
-                BMBTGTWriteIndex(context, selectedIdx, LocaleGetText(LOCALE_STRING_HANDSFREE_OFF), 0);
+                BMBTGTWriteIndexLocale(context, selectedIdx, LOCALE_STRING_HANDSFREE_OFF, 0);
             }
         } else {
             if (value == 0x01) {
                 BM83CommandDisconnect(context->bt, BM83_CMD_DISCONNECT_PARAM_HF);
                 ConfigSetSetting(CONFIG_SETTING_HFP, 0x00);
-                BMBTGTWriteIndex(context, selectedIdx, LocaleGetText(LOCALE_STRING_HANDSFREE_OFF), 0);
+                BMBTGTWriteIndexLocale(context, selectedIdx, LOCALE_STRING_HANDSFREE_OFF, 0);
             } else {
                 BTPairedDevice_t *device = 0;
                 uint8_t i = 0;
@@ -1512,7 +1562,7 @@ static void BMBTSettingsUpdateCalling(BMBTContext_t *context, uint8_t selectedId
                     );
                 }
                 ConfigSetSetting(CONFIG_SETTING_HFP, 0x01);
-                BMBTGTWriteIndex(context, selectedIdx, LocaleGetText(LOCALE_STRING_HANDSFREE_ON), 0);
+                BMBTGTWriteIndexLocale(context, selectedIdx, LOCALE_STRING_HANDSFREE_ON, 0);
             }
         }
     } else if (selectedIdx == BMBT_MENU_IDX_SETTINGS_CALLING_MIC_GAIN) {
@@ -1580,26 +1630,26 @@ static void BMBTSettingsUpdateCalling(BMBTContext_t *context, uint8_t selectedId
         uint8_t telMode = ConfigGetSetting(CONFIG_SETTING_TEL_MODE);
         if (telMode == CONFIG_SETTING_TEL_MODE_DEFAULT) {
             ConfigSetSetting(CONFIG_SETTING_TEL_MODE, CONFIG_SETTING_TEL_MODE_TCU);
-            BMBTGTWriteIndex(
+            BMBTGTWriteIndexLocale(
                 context,
                 BMBT_MENU_IDX_SETTINGS_CALLING_MODE,
-                LocaleGetText(LOCALE_STRING_MODE_TCU),
+                LOCALE_STRING_MODE_TCU,
                 0
             );
         } else if (telMode == CONFIG_SETTING_TEL_MODE_TCU) {
             ConfigSetSetting(CONFIG_SETTING_TEL_MODE, CONFIG_SETTING_TEL_MODE_NO_MUTE);
-            BMBTGTWriteIndex(
+            BMBTGTWriteIndexLocale(
                 context,
                 BMBT_MENU_IDX_SETTINGS_CALLING_MODE,
-                LocaleGetText(LOCALE_STRING_MODE_NO_MUTE),
+                LOCALE_STRING_MODE_NO_MUTE,
                 0
             );
         } else {
             ConfigSetSetting(CONFIG_SETTING_TEL_MODE, CONFIG_SETTING_TEL_MODE_DEFAULT);
-            BMBTGTWriteIndex(
+            BMBTGTWriteIndexLocale(
                 context,
                 BMBT_MENU_IDX_SETTINGS_CALLING_MODE,
-                LocaleGetText(LOCALE_STRING_MODE_DEFAULT),
+                LOCALE_STRING_MODE_DEFAULT,
                 0
             );
         }
@@ -1617,13 +1667,13 @@ static void BMBTSettingsUpdateUI(BMBTContext_t *context, uint8_t selectedIdx)
         uint8_t value = ConfigGetSetting(CONFIG_SETTING_METADATA_MODE);
         if (value == 0x00) {
             value = BMBT_METADATA_MODE_PARTY;
-            BMBTGTWriteIndex(context, selectedIdx, LocaleGetText(LOCALE_STRING_METADATA_PARTY), 0);
+            BMBTGTWriteIndexLocale(context, selectedIdx, LOCALE_STRING_METADATA_PARTY, 0);
         } else if (value == 0x01) {
             value = BMBT_METADATA_MODE_CHUNK;
-            BMBTGTWriteIndex(context, selectedIdx, LocaleGetText(LOCALE_STRING_METADATA_CHUNK), 0);
+            BMBTGTWriteIndexLocale(context, selectedIdx, LOCALE_STRING_METADATA_CHUNK, 0);
         } else {
             value = BMBT_METADATA_MODE_OFF;
-            BMBTGTWriteIndex(context, selectedIdx, LocaleGetText(LOCALE_STRING_METADATA_OFF), 0);
+            BMBTGTWriteIndexLocale(context, selectedIdx, LOCALE_STRING_METADATA_OFF, 0);
         }
         ConfigSetSetting(CONFIG_SETTING_METADATA_MODE, value);
         if (value != BMBT_METADATA_MODE_OFF &&
@@ -1647,10 +1697,10 @@ static void BMBTSettingsUpdateUI(BMBTContext_t *context, uint8_t selectedIdx)
     } else if (selectedIdx == BMBT_MENU_IDX_SETTINGS_UI_DEFAULT_MENU) {
         if (ConfigGetSetting(CONFIG_SETTING_BMBT_DEFAULT_MENU) == 0x00) {
             ConfigSetSetting(CONFIG_SETTING_BMBT_DEFAULT_MENU, 0x01);
-            BMBTGTWriteIndex(context, selectedIdx, LocaleGetText(LOCALE_STRING_MENU_DASHBOARD), 0);
+            BMBTGTWriteIndexLocale(context, selectedIdx, LOCALE_STRING_MENU_DASHBOARD, 0);
         } else {
             ConfigSetSetting(CONFIG_SETTING_BMBT_DEFAULT_MENU, 0x00);
-            BMBTGTWriteIndex(context, selectedIdx, LocaleGetText(LOCALE_STRING_MENU_MAIN), 0);
+            BMBTGTWriteIndexLocale(context, selectedIdx, LOCALE_STRING_MENU_MAIN, 0);
         }
     } else if (selectedIdx == BMBT_MENU_IDX_SETTINGS_UI_TEMPS) {
         uint8_t tempMode = ConfigGetTempDisplay();
@@ -1658,12 +1708,12 @@ static void BMBTSettingsUpdateUI(BMBTContext_t *context, uint8_t selectedIdx)
             ConfigSetTempDisplay(CONFIG_SETTING_TEMP_COOLANT);
             uint8_t valueType = IBUS_SENSOR_VALUE_COOLANT_TEMP;
             BMBTIBusSensorValueUpdate((void *)context, &valueType);
-            BMBTGTWriteIndex(context, selectedIdx, LocaleGetText(LOCALE_STRING_TEMPS_COOLANT), 0);
+            BMBTGTWriteIndexLocale(context, selectedIdx, LOCALE_STRING_TEMPS_COOLANT, 0);
         } else if (tempMode == CONFIG_SETTING_TEMP_COOLANT) {
             ConfigSetTempDisplay(CONFIG_SETTING_TEMP_AMBIENT);
             uint8_t valueType = IBUS_SENSOR_VALUE_AMBIENT_TEMP;
             BMBTIBusSensorValueUpdate((void *)context, &valueType);
-            BMBTGTWriteIndex(context, selectedIdx, LocaleGetText(LOCALE_STRING_TEMPS_AMBIENT), 0);
+            BMBTGTWriteIndexLocale(context, selectedIdx, LOCALE_STRING_TEMPS_AMBIENT, 0);
         } else if (
             tempMode == CONFIG_SETTING_TEMP_AMBIENT &&
             context->ibus->vehicleType != IBUS_VEHICLE_TYPE_E46 &&
@@ -1672,20 +1722,20 @@ static void BMBTSettingsUpdateUI(BMBTContext_t *context, uint8_t selectedIdx)
             ConfigSetTempDisplay(CONFIG_SETTING_TEMP_OIL);
             uint8_t valueType = IBUS_SENSOR_VALUE_OIL_TEMP;
             BMBTIBusSensorValueUpdate((void *)context, &valueType);
-            BMBTGTWriteIndex(context, selectedIdx, LocaleGetText(LOCALE_STRING_TEMPS_OIL), 0);
+            BMBTGTWriteIndexLocale(context, selectedIdx, LOCALE_STRING_TEMPS_OIL, 0);
         } else {
             // Clear the header area
             IBusCommandGTWriteZone(context->ibus, BMBT_HEADER_TEMPS, "      ");
             IBusCommandGTUpdate(context->ibus, IBUS_CMD_GT_WRITE_ZONE);
             ConfigSetTempDisplay(CONFIG_SETTING_OFF);
-            BMBTGTWriteIndex(context, selectedIdx, LocaleGetText(LOCALE_STRING_TEMPS_OFF), 0);
+            BMBTGTWriteIndexLocale(context, selectedIdx, LOCALE_STRING_TEMPS_OFF, 0);
         }
     } else if (selectedIdx == BMBT_MENU_IDX_SETTINGS_IU_DASH_OBC) {
         if (ConfigGetSetting(CONFIG_SETTING_BMBT_DASHBOARD_OBC) == CONFIG_SETTING_ON) {
-            BMBTGTWriteIndex(
+            BMBTGTWriteIndexLocale(
                 context,
                 BMBT_MENU_IDX_SETTINGS_IU_DASH_OBC,
-                LocaleGetText(LOCALE_STRING_DASH_OBC_OFF),
+                LOCALE_STRING_DASH_OBC_OFF,
                 0
             );
             ConfigSetSetting(
@@ -1693,10 +1743,10 @@ static void BMBTSettingsUpdateUI(BMBTContext_t *context, uint8_t selectedIdx)
                 CONFIG_SETTING_OFF
             );
         } else {
-            BMBTGTWriteIndex(
+            BMBTGTWriteIndexLocale(
                 context,
                 BMBT_MENU_IDX_SETTINGS_IU_DASH_OBC,
-                LocaleGetText(LOCALE_STRING_DASH_OBC_ON),
+                LOCALE_STRING_DASH_OBC_ON,
                 0
             );
             ConfigSetSetting(
@@ -1706,18 +1756,18 @@ static void BMBTSettingsUpdateUI(BMBTContext_t *context, uint8_t selectedIdx)
         }
     } else if (selectedIdx == BMBT_MENU_IDX_SETTINGS_UI_MONITOR_OFF) {
         if (ConfigGetSetting(CONFIG_SETTING_MONITOR_OFF) == CONFIG_SETTING_ON) {
-            BMBTGTWriteIndex(
+            BMBTGTWriteIndexLocale(
                 context,
                 BMBT_MENU_IDX_SETTINGS_UI_MONITOR_OFF,
-                LocaleGetText(LOCALE_STRING_BMBT_OFF_OFF),
+                LOCALE_STRING_BMBT_OFF_OFF,
                 0
             );
             ConfigSetSetting(CONFIG_SETTING_MONITOR_OFF, CONFIG_SETTING_OFF);
         } else {
-            BMBTGTWriteIndex(
+            BMBTGTWriteIndexLocale(
                 context,
                 BMBT_MENU_IDX_SETTINGS_UI_MONITOR_OFF,
-                LocaleGetText(LOCALE_STRING_BMBT_OFF_ON),
+                LOCALE_STRING_BMBT_OFF_ON,
                 0
             );
             ConfigSetSetting(CONFIG_SETTING_MONITOR_OFF, CONFIG_SETTING_ON);
@@ -2193,10 +2243,10 @@ void BMBTIBusMenuSelect(void *ctx, uint8_t *pkt)
             if (selectedIdx == BMBT_MENU_IDX_PAIRING_MODE) {
                 uint8_t state;
                 if (context->bt->discoverable == BT_STATE_ON) {
-                    BMBTGTWriteIndex(context, BMBT_MENU_IDX_PAIRING_MODE, LocaleGetText(LOCALE_STRING_PAIRING_OFF), 0);
+                    BMBTGTWriteIndexLocale(context, BMBT_MENU_IDX_PAIRING_MODE, LOCALE_STRING_PAIRING_OFF, 0);
                     state = BT_STATE_OFF;
                 } else {
-                    BMBTGTWriteIndex(context, BMBT_MENU_IDX_PAIRING_MODE, LocaleGetText(LOCALE_STRING_PAIRING_ON), 0);
+                    BMBTGTWriteIndexLocale(context, BMBT_MENU_IDX_PAIRING_MODE, LOCALE_STRING_PAIRING_ON, 0);
                     state = BT_STATE_ON;
                     if (context->bt->activeDevice.deviceId != 0) {
                         // To pair a new device, we must disconnect the active one
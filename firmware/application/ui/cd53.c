@@ -157,8 +157,15 @@ static void CD53SetMainDisplayText(
     const char *str,
     int8_t timeout
 ) {
-    UtilsStrncpy(context->mainDisplay.text, str, UTILS_DISPLAY_TEXT_SIZE);
-    context->mainDisplay.length = strlen(context->mainDisplay.text);
+    // Measure once and copy the bounded length, instead of copying the
+    // padded buffer and measuring the result again
+    size_t length = strlen(str);
+    if (length > UTILS_DISPLAY_TEXT_SIZE - 1) {
+        length = UTILS_DISPLAY_TEXT_SIZE - 1;
+    }
+    memcpy(context->mainDisplay.text, str, length);
+    context->mainDisplay.text[length] = '\0';
+    context->mainDisplay.length = length;
     context->mainDisplay.index = 0;
     TimerTriggerScheduledTask(context->displayUpdateTaskId);
     context->mainDisplay.timeout = timeout;
@@ -25,6 +25,8 @@ void CLIInit(UART_t *uart, BT_t *bt, IBus_t *ibus)
     cli.bt = bt;
     cli.ibus = ibus;
     cli.terminalReady = 0;
+    // Nobody reads the output until a terminal asserts DTR
+    UARTSetTXFullMode(cli.uart, UART_TX_FULL_DROP);
     cli.terminalReadyTaskId = TimerRegisterScheduledTask(
         &CLITimerTerminalReady,
         &cli,
@@ -39,6 +41,58 @@ void CLIInit(UART_t *uart, BT_t *bt, IBus_t *ibus)
     );
 }
 
+/**
+ * CLICommandBenchmark()
+ *     Description:
+ *         Parse the "BENCH" CLI Commands. Run every benchmark, or the one
+ *         named, and print its instruction cycles and input bytes per
+ *         operation, in the form that host/bench_compare.py compares. The
+ *         main loop does not run until they finish.
+ *     Params:
+ *         char **msgBuf - The message buffer
+ *         uint8_t *cmdSuccess - A pointer to the command success flag
+ *         uint8_t delimCount - The number of parameters in the command
+ *     Returns:
+ *         void
+ */
+void CLICommandBenchmark(char **msgBuf, uint8_t *cmdSuccess, uint8_t delimCount)
+{
+    uint8_t ran = 0;
+    uint8_t idx;
+    if (delimCount > 2) {
+        *cmdSuccess = 0;
+        return;
+    }
+    for (idx = 0; idx < BenchmarkGetCount(); idx++) {
+        const char *name = BenchmarkGetName(idx);
+        BenchmarkResult_t result;
+        if (delimCount == 2 && UtilsStricmp(msgBuf[1], name) != 0) {
+            continue;
+        }
+        if (ran == 0) {
+            LogRaw(
+                "Benchmarks, fastest of %u runs, in instruction cycles per operation:\r\n",
+                BENCHMARK_REPEATS
+            );
+        }
+        BenchmarkRun(idx, &result);
+        uint32_t cycles = (uint64_t) result.cycles * 100 / result.iterations;
+        uint32_t bytes = result.bytes * 100 / result.iterations;
+        LogRaw(
+            "    %s %lu.%02u %lu.%02u\r\n",
+            name,
+            cycles / 100,
+            (uint16_t) (cycles % 100),
+            bytes / 100,
+            (uint16_t) (bytes % 100)
+        );
+        ran++;
+    }
+    if (ran == 0) {
+        *cmdSuccess = 0;
+    }
+}
+
 /**
  * CLICommandBTBC127()
  *     Description:
@@ -214,7 +268,7 @@ void CLICommandBTBC127(char **msgBuf, uint8_t *cmdSuccess, uint8_t delimCount)
             BC127CommandSetModuleName(cli.bt, nameBuf);
         }
     } else if (UtilsStricmp(msgBuf[1], "PBAP") == 0) {
-        BC127SendCommand(cli.bt, "PB_PULL 16 3 1 5 0 87");
+        BC127CommandPhonebookPull(cli.bt);
     } else if (UtilsStricmp(msgBuf[1], "VERSION") == 0) {
         BC127CommandVersion(cli.bt);
     } else {
@@ -257,6 +311,35 @@ void CLICommandBTBM83(char **msgBuf, uint8_t *cmdSuccess, uint8_t delimCount)
             uint8_t cmd[] = {0x2D, 0x04};
             BM83SendCommand(cli.bt, cmd, sizeof(cmd));
         }
+    } else if (UtilsStricmp(msgBuf[1], "CMDS") == 0) {
+        uint8_t idx = 0;
+        BM83CommandStats_t *stats = BM83GetCommandStats(idx);
+        LogRaw("BM83 TX Commands:\r\n");
+        while (stats != 0) {
+            uint16_t latencyAvg = 0;
+            if (stats->acked > 0) {
+                latencyAvg = stats->latencyTotal / stats->acked;
+            }
+            LogRaw(
+                "    %02X: Sent %u ACK %u Retries %u Failed %u Latency %ums avg %ums max\r\n",
+                stats->opcode,
+                stats->sent,
+                stats->acked,
+                stats->retries,
+                stats->failed,
+                latencyAvg,
+                stats->latencyMax
+            );
+            stats = BM83GetCommandStats(++idx);
+        }
+    } else if (UtilsStricmp(msgBuf[1], "FRAMES") == 0) {
+        BM83FrameStats_t *stats = BM83GetFrameStats();
+        LogRaw("BM83 RX Frames:\r\n");
+        LogRaw("    Received: %u\r\n", stats->received);
+        LogRaw("    Bad Checksum: %u\r\n", stats->droppedChecksum);
+        LogRaw("    Bad Length: %u\r\n", stats->droppedLength);
+        LogRaw("    Timed Out: %u\r\n", stats->droppedTimeout);
+        LogRaw("    Trash Bytes: %u\r\n", stats->trashBytes);
     } else if (UtilsStricmp(msgBuf[1], "LIST") == 0) {
         BM83CommandReadPairedDevices(cli.bt);
     } else if (UtilsStricmp(msgBuf[1], "INFO") == 0) {
@@ -277,6 +360,36 @@ void CLICommandBTBM83(char **msgBuf, uint8_t *cmdSuccess, uint8_t delimCount)
         BM83CommandPairingEnable(cli.bt);
     } else if (UtilsStricmp(msgBuf[1], "MACID") == 0) {
         BM83CommandReadLocalBDAddress(cli.bt);
+    } else if (UtilsStricmp(msgBuf[1], "PBAP") == 0) {
+        BM83CommandPBAPPullPhonebook(cli.bt);
+    } else if (UtilsStricmp(msgBuf[1], "BROWSE") == 0) {
+        if (delimCount == 2) {
+            BTBrowseOpen(cli.bt, BT_BROWSE_SCOPE_FILESYSTEM);
+        } else if (UtilsStricmp(msgBuf[2], "NP") == 0) {
+            BTBrowseOpen(cli.bt, BT_BROWSE_SCOPE_NOW_PLAYING);
+        } else if (UtilsStricmp(msgBuf[2], "UP") == 0) {
+            BTBrowseUp(cli.bt);
+        } else if (UtilsStricmp(msgBuf[2], "OPEN") == 0 && delimCount == 4) {
+            BTBrowseEnterItem(cli.bt, (uint16_t) strtoul(msgBuf[3], 0, 10));
+        } else {
+            uint16_t position = (uint16_t) strtoul(msgBuf[2], 0, 10);
+            uint8_t i;
+            BTBrowseSetPosition(cli.bt, position);
+            for (i = 0; i < BT_BROWSE_PAGE_SIZE; i++) {
+                BTBrowseItem_t *item = BTBrowseGetItem(cli.bt, position + i);
+                if (item != 0) {
+                    char name[BT_BROWSE_NAME_SIZE] = {0};
+                    BTBrowseGetItemName(item, name, BT_BROWSE_NAME_SIZE);
+                    LogRaw(
+                        "    %u: %s%s\r\n",
+                        position + i,
+                        name,
+                        item->type == BT_BROWSE_ITEM_TYPE_FOLDER ? "/" : ""
+                    );
+                }
+            }
+            LogRaw("    Items: %u\r\n", cli.bt->browse.itemCount);
+        }
     } else if (UtilsStricmp(msgBuf[1], "MGAIN") == 0) {
         uint8_t currentMicGain = ConfigGetSetting(CONFIG_SETTING_MIC_GAIN);
         if (delimCount == 2) {
@@ -320,6 +433,270 @@ void CLICommandBTBM83(char **msgBuf, uint8_t *cmdSuccess, uint8_t delimCount)
     }
 }
 
+/**
+ * CLIPrintCrashRecord()
+ *     Description:
+ *         Print the crash on record, followed by the raw record for
+ *         utility/crash_decoder.py, which maps the addresses in it to
+ *         functions in the firmware ELF
+ *     Params:
+ *         CrashRecord_t *record - The crash record
+ *     Returns:
+ *         void
+ */
+static void CLIPrintCrashRecord(CrashRecord_t *record)
+{
+    uint8_t *data = (uint8_t *) record;
+    uint8_t i;
+    LogRaw(
+        "Crash: %s at 0x%06lX, %lums after boot on v%u.%u.%u\r\n",
+        CrashGetTrapName(record->trap),
+        CrashGetReturnAddress(record),
+        record->uptime,
+        record->version[0],
+        record->version[1],
+        record->version[2]
+    );
+    LogRaw(
+        "    INTCON1: 0x%04X SP: 0x%04X SPLIM: 0x%04X Stack High Water Mark: %u\r\n",
+        record->intcon1,
+        record->w[15],
+        record->splim,
+        record->stackHighWaterMark
+    );
+    for (i = 0; i < 16; i += 4) {
+        LogRaw(
+            "    W%u: 0x%04X W%u: 0x%04X W%u: 0x%04X W%u: 0x%04X\r\n",
+            i, record->w[i],
+            i + 1, record->w[i + 1],
+            i + 2, record->w[i + 2],
+            i + 3, record->w[i + 3]
+        );
+    }
+    LogRaw("    Stages:");
+    for (i = 0; i < PROFILE_STAGE_HISTORY_SIZE; i++) {
+        if (record->stages[i] < PROFILE_STAGE_COUNT) {
+            LogRaw(" %s,", ProfileGetStageName(record->stages[i]));
+        }
+    }
+    LogRaw(" then the crash\r\n");
+    for (i = 0; i < CRASH_UART_COUNT; i++) {
+        LogRaw(
+            "    UART[%u] Queue Max: RX %u TX %u\r\n",
+            i + 1,
+            record->rxQueueMax[i],
+            record->txQueueMax[i]
+        );
+    }
+    LogRaw("Crash Record:");
+    for (i = 0; i < CRASH_RECORD_SIZE; i++) {
+        if ((i % 32) == 0) {
+            LogRaw("\r\n    %02X:", i);
+        }
+        LogRaw(" %02X", data[i]);
+    }
+    LogRaw("\r\n");
+}
+
+/**
+ * CLIPrintProfileStat()
+ *     Description:
+ *         Print the cost of a main loop stage, along with its share of the
+ *         time spent in the loop
+ *     Params:
+ *         const char *name - The name to print it under
+ *         ProfileStat_t *stat - The stage cost
+ *         uint64_t loopTotal - The cycles spent in the loop
+ *     Returns:
+ *         void
+ */
+static void CLIPrintProfileStat(const char *name, ProfileStat_t *stat, uint64_t loopTotal)
+{
+    uint32_t average = 0;
+    uint8_t share = 0;
+    if (stat->count != 0) {
+        average = stat->total / stat->count / TIMER_CYCLES_PER_MICROSECOND;
+    }
+    if (loopTotal != 0) {
+        share = stat->total * 100 / loopTotal;
+    }
+    LogRaw(
+        "    %s: %lu runs, %luus avg, %luus max, %u%% of the loop\r\n",
+        name,
+        stat->count,
+        average,
+        stat->max / TIMER_CYCLES_PER_MICROSECOND,
+        share
+    );
+    LogRaw(
+        "        %u %u %u %u %u %u %u %u\r\n",
+        stat->histogram[0],
+        stat->histogram[1],
+        stat->histogram[2],
+        stat->histogram[3],
+        stat->histogram[4],
+        stat->histogram[5],
+        stat->histogram[6],
+        stat->histogram[7]
+    );
+}
+
+/**
+ * CLICommandProfile()
+ *     Description:
+ *         Parse the "PROFILE" CLI Commands. Without a parameter, print what
+ *         each main loop stage, scheduled task and event callback has cost
+ *         since the last reset, and the duty cycle of the main loop, which
+ *         is the share of the time it was not idle. Tasks and callbacks are
+ *         listed by address, which the linker map file turns into a
+ *         function name.
+ *     Params:
+ *         char **msgBuf - The message buffer
+ *         uint8_t *cmdSuccess - A pointer to the command success flag
+ *         uint8_t delimCount - The number of parameters in the command
+ *     Returns:
+ *         void
+ */
+void CLICommandProfile(char **msgBuf, uint8_t *cmdSuccess, uint8_t delimCount)
+{
+    if (delimCount > 1) {
+        if (delimCount == 2 && UtilsStricmp(msgBuf[1], "RESET") == 0) {
+            ProfileReset();
+        } else {
+            *cmdSuccess = 0;
+        }
+        return;
+    }
+    uint64_t loopTotal = ProfileGetStage(PROFILE_STAGE_LOOP)->total;
+    uint32_t elapsed = TimerGetMillis() - ProfileGetResetTime();
+    uint8_t idx;
+    LogRaw(
+        "Profile over the last %lums, with runs counted in buckets of "
+        "<16us <64us <256us <1ms <4ms <16ms <65ms >=65ms:\r\n",
+        elapsed
+    );
+    for (idx = 0; idx < PROFILE_STAGE_COUNT; idx++) {
+        CLIPrintProfileStat(
+            ProfileGetStageName(idx),
+            ProfileGetStage(idx),
+            loopTotal
+        );
+    }
+    // The duty cycle is kept in tenths of a percent. The idle time is only
+    // as fine as the milliseconds, so it may come out over the elapsed time.
+    ProfileStat_t *idle = ProfileGetIdle();
+    uint64_t elapsedCycles = (uint64_t) elapsed * (SYS_CLOCK / 1000);
+    uint64_t idleCycles = idle->total;
+    uint16_t duty = 1000;
+    uint32_t idleAverage = 0;
+    if (elapsedCycles != 0) {
+        if (idleCycles > elapsedCycles) {
+            idleCycles = elapsedCycles;
+        }
+        duty = 1000 - idleCycles * 1000 / elapsedCycles;
+    }
+    if (idle->count != 0) {
+        idleAverage = idle->total / idle->count / TIMER_CYCLES_PER_MICROSECOND;
+    }
+    LogRaw(
+        "    Duty Cycle: %u.%u%% awake, idle %lu times, %luus avg, %luus max\r\n",
+        duty / 10,
+        duty % 10,
+        idle->count,
+        idleAverage,
+        idle->max / TIMER_CYCLES_PER_MICROSECOND
+    );
+    LogRaw("Scheduled Tasks:\r\n");
+    for (idx = 0; idx < TIMER_TASKS_MAX; idx++) {
+        volatile TimerScheduledTask_t *task = TimerGetScheduledTask(idx);
+        ProfileSlotStat_t *stat = ProfileGetTask(idx);
+        if (task == 0 || stat->count == 0) {
+            continue;
+        }
+        uint8_t share = 0;
+        if (loopTotal != 0) {
+            share = (uint64_t) stat->total * 100 / loopTotal;
+        }
+        LogRaw(
+            "    %u (%p): %u runs, %luus avg, %uus max, %u%% of the loop\r\n",
+            idx,
+            (void *) task->task,
+            stat->count,
+            stat->total / stat->count / TIMER_CYCLES_PER_MICROSECOND,
+            stat->max,
+            share
+        );
+    }
+    LogRaw("Event Callbacks:\r\n");
+    for (idx = 0; idx < PROFILE_CALLBACKS_MAX; idx++) {
+        volatile Event_t *callback = EventGetCallback(idx);
+        ProfileSlotStat_t *stat = ProfileGetCallback(idx);
+        if (callback == 0 || stat->count == 0) {
+            continue;
+        }
+        LogRaw(
+            "    %u (Event %u, %p): %u runs, %luus avg, %uus max\r\n",
+            idx,
+            callback->type,
+            (void *) callback->callback,
+            stat->count,
+            stat->total / stat->count / TIMER_CYCLES_PER_MICROSECOND,
+            stat->max
+        );
+    }
+}
+
+/**
+ * CLICommandTrace()
+ *     Description:
+ *         Parse the "TRACE" CLI Commands. Without a parameter, print the
+ *         records in the trace ring, timed from the oldest one. The RX
+ *         arrival of a frame is recorded when the frame completes, so it
+ *         can come before the oldest record.
+ *     Params:
+ *         char **msgBuf - The message buffer
+ *         uint8_t *cmdSuccess - A pointer to the command success flag
+ *         uint8_t delimCount - The number of parameters in the command
+ *     Returns:
+ *         void
+ */
+void CLICommandTrace(char **msgBuf, uint8_t *cmdSuccess, uint8_t delimCount)
+{
+    if (delimCount > 1) {
+        if (delimCount != 2) {
+            *cmdSuccess = 0;
+        } else if (UtilsStricmp(msgBuf[1], "ON") == 0) {
+            TraceSetMode(TRACE_MODE_RING);
+        } else if (UtilsStricmp(msgBuf[1], "STREAM") == 0) {
+            TraceSetMode(TRACE_MODE_STREAM);
+        } else if (UtilsStricmp(msgBuf[1], "OFF") == 0) {
+            TraceSetMode(TRACE_MODE_OFF);
+        } else if (UtilsStricmp(msgBuf[1], "CLEAR") == 0) {
+            TraceReset();
+        } else {
+            *cmdSuccess = 0;
+        }
+        return;
+    }
+    uint8_t count = TraceGetCount();
+    uint32_t first = 0;
+    uint8_t idx;
+    LogRaw("Trace: Mode %d, %u Records\r\n", TraceGetMode(), count);
+    if (count != 0) {
+        first = TraceGet(0)->timestamp;
+    }
+    for (idx = 0; idx < count; idx++) {
+        TraceRecord_t *record = TraceGet(idx);
+        LogRaw(
+            "    %ldus: %s %02X %04X\r\n",
+            (long) ((int32_t) (record->timestamp - first) / TIMER_CYCLES_PER_MICROSECOND),
+            TraceGetPointName(record->point),
+            record->value,
+            record->detail
+        );
+    }
+}
+
 /**
  * CLIEventBTBTMAddress()
  *     Description:
@@ -367,10 +744,12 @@ void CLIProcess()
     }
     if (cli.terminalReady == 0 && SYS_DTR_STATUS == 0) {
         cli.terminalReady = 1;
+        UARTSetTXFullMode(cli.uart, UART_TX_FULL_WAIT);
         TimerResetScheduledTask(cli.terminalReadyTaskId);
     }
     if (cli.terminalReady == 2 && SYS_DTR_STATUS == 1) {
         cli.terminalReady = 0;
+        UARTSetTXFullMode(cli.uart, UART_TX_FULL_DROP);
     }
     // Check for the backspace character
     uint16_t backspaceLegnth = CharQueueSeek(&cli.uart->rxQueue, CLI_MSG_DELETE_CHAR);
@@ -426,14 +805,34 @@ void CLIProcess()
                 msgBuf[i++] = p;
                 p = strtok(0x00, " ");
             }
-            if (UtilsStricmp(msgBuf[0], "BOOTLOADER") == 0) {
+            if (UtilsStricmp(msgBuf[0], "BOOT") == 0) {
+                BootTrace_t *trace = BootTraceGet();
+                uint32_t previous = 0;
+                uint8_t stage;
+                LogRaw("Boot Trace:\r\n");
+                for (stage = 0; stage < BOOT_TRACE_STAGE_COUNT; stage++) {
+                    if (BootTraceIsMarked(stage) == 0) {
+                        LogRaw("    %s: Pending\r\n", BootTraceGetStageName(stage));
+                        continue;
+                    }
+                    uint32_t timestamp = trace->timestamps[stage];
+                    LogRaw(
+                        "    %s: %lums (+%lums)\r\n",
+                        BootTraceGetStageName(stage),
+                        timestamp,
+                        timestamp - previous
+                    );
+                    previous = timestamp;
+                }
+            } else if (UtilsStricmp(msgBuf[0], "BOOTLOADER") == 0) {
                 LogRaw("Rebooting into bootloader\r\n");
-                uint32_t now = TimerGetMillis();
-                // Wait 15ms before going into the bootloader
-                // so our message debug goes through to the CLI
-                while (TimerGetMillis() - now <= 15);
+                // Make sure our message goes through to the CLI
+                // before going into the bootloader
+                UARTFlush(cli.uart);
                 ConfigSetBootloaderMode(0x01);
                 UtilsReset();
+            } else if (UtilsStricmp(msgBuf[0], "BENCH") == 0) {
+                CLICommandBenchmark(msgBuf, &cmdSuccess, delimCount);
             } else if (UtilsStricmp(msgBuf[0], "BT") == 0) {
                 if (UtilsStricmp(msgBuf[1], "AT") == 0) {
                     if (delimCount == 3) {
@@ -457,6 +856,44 @@ void CLIProcess()
                     BTCommandDial(cli.bt, cli.bt->dialBuffer, 0);
                 } else if (UtilsStricmp(msgBuf[1], "REDIAL_PHONE") == 0) {
                     BTCommandRedial(cli.bt);
+                } else if (UtilsStricmp(msgBuf[1], "RECONNECT") == 0) {
+                    BTReconnect_t *reconnect = &cli.bt->reconnect;
+                    int8_t recent = BTPairedDeviceGetRecent(cli.bt);
+                    uint8_t idx;
+                    if (reconnect->status == BT_RECONNECT_STATUS_ACTIVE) {
+                        uint32_t now = TimerGetMillis();
+                        uint32_t elapsed = now - reconnect->scheduled;
+                        uint32_t next = 0;
+                        if (elapsed < reconnect->wait) {
+                            next = reconnect->wait - elapsed;
+                        }
+                        LogRaw(
+                            "Reconnect: Active, %u attempts in %lums, next in %lums (delay %ums)\r\n",
+                            reconnect->attempts,
+                            now - reconnect->start,
+                            next,
+                            reconnect->delay
+                        );
+                    } else {
+                        LogRaw("Reconnect: Idle\r\n");
+                    }
+                    LogRaw(
+                        "Connections: %u, last took %u attempts in %lums\r\n",
+                        reconnect->connects,
+                        reconnect->lastAttempts,
+                        reconnect->lastDuration
+                    );
+                    for (idx = 0; idx < cli.bt->pairedDevicesCount; idx++) {
+                        BTPairedDevice_t *dev = &cli.bt->pairedDevices[idx];
+                        LogRaw(
+                            "    %d: %s - %u OK %u Failed%s\r\n",
+                            idx,
+                            dev->deviceName,
+                            dev->connectSuccesses,
+                            dev->connectFailures,
+                            recent == idx ? " (Last)" : ""
+                        );
+                    }
                 } else if (cli.bt->type == BT_BTM_TYPE_BC127) {
                     CLICommandBTBC127(msgBuf, &cmdSuccess, delimCount);
                 } else {
@@ -478,6 +915,13 @@ void CLIProcess()
                     IBusCommandDIAGetIdentity(cli.ibus, IBUS_DEVICE_RAD);
                 } else if (UtilsStricmp(msgBuf[1], "LCM") == 0) {
                     IBusCommandDIAGetIdentity(cli.ibus, IBUS_DEVICE_LCM);
+                } else if (UtilsStricmp(msgBuf[1], "CRASH") == 0) {
+                    CrashRecord_t record;
+                    if (CrashGetRecord(&record) != 0) {
+                        CLIPrintCrashRecord(&record);
+                    } else {
+                        LogRaw("No crash on record\r\n");
+                    }
                 } else if (UtilsStricmp(msgBuf[1], "ERR") == 0) {
                     // Errors
                     LogRaw("Trap Counts: \r\n");
@@ -489,6 +933,22 @@ void CLIProcess()
                     LogRaw("    General Failures: %d\r\n", ConfigGetTrapCount(CONFIG_TRAP_GEN));
                     LogRaw("    Last Trap: %02x\r\n", ConfigGetTrapLast());
                     LogRaw("BC127 Boot Failures: %u\r\n", ConfigGetBC127BootFailures());
+                    LogRaw("Stack High Water Mark: %u bytes\r\n", ConfigGetStackHighWaterMark());
+                    CrashRecord_t record;
+                    if (CrashGetRecord(&record) != 0) {
+                        LogRaw(
+                            "Last Crash: %s at 0x%06lX\r\n",
+                            CrashGetTrapName(record.trap),
+                            CrashGetReturnAddress(&record)
+                        );
+                    }
+                } else if (UtilsStricmp(msgBuf[1], "STACK") == 0) {
+                    LogRaw(
+                        "Stack: %u of %u bytes used since boot, %u at most\r\n",
+                        StackGetHighWaterMark(),
+                        StackGetSize(),
+                        ConfigGetStackHighWaterMark()
+                    );
                 } else if (UtilsStricmp(msgBuf[1], "UI") == 0) {
                     uint8_t uiMode = ConfigGetUIMode();
                     if (uiMode == CONFIG_UI_CD53) {
@@ -557,7 +1017,42 @@ void CLIProcess()
                 } else {
                     cmdSuccess = 0;
                 }
+            } else if (UtilsStricmp(msgBuf[0], "PB") == 0) {
+                uint16_t count = PhonebookGetCount();
+                if (delimCount == 1) {
+                    LogRaw(
+                        "Phonebook: Status %d, %u Contacts\r\n",
+                        PhonebookGetStatus(),
+                        count
+                    );
+                } else {
+                    // Jump to a letter, or to a position in the list
+                    uint16_t position = 0;
+                    if (isalpha((uint8_t) msgBuf[1][0]) != 0) {
+                        position = PhonebookGetLetterPosition(msgBuf[1][0]);
+                    } else {
+                        position = (uint16_t) strtoul(msgBuf[1], 0, 10);
+                    }
+                    PhonebookContact_t contacts[CLI_PHONEBOOK_PAGE_SIZE];
+                    uint8_t read = PhonebookGetPage(
+                        position,
+                        contacts,
+                        CLI_PHONEBOOK_PAGE_SIZE
+                    );
+                    uint8_t i;
+                    for (i = 0; i < read; i++) {
+                        LogRaw(
+                            "    %u: %s %s\r\n",
+                            position + i,
+                            contacts[i].name,
+                            contacts[i].number
+                        );
+                    }
+                }
+            } else if (UtilsStricmp(msgBuf[0], "PROFILE") == 0) {
+                CLICommandProfile(msgBuf, &cmdSuccess, delimCount);
             } else if (UtilsStricmp(msgBuf[0], "REBOOT") == 0) {
+                UARTFlush(cli.uart);
                 UtilsReset();
             } else if (UtilsStricmp(msgBuf[0], "RESET") == 0) {
                 if (UtilsStricmp(msgBuf[1], "TRAPS") == 0) {
@@ -567,6 +1062,8 @@ void CLIProcess()
                     ConfigSetTrapCount(CONFIG_TRAP_MATH, 0);
                     ConfigSetTrapCount(CONFIG_TRAP_NVM, 0);
                     ConfigSetTrapCount(CONFIG_TRAP_GEN, 0);
+                    ConfigSetStackHighWaterMark(0);
+                    CrashReset();
                 } else {
                     cmdSuccess = 0;
                 }
@@ -848,6 +1345,8 @@ void CLIProcess()
                     LogRaw("DAC: FAIL\r\n");
                 }
                 BM83CommandReadLocalBDAddress(cli.bt);
+            } else if (UtilsStricmp(msgBuf[0], "TRACE") == 0) {
+                CLICommandTrace(msgBuf, &cmdSuccess, delimCount);
             } else if (UtilsStricmp(msgBuf[0], "VERSION") == 0) {
                 char version[9];
                 ConfigGetFirmwareVersionString(version);
@@ -857,6 +1356,8 @@ void CLIProcess()
                 LogRaw("Hardware Revision: %d\r\n", BOARD_VERSION_STATUS + 1);
             } else if (UtilsStricmp(msgBuf[0], "HELP") == 0 || UtilsStricmp(msgBuf[0], "?") == 0) {
                 LogRaw("Available Commands:\r\n");
+                LogRaw("    BENCH [NAME] - Time the busiest functions in instruction cycles, pausing the main loop while they run\r\n");
+                LogRaw("    BOOT - Get the time at which each boot stage completed\r\n");
                 LogRaw("    BOOTLOADER - Reboot into the bootloader immediately\r\n");
                 if (cli.bt->type == BT_BTM_TYPE_BC127) {
                     LogRaw("    BT CONFIG - Get the BC127 Configuration\r\n");
@@ -865,15 +1366,20 @@ void CLIProcess()
                     LogRaw("    BT MGAIN x - Set the Mic gain to x where x is octal C0-D6\r\n");
                     LogRaw("    BT MPREAMP ON/OFF - Enable the microphone pre-amp so non-OE microphones work well\r\n");
                     LogRaw("    BT PAIR - Enable pairing mode\r\n");
+                    LogRaw("    BT PBAP - Pull the phonebook from the connected device\r\n");
                     LogRaw("    BT NAME <name> - Set the module name, up to 32 chars\r\n");
                     LogRaw("    BT REBOOT - Reboot the BC127\r\n");
                     LogRaw("    BT UNPAIR - Unpair all devices from the BC127\r\n");
                     LogRaw("    BT VERSION - Get the BC127 Version Info\r\n");
                 } else {
                     LogRaw("    BT CONN - Initiate a connection to the last device\r\n");
+                    LogRaw("    BT CMDS - Get the BM83 TX command counters\r\n");
+                    LogRaw("    BT FRAMES - Get the BM83 RX frame counters\r\n");
                     LogRaw("    BT LIST - Query the BM83 for the paired device list\r\n");
                     LogRaw("    BT PAIR - Enter Pairing Mode\r\n");
                     LogRaw("    BT MACID - Query the BM83 for the MAC Address\r\n");
+                    LogRaw("    BT PBAP - Pull the phonebook from the connected device\r\n");
+                    LogRaw("    BT BROWSE [NP|UP|OPEN x|x] - Browse the device folders or the now playing list\r\n");
                     LogRaw("    BT BLE - Enter BLE Mode\r\n");
                     LogRaw("    BT PLAY - Send the AVRCP Play Command\r\n");
                     LogRaw("    BT PAUSE - Send the AVRCP Pause Command\r\n");
@@ -881,13 +1387,18 @@ void CLIProcess()
                 }
                 LogRaw("    BT AT command> - Send raw AT command\r\n");
                 LogRaw("    BT DIAL <number> <name> - Dial a number and display name\r\n");
+                LogRaw("    BT RECONNECT - Get the reconnect attempts, timings and the per device history\r\n");
                 LogRaw("    BT REDIAL - Dial last number\r\n");
+                LogRaw("    GET CRASH - Get the state of the device at the last trap\r\n");
                 LogRaw("    GET DAC - Get info from the PCM5122 DAC\r\n");
                 LogRaw("    GET ERR - Get the Error counter\r\n");
                 LogRaw("    GET IBUS - Get debug info from the IBus\r\n");
+                LogRaw("    GET STACK - Get the most stack used since boot and ever\r\n");
                 LogRaw("    GET UI - Get the current UI Mode\r\n");
                 LogRaw("    GET I2S - Read the WM8804 INT/SPD Status registers\r\n");
                 LogRaw("    GET VIN - Read the stored vehicle VIN\r\n");
+                LogRaw("    PB [x] - Get the phonebook status, or list the contacts from position or letter x\r\n");
+                LogRaw("    PROFILE [RESET] - Get the time spent in each main loop stage, scheduled task and event callback, or start over\r\n");
                 LogRaw("    REBOOT - Reboot the device\r\n");
                 LogRaw("    SET COMFORT BLINKERS x - Set the comfort blinkers between 1 and 8\r\n");
                 LogRaw("    SET COMFORT LOCK x - Lock the car at the given KM/h. 10, 20 or OFF\r\n");
@@ -905,7 +1416,9 @@ void CLIProcess()
                 LogRaw("        x = 3. MID (Multi-Info Display)\r\n");
                 LogRaw("        x = 4. BMBT / MID\r\n");
                 LogRaw("        x = 5. Business Navigation (MIR)\r\n");
+                LogRaw("    RESET TRAPS - Clear the trap counters, the stack high water mark and the crash record\r\n");
                 LogRaw("    RESTORE - Fully Reset the BlueBus and BC127 to factory defaults\r\n");
+                LogRaw("    TRACE [ON/STREAM/OFF/CLEAR] - Get the latency trace, or record it, record and stream it in binary, stop or clear it\r\n");
                 LogRaw("    VERSION - Get the BlueBus Hardware/Software Versions\r\n");
             } else {
                 cmdSuccess = 0;
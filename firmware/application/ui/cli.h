@@ -10,15 +10,22 @@
 #include <string.h>
 #include <stdio.h>
 #include "../mappings.h"
+#include "../lib/benchmark.h"
+#include "../lib/boot_trace.h"
 #include "../lib/bt/bt_bc127.h"
 #include "../lib/bt/bt_bm83.h"
 #include "../lib/bt.h"
 #include "../lib/char_queue.h"
 #include "../lib/config.h"
+#include "../lib/crash.h"
 #include "../lib/i2c.h"
 #include "../lib/ibus.h"
 #include "../lib/pcm51xx.h"
+#include "../lib/phonebook.h"
+#include "../lib/profile.h"
+#include "../lib/stack.h"
 #include "../lib/timer.h"
+#include "../lib/trace.h"
 #include "../lib/uart.h"
 
 // Banner timeout is in seconds
@@ -26,6 +33,7 @@
 #define CLI_MSG_END_CHAR 0x0D
 #define CLI_MSG_DELIMETER 0x20
 #define CLI_MSG_DELETE_CHAR 0x7F
+#define CLI_PHONEBOOK_PAGE_SIZE 5
 /**
  * CLI_t
  *     Description:
@@ -46,8 +54,11 @@ typedef struct CLI_t {
     uint8_t terminalReady;
 } CLI_t;
 void CLIInit(UART_t *, BT_t *, IBus_t *);
+void CLICommandBenchmark(char **, uint8_t *, uint8_t);
 void CLICommandBTBC127(char **, uint8_t *, uint8_t);
 void CLICommandBTBM83(char **, uint8_t *, uint8_t);
+void CLICommandProfile(char **, uint8_t *, uint8_t);
+void CLICommandTrace(char **, uint8_t *, uint8_t);
 void CLIEventBTBTMAddress(void *, uint8_t *);
 void CLIProcess();
 void CLITimerTerminalReady(void *);
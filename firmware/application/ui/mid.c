@@ -124,26 +124,32 @@ static void MIDSetMainDisplayText(
     const char *str,
     int8_t timeout
 ) {
-    char text[UTILS_DISPLAY_TEXT_SIZE] = {0};
-    if (strlen(context->mainText) != 0) {
-        snprintf(
-            text,
+    // Format straight into the display buffer and take the length from
+    // snprintf() rather than copying and measuring the text again
+    int length = 0;
+    if (context->mainText[0] != '\0') {
+        length = snprintf(
+            context->mainDisplay.text,
             UTILS_DISPLAY_TEXT_SIZE,
             "%s %s",
             context->mainText,
             str
         );
     } else {
-        snprintf(
-            text,
+        length = snprintf(
+            context->mainDisplay.text,
             UTILS_DISPLAY_TEXT_SIZE,
             "%s",
             str
         );
     }
-    memset(context->mainDisplay.text, 0, UTILS_DISPLAY_TEXT_SIZE);
-    UtilsStrncpy(context->mainDisplay.text, text, UTILS_DISPLAY_TEXT_SIZE);
-    context->mainDisplay.length = strlen(context->mainDisplay.text);
+    if (length < 0) {
+        length = 0;
+        context->mainDisplay.text[0] = '\0';
+    } else if (length > UTILS_DISPLAY_TEXT_SIZE - 1) {
+        length = UTILS_DISPLAY_TEXT_SIZE - 1;
+    }
+    context->mainDisplay.length = length;
     context->mainDisplay.index = 0;
     TimerTriggerScheduledTask(context->displayUpdateTaskId);
     context->mainDisplay.timeout = timeout;
@@ -0,0 +1,224 @@
+#!/usr/bin/env python3
+"""
+Decode the crash record that "GET CRASH" prints on the BlueBus CLI.
+
+The record holds the address that the trap returned to, the registers, the
+words on top of the stack, the last main loop stages to run and the high
+water marks of the UART queues. Given the ELF of the firmware that crashed,
+the addresses are mapped to the functions, and the lines if the compiler's
+addr2line is found, that they belong to.
+
+Examples:
+    # Decode a capture of the CLI
+    ./crash_decoder.py crash.txt --elf BlueBus.X.production.elf
+
+    # Read from the clipboard
+    xclip -o | ./crash_decoder.py - --elf BlueBus.X.production.elf
+"""
+import re
+import shutil
+import struct
+import subprocess
+import sys
+
+from argparse import ArgumentParser
+
+RECORD_SIZE = 128
+RECORD_MAGIC = 0xC5
+RECORD_FORMAT = '<BBHI2H16HHH4H4H8s4B26H'
+RECORD_LINE = re.compile(r'^\s*([0-9A-Fa-f]{2}):((?:\s+[0-9A-Fa-f]{2})+)\s*$')
+UART_NAMES = ['IBus', 'BT', 'System', 'UART 4']
+STAGE_NAMES = ['Loop', 'BT', 'IBus', 'Timer', 'Phonebook', 'CLI', 'Deferred Init']
+TRAP_NAMES = {
+    0x08: 'Oscillator Failure',
+    0x09: 'Address Error',
+    0x0A: 'Stack Error',
+    0x0B: 'Math Error',
+    0x0C: 'NVM Error',
+    0x0D: 'General Error',
+}
+INTCON1_BITS = [
+    (1, 'OSCFAIL'),
+    (2, 'STKERR'),
+    (3, 'ADDRERR'),
+    (4, 'MATHERR'),
+    (15, 'NSTDIS'),
+]
+
+
+def read_record(text):
+    """Pull the raw record out of the CLI output"""
+    data = bytearray()
+    found = False
+    for line in text.splitlines():
+        if line.strip().startswith('Crash Record:'):
+            found = True
+            data = bytearray()
+            continue
+        if not found:
+            continue
+        match = RECORD_LINE.match(line)
+        if match is None:
+            if len(data) != 0:
+                break
+            continue
+        data += bytes(int(b, 16) for b in match.group(2).split())
+    if len(data) < RECORD_SIZE:
+        return None
+    return bytes(data[:RECORD_SIZE])
+
+
+def parse_record(data):
+    fields = struct.unpack(RECORD_FORMAT, data)
+    return {
+        'magic': fields[0],
+        'trap': fields[1],
+        'intcon1': fields[2],
+        'uptime': fields[3],
+        'pc': fields[4:6],
+        'w': fields[6:22],
+        'splim': fields[22],
+        'stack_high_water_mark': fields[23],
+        'rx_queue_max': fields[24:28],
+        'tx_queue_max': fields[28:32],
+        'stages': bytearray(fields[32]),
+        'version': fields[33:37],
+        'stack': fields[37:],
+    }
+
+
+class Symbols(object):
+    """The functions in the ELF, and where they are in program memory"""
+
+    def __init__(self, elf, nm, addr2line):
+        self.elf = elf
+        self.addr2line = addr2line
+        self.functions = []
+        output = subprocess.check_output(
+            [nm, '-n', '--defined-only', elf],
+            universal_newlines=True
+        )
+        for line in output.splitlines():
+            parts = line.split()
+            if len(parts) == 3 and parts[1] in ('T', 't'):
+                self.functions.append((int(parts[0], 16), parts[2]))
+
+    def lookup(self, address):
+        """The function an address falls in, as 'name+0xoffset'"""
+        best = None
+        for start, name in self.functions:
+            if start > address:
+                break
+            best = (start, name)
+        if best is None or best == self.functions[-1]:
+            return None
+        return '%s+0x%X' % (best[1], address - best[0])
+
+    def line(self, address):
+        if self.addr2line is None:
+            return None
+        output = subprocess.check_output(
+            [self.addr2line, '-e', self.elf, '0x%X' % address],
+            universal_newlines=True
+        ).strip()
+        if output.startswith('??'):
+            return None
+        return output
+
+
+def describe(symbols, address):
+    text = '0x%06X' % address
+    if symbols is None:
+        return text
+    function = symbols.lookup(address)
+    if function is not None:
+        text += ' %s' % function
+        line = symbols.line(address)
+        if line is not None:
+            text += ' (%s)' % line
+    return text
+
+
+def find_tool(name):
+    if name is not None and shutil.which(name) is not None:
+        return name
+    return None
+
+
+def main():
+    parser = ArgumentParser(description='Decode a BlueBus crash record')
+    parser.add_argument('capture', help='The output of "GET CRASH", or - for stdin')
+    parser.add_argument('--elf', help='The ELF of the firmware that crashed')
+    parser.add_argument('--nm', default='xc16-nm', help='The nm to read the ELF with')
+    parser.add_argument('--addr2line', default='xc16-addr2line', help='The addr2line to find lines with')
+    args = parser.parse_args()
+
+    if args.capture == '-':
+        text = sys.stdin.read()
+    else:
+        with open(args.capture) as f:
+            text = f.read()
+    data = read_record(text)
+    if data is None:
+        print('No crash record found')
+        return 1
+    record = parse_record(data)
+    if record['magic'] != RECORD_MAGIC:
+        print('The record is empty')
+        return 1
+
+    symbols = None
+    if args.elf:
+        nm = find_tool(args.nm) or find_tool('nm')
+        if nm is None:
+            print('Unable to find %s to read the ELF with' % args.nm)
+            return 1
+        symbols = Symbols(args.elf, nm, find_tool(args.addr2line))
+
+    pc = ((record['pc'][1] & 0x7F) << 16) | record['pc'][0]
+    intcon1 = record['intcon1']
+    print('%s after %.1fs on v%d.%d.%d (board %d)' % (
+        (TRAP_NAMES.get(record['trap'], 'Unknown trap'),
+         record['uptime'] / 1000.0) + tuple(record['version'])
+    ))
+    print('Returned to: %s' % describe(symbols, pc))
+    print('    SR: 0x%02X IPL3: %d' % (record['pc'][1] >> 8, (record['pc'][1] >> 7) & 1))
+    print('    INTCON1: 0x%04X %s' % (
+        intcon1,
+        ' '.join(name for bit, name in INTCON1_BITS if intcon1 & (1 << bit))
+    ))
+    for i in range(0, 16, 4):
+        print('    ' + ' '.join(
+            'W%-2d 0x%04X' % (n, record['w'][n]) for n in range(i, i + 4)
+        ))
+    print('    SP: 0x%04X SPLIM: 0x%04X, %d bytes of stack used at most' % (
+        record['w'][15], record['splim'], record['stack_high_water_mark']
+    ))
+
+    stages = [STAGE_NAMES[s] if s < len(STAGE_NAMES) else str(s)
+              for s in record['stages'] if s != 0xFF]
+    print('Main loop stages, oldest first: %s' % ', '.join(stages))
+    print('UART queue high water marks:')
+    for i, name in enumerate(UART_NAMES):
+        print('    %s: RX %d TX %d' % (
+            name, record['rx_queue_max'][i], record['tx_queue_max'][i]
+        ))
+
+    # A call pushes the low word of the return address and then its high
+    # seven bits, so any such pair that lands in a function is a candidate
+    stack = record['stack']
+    top = record['w'][15] - 4 - 2 * len(stack)
+    print('Stack, from 0x%04X:' % top)
+    for i, word in enumerate(stack):
+        line = '    0x%04X: 0x%04X' % (top + i * 2, word)
+        if symbols is not None and i + 1 < len(stack) and stack[i + 1] <= 0x7F:
+            address = (stack[i + 1] << 16) | word
+            function = symbols.lookup(address) if address & 1 == 0 else None
+            if function is not None and not function.endswith('+0x0'):
+                line += '  return into %s' % describe(symbols, address)
+        print(line)
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
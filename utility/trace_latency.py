@@ -0,0 +1,206 @@
+#!/usr/bin/env python3
+"""
+Measure the latency between two trace points from a BlueBus trace.
+
+Turn tracing on with "TRACE STREAM" on the CLI and capture the system UART,
+either to a file with any terminal program or with --port. Text output of the
+"TRACE" command can be read from a file as well.
+
+Examples:
+    # How long from an MFL button press to the BT play command (BM83)
+    ./trace_latency.py capture.bin --start "IBus RX:50" --end "BT TX:02"
+
+    # How long from an AVRCP track change to the GT title update
+    ./trace_latency.py capture.bin --start "BT RX:5D" --end "IBus TX:68:3B21"
+
+A filter is the trace point name or number, optionally followed by the value
+and the detail in hex, separated by colons. Every end record is paired with
+the last start record before it that has not been paired yet.
+"""
+import sys
+
+from argparse import ArgumentParser
+
+CYCLES_PER_MICROSECOND = 16
+STREAM_SYNC = 0xFF
+STREAM_FRAME_SIZE = 10
+POINT_NAMES = [
+    'UART RX',
+    'IBus RX',
+    'BT RX',
+    'Event',
+    'IBus TX Queue',
+    'IBus TX',
+    'BT TX',
+]
+
+
+def parse_filter(text):
+    parts = text.split(':')
+    name = parts[0].strip()
+    if name.isdigit():
+        point = int(name)
+    else:
+        names = [n.lower() for n in POINT_NAMES]
+        if name.lower() not in names:
+            raise ValueError('Unknown trace point "%s"' % name)
+        point = names.index(name.lower())
+    value = int(parts[1], 16) if len(parts) > 1 and parts[1] != '' else None
+    detail = int(parts[2], 16) if len(parts) > 2 and parts[2] != '' else None
+    return (point, value, detail)
+
+
+def matches(record, record_filter):
+    point, value, detail = record_filter
+    if record[1] != point:
+        return False
+    if value is not None and record[2] != value:
+        return False
+    if detail is not None and record[3] != detail:
+        return False
+    return True
+
+
+def parse_stream(data):
+    """Pull the binary records out of a capture, skipping any text"""
+    records = []
+    idx = 0
+    while idx + STREAM_FRAME_SIZE <= len(data):
+        if data[idx] != STREAM_SYNC:
+            idx += 1
+            continue
+        frame = data[idx + 1:idx + STREAM_FRAME_SIZE]
+        if sum(frame) & 0xFF != 0:
+            idx += 1
+            continue
+        timestamp = frame[0] | frame[1] << 8 | frame[2] << 16 | frame[3] << 24
+        records.append((timestamp, frame[4], frame[5], frame[6] | frame[7] << 8))
+        idx += STREAM_FRAME_SIZE
+    return records
+
+
+def parse_text(data):
+    """Read the records printed by the TRACE command"""
+    records = []
+    names = [n.lower() for n in POINT_NAMES]
+    for line in data.decode('ascii', 'ignore').splitlines():
+        line = line.strip()
+        if not line.endswith(tuple('0123456789ABCDEF')) or 'us: ' not in line:
+            continue
+        micros, rest = line.split('us: ', 1)
+        fields = rest.rsplit(' ', 2)
+        if len(fields) != 3 or fields[0].lower() not in names:
+            continue
+        records.append((
+            int(micros) * CYCLES_PER_MICROSECOND & 0xFFFFFFFF,
+            names.index(fields[0].lower()),
+            int(fields[1], 16),
+            int(fields[2], 16)
+        ))
+    return records
+
+
+def unwrap(records):
+    """
+    The cycle counter wraps every 268 seconds, and an RX arrival is recorded
+    after the records that follow it, so each record is placed by the signed
+    difference to the one before
+    """
+    result = []
+    last = None
+    now = 0
+    for record in records:
+        if last is not None:
+            delta = (record[0] - last) & 0xFFFFFFFF
+            if delta >= 1 << 31:
+                delta -= 1 << 32
+            now += delta
+        last = record[0]
+        result.append((now,) + record[1:])
+    return result
+
+
+def percentile(values, pct):
+    idx = int(round(pct / 100.0 * (len(values) - 1)))
+    return values[idx]
+
+
+def capture(port, seconds):
+    from serial import Serial
+    from time import time
+    data = bytearray()
+    with Serial(port, 115200, timeout=0.1) as serial:
+        serial.write(b'TRACE STREAM\r')
+        end = time() + seconds
+        while time() < end:
+            data += serial.read(4096)
+        serial.write(b'TRACE OFF\r')
+    return bytes(data)
+
+
+def main():
+    parser = ArgumentParser(description='Measure latency between BlueBus trace points')
+    parser.add_argument('capture', nargs='?', help='A capture of the system UART')
+    parser.add_argument('--port', help='Capture from this serial port instead')
+    parser.add_argument('--seconds', type=float, default=60, help='How long to capture for')
+    parser.add_argument('--start', help='The trace point that starts the interval')
+    parser.add_argument('--end', help='The trace point that ends the interval')
+    parser.add_argument('--save', help='Write the capture to this file')
+    args = parser.parse_args()
+
+    if args.port:
+        data = capture(args.port, args.seconds)
+        if args.save:
+            with open(args.save, 'wb') as f:
+                f.write(data)
+    elif args.capture:
+        with open(args.capture, 'rb') as f:
+            data = f.read()
+    else:
+        parser.error('Give a capture file or a serial port')
+
+    records = parse_stream(data)
+    if len(records) == 0:
+        records = parse_text(data)
+    # Records that carry an earlier timestamp, like UART RX, are recorded
+    # late, so put them back in order
+    records = sorted(unwrap(records), key=lambda r: r[0])
+    if len(records) == 0:
+        print('No trace records found')
+        return 1
+
+    if not args.start or not args.end:
+        counts = {}
+        for record in records:
+            counts[record[1]] = counts.get(record[1], 0) + 1
+        print('%d records' % len(records))
+        for point in sorted(counts):
+            name = POINT_NAMES[point] if point < len(POINT_NAMES) else str(point)
+            print('    %s: %d' % (name, counts[point]))
+        return 0
+
+    start_filter = parse_filter(args.start)
+    end_filter = parse_filter(args.end)
+    latencies = []
+    pending = None
+    for record in records:
+        if matches(record, end_filter) and pending is not None:
+            latencies.append((record[0] - pending) / float(CYCLES_PER_MICROSECOND))
+            pending = None
+        elif matches(record, start_filter):
+            pending = record[0]
+    if len(latencies) == 0:
+        print('No intervals found')
+        return 1
+    latencies.sort()
+    print('%d intervals (us)' % len(latencies))
+    print('    min: %.0f' % latencies[0])
+    print('    p50: %.0f' % percentile(latencies, 50))
+    print('    p90: %.0f' % percentile(latencies, 90))
+    print('    p99: %.0f' % percentile(latencies, 99))
+    print('    max: %.0f' % latencies[-1])
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())